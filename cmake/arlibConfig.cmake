@@ -1,3 +1,4 @@
 include(CMakeFindDependencyMacro)
 find_package(Boost REQUIRED COMPONENTS graph)
+find_dependency(Threads)
 include("${CMAKE_CURRENT_LIST_DIR}/arlibTargets.cmake")
\ No newline at end of file
@@ -6,8 +6,18 @@
 #include "arlib/penalty.hpp"
 #include "arlib/uninformed_bidirectional_pruning.hpp"
 
+#include "arlib/contraction_hierarchy.hpp"
+#include "arlib/customizable_contraction_hierarchy.hpp"
+#include "arlib/edge_index.hpp"
+#include "arlib/geometric_heuristic.hpp"
+#include "arlib/hub_labels.hpp"
+#include "arlib/landmarks.hpp"
 #include "arlib/multi_predecessor_map.hpp"
+#include "arlib/query_context.hpp"
+#include "arlib/reachability_index.hpp"
+#include "arlib/road_graph.hpp"
 #include "arlib/terminators.hpp"
+#include "arlib/thread_pool.hpp"
 #include "arlib/path.hpp"
 
 #include "arlib/graph_utils.hpp"
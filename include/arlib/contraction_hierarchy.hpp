@@ -0,0 +1,462 @@
+/**
+ * @file contraction_hierarchy.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_HPP
+#define ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/details/binary_io.hpp>
+#include <arlib/details/contraction_hierarchy_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                       Contraction Hierarchies
+//===----------------------------------------------------------------------===//
+
+/**
+ * A Contraction Hierarchy (CH) of a graph.
+ *
+ * This implementation refers to the following publication:
+ *
+ * Robert Geisberger, Peter Sanders, Dominik Schultes and Daniel Delling,
+ * Contraction Hierarchies: Faster and Simpler Hierarchical Routing in Road
+ * Networks, In Proc. of the 7th Int. Workshop on Experimental Algorithms
+ * (WEA) (2008)
+ *
+ * Vertices are contracted one by one; shortcuts preserve shortest path
+ * distances among the vertices left. Each vertex then stores its *upward*
+ * arcs, to vertices contracted later, for the forward search, and its
+ * *downward* arcs, from vertices contracted later, for the backward one. A
+ * shortcut remembers the vertex it bypasses and an original arc the ordinal
+ * of its edge in `edges(G)`, so every path can be unpacked to `Edge`
+ * descriptors.
+ *
+ * @tparam Graph A Boost::EdgeListGraph.
+ * @tparam Length The edge weight type.
+ */
+template <typename Graph, typename Length = length_of_t<Graph>>
+class contraction_hierarchy {
+public:
+  /**
+   * An upward or downward arc.
+   */
+  using Arc = details::ch_arc<Length>;
+  /**
+   * Graph edge descriptor.
+   */
+  using Edge = edge_of_t<Graph>;
+  /**
+   * A range of arcs.
+   */
+  using ArcRange = std::pair<Arc const *, Arc const *>;
+
+  contraction_hierarchy() = default;
+  /**
+   * Construct a new contraction_hierarchy object.
+   *
+   * @param rank The position of each vertex index in the contraction order.
+   * @param up_offsets The upward arcs of `v` are at
+   *        `[up_offsets[v], up_offsets[v + 1])` in @p up.
+   * @param up The upward arcs `v -> head`.
+   * @param down_offsets The downward arcs of `v` are at
+   *        `[down_offsets[v], down_offsets[v + 1])` in @p down.
+   * @param down The downward arcs `head -> v`.
+   * @param edges The edges of the graph, in `edges(G)` order.
+   */
+  contraction_hierarchy(std::vector<std::size_t> rank,
+                        std::vector<std::size_t> up_offsets,
+                        std::vector<Arc> up,
+                        std::vector<std::size_t> down_offsets,
+                        std::vector<Arc> down, std::vector<Edge> edges)
+      : rank_{std::move(rank)}, up_offsets{std::move(up_offsets)},
+        up{std::move(up)}, down_offsets{std::move(down_offsets)},
+        down{std::move(down)}, edges{std::move(edges)} {}
+
+  /**
+   * @return The number of vertices.
+   */
+  std::size_t num_vertices() const { return rank_.size(); }
+  /**
+   * @return The number of arcs, shortcuts included.
+   */
+  std::size_t num_arcs() const { return up.size() + down.size(); }
+  /**
+   * @param v A vertex index.
+   * @return The position of @p v in the contraction order.
+   */
+  std::size_t rank(std::size_t v) const { return rank_[v]; }
+  /**
+   * @param v A vertex index.
+   * @return The arcs from @p v to vertices of higher rank.
+   */
+  ArcRange up_arcs(std::size_t v) const {
+    return {up.data() + up_offsets[v], up.data() + up_offsets[v + 1]};
+  }
+  /**
+   * @param v A vertex index.
+   * @return The arcs to @p v from vertices of higher rank.
+   */
+  ArcRange down_arcs(std::size_t v) const {
+    return {down.data() + down_offsets[v], down.data() + down_offsets[v + 1]};
+  }
+  /**
+   * @param ordinal The position of an edge in `edges(G)`.
+   * @return The edge.
+   */
+  Edge edge(std::size_t ordinal) const { return edges[ordinal]; }
+
+  /**
+   * Unpack the arc @p u -> @p v into the edges of the original graph.
+   *
+   * @param u The tail vertex index of @p arc.
+   * @param v The head vertex index of @p arc.
+   * @param arc An arc of the hierarchy from @p u to @p v, either upward or
+   *        downward.
+   * @param out Where to write the edges, in path order.
+   */
+  template <typename OutputIt>
+  OutputIt unpack(std::size_t u, std::size_t v, Arc const &arc,
+                  OutputIt out) const {
+    // Arcs left to unpack, in reverse path order
+    struct Pending {
+      std::size_t tail;
+      std::size_t head;
+      Arc const *arc;
+    };
+    auto stack = std::vector<Pending>{{u, v, &arc}};
+    while (!stack.empty()) {
+      auto [tail, head, a] = stack.back();
+      stack.pop_back();
+      if (a->middle == details::ch_none) {
+        *out++ = edges[a->edge];
+        continue;
+      }
+      // Both halves of a shortcut are arcs of its middle vertex, which was
+      // contracted before either end.
+      auto m = a->middle;
+      auto [down_first, down_last] = down_arcs(m);
+      auto first = std::find_if(down_first, down_last, [tail = tail](auto &b) {
+        return b.head == tail;
+      });
+      auto [up_first, up_last] = up_arcs(m);
+      auto second = std::find_if(up_first, up_last, [head = head](auto &b) {
+        return b.head == head;
+      });
+      stack.push_back(Pending{m, head, second});
+      stack.push_back(Pending{tail, m, first});
+    }
+    return out;
+  }
+
+  /**
+   * @return The rank of every vertex.
+   */
+  std::vector<std::size_t> const &ranks() const { return rank_; }
+  /**
+   * @return The offsets of the upward arcs.
+   */
+  std::vector<std::size_t> const &up_arc_offsets() const { return up_offsets; }
+  /**
+   * @return The upward arcs.
+   */
+  std::vector<Arc> const &up_arc_list() const { return up; }
+  /**
+   * @return The offsets of the downward arcs.
+   */
+  std::vector<std::size_t> const &down_arc_offsets() const {
+    return down_offsets;
+  }
+  /**
+   * @return The downward arcs.
+   */
+  std::vector<Arc> const &down_arc_list() const { return down; }
+
+private:
+  std::vector<std::size_t> rank_;
+  std::vector<std::size_t> up_offsets;
+  std::vector<Arc> up;
+  std::vector<std::size_t> down_offsets;
+  std::vector<Arc> down;
+  std::vector<Edge> edges;
+};
+
+namespace details {
+/**
+ * Lay the arcs of @p arcs out in CSR form, grouped by their owner vertex.
+ */
+template <typename Length>
+std::pair<std::vector<std::size_t>, std::vector<ch_arc<Length>>>
+make_ch_csr(std::size_t n,
+            std::vector<std::pair<std::size_t, ch_arc<Length>>> const &arcs) {
+  auto offsets = std::vector<std::size_t>(n + 1, 0);
+  for (auto const &[owner, arc] : arcs) {
+    ++offsets[owner + 1];
+  }
+  for (std::size_t v = 0; v < n; ++v) {
+    offsets[v + 1] += offsets[v];
+  }
+  auto csr = std::vector<ch_arc<Length>>(arcs.size());
+  auto next = offsets;
+  for (auto const &[owner, arc] : arcs) {
+    csr[next[owner]++] = arc;
+  }
+  return {std::move(offsets), std::move(csr)};
+}
+
+/**
+ * @return The edges of @p G, in `edges(G)` order.
+ */
+template <typename Graph>
+std::vector<edge_of_t<Graph>> edge_list(const Graph &G) {
+  using namespace boost;
+  auto result = std::vector<edge_of_t<Graph>>{};
+  result.reserve(num_edges(G));
+  for (auto [e_it, e_end] = edges(G); e_it != e_end; ++e_it) {
+    result.push_back(*e_it);
+  }
+  return result;
+}
+
+constexpr char ch_magic[4] = {'A', 'R', 'C', 'H'};
+constexpr std::uint32_t ch_version = 1;
+
+template <typename Length>
+void write_ch_arcs(std::ostream &os, std::vector<ch_arc<Length>> const &arcs) {
+  for (auto const &arc : arcs) {
+    auto head = static_cast<std::uint64_t>(arc.head);
+    auto middle = static_cast<std::uint64_t>(arc.middle);
+    auto edge = static_cast<std::uint64_t>(arc.edge);
+    write_raw(os, &head, 1);
+    write_raw(os, &arc.weight, 1);
+    write_raw(os, &middle, 1);
+    write_raw(os, &edge, 1);
+  }
+}
+
+template <typename Length>
+bool read_ch_arcs(std::istream &is, std::vector<ch_arc<Length>> &arcs) {
+  for (auto &arc : arcs) {
+    std::uint64_t head, middle, edge;
+    if (!read_raw(is, &head, 1) || !read_raw(is, &arc.weight, 1) ||
+        !read_raw(is, &middle, 1) || !read_raw(is, &edge, 1)) {
+      return false;
+    }
+    arc.head = static_cast<std::size_t>(head);
+    arc.middle = static_cast<std::size_t>(middle);
+    arc.edge = static_cast<std::size_t>(edge);
+  }
+  return true;
+}
+
+inline void write_ch_offsets(std::ostream &os,
+                             std::vector<std::size_t> const &values) {
+  auto raw = std::vector<std::uint64_t>(values.begin(), values.end());
+  write_raw(os, raw.data(), raw.size());
+}
+
+inline bool read_ch_offsets(std::istream &is,
+                            std::vector<std::size_t> &values) {
+  auto raw = std::vector<std::uint64_t>(values.size());
+  if (!read_raw(is, raw.data(), raw.size())) {
+    return false;
+  }
+  std::copy(raw.begin(), raw.end(), values.begin());
+  return true;
+}
+} // namespace details
+
+/**
+ * Build the Contraction Hierarchy of @p G.
+ *
+ * Vertices are contracted in order of edge difference, updated lazily.
+ * Witness searches are bounded Dijkstra's searches settling at most
+ * @p settle_limit vertices: a lower limit speeds preprocessing up at the
+ * price of superfluous shortcuts, never of wrong distances.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::EdgeListGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param settle_limit The maximum number of vertices of a witness search.
+ * @return The contraction hierarchy of @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length = value_of_t<WeightMap>>
+contraction_hierarchy<Graph, Length>
+build_contraction_hierarchy(const Graph &G, WeightMap weight, IndexMap index,
+                            std::size_t settle_limit = 500) {
+  using namespace boost;
+  using Arc = details::ch_arc<Length>;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((EdgeListGraphConcept<Graph>));
+
+  auto n = num_vertices(G);
+  auto edges = details::edge_list(G);
+  auto overlay = details::ch_overlay<Length>{n};
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    auto u = get(index, source(edges[i], G));
+    auto v = get(index, target(edges[i], G));
+    if (u != v) {
+      overlay.add_arc(u, Arc{v, get(weight, edges[i]), details::ch_none, i});
+    }
+  }
+
+  auto rank = details::contract(overlay, settle_limit);
+
+  auto up = std::vector<std::pair<std::size_t, Arc>>{};
+  auto down = std::vector<std::pair<std::size_t, Arc>>{};
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto const &arc : overlay.out[u]) {
+      if (rank[u] < rank[arc.head]) {
+        up.emplace_back(u, arc);
+      } else {
+        down.emplace_back(arc.head, Arc{u, arc.weight, arc.middle, arc.edge});
+      }
+    }
+  }
+  auto [up_offsets, up_arcs] = details::make_ch_csr(n, up);
+  auto [down_offsets, down_arcs] = details::make_ch_csr(n, down);
+  return contraction_hierarchy<Graph, Length>{
+      std::move(rank),         std::move(up_offsets), std::move(up_arcs),
+      std::move(down_offsets), std::move(down_arcs),  std::move(edges)};
+}
+
+/**
+ * Build the Contraction Hierarchy of a `PropertyGraph`, using its
+ * `boost::edge_weight_t` and `boost::vertex_index_t` properties.
+ *
+ * @see build_contraction_hierarchy(const Graph &G, WeightMap weight,
+ *                                  IndexMap index, std::size_t settle_limit)
+ */
+template <typename PropertyGraph>
+auto build_contraction_hierarchy(const PropertyGraph &G) {
+  return build_contraction_hierarchy(G, get(boost::edge_weight, G),
+                                     get(boost::vertex_index, G));
+}
+
+/**
+ * Write @p ch to @p os in a binary format: a header with a magic number, a
+ * version, `sizeof(Length)`, the number of vertices, edges, upward and
+ * downward arcs, then ranks, offsets and arcs, in native byte order.
+ * Original edges are stored by ordinal, so the file is only meaningful
+ * together with the graph it was built on.
+ *
+ * @param os The stream to write to. Open it in binary mode.
+ * @param ch The contraction hierarchy.
+ * @param G The graph @p ch was built on.
+ */
+template <typename Graph, typename Length>
+void write_contraction_hierarchy(std::ostream &os,
+                                 contraction_hierarchy<Graph, Length> const &ch,
+                                 const Graph &G) {
+  using namespace boost;
+  auto length_size = static_cast<std::uint32_t>(sizeof(Length));
+  std::uint64_t header[4] = {ch.num_vertices(), num_edges(G),
+                             ch.up_arc_list().size(),
+                             ch.down_arc_list().size()};
+  os.write(details::ch_magic, sizeof(details::ch_magic));
+  details::write_raw(os, &details::ch_version, 1);
+  details::write_raw(os, &length_size, 1);
+  details::write_raw(os, header, 4);
+  details::write_ch_offsets(os, ch.ranks());
+  details::write_ch_offsets(os, ch.up_arc_offsets());
+  details::write_ch_arcs(os, ch.up_arc_list());
+  details::write_ch_offsets(os, ch.down_arc_offsets());
+  details::write_ch_arcs(os, ch.down_arc_list());
+}
+
+/**
+ * Read a contraction hierarchy written by write_contraction_hierarchy().
+ *
+ * @param is The stream to read from. Open it in binary mode.
+ * @param G The graph the hierarchy was built on.
+ * @return The contraction hierarchy, or an empty optional if @p is does not
+ *         hold a hierarchy of a graph of the same order and size as @p G,
+ *         with the same `Length` type.
+ */
+template <typename Length, typename Graph>
+std::optional<contraction_hierarchy<Graph, Length>>
+read_contraction_hierarchy(std::istream &is, const Graph &G) {
+  using namespace boost;
+  using Arc = details::ch_arc<Length>;
+  char magic[4];
+  auto version = std::uint32_t{};
+  auto length_size = std::uint32_t{};
+  std::uint64_t header[4];
+  if (!details::read_raw(is, magic, 4) ||
+      !std::equal(magic, magic + 4, details::ch_magic) ||
+      !details::read_raw(is, &version, 1) || version != details::ch_version ||
+      !details::read_raw(is, &length_size, 1) ||
+      length_size != sizeof(Length) || !details::read_raw(is, header, 4) ||
+      header[0] != num_vertices(G) || header[1] != num_edges(G)) {
+    return {};
+  }
+
+  auto n = static_cast<std::size_t>(header[0]);
+  auto rank = std::vector<std::size_t>(n);
+  auto up_offsets = std::vector<std::size_t>(n + 1);
+  auto up = std::vector<Arc>(static_cast<std::size_t>(header[2]));
+  auto down_offsets = std::vector<std::size_t>(n + 1);
+  auto down = std::vector<Arc>(static_cast<std::size_t>(header[3]));
+  if (!details::read_ch_offsets(is, rank) ||
+      !details::read_ch_offsets(is, up_offsets) ||
+      !details::read_ch_arcs(is, up) ||
+      !details::read_ch_offsets(is, down_offsets) ||
+      !details::read_ch_arcs(is, down)) {
+    return {};
+  }
+  return contraction_hierarchy<Graph, Length>{
+      std::move(rank),         std::move(up_offsets), std::move(up),
+      std::move(down_offsets), std::move(down),       details::edge_list(G)};
+}
+
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_HPP
@@ -0,0 +1,746 @@
+/**
+ * @file customizable_contraction_hierarchy.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
+#define ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/customizable_contraction_hierarchy_impl.hpp>
+#include <arlib/thread_pool.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                  Customizable Contraction Hierarchies
+//===----------------------------------------------------------------------===//
+
+/**
+ * The metric-independent part of a Customizable Contraction Hierarchy (CCH).
+ *
+ * This implementation refers to the following publication:
+ *
+ * Julian Dibbelt, Ben Strasser and Dorothea Wagner, Customizable Contraction
+ * Hierarchies, ACM Journal of Experimental Algorithmics 21 (2016)
+ *
+ * Vertices are eliminated in a nested dissection order, adding every arc
+ * that could ever be needed, whatever the weights. Each vertex, identified
+ * by its rank, stores its upward arcs sorted by head. An arc carries two
+ * weights in a cch_metric, one per direction, so a single topology serves
+ * any number of metrics.
+ *
+ * @tparam Graph A Boost::EdgeListGraph.
+ */
+template <typename Graph> class customizable_contraction_hierarchy {
+public:
+  /**
+   * Graph edge descriptor.
+   */
+  using Edge = edge_of_t<Graph>;
+  /**
+   * A lower neighbor of a vertex and the arc leading to it.
+   */
+  using DownArc = std::pair<std::size_t, std::size_t>;
+
+  customizable_contraction_hierarchy() = default;
+  /**
+   * Construct a new customizable_contraction_hierarchy object.
+   *
+   * @param order The vertex indices in contraction order.
+   * @param upward For each rank, the sorted ranks of its upward neighbors in
+   *        the chordal supergraph.
+   * @param edges The edges of the graph, in `edges(G)` order.
+   * @param endpoints The source and target vertex index of each edge.
+   */
+  customizable_contraction_hierarchy(
+      std::vector<std::size_t> order,
+      std::vector<std::vector<std::size_t>> const &upward,
+      std::vector<Edge> edges,
+      std::vector<std::pair<std::size_t, std::size_t>> const &endpoints)
+      : order{std::move(order)}, edges{std::move(edges)} {
+    auto n = this->order.size();
+    rank_.resize(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      rank_[this->order[r]] = r;
+    }
+
+    // Upward arcs, the elimination tree and its levels
+    up_offsets.assign(n + 1, 0);
+    parent_.assign(n, details::ch_none);
+    auto height = std::vector<std::size_t>(n, 0);
+    for (std::size_t x = 0; x < n; ++x) {
+      up_offsets[x + 1] = up_offsets[x] + upward[x].size();
+      heads.insert(heads.end(), upward[x].begin(), upward[x].end());
+      if (!upward[x].empty()) {
+        parent_[x] = upward[x].front();
+        auto &h = height[parent_[x]];
+        h = std::max(h, height[x] + 1);
+      }
+    }
+    auto num_levels = n == 0 ? 0 : *std::max_element(height.begin(),
+                                                     height.end()) + 1;
+    level_offsets.assign(num_levels + 1, 0);
+    for (auto h : height) {
+      ++level_offsets[h + 1];
+    }
+    for (std::size_t l = 0; l < num_levels; ++l) {
+      level_offsets[l + 1] += level_offsets[l];
+    }
+    by_level.resize(n);
+    auto next = level_offsets;
+    for (std::size_t x = 0; x < n; ++x) {
+      by_level[next[height[x]]++] = x;
+    }
+
+    // Downward arcs, grouped by their head
+    down_offsets.assign(n + 1, 0);
+    for (auto y : heads) {
+      ++down_offsets[y + 1];
+    }
+    for (std::size_t y = 0; y < n; ++y) {
+      down_offsets[y + 1] += down_offsets[y];
+    }
+    down.resize(heads.size());
+    next = down_offsets;
+    for (std::size_t x = 0; x < n; ++x) {
+      for (auto a = up_offsets[x]; a < up_offsets[x + 1]; ++a) {
+        down[next[heads[a]]++] = DownArc{x, a};
+      }
+    }
+
+    // The arc of each edge, and whether the edge runs upward along it
+    edge_arc.assign(endpoints.size(), details::ch_none);
+    edge_upward.assign(endpoints.size(), false);
+    for (std::size_t i = 0; i < endpoints.size(); ++i) {
+      auto ru = rank_[endpoints[i].first];
+      auto rv = rank_[endpoints[i].second];
+      if (ru != rv) {
+        edge_arc[i] = find_arc(std::min(ru, rv), std::max(ru, rv));
+        edge_upward[i] = ru < rv;
+      }
+    }
+
+    // The edges of each arc, in `edges(G)` order
+    arc_edge_offsets.assign(heads.size() + 1, 0);
+    for (auto a : edge_arc) {
+      if (a != details::ch_none) {
+        ++arc_edge_offsets[a + 1];
+      }
+    }
+    for (std::size_t a = 0; a < heads.size(); ++a) {
+      arc_edge_offsets[a + 1] += arc_edge_offsets[a];
+    }
+    arc_edges_.resize(arc_edge_offsets.back());
+    next = arc_edge_offsets;
+    for (std::size_t i = 0; i < edge_arc.size(); ++i) {
+      if (edge_arc[i] != details::ch_none) {
+        arc_edges_[next[edge_arc[i]]++] = i;
+      }
+    }
+  }
+
+  /**
+   * @return The number of vertices.
+   */
+  std::size_t num_vertices() const { return order.size(); }
+  /**
+   * @return The number of arcs, each usable in both directions.
+   */
+  std::size_t num_arcs() const { return heads.size(); }
+  /**
+   * @param v A vertex index.
+   * @return The position of @p v in the contraction order.
+   */
+  std::size_t rank(std::size_t v) const { return rank_[v]; }
+  /**
+   * @param r A rank.
+   * @return The vertex index of rank @p r.
+   */
+  std::size_t vertex(std::size_t r) const { return order[r]; }
+  /**
+   * @param x A rank.
+   * @return The parent of @p x in the elimination tree, or details::ch_none
+   *         for a root.
+   */
+  std::size_t parent(std::size_t x) const { return parent_[x]; }
+  /**
+   * @param x A rank.
+   * @return The range of the upward arcs of @p x, sorted by head.
+   */
+  std::pair<std::size_t, std::size_t> up_arcs(std::size_t x) const {
+    return {up_offsets[x], up_offsets[x + 1]};
+  }
+  /**
+   * @param a An arc.
+   * @return The rank of the upper end of @p a.
+   */
+  std::size_t head(std::size_t a) const { return heads[a]; }
+  /**
+   * @param a An arc.
+   * @return The rank of the lower end of @p a.
+   */
+  std::size_t tail(std::size_t a) const {
+    auto it = std::upper_bound(up_offsets.begin(), up_offsets.end(), a);
+    return static_cast<std::size_t>(it - up_offsets.begin()) - 1;
+  }
+  /**
+   * @param y A rank.
+   * @return The lower neighbors of @p y and the arcs leading to them.
+   */
+  std::pair<DownArc const *, DownArc const *>
+  down_arcs(std::size_t y) const {
+    return {down.data() + down_offsets[y], down.data() + down_offsets[y + 1]};
+  }
+  /**
+   * @param lower A rank.
+   * @param higher A rank greater than @p lower.
+   * @return The arc between @p lower and @p higher, or details::ch_none.
+   */
+  std::size_t find_arc(std::size_t lower, std::size_t higher) const {
+    auto first = heads.begin() + up_offsets[lower];
+    auto last = heads.begin() + up_offsets[lower + 1];
+    auto it = std::lower_bound(first, last, higher);
+    return (it != last && *it == higher)
+               ? static_cast<std::size_t>(it - heads.begin())
+               : details::ch_none;
+  }
+  /**
+   * @return The number of levels of the elimination tree.
+   */
+  std::size_t num_levels() const { return level_offsets.size() - 1; }
+  /**
+   * @param l A level of the elimination tree, 0 being the leaves.
+   * @return The ranks whose subtree has height @p l. Their arcs only depend
+   *         on arcs of lower levels.
+   */
+  std::pair<std::size_t const *, std::size_t const *>
+  level(std::size_t l) const {
+    return {by_level.data() + level_offsets[l],
+            by_level.data() + level_offsets[l + 1]};
+  }
+  /**
+   * @return The number of edges of the graph.
+   */
+  std::size_t num_edges() const { return edges.size(); }
+  /**
+   * @param ordinal The position of an edge in `edges(G)`.
+   * @return The edge.
+   */
+  Edge edge(std::size_t ordinal) const { return edges[ordinal]; }
+  /**
+   * @param ordinal The position of an edge in `edges(G)`.
+   * @return The arc of the edge, or details::ch_none for a self-loop.
+   */
+  std::size_t arc_of(std::size_t ordinal) const { return edge_arc[ordinal]; }
+  /**
+   * @param ordinal The position of an edge in `edges(G)`.
+   * @return Whether the edge runs from the lower to the upper end of its arc.
+   */
+  bool is_upward(std::size_t ordinal) const { return edge_upward[ordinal]; }
+  /**
+   * @param a An arc.
+   * @return The ordinals of the edges of @p a, increasing.
+   */
+  std::pair<std::size_t const *, std::size_t const *>
+  arc_edges(std::size_t a) const {
+    return {arc_edges_.data() + arc_edge_offsets[a],
+            arc_edges_.data() + arc_edge_offsets[a + 1]};
+  }
+
+private:
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> rank_;
+  std::vector<std::size_t> parent_;
+  std::vector<std::size_t> up_offsets;
+  std::vector<std::size_t> heads;
+  std::vector<std::size_t> down_offsets;
+  std::vector<DownArc> down;
+  std::vector<std::size_t> level_offsets;
+  std::vector<std::size_t> by_level;
+  std::vector<Edge> edges;
+  std::vector<std::size_t> edge_arc;
+  std::vector<bool> edge_upward;
+  std::vector<std::size_t> arc_edge_offsets;
+  std::vector<std::size_t> arc_edges_;
+};
+
+/**
+ * The weights of a customizable_contraction_hierarchy for one metric.
+ *
+ * customize() recomputes every arc weight from a weight map, so the same
+ * metric object can follow live weight changes, and is much cheaper than
+ * building a Contraction Hierarchy from scratch. When only a few edges
+ * changed, customize_edges() recomputes only the arcs that depend on them.
+ * The metric refers to its hierarchy, which must outlive it.
+ *
+ * @tparam Graph A Boost::EdgeListGraph.
+ * @tparam Length The edge weight type.
+ */
+template <typename Graph, typename Length> class cch_metric {
+public:
+  /**
+   * The metric-independent hierarchy.
+   */
+  using Topology = customizable_contraction_hierarchy<Graph>;
+
+  /**
+   * Construct a metric of @p cch where every arc is missing.
+   *
+   * @param cch The hierarchy.
+   */
+  explicit cch_metric(Topology const &cch)
+      : cch{&cch}, up_weight(cch.num_arcs(), inf),
+        down_weight(cch.num_arcs(), inf),
+        up_middle(cch.num_arcs(), details::ch_none),
+        down_middle(cch.num_arcs(), details::ch_none),
+        up_edge(cch.num_arcs(), details::ch_none),
+        down_edge(cch.num_arcs(), details::ch_none) {}
+
+  /**
+   * Recompute the arc weights for @p weight.
+   *
+   * Arcs are first given the weight of their shortest edge, then lower
+   * triangles are enumerated level by level in the elimination tree. Each
+   * vertex only writes its own upward arcs and only reads arcs of lower
+   * levels, so the vertices of a level are split among @p num_threads
+   * threads, started for each level large enough.
+   *
+   * @tparam WeightMap A readable property map from the graph's edges to
+   *         non-negative weights convertible to `Length`.
+   * @param weight The WeightMap.
+   * @param num_threads The number of threads to customize on.
+   */
+  template <typename WeightMap>
+  void customize(WeightMap const &weight, unsigned num_threads = 1) {
+    customize_on(weight, num_threads, [num_threads](auto const &run) {
+      auto workers = std::vector<std::thread>{};
+      for (unsigned i = 1; i < num_threads; ++i) {
+        workers.emplace_back(run, i);
+      }
+      run(0);
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    });
+  }
+
+  /**
+   * Recompute the arc weights for @p weight, splitting each level among
+   * the threads of @p pool.
+   *
+   * Unlike the overload taking a number of threads, no thread is started:
+   * a metric customized over and over, e.g. once per Penalty iteration,
+   * reuses the same workers.
+   *
+   * @see customize(WeightMap const &weight, unsigned num_threads)
+   *
+   * @param pool The threads to customize on.
+   */
+  template <typename WeightMap>
+  void customize(WeightMap const &weight, thread_pool &pool) {
+    customize_on(weight, pool.size(),
+                 [&pool](auto const &run) { pool.run(run); });
+  }
+
+  /**
+   * Recompute the arc weights for @p weight, after the weights of the edges
+   * in [@p first, @p last) changed.
+   *
+   * The arcs of the changed edges are given the weight of their shortest
+   * edge again, and so are the other upward arcs of their lower ends. These
+   * vertices are then customized again in rank order, and whenever one of
+   * their arcs changes, so are the upper ends of their arcs: the arcs
+   * depending on a changed one, all the way up the elimination tree. The
+   * result is the same as customize(weight), in time proportional to the
+   * part of the hierarchy that changed.
+   *
+   * @pre The metric was customized for a weight map equal to @p weight but
+   *      on the edges in [@p first, @p last).
+   *
+   * @tparam WeightMap A readable property map from the graph's edges to
+   *         non-negative weights convertible to `Length`.
+   * @tparam InputIt An input iterator of edge ordinals.
+   * @param weight The WeightMap.
+   * @param first The ordinal of the first changed edge, in `edges(G)`.
+   * @param last One past the last changed edge.
+   */
+  template <typename WeightMap, typename InputIt>
+  void customize_edges(WeightMap const &weight, InputIt first, InputIt last) {
+    dirty.resize(cch->num_vertices(), false);
+    auto mark = [this](std::size_t x) {
+      if (!dirty[x]) {
+        dirty[x] = true;
+        dirty_ranks.push_back(x);
+        std::push_heap(dirty_ranks.begin(), dirty_ranks.end(),
+                       std::greater<>{});
+      }
+    };
+    for (; first != last; ++first) {
+      if (auto a = cch->arc_of(*first); a != details::ch_none) {
+        mark(cch->tail(a));
+      }
+    }
+
+    // Lower vertices first, so that the lower triangles of each vertex are
+    // final when it is customized
+    while (!dirty_ranks.empty()) {
+      std::pop_heap(dirty_ranks.begin(), dirty_ranks.end(), std::greater<>{});
+      auto y = dirty_ranks.back();
+      dirty_ranks.pop_back();
+      dirty[y] = false;
+
+      auto [begin, end] = cch->up_arcs(y);
+      previous.clear();
+      for (auto a = begin; a < end; ++a) {
+        previous.emplace_back(up_weight[a], down_weight[a]);
+        seed_arc(weight, a);
+      }
+      customize_vertex(y);
+      // An arc y - z is in the lower triangles of every other upper end of y
+      auto changed = false;
+      for (auto a = begin; a < end; ++a) {
+        changed = changed || previous[a - begin] !=
+                                 std::make_pair(up_weight[a], down_weight[a]);
+      }
+      if (changed) {
+        for (auto a = begin; a < end; ++a) {
+          mark(cch->head(a));
+        }
+      }
+    }
+  }
+
+  /**
+   * @return The hierarchy of this metric.
+   */
+  Topology const &topology() const { return *cch; }
+  /**
+   * @param a An arc.
+   * @param upward The direction: from the lower to the upper end of @p a if
+   *        `true`, the opposite otherwise.
+   * @return The weight of @p a in that direction, or the maximum `Length` if
+   *         there is no path through it.
+   */
+  Length weight(std::size_t a, bool upward) const {
+    return upward ? up_weight[a] : down_weight[a];
+  }
+
+  /**
+   * Unpack an arc into the edges of the original graph.
+   *
+   * @param lower The lower end of @p arc.
+   * @param arc An arc with a finite weight in direction @p upward.
+   * @param upward The direction to unpack @p arc in.
+   * @param out Where to write the edges, in path order.
+   */
+  template <typename OutputIt>
+  OutputIt unpack(std::size_t lower, std::size_t arc, bool upward,
+                  OutputIt out) const {
+    // Arcs left to unpack, in reverse path order
+    struct Pending {
+      std::size_t lower;
+      std::size_t arc;
+      bool upward;
+    };
+    auto stack = std::vector<Pending>{{lower, arc, upward}};
+    while (!stack.empty()) {
+      auto [x, a, up] = stack.back();
+      stack.pop_back();
+      auto middle = up ? up_middle[a] : down_middle[a];
+      if (middle == details::ch_none) {
+        *out++ = cch->edge(up ? up_edge[a] : down_edge[a]);
+        continue;
+      }
+      // The middle vertex is below both ends of the arc
+      auto to_lower = cch->find_arc(middle, x);
+      auto to_higher = cch->find_arc(middle, cch->head(a));
+      if (up) {
+        stack.push_back(Pending{middle, to_higher, true});
+        stack.push_back(Pending{middle, to_lower, false});
+      } else {
+        stack.push_back(Pending{middle, to_lower, true});
+        stack.push_back(Pending{middle, to_higher, false});
+      }
+    }
+    return out;
+  }
+
+private:
+  static constexpr Length inf = std::numeric_limits<Length>::max();
+  // Levels smaller than this are not worth splitting among threads
+  static constexpr std::size_t parallel_grain = 1024;
+
+  Topology const *cch;
+  std::vector<Length> up_weight;
+  std::vector<Length> down_weight;
+  std::vector<std::size_t> up_middle;
+  std::vector<std::size_t> down_middle;
+  std::vector<std::size_t> up_edge;
+  std::vector<std::size_t> down_edge;
+  // The state of customize_edges(): the ranks left to customize again as a
+  // min-heap, and the arc weights of the current one before it
+  std::vector<bool> dirty;
+  std::vector<std::size_t> dirty_ranks;
+  std::vector<std::pair<Length, Length>> previous;
+
+  /**
+   * Give arc @p a the weight of its shortest edge in each direction for
+   * @p weight, and no middle vertex.
+   */
+  template <typename WeightMap>
+  void seed_arc(WeightMap const &weight, std::size_t a) {
+    up_weight[a] = inf;
+    down_weight[a] = inf;
+    up_middle[a] = details::ch_none;
+    down_middle[a] = details::ch_none;
+    for (auto [it, end] = cch->arc_edges(a); it != end; ++it) {
+      // Parallel edges: keep the shortest one
+      auto w = static_cast<Length>(get(weight, cch->edge(*it)));
+      if (cch->is_upward(*it) && w < up_weight[a]) {
+        up_weight[a] = w;
+        up_edge[a] = *it;
+      } else if (!cch->is_upward(*it) && w < down_weight[a]) {
+        down_weight[a] = w;
+        down_edge[a] = *it;
+      }
+    }
+  }
+
+  /**
+   * Recompute the arc weights for @p weight, calling `for_each_thread(run)`
+   * to run `run(i)` for each i in [0, @p num_threads) in parallel.
+   */
+  template <typename WeightMap, typename ForEachThread>
+  void customize_on(WeightMap const &weight, unsigned num_threads,
+                    ForEachThread &&for_each_thread) {
+    std::fill(up_weight.begin(), up_weight.end(), inf);
+    std::fill(down_weight.begin(), down_weight.end(), inf);
+    std::fill(up_middle.begin(), up_middle.end(), details::ch_none);
+    std::fill(down_middle.begin(), down_middle.end(), details::ch_none);
+
+    for (std::size_t i = 0; i < cch->num_edges(); ++i) {
+      auto a = cch->arc_of(i);
+      if (a == details::ch_none) {
+        continue;
+      }
+      // Parallel edges: keep the shortest one
+      auto w = static_cast<Length>(get(weight, cch->edge(i)));
+      if (cch->is_upward(i) && w < up_weight[a]) {
+        up_weight[a] = w;
+        up_edge[a] = i;
+      } else if (!cch->is_upward(i) && w < down_weight[a]) {
+        down_weight[a] = w;
+        down_edge[a] = i;
+      }
+    }
+
+    for (std::size_t l = 1; l < cch->num_levels(); ++l) {
+      auto [first, last] = cch->level(l);
+      auto size = static_cast<std::size_t>(last - first);
+      if (num_threads <= 1 || size < parallel_grain) {
+        std::for_each(first, last, [this](auto y) { customize_vertex(y); });
+        continue;
+      }
+
+      auto chunk = (size + num_threads - 1) / num_threads;
+      auto run = [this, first = first, last = last, chunk](std::size_t i) {
+        auto begin = first + std::min(i * chunk, std::size_t(last - first));
+        auto end = begin + std::min(chunk, std::size_t(last - begin));
+        std::for_each(begin, end, [this](auto y) { customize_vertex(y); });
+      };
+      for_each_thread(run);
+    }
+  }
+
+  /**
+   * Relax the upward arcs of @p y through its lower triangles: for each
+   * lower neighbor x and each upward arc x - z above y, the arc y - z
+   * exists, and y -> x -> z and z -> x -> y are paths through it.
+   */
+  void customize_vertex(std::size_t y) {
+    auto [first, last] = cch->down_arcs(y);
+    for (; first != last; ++first) {
+      auto [x, xy] = *first;
+      auto yz = cch->up_arcs(y).first;
+      for (auto xz = xy + 1; xz < cch->up_arcs(x).second; ++xz) {
+        auto z = cch->head(xz);
+        while (cch->head(yz) != z) {
+          ++yz;
+        }
+        assert(yz < cch->up_arcs(y).second && "CCH is not chordal");
+        if (auto w = details::cch_add(down_weight[xy], up_weight[xz]);
+            w < up_weight[yz]) {
+          up_weight[yz] = w;
+          up_middle[yz] = x;
+        }
+        if (auto w = details::cch_add(down_weight[xz], up_weight[xy]);
+            w < down_weight[yz]) {
+          down_weight[yz] = w;
+          down_middle[yz] = x;
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Compute a nested dissection order of @p G, ignoring edge directions.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::EdgeListGraph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param index The IndexMap of @p G.
+ * @param leaf_size Parts with at most this many vertices are not split any
+ *        further.
+ * @return The vertex indices in contraction order.
+ */
+template <typename Graph, typename IndexMap>
+std::vector<std::size_t> nested_dissection_order(const Graph &G,
+                                                 IndexMap index,
+                                                 std::size_t leaf_size = 8) {
+  auto adjacency = details::make_cch_adjacency(G, index);
+  return details::nested_dissection{adjacency, leaf_size}.order();
+}
+
+/**
+ * Build the Customizable Contraction Hierarchy of @p G for a given order.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::EdgeListGraph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param index The IndexMap of @p G.
+ * @param order The vertex indices in contraction order.
+ * @return The metric-independent hierarchy of @p G.
+ */
+template <typename Graph, typename IndexMap>
+customizable_contraction_hierarchy<Graph>
+build_customizable_contraction_hierarchy(const Graph &G, IndexMap index,
+                                         std::vector<std::size_t> order) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((EdgeListGraphConcept<Graph>));
+
+  auto rank = std::vector<std::size_t>(order.size());
+  for (std::size_t r = 0; r < order.size(); ++r) {
+    rank[order[r]] = r;
+  }
+  auto adjacency = details::make_cch_adjacency(G, index);
+  auto upward = details::cch_upward_neighbors(adjacency, rank);
+
+  auto edges = details::edge_list(G);
+  auto endpoints = std::vector<std::pair<std::size_t, std::size_t>>{};
+  endpoints.reserve(edges.size());
+  for (auto const &e : edges) {
+    endpoints.emplace_back(get(index, source(e, G)), get(index, target(e, G)));
+  }
+  return customizable_contraction_hierarchy<Graph>{
+      std::move(order), upward, std::move(edges), endpoints};
+}
+
+/**
+ * Build the Customizable Contraction Hierarchy of @p G, on a
+ * nested_dissection_order() of @p G.
+ *
+ * @see build_customizable_contraction_hierarchy(const Graph &G,
+ *        IndexMap index, std::vector<std::size_t> order)
+ */
+template <typename Graph, typename IndexMap>
+customizable_contraction_hierarchy<Graph>
+build_customizable_contraction_hierarchy(const Graph &G, IndexMap index) {
+  return build_customizable_contraction_hierarchy(
+      G, index, nested_dissection_order(G, index));
+}
+
+/**
+ * Build the Customizable Contraction Hierarchy of a `PropertyGraph`, using
+ * its `boost::vertex_index_t` property.
+ *
+ * @see build_customizable_contraction_hierarchy(const Graph &G,
+ *        IndexMap index)
+ */
+template <typename PropertyGraph>
+auto build_customizable_contraction_hierarchy(const PropertyGraph &G) {
+  return build_customizable_contraction_hierarchy(
+      G, get(boost::vertex_index, G));
+}
+
+/**
+ * Customize @p cch for @p weight.
+ *
+ * @see cch_metric::customize()
+ *
+ * @return The customized metric, referring to @p cch.
+ */
+template <typename Graph, typename WeightMap,
+          typename Length = value_of_t<WeightMap>>
+cch_metric<Graph, Length>
+customize(customizable_contraction_hierarchy<Graph> const &cch,
+          WeightMap const &weight, unsigned num_threads = 1) {
+  auto metric = cch_metric<Graph, Length>{cch};
+  metric.customize(weight, num_threads);
+  return metric;
+}
+
+/**
+ * Customize @p cch for @p weight on the threads of @p pool.
+ *
+ * @see cch_metric::customize()
+ *
+ * @return The customized metric, referring to @p cch.
+ */
+template <typename Graph, typename WeightMap,
+          typename Length = value_of_t<WeightMap>>
+cch_metric<Graph, Length>
+customize(customizable_contraction_hierarchy<Graph> const &cch,
+          WeightMap const &weight, thread_pool &pool) {
+  auto metric = cch_metric<Graph, Length>{cch};
+  metric.customize(weight, pool);
+  return metric;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
@@ -40,11 +40,20 @@
 #include <boost/graph/reverse_graph.hpp>
 
 #include <arlib/path.hpp>
+#include <arlib/routing_kernels/delta_stepping.hpp>
+#include <arlib/routing_kernels/lazy_reverse_dijkstra.hpp>
+#include <arlib/routing_kernels/phast.hpp>
+#include <arlib/thread_pool.hpp>
 #include <arlib/type_traits.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
@@ -120,6 +129,83 @@ private:
   Vertex t;
 };
 
+//===----------------------------------------------------------------------===//
+//                      Reverse graph edge mapping
+//===----------------------------------------------------------------------===//
+
+/**
+ * A Readable Property Map from the edges of a `boost::reverse_graph<Graph>` to
+ * the edges of `Graph` they are the reverse of.
+ *
+ * Edge descriptors of a `boost::reverse_graph` wrap the descriptor of their
+ * forward edge, so this mapping is built alongside the reverse graph and every
+ * lookup is O(1). Backward searches should read forward weights through it
+ * instead of calling `edge(v, u, G)`, which scans the out-edges of `v` and
+ * picks an arbitrary edge on multigraphs.
+ *
+ * @tparam Graph The forward graph type.
+ */
+template <typename Graph>
+using forward_edge_map =
+    typename boost::property_map<boost::reverse_graph<Graph>,
+                                 boost::edge_underlying_t>::const_type;
+
+/**
+ * @param rev_G A `boost::reverse_graph`.
+ * @return The forward_edge_map of @p rev_G.
+ */
+template <typename Graph, typename GRef>
+forward_edge_map<Graph>
+get_forward_edge_map(boost::reverse_graph<Graph, GRef> const &rev_G) {
+  return boost::get(boost::edge_underlying, rev_G);
+}
+
+/**
+ * A Readable Property Map exposing the weights of a forward graph to a
+ * search running on its `boost::reverse_graph`.
+ *
+ * @tparam WeightMap A Readable Property Map whose key type is the edge
+ *         descriptor of `Graph`.
+ * @tparam Graph The forward graph type.
+ */
+template <typename WeightMap, typename Graph> class reverse_weight_map {
+public:
+  using key_type = edge_of_t<boost::reverse_graph<Graph>>;
+  using value_type = value_of_t<WeightMap>;
+  using reference = value_type;
+  using category = boost::readable_property_map_tag;
+
+  reverse_weight_map() = default;
+  explicit reverse_weight_map(WeightMap weight) : weight{weight} {}
+
+  /**
+   * @param e An edge of the reverse graph.
+   * @return The weight of the forward edge @p e is the reverse of.
+   */
+  value_type operator[](key_type const &e) const {
+    return get(weight, get(forward_edge_map<Graph>{}, e));
+  }
+
+  friend value_type get(reverse_weight_map const &m, key_type const &e) {
+    return m[e];
+  }
+
+private:
+  WeightMap weight;
+};
+
+/**
+ * @param weight The weight map of the forward graph.
+ * @param rev_G The reverse graph the backward search runs on.
+ * @return A reverse_weight_map reading @p weight through @p rev_G edges.
+ */
+template <typename WeightMap, typename Graph, typename GRef>
+reverse_weight_map<WeightMap, Graph>
+make_reverse_weight_map(WeightMap weight,
+                        boost::reverse_graph<Graph, GRef> const &) {
+  return reverse_weight_map<WeightMap, Graph>{weight};
+}
+
 //===----------------------------------------------------------------------===//
 //                      kSPwLO algorithms routines
 //===----------------------------------------------------------------------===//
@@ -154,17 +240,38 @@ Length compute_length_from_edges(ForwardIt first, ForwardIt last,
   return length;
 }
 
-template <typename GWeightMap, typename Edge,
+/**
+ * Compare two path lengths summed up in different orders. Integral lengths
+ * must be equal, floating-point ones only up to the rounding error of the
+ * sums, relative to their magnitude.
+ *
+ * @return Whether @p a and @p b are the length of equally short paths.
+ */
+template <typename Length> bool same_length(Length a, Length b) {
+  if constexpr (std::is_floating_point_v<Length>) {
+    static const auto tolerance =
+        std::sqrt(std::numeric_limits<Length>::epsilon());
+    return std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b));
+  } else {
+    return a == b;
+  }
+}
+
+/**
+ * @param alt_path The edges of an alternative path, in a set such as
+ *        `std::unordered_set` or edge_set.
+ * @return The length of the edges @p candidate shares with @p alt_path.
+ */
+template <typename GWeightMap, typename Edge, typename EdgeSet,
           typename Length = value_of_t<GWeightMap>>
-Length compute_shared_length(
-    const std::vector<Edge> &candidate,
-    std::unordered_set<Edge, boost::hash<Edge>> const &alt_path,
-    GWeightMap const &weight) {
+Length compute_shared_length(const std::vector<Edge> &candidate,
+                             EdgeSet const &alt_path,
+                             GWeightMap const &weight) {
   using namespace boost;
   Length length = 0;
 
   for (const auto &e : candidate) {
-    if (auto search = alt_path.find(e); search != alt_path.end()) {
+    if (alt_path.count(e) != 0) {
       length += weight[e];
     }
   }
@@ -193,6 +300,23 @@ Length compute_shared_length(const Graph &candidate, const Graph &G,
   return length;
 }
 
+/**
+ * @return The length of the edges @p candidate shares with @p alt_path.
+ */
+template <typename Graph, typename GWeightMap,
+          typename Length = value_of_t<GWeightMap>>
+Length compute_shared_length(const Path<Graph> &candidate,
+                             const Path<Graph> &alt_path,
+                             GWeightMap const &weight) {
+  Length length = 0;
+  for (auto [it, last] = edges(candidate); it != last; ++it) {
+    if (alt_path.contains(*it)) {
+      length += weight[*it];
+    }
+  }
+  return length;
+}
+
 template <typename Edge, typename AltEdgeWeightMap>
 double
 compute_similarity(const std::vector<Edge> &candidate,
@@ -205,6 +329,24 @@ compute_similarity(const std::vector<Edge> &candidate,
   return shared_length / alt_length;
 }
 
+/**
+ * @param alt_path The edges of an alternative path.
+ * @param alt_edges The edges of @p alt_path, in a set such as edge_set.
+ * @return The fraction of the length of @p alt_path shared with
+ *         @p candidate.
+ */
+template <typename Edge, typename EdgeSet, typename AltEdgeWeightMap>
+double compute_similarity(const std::vector<Edge> &candidate,
+                          const std::vector<Edge> &alt_path,
+                          const EdgeSet &alt_edges,
+                          AltEdgeWeightMap const &weight) {
+  double shared_length =
+      static_cast<double>(compute_shared_length(candidate, alt_edges, weight));
+  double alt_length = static_cast<double>(
+      compute_length_from_edges(alt_path.begin(), alt_path.end(), weight));
+  return shared_length / alt_length;
+}
+
 template <typename Graph, typename AltEdgeWeightMap>
 double compute_similarity(const Path<Graph> &candidate,
                           const Path<Graph> &alt_path,
@@ -226,6 +368,43 @@ std::vector<Length> distance_from_target(const Graph &G, Vertex t) {
   return distance;
 }
 
+/**
+ * Compute the distance of every vertex of @p G to @p t, running a parallel
+ * Delta-stepping search on the reverse graph when @p pool has more than one
+ * thread.
+ */
+template <typename Length, typename Graph, typename Vertex = vertex_of_t<Graph>>
+std::vector<Length> distance_from_target(const Graph &G, Vertex t,
+                                         thread_pool &pool) {
+  if (pool.size() == 1) {
+    return distance_from_target<Length>(G, t);
+  }
+  auto G_rev = boost::make_reverse_graph(G);
+  auto distance = std::vector<Length>(boost::num_vertices(G_rev));
+  delta_stepping(G_rev, t, boost::get(boost::edge_weight, G_rev),
+                 boost::get(boost::vertex_index, G_rev), &distance[0], pool);
+  return distance;
+}
+
+/**
+ * Compute the distance of every vertex of @p G to @p t with a reverse PHAST
+ * sweep of @p ph, instead of a Dijkstra's search of the whole graph.
+ *
+ * @param ph The PHAST layout of a contraction hierarchy of @p G, built on
+ *        its `boost::edge_weight_t` property.
+ * @param pool If not null, the threads to sweep on.
+ */
+template <typename Length, typename Graph, typename Vertex = vertex_of_t<Graph>>
+std::vector<Length> distance_from_target(const Graph &G, Vertex t,
+                                         phast_hierarchy<Length> const &ph,
+                                         thread_pool *pool = nullptr) {
+  auto distance = std::vector<Length>(boost::num_vertices(G));
+  auto workspace = PHASTWorkspace<Length>{distance.size()};
+  phast_to(ph, boost::get(boost::vertex_index, G, t), distance.begin(),
+           workspace, pool);
+  return distance;
+}
+
 /**
  * An A* heuristic using <em>distance from target</em> lower bound.
  *
@@ -254,6 +433,29 @@ public:
    */
   distance_heuristic(const Graph &G, Vertex t)
       : lower_bounds{distance_from_target<CostType>(G, t)} {}
+  /**
+   * Construct a new distance heuristic object, running the reverse search
+   * from @p t on the threads of @p pool.
+   *
+   * @param G The Graph on which to search
+   * @param t The target vertex
+   * @param pool The threads computing the lower bounds
+   */
+  distance_heuristic(const Graph &G, Vertex t, thread_pool &pool)
+      : lower_bounds{distance_from_target<CostType>(G, t, pool)} {}
+  /**
+   * Construct a new distance heuristic object, computing the lower bounds
+   * with a reverse PHAST sweep from @p t.
+   *
+   * @param G The Graph on which to search
+   * @param t The target vertex
+   * @param ph The PHAST layout of a contraction hierarchy of @p G
+   * @param pool If not null, the threads to sweep on
+   */
+  distance_heuristic(const Graph &G, Vertex t,
+                     phast_hierarchy<CostType> const &ph,
+                     thread_pool *pool = nullptr)
+      : lower_bounds{distance_from_target<CostType>(G, t, ph, pool)} {}
   /**
    * @param u The Vertex
    * @return The heuristic of the cost of Vertex @p u.
@@ -264,6 +466,66 @@ private:
   std::vector<CostType> lower_bounds;
 };
 
+/**
+ * True if @p Heuristic is an A* heuristic on @p Graph with cost type
+ * @p Length, i.e. derives from `boost::astar_heuristic<Graph, Length>`.
+ */
+template <typename Graph, typename Length, typename Heuristic>
+constexpr bool is_astar_heuristic_v =
+    std::is_base_of_v<boost::astar_heuristic<Graph, Length>,
+                      std::decay_t<Heuristic>>;
+
+/**
+ * An A* heuristic using <em>distance from target</em> lower bound, computed
+ * lazily.
+ *
+ * The reverse Dijkstra's search from t is resumed on demand, only as far as
+ * the vertices asked for, instead of settling the whole graph upfront. Copies
+ * of the heuristic share the same search.
+ *
+ * @see lazy_reverse_dijkstra
+ *
+ * @tparam Graph A Boost::PropertyGraph having at least one edge
+ *         property with tag boost::edge_weight_t.
+ * @tparam CostType The value type of an edge weight of Graph.
+ */
+template <typename Graph, typename CostType>
+class lazy_distance_heuristic
+    : public boost::astar_heuristic<Graph, CostType> {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+  /**
+   * Construct a new lazy distance heuristic object. Only @p t is touched
+   * upon construction.
+   *
+   * @param G The Graph on which to search
+   * @param t The target vertex
+   * @param max_radius The distance from @p t beyond which the reverse search
+   *        stops growing, answering the smallest distance still to settle.
+   */
+  lazy_distance_heuristic(
+      const Graph &G, Vertex t,
+      CostType max_radius = std::numeric_limits<CostType>::max())
+      : search{std::make_shared<Search>(G, t, get(boost::edge_weight, G),
+                                        get(boost::vertex_index, G),
+                                        max_radius)} {}
+  /**
+   * @param u The Vertex
+   * @return The heuristic of the cost of Vertex @p u.
+   */
+  CostType operator()(Vertex u) const { return search->distance(u); }
+
+private:
+  using Search = lazy_reverse_dijkstra<
+      Graph,
+      typename boost::property_map<Graph, boost::edge_weight_t>::const_type,
+      typename boost::property_map<Graph, boost::vertex_index_t>::const_type>;
+  std::shared_ptr<Search> search;
+};
+
 template <typename Graph, typename EdgeWeightMap, typename PredecessorMap,
           typename Vertex>
 Path<Graph>
@@ -334,33 +596,34 @@ std::vector<Edge> build_edge_list_from_dijkstra(Graph const &G, Vertex s,
   return edge_list;
 }
 
-template <typename Graph, typename EdgeWeightMap,
-          typename Vertex = vertex_of_t<Graph>,
+/**
+ * Builds the list of the edges from @p s to @p t out of the edge through
+ * which a shortest path search reached each vertex.
+ *
+ * Unlike build_edge_list_from_dijkstra() no edge is looked up by its
+ * endpoints: each hop is O(1) and on multigraphs the list holds the very
+ * edges the search relaxed.
+ *
+ * @param G The graph whose edges are listed.
+ * @param s The source vertex
+ * @param t The target vertex
+ * @param tree_edge A Readable Property Map from each vertex of the path but
+ *        @p s to the edge of @p G it was reached through.
+ * @return The edges of the path from @p t back to @p s.
+ */
+template <typename Graph, typename TreeEdgeMap,
           typename Edge = edge_of_t<Graph>,
-          typename Length = value_of_t<EdgeWeightMap>>
-std::optional<std::vector<Edge>>
-compute_shortest_path(const Graph &G, EdgeWeightMap const &weight, Vertex s,
-                      Vertex t) {
-  using namespace boost;
-  auto sp_distances = std::vector<Length>(num_vertices(G));
-  auto predecessor = std::vector<Vertex>(num_vertices(G), s);
-  auto vertex_id = get(vertex_index, G);
-  try {
-    dijkstra_shortest_paths(
-        G, s,
-        distance_map(&sp_distances[0])
-            .predecessor_map(make_iterator_property_map(std::begin(predecessor),
-                                                        vertex_id, s))
-            .weight_map(weight)
-            .visitor(make_dijkstra_visitor(
-                make_target_visitor(t, on_examine_vertex{}))));
-  } catch (target_found &tf) {
-    auto path = build_edge_list_from_dijkstra(G, s, t, predecessor);
-    return {path};
+          typename Vertex = vertex_of_t<Graph>>
+std::vector<Edge> build_edge_list_from_tree(Graph const &G, Vertex s,
+                                            Vertex t,
+                                            const TreeEdgeMap &tree_edge) {
+  auto edge_list = std::vector<Edge>{};
+  for (auto current = t; current != s;) {
+    auto const &e = get(tree_edge, current);
+    edge_list.push_back(e);
+    current = source(e, G);
   }
-
-  // If target was not found, t is unreachable from s
-  return {};
+  return edge_list;
 }
 
 template <typename ForwardIt, typename Graph, typename MultiPredecessorMap>
@@ -0,0 +1,144 @@
+/**
+ * @file binary_io.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_BINARY_IO_HPP
+#define ALTERNATIVE_ROUTING_LIB_BINARY_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                      Binary serialization helpers
+//===----------------------------------------------------------------------===//
+
+/**
+ * Write @p count objects starting at @p data to @p os, in native byte order.
+ */
+template <typename T>
+void write_raw(std::ostream &os, T const *data, std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable types can be serialized.");
+  os.write(reinterpret_cast<char const *>(data),
+           static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+/**
+ * Read @p count objects written by write_raw() into @p data.
+ *
+ * @return false if @p is ended before @p count objects were read.
+ */
+template <typename T>
+bool read_raw(std::istream &is, T *data, std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable types can be serialized.");
+  is.read(reinterpret_cast<char *>(data),
+          static_cast<std::streamsize>(count * sizeof(T)));
+  return static_cast<bool>(is);
+}
+
+/**
+ * @return @p bytes rounded up to a multiple of 8.
+ */
+inline std::size_t padded_size(std::size_t bytes) {
+  return (bytes + 7) / 8 * 8;
+}
+
+/**
+ * Write @p count objects from @p data, then zeros up to an 8-byte boundary.
+ */
+template <typename T>
+void write_padded(std::ostream &os, T const *data, std::size_t count) {
+  constexpr char zeros[8] = {};
+  write_raw(os, data, count);
+  auto bytes = count * sizeof(T);
+  write_raw(os, zeros, padded_size(bytes) - bytes);
+}
+
+/**
+ * Read @p count objects written by write_padded().
+ */
+template <typename T>
+bool read_padded(std::istream &is, std::vector<T> &data, std::size_t count) {
+  char padding[8];
+  data.resize(count);
+  auto bytes = count * sizeof(T);
+  return read_raw(is, data.data(), count) &&
+         read_raw(is, padding, padded_size(bytes) - bytes);
+}
+
+/**
+ * The finalizer of MurmurHash3: a bijection of 64-bit words in which every
+ * input bit flips each output bit with probability close to 1/2.
+ */
+inline std::uint64_t mix64(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+/**
+ * Hash @p bytes bytes from @p data into the checksum @p hash, a 64-bit word
+ * at a time: each word, the last one padded with zeros as by
+ * write_padded(), is xored into the hash, which is then mixed with mix64().
+ * Pass the checksum of the previous blocks to chain them.
+ *
+ * This detects corruption, e.g. a flipped bit, but is not a cryptographic
+ * hash.
+ */
+inline std::uint64_t checksum(void const *data, std::size_t bytes,
+                              std::uint64_t hash = 0x9e3779b97f4a7c15ull) {
+  auto first = static_cast<unsigned char const *>(data);
+  auto i = std::size_t{0};
+  for (; i + 8 <= bytes; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, first + i, 8);
+    hash = mix64(hash ^ word);
+  }
+  if (i < bytes) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, first + i, bytes - i);
+    hash = mix64(hash ^ word);
+  }
+  return hash;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_BINARY_IO_HPP
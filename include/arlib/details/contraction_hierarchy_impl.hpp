@@ -0,0 +1,309 @@
+/**
+ * @file contraction_hierarchy_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                 Contraction Hierarchies support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * A sentinel for "no vertex" and "no edge" in CH arcs.
+ */
+constexpr std::size_t ch_none = std::numeric_limits<std::size_t>::max();
+
+/**
+ * An arc of a contraction hierarchy. An arc is either the copy of an edge of
+ * the original graph, or a shortcut bypassing its middle vertex.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct ch_arc {
+  std::size_t head;   /**< The vertex index at the other end of the arc. */
+  Length weight;      /**< The length of the arc. */
+  std::size_t middle; /**< The bypassed vertex of a shortcut, or ch_none. */
+  std::size_t edge;   /**< The ordinal of the original edge, or ch_none. */
+};
+
+/**
+ * The graph being contracted: for each vertex, its outgoing and incoming
+ * arcs. Parallel arcs are merged into the shortest one, so a shortcut can be
+ * unpacked by looking its two halves up by their endpoints.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class ch_overlay {
+public:
+  using Arc = ch_arc<Length>;
+
+  explicit ch_overlay(std::size_t n) : out(n), in(n), contracted(n, false) {}
+
+  std::size_t size() const { return out.size(); }
+
+  /**
+   * Add the arc @p u -> @p arc.head, unless a shorter one already exists.
+   *
+   * @return true if the overlay changed.
+   */
+  bool add_arc(std::size_t u, Arc const &arc) {
+    auto v = arc.head;
+    for (auto &a : out[u]) {
+      if (a.head == v) {
+        if (arc.weight >= a.weight) {
+          return false;
+        }
+        a = arc;
+        for (auto &b : in[v]) {
+          if (b.head == u) {
+            b = Arc{u, arc.weight, arc.middle, arc.edge};
+          }
+        }
+        return true;
+      }
+    }
+    out[u].push_back(arc);
+    in[v].push_back(Arc{u, arc.weight, arc.middle, arc.edge});
+    return true;
+  }
+
+  std::vector<std::vector<Arc>> out;
+  std::vector<std::vector<Arc>> in;
+  std::vector<bool> contracted;
+};
+
+/**
+ * A shortcut to add upon contraction of a vertex.
+ */
+template <typename Length> struct ch_shortcut {
+  std::size_t from;
+  std::size_t to;
+  Length weight;
+};
+
+/**
+ * Bounded Dijkstra's searches looking for witness paths: paths between two
+ * neighbors of a vertex @c v that avoid @c v and are not longer than the
+ * path through @c v.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class ch_witness_search {
+public:
+  /**
+   * @param n The number of vertices.
+   * @param settle_limit The maximum number of vertices a search settles.
+   *        Stopping early may add superfluous shortcuts, never miss one.
+   */
+  ch_witness_search(std::size_t n, std::size_t settle_limit)
+      : distance(n, std::numeric_limits<Length>::max()), fringe(n),
+        settle_limit{settle_limit} {}
+
+  /**
+   * Search from @p source on the uncontracted vertices of @p overlay other
+   * than @p avoid, up to distance @p bound.
+   */
+  void run(ch_overlay<Length> const &overlay, std::size_t source,
+           std::size_t avoid, Length bound) {
+    distance.clear();
+    fringe.clear();
+    distance.at(source) = Length{};
+    fringe.push_or_decrease(source, Length{});
+
+    std::size_t settled = 0;
+    while (!fringe.empty() && settled < settle_limit) {
+      auto [d_u, u] = fringe.top();
+      if (d_u > bound) {
+        break;
+      }
+      fringe.pop();
+      ++settled;
+      for (auto const &arc : overlay.out[u]) {
+        auto v = arc.head;
+        if (v == avoid || overlay.contracted[v]) {
+          continue;
+        }
+        auto d_v = d_u + arc.weight;
+        if (d_v < distance[v]) {
+          distance.at(v) = d_v;
+          fringe.push_or_decrease(v, d_v);
+        }
+      }
+    }
+  }
+
+  /**
+   * @return The distance of @p v found by the last run(), an upper bound on
+   *         the distance that avoids the contracted vertex.
+   */
+  Length operator[](std::size_t v) const { return distance[v]; }
+
+private:
+  stamped_vector<Length> distance;
+  d_ary_heap<Length> fringe;
+  std::size_t settle_limit;
+};
+
+/**
+ * Compute the shortcuts that contracting @p v would add to @p overlay.
+ */
+template <typename Length>
+std::vector<ch_shortcut<Length>>
+find_shortcuts(ch_overlay<Length> const &overlay, std::size_t v,
+               ch_witness_search<Length> &witness) {
+  auto shortcuts = std::vector<ch_shortcut<Length>>{};
+  for (auto const &in_arc : overlay.in[v]) {
+    auto u = in_arc.head;
+    if (overlay.contracted[u]) {
+      continue;
+    }
+
+    auto bound = Length{};
+    auto any_target = false;
+    for (auto const &out_arc : overlay.out[v]) {
+      if (out_arc.head != u && !overlay.contracted[out_arc.head]) {
+        bound = std::max(bound, in_arc.weight + out_arc.weight);
+        any_target = true;
+      }
+    }
+    if (!any_target) {
+      continue;
+    }
+
+    witness.run(overlay, u, v, bound);
+    for (auto const &out_arc : overlay.out[v]) {
+      auto w = out_arc.head;
+      if (w == u || overlay.contracted[w]) {
+        continue;
+      }
+      auto via_v = in_arc.weight + out_arc.weight;
+      if (witness[w] > via_v) {
+        shortcuts.push_back(ch_shortcut<Length>{u, w, via_v});
+      }
+    }
+  }
+  return shortcuts;
+}
+
+/**
+ * The contraction priority of @p v: its edge difference, i.e. the number of
+ * shortcuts its contraction adds minus the number of arcs it removes, plus
+ * the number of its already contracted neighbors, which spreads contraction
+ * uniformly over the graph.
+ */
+template <typename Length>
+long contraction_priority(ch_overlay<Length> const &overlay, std::size_t v,
+                          std::vector<std::size_t> const &contracted_neighbors,
+                          ch_witness_search<Length> &witness) {
+  long removed = 0;
+  for (auto const &arc : overlay.out[v]) {
+    removed += overlay.contracted[arc.head] ? 0 : 1;
+  }
+  for (auto const &arc : overlay.in[v]) {
+    removed += overlay.contracted[arc.head] ? 0 : 1;
+  }
+  auto added = static_cast<long>(find_shortcuts(overlay, v, witness).size());
+  return added - removed + static_cast<long>(contracted_neighbors[v]);
+}
+
+/**
+ * Contract every vertex of @p overlay in order of contraction_priority(),
+ * updated lazily, adding shortcuts to @p overlay as needed.
+ *
+ * @return The rank of each vertex, i.e. its position in the contraction
+ *         order.
+ */
+template <typename Length>
+std::vector<std::size_t> contract(ch_overlay<Length> &overlay,
+                                  std::size_t settle_limit) {
+  using Entry = std::pair<long, std::size_t>;
+  auto n = overlay.size();
+  auto witness = ch_witness_search<Length>{n, settle_limit};
+  auto contracted_neighbors = std::vector<std::size_t>(n, 0);
+  auto queue =
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>{};
+  for (std::size_t v = 0; v < n; ++v) {
+    queue.emplace(contraction_priority(overlay, v, contracted_neighbors,
+                                       witness),
+                  v);
+  }
+
+  auto rank = std::vector<std::size_t>(n);
+  std::size_t next_rank = 0;
+  while (!queue.empty()) {
+    auto [priority, v] = queue.top();
+    queue.pop();
+    if (overlay.contracted[v]) {
+      continue;
+    }
+
+    // Lazy update: re-queue v if its priority got worse than the next one
+    auto current =
+        contraction_priority(overlay, v, contracted_neighbors, witness);
+    if (current > priority && !queue.empty() && current > queue.top().first) {
+      queue.emplace(current, v);
+      continue;
+    }
+
+    for (auto const &s : find_shortcuts(overlay, v, witness)) {
+      overlay.add_arc(s.from, ch_arc<Length>{s.to, s.weight, v, ch_none});
+    }
+    overlay.contracted[v] = true;
+    rank[v] = next_rank++;
+    for (auto const &arc : overlay.out[v]) {
+      ++contracted_neighbors[arc.head];
+    }
+    for (auto const &arc : overlay.in[v]) {
+      ++contracted_neighbors[arc.head];
+    }
+  }
+  return rank;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CONTRACTION_HIERARCHY_IMPL_HPP
@@ -0,0 +1,314 @@
+/**
+ * @file customizable_contraction_hierarchy_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/details/contraction_hierarchy_impl.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                     Nested dissection support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * The simple undirected graph underlying a graph, in CSR form over vertex
+ * indices. Self-loops and parallel edges are dropped.
+ */
+struct cch_adjacency {
+  std::vector<std::size_t> offsets;
+  std::vector<std::size_t> neighbors;
+
+  std::size_t num_vertices() const { return offsets.size() - 1; }
+  std::size_t degree(std::size_t v) const {
+    return offsets[v + 1] - offsets[v];
+  }
+  std::pair<std::size_t const *, std::size_t const *>
+  neighbors_of(std::size_t v) const {
+    return {neighbors.data() + offsets[v], neighbors.data() + offsets[v + 1]};
+  }
+};
+
+template <typename Graph, typename IndexMap>
+cch_adjacency make_cch_adjacency(const Graph &G, IndexMap index) {
+  using namespace boost;
+  auto n = num_vertices(G);
+  auto pairs = std::vector<std::pair<std::size_t, std::size_t>>{};
+  pairs.reserve(2 * num_edges(G));
+  for (auto [e_it, e_end] = edges(G); e_it != e_end; ++e_it) {
+    std::size_t u = get(index, source(*e_it, G));
+    std::size_t v = get(index, target(*e_it, G));
+    if (u != v) {
+      pairs.emplace_back(u, v);
+      pairs.emplace_back(v, u);
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  auto adjacency = cch_adjacency{std::vector<std::size_t>(n + 1, 0), {}};
+  adjacency.neighbors.reserve(pairs.size());
+  for (auto const &[u, v] : pairs) {
+    ++adjacency.offsets[u + 1];
+    adjacency.neighbors.push_back(v);
+  }
+  for (std::size_t v = 0; v < n; ++v) {
+    adjacency.offsets[v + 1] += adjacency.offsets[v];
+  }
+  return adjacency;
+}
+
+/**
+ * Computes a nested dissection order by recursive bisection. Each connected
+ * part is split by a vertex separator taken from a level of a breadth-first
+ * search rooted at a pseudo-peripheral vertex; separators are ordered after
+ * the parts they split, so they end up at the top of the hierarchy.
+ */
+class nested_dissection {
+public:
+  nested_dissection(cch_adjacency const &adjacency, std::size_t leaf_size)
+      : adjacency{adjacency}, leaf_size{std::max<std::size_t>(leaf_size, 1)},
+        mark(adjacency.num_vertices(), 0),
+        level(adjacency.num_vertices(), 0) {}
+
+  /**
+   * @return The vertex indices in contraction order.
+   */
+  std::vector<std::size_t> order() {
+    auto n = adjacency.num_vertices();
+    auto result = std::vector<std::size_t>(n);
+
+    // A part of the graph and the end of the range of positions it fills
+    struct Part {
+      std::vector<std::size_t> vertices;
+      std::size_t end;
+    };
+    auto all = std::vector<std::size_t>(n);
+    for (std::size_t v = 0; v < n; ++v) {
+      all[v] = v;
+    }
+    auto parts = std::vector<Part>{};
+    parts.push_back(Part{std::move(all), n});
+
+    auto visited = std::vector<std::size_t>{};
+    while (!parts.empty()) {
+      auto [vertices, end] = std::move(parts.back());
+      parts.pop_back();
+      auto first = end - vertices.size();
+
+      if (vertices.size() <= leaf_size) {
+        // Contract low-degree vertices first
+        std::stable_sort(vertices.begin(), vertices.end(),
+                         [this](std::size_t a, std::size_t b) {
+                           return adjacency.degree(a) < adjacency.degree(b);
+                         });
+        std::copy(vertices.begin(), vertices.end(), result.begin() + first);
+        continue;
+      }
+
+      // Split disconnected parts without a separator
+      enter(vertices);
+      search(vertices.front(), visited);
+      if (visited.size() < vertices.size()) {
+        auto rest = std::vector<std::size_t>{};
+        for (auto v : vertices) {
+          if (mark[v] == stamp) {
+            rest.push_back(v);
+          }
+        }
+        parts.push_back(Part{visited, end});
+        parts.push_back(Part{std::move(rest), end - visited.size()});
+        continue;
+      }
+
+      // Root the levels at the last vertex reached, far from everyone
+      auto root = visited.back();
+      enter(vertices);
+      search(root, visited);
+      auto separator = level_separator(visited);
+
+      auto rest = std::vector<std::size_t>{};
+      rest.reserve(vertices.size() - separator.size());
+      for (auto v : vertices) {
+        if (mark[v] != separated) {
+          rest.push_back(v);
+        }
+      }
+      std::copy(separator.begin(), separator.end(),
+                result.begin() + (end - separator.size()));
+      parts.push_back(Part{std::move(rest), end - separator.size()});
+    }
+    return result;
+  }
+
+private:
+  cch_adjacency const &adjacency;
+  std::size_t leaf_size;
+  std::vector<std::size_t> mark;
+  std::vector<std::size_t> level;
+  // Vertices of the current part are marked with stamp, reached ones with
+  // stamp + 1 and separator ones with stamp + 2.
+  std::size_t stamp = 0;
+  std::size_t separated = 0;
+
+  void enter(std::vector<std::size_t> const &vertices) {
+    stamp += 3;
+    separated = stamp + 2;
+    for (auto v : vertices) {
+      mark[v] = stamp;
+    }
+  }
+
+  /**
+   * Breadth-first search from @p root within the current part, writing the
+   * vertices reached to @p visited in order and their depth to `level`.
+   */
+  void search(std::size_t root, std::vector<std::size_t> &visited) {
+    visited.clear();
+    visited.push_back(root);
+    mark[root] = stamp + 1;
+    level[root] = 0;
+    for (std::size_t i = 0; i < visited.size(); ++i) {
+      auto u = visited[i];
+      auto [first, last] = adjacency.neighbors_of(u);
+      for (; first != last; ++first) {
+        if (mark[*first] == stamp) {
+          mark[*first] = stamp + 1;
+          level[*first] = level[u] + 1;
+          visited.push_back(*first);
+        }
+      }
+    }
+  }
+
+  /**
+   * Pick the smallest level among those leaving at least a quarter of
+   * @p visited on each side, and return its vertices with a neighbor on the
+   * next level. Removing them disconnects the levels above from the levels
+   * below.
+   */
+  std::vector<std::size_t>
+  level_separator(std::vector<std::size_t> const &visited) {
+    auto depth = level[visited.back()];
+    auto sizes = std::vector<std::size_t>(depth + 1, 0);
+    for (auto v : visited) {
+      ++sizes[level[v]];
+    }
+
+    auto size = visited.size();
+    auto chosen = std::min(level[visited[size / 2]], depth - 1);
+    auto below = std::size_t{0};
+    for (std::size_t l = 0; l < depth; ++l) {
+      if (4 * below >= size && 4 * (below + sizes[l]) <= 3 * size &&
+          sizes[l] < sizes[chosen]) {
+        chosen = l;
+      }
+      below += sizes[l];
+    }
+
+    auto separator = std::vector<std::size_t>{};
+    for (auto v : visited) {
+      if (level[v] != chosen) {
+        continue;
+      }
+      auto [first, last] = adjacency.neighbors_of(v);
+      auto crosses = std::any_of(first, last, [this, chosen](std::size_t w) {
+        return mark[w] == stamp + 1 && level[w] == chosen + 1;
+      });
+      if (crosses) {
+        separator.push_back(v);
+      }
+    }
+    for (auto v : separator) {
+      mark[v] = separated;
+    }
+    return separator;
+  }
+};
+
+//===----------------------------------------------------------------------===//
+//                  Customizable Contraction Hierarchies support
+//===----------------------------------------------------------------------===//
+
+/**
+ * Eliminate the vertices of @p adjacency in @p rank order.
+ *
+ * The upward neighbors of each eliminated vertex form a clique in the
+ * resulting chordal supergraph. It is enough to add them to the upward
+ * neighbors of the lowest one, its parent in the elimination tree.
+ *
+ * @return For each rank, the sorted ranks of its upward neighbors.
+ */
+inline std::vector<std::vector<std::size_t>>
+cch_upward_neighbors(cch_adjacency const &adjacency,
+                     std::vector<std::size_t> const &rank) {
+  auto n = adjacency.num_vertices();
+  auto upward = std::vector<std::vector<std::size_t>>(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    auto [first, last] = adjacency.neighbors_of(v);
+    for (; first != last; ++first) {
+      if (rank[*first] > rank[v]) {
+        upward[rank[v]].push_back(rank[*first]);
+      }
+    }
+  }
+  for (std::size_t x = 0; x < n; ++x) {
+    auto &up = upward[x];
+    std::sort(up.begin(), up.end());
+    up.erase(std::unique(up.begin(), up.end()), up.end());
+    if (!up.empty()) {
+      auto &parent = upward[up.front()];
+      parent.insert(parent.end(), up.begin() + 1, up.end());
+    }
+  }
+  return upward;
+}
+
+/**
+ * @return @p a + @p b, or the maximum `Length` if either is.
+ */
+template <typename Length> Length cch_add(Length a, Length b) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  return (a == inf || b == inf) ? inf : a + b;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CUSTOMIZABLE_CONTRACTION_HIERARCHY_IMPL_HPP
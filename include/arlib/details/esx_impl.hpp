@@ -38,13 +38,27 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
 
+#include <arlib/contraction_hierarchy.hpp>
 #include <arlib/details/arlib_utils.hpp>
+#include <arlib/edge_index.hpp>
+#include <arlib/hub_labels.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/routing_kernels/bidirectional_alt.hpp>
 #include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/ch_query.hpp>
+#include <arlib/routing_kernels/many_to_many.hpp>
+#include <arlib/routing_kernels/parallel_bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
 #include <arlib/routing_kernels/types.hpp>
 #include <arlib/terminators.hpp>
 #include <arlib/type_traits.hpp>
 
+#include <algorithm>
+#include <iostream>
 #include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
 #include <unordered_set>
 #include <utility>
 
@@ -93,13 +107,12 @@ template <typename Edge> struct EdgePriorityComparator {
  * ESX.
  *
  * @tparam Edge A Boost::Graph edge descriptor
+ * @tparam DeletedEdgeMap The set of deleted edges, e.g. an edge_set.
  */
-template <typename Edge> class edge_deleted_filter {
+template <typename Edge,
+          typename DeletedEdgeMap = std::unordered_set<Edge, boost::hash<Edge>>>
+class edge_deleted_filter {
 public:
-  /**
-   * The deleted edges map.
-   */
-  using DeletedEdgeMap = std::unordered_set<Edge, boost::hash<Edge>>;
   /**
    * Empty constructor, required by Boost::Graph
    */
@@ -118,58 +131,53 @@ public:
    * @return false otherwise.
    */
   bool operator()(const Edge &e) const {
-    return deleted_edge_map->find(e) == std::end(*deleted_edge_map);
+    return deleted_edge_map->count(e) == 0;
   }
 
 private:
   const DeletedEdgeMap *deleted_edge_map;
 };
 
+template <typename DeletedEdgeMap>
+edge_deleted_filter(const DeletedEdgeMap &)
+    -> edge_deleted_filter<typename DeletedEdgeMap::key_type, DeletedEdgeMap>;
+
+/**
+ * A functor exposing the weights of a forward graph to a search running on its
+ * `boost::reverse_graph`. Reverse edges are mapped to forward ones through
+ * forward_edge_map, so each weight read is O(1).
+ *
+ * @tparam PMap The weight property map of @c Graph.
+ * @tparam Graph The forward graph type.
+ */
 template <typename PMap, class Graph> class reverse_weight_functor {
 public:
   using Edge = typename boost::graph_traits<
       boost::reverse_graph<Graph>>::edge_descriptor;
   using Length = typename boost::property_traits<PMap>::value_type;
 
-  reverse_weight_functor(PMap &pmap, Graph const &G,
+  reverse_weight_functor(PMap &pmap, Graph const &,
                          const boost::reverse_graph<Graph> &rev_G)
-      : inner_weight{pmap}, G{G}, rev_G{rev_G} {}
+      : inner_weight{pmap}, forward_edge{get_forward_edge_map(rev_G)} {}
 
   reverse_weight_functor(reverse_weight_functor const &other)
-      : inner_weight{other.inner_weight}, G{other.G}, rev_G{other.rev_G} {}
+      : inner_weight{other.inner_weight}, forward_edge{other.forward_edge} {}
 
   const Length &operator()(const Edge &e) const {
-    auto forward_edge = get_forward_edge(e);
-
-    return inner_weight[forward_edge];
+    return inner_weight[get(forward_edge, e)];
   }
 
   Length &operator[](const Edge &e) {
-    auto forward_edge = get_forward_edge(e);
-
-    return inner_weight[forward_edge];
+    return inner_weight[get(forward_edge, e)];
   }
 
   const Length &operator[](const Edge &e) const {
-    auto forward_edge = get_forward_edge(e);
-
-    return inner_weight[forward_edge];
+    return inner_weight[get(forward_edge, e)];
   }
 
 private:
-  auto get_forward_edge(const Edge &e) const {
-    using namespace boost;
-    auto u = source(e, rev_G);
-    auto v = target(e, rev_G);
-
-    auto [forward_edge, is_valid] = edge(v, u, G);
-    assert(is_valid);
-    return forward_edge;
-  }
-
   PMap &inner_weight;
-  const Graph &G;
-  const boost::reverse_graph<Graph> &rev_G;
+  forward_edge_map<Graph> forward_edge;
 };
 
 //===----------------------------------------------------------------------===//
@@ -211,43 +219,57 @@ bool shortest_path_contains_edge(Vertex s, Vertex t, Edge e, const Graph &G,
   return false;
 }
 
+/**
+ * Compute a shortest path between two vertices on a filtered graph with
+ * Dijkstra's algorithm, running on a reusable SearchWorkspace.
+ *
+ * @param G The graph
+ * @param s The source vertex
+ * @param t The target vertex
+ * @param deleted_edge_map The set of edges to filter from @p G
+ * @param workspace The memory to run the search on.
+ * @param radius The greatest length of a path to look for.
+ * @return A std::optional of the list of edges from @p s to @p t if a path
+ * could be found. An empty optional otherwise.
+ */
 template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
-          typename Vertex = vertex_of_t<Graph>,
-          typename Edge = edge_of_t<Graph>>
-std::optional<std::vector<Edge>>
-dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
-                       const WeightMap &weight,
-                       DeletedEdgeMap &deleted_edge_map) {
+          typename Vertex, typename Length, typename QueuePolicy,
+          typename TreeEdge, typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+    DeletedEdgeMap &deleted_edge_map,
+    SearchWorkspace<Vertex, Length, QueuePolicy, TreeEdge> &workspace,
+    Length radius = std::numeric_limits<Length>::max()) {
   using namespace boost;
 
   // Get a graph with deleted edges filtered out
   auto filter = edge_deleted_filter{deleted_edge_map};
   auto filtered_G = filtered_graph(G, filter);
 
-  auto predecessor = std::vector<Vertex>(num_vertices(filtered_G), s);
-  auto vertex_id = get(vertex_index, filtered_G);
-
-  try {
-    dijkstra_shortest_paths(
-        filtered_G, s,
-        weight_map(weight)
-            .predecessor_map(make_iterator_property_map(std::begin(predecessor),
-                                                        vertex_id, s))
-            .visitor(make_dijkstra_visitor(
-                make_target_visitor(t, on_examine_vertex{}))));
-  } catch (target_found &) {
-    auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
-    return std::make_optional(edge_list);
-  }
+  return workspace_shortest_path(filtered_G, G, s, t, weight,
+                                 get(vertex_index, filtered_G),
+                                 zero_potential{}, workspace, radius);
+}
 
-  // In case t could not be found from astar_search and target_found is not
-  // thrown, return empty optional
-  return std::optional<std::vector<Edge>>{};
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
+std::optional<std::vector<Edge>>
+dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
+                       const WeightMap &weight,
+                       DeletedEdgeMap &deleted_edge_map) {
+  auto workspace = PathWorkspace<Graph, Length>{num_vertices(G)};
+  return dijkstra_shortest_path(G, s, t, weight, deleted_edge_map, workspace);
 }
 
 /**
  * Compute a shortest path between two vertices on a filtered graph using
- * an A* approach, provided the set of edges to filter and the heuristic.
+ * an A* approach, provided the set of edges to filter and the heuristic,
+ * running on a reusable SearchWorkspace.
+ *
+ * Deleting edges only makes distances longer, so a consistent heuristic of
+ * @p G stays consistent on the filtered graph.
  *
  * @tparam Graph A Boost::PropertyGraph having at least one edge
  *         property with tag boost::edge_weight_t.
@@ -256,40 +278,92 @@ dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
  * @param G The graph
  * @param s The source vertex
  * @param t The target vertex
- * @param heuristic The A* heuristic.
+ * @param heuristic The consistent A* heuristic.
  * @param deleted_edge_map The set of edges to filter from @p G
+ * @param workspace The memory to run the search on.
+ * @param radius The greatest length of a path to look for.
  * @return A std::optional of the list of edges from @p s to @p t if a path
  * could be found. An empty optional otherwise.
  */
 template <typename Graph, typename WeightMap, typename AStarHeuristic,
-          typename DeletedEdgeMap, typename Vertex = vertex_of_t<Graph>,
+          typename DeletedEdgeMap, typename Vertex, typename Length,
+          typename QueuePolicy, typename TreeEdge,
           typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> astar_shortest_path(
+    const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+    const AStarHeuristic &heuristic, DeletedEdgeMap &deleted_edge_map,
+    SearchWorkspace<Vertex, Length, QueuePolicy, TreeEdge> &workspace,
+    Length radius = std::numeric_limits<Length>::max()) {
+  using namespace boost;
+
+  // Get a graph with deleted edges filtered out
+  auto filter = edge_deleted_filter{deleted_edge_map};
+  auto filtered_G = filtered_graph(G, filter);
+
+  return workspace_shortest_path(filtered_G, G, s, t, weight,
+                                 get(vertex_index, filtered_G), heuristic,
+                                 workspace, radius);
+}
+
+/**
+ * Compute a shortest path between two vertices on a filtered graph using
+ * an A* approach, provided the set of edges to filter and the heuristic.
+ *
+ * @see astar_shortest_path(const Graph &G, Vertex s, Vertex t,
+ *                          const WeightMap &weight,
+ *                          const AStarHeuristic &heuristic,
+ *                          DeletedEdgeMap &deleted_edge_map,
+ *                          SearchWorkspace<Vertex, Length, QueuePolicy,
+ *                                          TreeEdge> &workspace)
+ */
+template <typename Graph, typename WeightMap, typename AStarHeuristic,
+          typename DeletedEdgeMap, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
 std::optional<std::vector<Edge>>
 astar_shortest_path(const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
                     const AStarHeuristic &heuristic,
                     DeletedEdgeMap &deleted_edge_map) {
+  auto workspace = PathWorkspace<Graph, Length>{num_vertices(G)};
+  return astar_shortest_path(G, s, t, weight, heuristic, deleted_edge_map,
+                             workspace);
+}
+
+/**
+ * Compute a shortest path between two vertices on a filtered graph with
+ * Bidirectional Dijkstra, running on a reusable PathWorkspace.
+ *
+ * @param G The graph
+ * @param s The source vertex
+ * @param t The target vertex
+ * @param deleted_edge_map The set of edges to filter from @p G
+ * @param workspace The memory to run the search on.
+ * @return A std::optional of the list of edges from @p s to @p t if a path
+ * could be found. An empty optional otherwise.
+ */
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Vertex, typename Length, typename QueuePolicy,
+          typename Edge>
+std::optional<std::vector<Edge>> bidirectional_dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+    DeletedEdgeMap &deleted_edge_map,
+    SearchWorkspace<Vertex, Length, QueuePolicy, Edge> &workspace) {
   using namespace boost;
 
   // Get a graph with deleted edges filtered out
   auto filter = edge_deleted_filter{deleted_edge_map};
-  auto filtered_G = filtered_graph(G, filter);
+  using FilteredGraph = boost::filtered_graph<Graph, decltype(filter)>;
+  const auto filtered_G = filtered_graph(G, filter);
 
-  auto predecessor = std::vector<Vertex>(num_vertices(G), s);
-  auto vertex_id = get(vertex_index, filtered_G);
+  auto rev_G = make_reverse_graph(filtered_G);
+  using RevEdge =
+      typename graph_traits<reverse_graph<FilteredGraph>>::edge_descriptor;
+  auto rev_weight = make_function_property_map<RevEdge, Length>(
+      reverse_weight_functor{weight, filtered_G, rev_G});
 
-  try {
-    astar_search(filtered_G, s, heuristic,
-                 predecessor_map(make_iterator_property_map(
-                                     std::begin(predecessor), vertex_id, s))
-                     .visitor(astar_target_visitor{t})
-                     .weight_map(weight));
-  } catch (target_found &) {
-    auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
-    return std::make_optional(edge_list);
-  }
-  // In case t could not be found from astar_search and target_found is not
-  // thrown, return empty optional
-  return std::optional<std::vector<Edge>>{};
+  return workspace_bidirectional_path(filtered_G, G, s, t, weight, rev_G,
+                                      rev_weight, get(vertex_index, filtered_G),
+                                      workspace);
 }
 
 template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
@@ -300,11 +374,129 @@ std::optional<std::vector<Edge>>
 bidirectional_dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
                                      const WeightMap &weight,
                                      DeletedEdgeMap &deleted_edge_map) {
+  auto workspace = PathWorkspace<Graph, Length>{num_vertices(G)};
+  return bidirectional_dijkstra_shortest_path(G, s, t, weight,
+                                              deleted_edge_map, workspace);
+}
+
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename LandmarkLength, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
+std::optional<std::vector<Edge>> bidirectional_alt_shortest_path(
+    const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+    landmarks<LandmarkLength> const &lm, DeletedEdgeMap &deleted_edge_map,
+    BiDijkstraWorkspace<Vertex, Length> &workspace) {
+  using namespace boost;
+
+  // Get a graph with deleted edges filtered out. Deleting edges only makes
+  // distances longer, so landmark bounds stay valid.
+  auto filter = edge_deleted_filter{deleted_edge_map};
+  using FilteredGraph = boost::filtered_graph<Graph, decltype(filter)>;
+  const auto filtered_G = filtered_graph(G, filter);
+
+  auto index = get(vertex_index, filtered_G);
+  auto predecessor_vec = std::vector<Vertex>(num_vertices(G), s);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+
+  auto rev_G = make_reverse_graph(filtered_G);
+  using RevEdge =
+      typename graph_traits<reverse_graph<FilteredGraph>>::edge_descriptor;
+  auto rev_weight = make_function_property_map<RevEdge, Length>(
+      reverse_weight_functor{weight, filtered_G, rev_G});
+
+  try {
+    bidirectional_alt(filtered_G, s, t, predecessor, weight, rev_G, rev_weight,
+                      index, lm, workspace);
+  } catch (target_not_found &) {
+    // In case t could not be found return empty optional
+    return std::optional<std::vector<Edge>>{};
+  }
+
+  auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
+  return std::make_optional(edge_list);
+}
+
+/**
+ * The workspace of the searches on a contraction hierarchy, holding the path
+ * found by the last of them.
+ *
+ * A hierarchy cannot see deleted edges, so its path between two vertices is
+ * the same whatever ESX has deleted: it is searched once and reused by the
+ * following queries between the same vertices.
+ *
+ * @tparam Graph The graph the hierarchy was built on.
+ * @tparam Length The edge weight type.
+ */
+template <typename Graph, typename Length> struct CHPathCache {
+  using Vertex = vertex_of_t<Graph>;
+  using Edge = edge_of_t<Graph>;
+
+  explicit CHPathCache(std::size_t n) : workspace{n} {}
+
+  CHWorkspace<Length> workspace;
+  std::optional<std::pair<Vertex, Vertex>> endpoints;
+  std::optional<std::vector<Edge>> path;
+};
+
+/**
+ * Compute a shortest path between two vertices on a filtered graph with a
+ * contraction hierarchy of the unfiltered one.
+ *
+ * A hierarchy cannot see deleted edges, but the distance it finds is a lower
+ * bound on the filtered one: if its path avoids every deleted edge it is a
+ * shortest path of the filtered graph too. Otherwise fall back to
+ * Bidirectional Dijkstra on the filtered graph.
+ *
+ * ESX deletes edges of the paths it has just found, so after its first
+ * iteration the hierarchy path almost always crosses a deleted edge, and
+ * nearly every query falls back. The hierarchy is thus searched only once
+ * per pair of vertices, through @p cache, and each query then costs a scan
+ * of that path on top of the fallback search.
+ */
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
+std::optional<std::vector<Edge>>
+ch_shortest_path(const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+                 contraction_hierarchy<Graph, Length> const &ch,
+                 DeletedEdgeMap &deleted_edge_map,
+                 CHPathCache<Graph, Length> &cache,
+                 PathWorkspace<Graph, Length> &fallback) {
+  using namespace boost;
+  if (cache.endpoints != std::make_pair(s, t)) {
+    cache.path = arlib::ch_shortest_path(ch, s, t, get(vertex_index, G),
+                                         cache.workspace);
+    cache.endpoints = std::make_pair(s, t);
+  }
+  if (!cache.path) {
+    // Deleting edges cannot make t reachable
+    return {};
+  }
+
+  auto is_deleted = [&deleted_edge_map](Edge const &e) {
+    return deleted_edge_map.count(e) != 0;
+  };
+  if (std::none_of(cache.path->begin(), cache.path->end(), is_deleted)) {
+    return cache.path;
+  }
+  return bidirectional_dijkstra_shortest_path(G, s, t, weight,
+                                              deleted_edge_map, fallback);
+}
+
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
+std::optional<std::vector<Edge>> parallel_bidirectional_dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t, const WeightMap &weight,
+    DeletedEdgeMap &deleted_edge_map) {
   using namespace boost;
 
   // Get a graph with deleted edges filtered out
-  using FilteredGraph = boost::filtered_graph<Graph, edge_deleted_filter<Edge>>;
   auto filter = edge_deleted_filter{deleted_edge_map};
+  using FilteredGraph = boost::filtered_graph<Graph, decltype(filter)>;
   const auto filtered_G = filtered_graph(G, filter);
 
   auto index = get(vertex_index, filtered_G);
@@ -318,11 +510,10 @@ bidirectional_dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
       typename graph_traits<reverse_graph<FilteredGraph>>::edge_descriptor;
   auto rev_weight = make_function_property_map<RevEdge, Length>(
       reverse_weight_functor{weight, filtered_G, rev_G});
-  auto rev_index = get(vertex_index, rev_G);
 
   try {
-    bidirectional_dijkstra(filtered_G, s, t, predecessor, distance, weight,
-                           rev_G, rev_weight, rev_index);
+    parallel_bidirectional_dijkstra(filtered_G, s, t, predecessor, distance,
+                                    weight, rev_G, rev_weight, index);
   } catch (target_not_found &) {
     // In case t could not be found return empty optional
     return std::optional<std::vector<Edge>>{};
@@ -332,20 +523,176 @@ bidirectional_dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
   return std::make_optional(edge_list);
 }
 
+//===----------------------------------------------------------------------===//
+//                       Compile-time routing kernels
+//===----------------------------------------------------------------------===//
+/**
+ * The routing kernel of ESX named by a tag: a callable computing a shortest
+ * path on @p G without its deleted edges, owning the workspace that all the
+ * queries of an ESX run share.
+ *
+ * The Dijkstra and A* kernels also take a trailing radius, the greatest
+ * length of a path to look for, and give up beyond it.
+ *
+ * @param G The graph.
+ * @return A callable invoked as `kernel(G, s, t, weight, deleted_edge_map)`.
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::dijkstra_t, const Graph &G) {
+  using Workspace = PathWorkspace<Graph>;
+  using Length = length_of_t<Graph>;
+  return [workspace = Workspace{num_vertices(G)}](
+             const auto &G, auto s, auto t, const auto &weight,
+             auto &deleted_edge_map,
+             Length radius = std::numeric_limits<Length>::max()) mutable {
+    return dijkstra_shortest_path(G, s, t, weight, deleted_edge_map,
+                                  workspace, radius);
+  };
+}
+
+/**
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G)
+ *
+ * @param heuristic The consistent A* heuristic, which must outlive the
+ *        kernel.
+ */
+template <typename Graph, typename AStarHeuristic>
+auto make_esx_kernel(kernels::astar_t, const Graph &G,
+                     const AStarHeuristic &heuristic) {
+  using Workspace = PathWorkspace<Graph>;
+  using Length = length_of_t<Graph>;
+  return [workspace = Workspace{num_vertices(G)}, &heuristic](
+             const auto &G, auto s, auto t, const auto &weight,
+             auto &deleted_edge_map,
+             Length radius = std::numeric_limits<Length>::max()) mutable {
+    return astar_shortest_path(G, s, t, weight, heuristic, deleted_edge_map,
+                               workspace, radius);
+  };
+}
+
+/**
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G)
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::bidirectional_dijkstra_t, const Graph &G) {
+  using Workspace = PathWorkspace<Graph>;
+  return [workspace = Workspace{num_vertices(G)}](
+             const auto &G, auto s, auto t, const auto &weight,
+             auto &deleted_edge_map) mutable {
+    return bidirectional_dijkstra_shortest_path(G, s, t, weight,
+                                                deleted_edge_map, workspace);
+  };
+}
+
+/**
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G)
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::parallel_bidirectional_dijkstra_t,
+                     const Graph &) {
+  return [](const auto &G, auto s, auto t, const auto &weight,
+            auto &deleted_edge_map) {
+    return parallel_bidirectional_dijkstra_shortest_path(G, s, t, weight,
+                                                         deleted_edge_map);
+  };
+}
+
+/**
+ * The routing kernel of ESX named by @p kernel, guided by @p heuristic if it
+ * is kernels::astar_t.
+ */
+template <typename Kernel, typename Graph, typename AStarHeuristic>
+auto make_esx_kernel(Kernel kernel, const Graph &G, const AStarHeuristic &) {
+  return make_esx_kernel(kernel, G);
+}
+
+/**
+ * The routing kernel of ESX named by a tag, running on @p workspace instead
+ * of a workspace of its own, so that it is reused across ESX runs.
+ *
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G)
+ *
+ * @param workspace The workspace of the searches, which must outlive the
+ *        kernel.
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::dijkstra_t, const Graph &,
+                     PathWorkspace<Graph> &workspace) {
+  using Length = length_of_t<Graph>;
+  return [&workspace](const auto &G, auto s, auto t, const auto &weight,
+                      auto &deleted_edge_map,
+                      Length radius = std::numeric_limits<Length>::max()) {
+    return dijkstra_shortest_path(G, s, t, weight, deleted_edge_map,
+                                  workspace, radius);
+  };
+}
+
+/**
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G,
+ *                      PathWorkspace<Graph> &workspace)
+ *
+ * @param heuristic The consistent A* heuristic, which must outlive the
+ *        kernel.
+ */
+template <typename Graph, typename AStarHeuristic>
+auto make_esx_kernel(kernels::astar_t, const Graph &,
+                     const AStarHeuristic &heuristic,
+                     PathWorkspace<Graph> &workspace) {
+  using Length = length_of_t<Graph>;
+  return [&workspace, &heuristic](
+             const auto &G, auto s, auto t, const auto &weight,
+             auto &deleted_edge_map,
+             Length radius = std::numeric_limits<Length>::max()) {
+    return astar_shortest_path(G, s, t, weight, heuristic, deleted_edge_map,
+                               workspace, radius);
+  };
+}
+
+/**
+ * @see make_esx_kernel(kernels::dijkstra_t, const Graph &G,
+ *                      PathWorkspace<Graph> &workspace)
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::bidirectional_dijkstra_t, const Graph &,
+                     PathWorkspace<Graph> &workspace) {
+  return [&workspace](const auto &G, auto s, auto t, const auto &weight,
+                      auto &deleted_edge_map) {
+    return bidirectional_dijkstra_shortest_path(G, s, t, weight,
+                                                deleted_edge_map, workspace);
+  };
+}
+
+/**
+ * Parallel Bidirectional Dijkstra runs on workspaces of its own threads:
+ * @p workspace is ignored.
+ */
+template <typename Graph>
+auto make_esx_kernel(kernels::parallel_bidirectional_dijkstra_t kernel,
+                     const Graph &G, PathWorkspace<Graph> &) {
+  return make_esx_kernel(kernel, G);
+}
+
+/**
+ * The routing kernel of ESX named by @p kernel on @p workspace, guided by
+ * @p heuristic if it is kernels::astar_t.
+ */
+template <typename Kernel, typename Graph, typename AStarHeuristic>
+auto make_esx_kernel(Kernel kernel, const Graph &G, const AStarHeuristic &,
+                     PathWorkspace<Graph> &workspace) {
+  return make_esx_kernel(kernel, G, workspace);
+}
+
 template <typename Graph, typename WeightMap, typename AStarHeuristic,
           typename DeletedEdgeMap, typename Vertex = vertex_of_t<Graph>,
           typename Edge = edge_of_t<Graph>>
 constexpr std::function<std::optional<std::vector<Edge>>(
     const Graph &, Vertex, Vertex, const WeightMap &, DeletedEdgeMap &)>
-build_shortest_path_fn(routing_kernels algorithm, const Graph &, Vertex, Vertex,
-                       const WeightMap &, const AStarHeuristic &heuristic,
-                       DeletedEdgeMap &) {
+build_shortest_path_fn(routing_kernels algorithm, const Graph &G, Vertex,
+                       Vertex, const WeightMap &,
+                       const AStarHeuristic &heuristic, DeletedEdgeMap &) {
   switch (algorithm) {
   case routing_kernels::astar:
-    return [&heuristic](const auto &G, auto s, auto t, const auto &weight,
-                        auto &deleted_edge_map) {
-      return astar_shortest_path(G, s, t, weight, heuristic, deleted_edge_map);
-    };
+    return make_esx_kernel(kernels::astar, G, heuristic);
   default:
     throw std::invalid_argument{"Invalid algorithm. Only [astar] "
                                 "allowed."};
@@ -357,27 +704,87 @@ template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
           typename Edge = edge_of_t<Graph>>
 constexpr std::function<std::optional<std::vector<Edge>>(
     const Graph &, Vertex, Vertex, const WeightMap &, DeletedEdgeMap &)>
-build_shortest_path_fn(routing_kernels algorithm, const Graph &, Vertex, Vertex,
-                       const WeightMap &, DeletedEdgeMap &) {
+build_shortest_path_fn(routing_kernels algorithm, const Graph &G, Vertex,
+                       Vertex, const WeightMap &, DeletedEdgeMap &) {
   switch (algorithm) {
   case routing_kernels::dijkstra:
-    return [](const auto &G, auto s, auto t, const auto &weight,
-              auto &deleted_edge_map) {
-      return dijkstra_shortest_path(G, s, t, weight, deleted_edge_map);
-    };
+    return make_esx_kernel(kernels::dijkstra, G);
   case routing_kernels::bidirectional_dijkstra:
-    return [](const auto &G, auto s, auto t, const auto &weight,
-              auto &deleted_edge_map) {
-      return bidirectional_dijkstra_shortest_path(G, s, t, weight,
-                                                  deleted_edge_map);
-    };
+    return make_esx_kernel(kernels::bidirectional_dijkstra, G);
+  case routing_kernels::parallel_bidirectional_dijkstra:
+    return make_esx_kernel(kernels::parallel_bidirectional_dijkstra, G);
   default:
     throw std::invalid_argument{
-        "Invalid algorithm. Only [dijkstra|bidirectional_dijkstra] "
+        "Invalid algorithm. Only "
+        "[dijkstra|bidirectional_dijkstra|parallel_bidirectional_dijkstra] "
         "allowed."};
   }
 }
 
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename LandmarkLength, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::function<std::optional<std::vector<Edge>>(
+    const Graph &, Vertex, Vertex, const WeightMap &, DeletedEdgeMap &)>
+build_landmark_shortest_path_fn(routing_kernels algorithm, const Graph &G,
+                                Vertex s, Vertex t, const WeightMap &weight,
+                                landmarks<LandmarkLength> const &lm,
+                                DeletedEdgeMap &deleted_edge_map) {
+  switch (algorithm) {
+  case routing_kernels::astar: {
+    auto heuristic = make_alt_heuristic(G, lm, t);
+    auto workspace = std::make_shared<PathWorkspace<Graph>>(num_vertices(G));
+    return [heuristic, workspace](const auto &G, auto s, auto t,
+                                  const auto &weight, auto &deleted_edge_map) {
+      return astar_shortest_path(G, s, t, weight, heuristic, deleted_edge_map,
+                                 *workspace);
+    };
+  }
+  case routing_kernels::bidirectional_alt: {
+    // Share one workspace among all the queries of this ESX run
+    using Workspace = BiDijkstraWorkspace<Vertex, length_of_t<Graph>>;
+    auto workspace = std::make_shared<Workspace>(num_vertices(G));
+    return [workspace, &lm](const auto &G, auto s, auto t, const auto &weight,
+                            auto &deleted_edge_map) {
+      return bidirectional_alt_shortest_path(G, s, t, weight, lm,
+                                             deleted_edge_map, *workspace);
+    };
+  }
+  default:
+    // Kernels which do not use landmarks
+    return build_shortest_path_fn(algorithm, G, s, t, weight,
+                                  deleted_edge_map);
+  }
+}
+
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Length, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::function<std::optional<std::vector<Edge>>(
+    const Graph &, Vertex, Vertex, const WeightMap &, DeletedEdgeMap &)>
+build_ch_shortest_path_fn(routing_kernels algorithm, const Graph &G, Vertex s,
+                          Vertex t, const WeightMap &weight,
+                          contraction_hierarchy<Graph, Length> const &ch,
+                          DeletedEdgeMap &deleted_edge_map) {
+  switch (algorithm) {
+  case routing_kernels::ch: {
+    // Share the workspaces among all the queries of this ESX run
+    auto cache = std::make_shared<CHPathCache<Graph, Length>>(num_vertices(G));
+    auto fallback =
+        std::make_shared<PathWorkspace<Graph, Length>>(num_vertices(G));
+    return [cache, fallback, &ch](const auto &G, auto s, auto t,
+                                  const auto &weight, auto &deleted_edge_map) {
+      return ch_shortest_path(G, s, t, weight, ch, deleted_edge_map, *cache,
+                              *fallback);
+    };
+  }
+  default:
+    // Kernels which do not use the hierarchy
+    return build_shortest_path_fn(algorithm, G, s, t, weight,
+                                  deleted_edge_map);
+  }
+}
+
 /**
  * Computes the ESX priority of an edge. Quoting the reference paper:
  *
@@ -398,22 +805,35 @@ build_shortest_path_fn(routing_kernels algorithm, const Graph &, Vertex, Vertex,
  * @param e An edge of @p G
  * @param heuristic An A* heuristic to use in performing shortest paths search.
  * @param deleted_edge_map The set of edges to filter from @p G
+ * @param workspace The memory of the many-to-many search, for the vertices of
+ *        @p G.
  * @return The priority of @p e.
  */
 template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
           typename Edge = edge_of_t<Graph>,
-          typename Length = length_of_t<Graph>>
+          typename Length = length_of_t<Graph>,
+          typename Vertex = vertex_of_t<Graph>>
 int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
-                     const DeletedEdgeMap &deleted_edge_map) {
+                     const DeletedEdgeMap &deleted_edge_map,
+                     ManyToManyWorkspace<Length, Vertex> &workspace) {
   using namespace boost;
-  using Vertex = typename graph_traits<Graph>::vertex_descriptor;
-  int priority = 0;
+  constexpr auto inf = std::numeric_limits<Length>::max();
   auto sources = std::vector<Vertex>{};
   auto targets = std::vector<Vertex>{};
 
   auto a = source(e, G);
   auto b = target(e, G);
 
+  // Get a graph with deleted edges filtered out
+  auto filter = edge_deleted_filter{deleted_edge_map};
+  const auto filtered_G = filtered_graph(G, filter);
+
+  // A path from n_i to n_j through e is no longer than the one going through
+  // the edges to and from e, if none of them is deleted. Searches can stop
+  // there.
+  auto to_a = Length{0}, from_b = Length{0};
+  bool bounded = true;
+
   // Compute all the n_i nodes s.t. (n_i, a) is an incoming edge of a, with n_i
   // != b
   for (auto in_it = in_edges(a, G).first; in_it != in_edges(a, G).second;
@@ -421,6 +841,8 @@ int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
     auto n_i = source(*in_it, G);
     if (n_i != b) {
       sources.push_back(n_i);
+      bounded = bounded && filter(*in_it);
+      to_a = std::max(to_a, get(weight, *in_it));
     }
   }
 
@@ -431,39 +853,38 @@ int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
     auto n_j = target(*out_it, G);
     if (n_j != a) {
       targets.push_back(n_j);
+      bounded = bounded && filter(*out_it);
+      from_b = std::max(from_b, get(weight, *out_it));
     }
   }
 
-  // Get a graph with deleted edges filtered out
-  auto filter = edge_deleted_filter{deleted_edge_map};
-  const auto filtered_G = filtered_graph(G, filter);
+  if (sources.empty() || targets.empty()) {
+    return 0;
+  }
 
-  for (auto s_i : sources) {
-    for (auto t_i : targets) {
-      // Compute the shortest path from s_i to t_i
-      auto index = get(vertex_index, filtered_G);
-      auto predecessor_vec = std::vector<Vertex>(num_vertices(G), s_i);
-      auto predecessor =
-          make_iterator_property_map(predecessor_vec.begin(), index);
-      auto distance_vec = std::vector<Length>(num_vertices(G));
-      auto distance = make_iterator_property_map(distance_vec.begin(), index);
-
-      auto rev_G = make_reverse_graph(filtered_G);
-      using RevEdge =
-          typename graph_traits<reverse_graph<Graph>>::edge_descriptor;
-      auto rev_weight = make_function_property_map<RevEdge>(
-          reverse_weight_functor{weight, filtered_G, rev_G});
-      auto rev_index = get(vertex_index, rev_G);
-
-      try {
-        bidirectional_dijkstra(filtered_G, s_i, t_i, predecessor, distance,
-                               weight, rev_G, rev_weight, rev_index);
-        if (shortest_path_contains_edge(s_i, t_i, e, filtered_G, predecessor)) {
-          ++priority;
-        }
-      } catch (target_not_found &ex) {
-        // In case t could not be found do nothing
-        std::cout << "Caught exception: " << ex.what() << "\n";
+  // One many-to-many computation instead of a search for each pair. The
+  // extra row and column give the distances from b and to a.
+  sources.push_back(b);
+  targets.push_back(a);
+  auto radius = bounded ? to_a + get(weight, e) + from_b : inf;
+  auto table =
+      many_to_many(filtered_G, sources, targets, weight,
+                   get(vertex_index, filtered_G), workspace, false, radius);
+
+  // A shortest path from n_i to n_j crosses e if going through e is as short.
+  // The two lengths are summed in different orders, so floating-point ones
+  // can differ by a rounding error.
+  int priority = 0;
+  auto row_b = sources.size() - 1;
+  auto column_a = targets.size() - 1;
+  for (std::size_t i = 0; i < row_b; ++i) {
+    for (std::size_t j = 0; j < column_a; ++j) {
+      if (table.reachable(i, j) && table.reachable(i, column_a) &&
+          table.reachable(row_b, j) &&
+          same_length<Length>(table.distance(i, column_a) + get(weight, e) +
+                                  table.distance(row_b, j),
+                              table.distance(i, j))) {
+        ++priority;
       }
     }
   }
@@ -471,6 +892,23 @@ int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
   return priority;
 }
 
+/**
+ * Computes the ESX priority of an edge, on a workspace of its own.
+ *
+ * @see compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
+ *                       const DeletedEdgeMap &deleted_edge_map,
+ *                       ManyToManyWorkspace<Length, Vertex> &workspace)
+ */
+template <typename Graph, typename WeightMap, typename DeletedEdgeMap,
+          typename Edge = edge_of_t<Graph>>
+int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
+                     const DeletedEdgeMap &deleted_edge_map) {
+  using Workspace =
+      ManyToManyWorkspace<length_of_t<Graph>, vertex_of_t<Graph>>;
+  auto workspace = Workspace{num_vertices(G)};
+  return compute_priority(G, e, weight, deleted_edge_map, workspace);
+}
+
 /**
  * Computes the edge priorities of an alternative path.
  *
@@ -493,14 +931,16 @@ int compute_priority(const Graph &G, const Edge &e, WeightMap &weight,
  * @param G The graph
  * @param heuristic An A* heuristic to use in performing shortest paths search.
  * @param deleted_edges The set of edges to filter from @p G
+ * @param workspace An optional ManyToManyWorkspace for compute_priority().
  */
 template <typename Graph, typename PrioritiesVector, typename WeightMap,
-          typename EdgeMap,
+          typename EdgeMap, typename... Workspace,
           typename Index = typename PrioritiesVector::size_type>
 void init_edge_priorities(const Graph &alternative,
                           PrioritiesVector &edge_priorities, Index alt_index,
                           const Graph &G, const WeightMap &weight,
-                          const EdgeMap &deleted_edges) {
+                          const EdgeMap &deleted_edges,
+                          Workspace &... workspace) {
   using namespace boost;
   for (auto it = edges(alternative).first; it != edges(alternative).second;
        ++it) {
@@ -509,7 +949,8 @@ void init_edge_priorities(const Graph &alternative,
     auto v = target(*it, alternative);
     auto edge_in_G = edge(u, v, G);
     assert(edge_in_G.second); // (u, v) must exist in G
-    auto prio_e_i = compute_priority(G, edge_in_G.first, weight, deleted_edges);
+    auto prio_e_i = compute_priority(G, edge_in_G.first, weight,
+                                     deleted_edges, workspace...);
     edge_priorities[alt_index].push(std::make_pair(edge_in_G.first, prio_e_i));
   }
 }
@@ -536,20 +977,42 @@ void init_edge_priorities(const Graph &alternative,
  * @param G The graph
  * @param heuristic An A* heuristic to use in performing shortest paths search.
  * @param deleted_edges The set of edges to filter from @p G
+ * @param workspace An optional ManyToManyWorkspace for compute_priority().
  */
 template <typename PrioritiesVector, typename Graph, typename WeightMap,
-          typename EdgeMap, typename Edge = edge_of_t<Graph>,
+          typename EdgeMap, typename... Workspace,
+          typename Edge = edge_of_t<Graph>,
           typename Index = typename PrioritiesVector::size_type>
 void init_edge_priorities(const std::vector<Edge> &alternative,
                           PrioritiesVector &edge_priorities, Index alt_index,
                           const Graph &G, const WeightMap &weight,
-                          const EdgeMap &deleted_edges) {
+                          const EdgeMap &deleted_edges,
+                          Workspace &... workspace) {
   for (const auto &e : alternative) {
-    auto prio_e_i = compute_priority(G, e, weight, deleted_edges);
+    auto prio_e_i =
+        compute_priority(G, e, weight, deleted_edges, workspace...);
     edge_priorities[alt_index].push(std::make_pair(e, prio_e_i));
   }
 }
 
+/**
+ * The default priority function of ESX: init_edge_priorities() on one
+ * ManyToManyWorkspace, shared by all the priorities computed in a run.
+ *
+ * @param G The graph.
+ */
+template <typename Graph> auto make_priority_fn(const Graph &G) {
+  using Workspace =
+      ManyToManyWorkspace<length_of_t<Graph>, vertex_of_t<Graph>>;
+  auto workspace = std::make_shared<Workspace>(num_vertices(G));
+  return [workspace](auto const &alternative, auto &edge_priorities,
+                     auto alt_index, auto const &G, auto const &weight,
+                     auto const &deleted_edges) {
+    init_edge_priorities(alternative, edge_priorities, alt_index, G, weight,
+                         deleted_edges, *workspace);
+  };
+}
+
 /**
  * Checks whether another alternative path can be found by ESX.
  *
@@ -569,20 +1032,23 @@ bool check_feasibility(const std::vector<double> &overlaps);
  *         property with tag boost::edge_weight_t.
  * @param candidate The candidate path.
  * @param alternatives The list of alternative paths.
+ * @param alternatives_edges The edges of each path of @p alternatives, in
+ *        a set such as edge_set.
  * @param theta The similarity threshold.
  * @return true If @p candidate is sufficiently dissimilar to all the other
  * alternative paths.
  * @return false Otherwise.
  */
-template <typename Edge, typename WeightMap>
+template <typename Edge, typename EdgeSet, typename WeightMap>
 bool check_candidate_validity(
     const std::vector<Edge> &candidate,
-    const std::vector<std::unordered_set<Edge, boost::hash<Edge>>>
-        &alternatives,
-    WeightMap const &weight, double theta) {
+    const std::vector<std::vector<Edge>> &alternatives,
+    const std::vector<EdgeSet> &alternatives_edges, WeightMap const &weight,
+    double theta) {
   bool candidate_is_valid = true;
-  for (const auto &alt_path : alternatives) {
-    if (compute_similarity(candidate, alt_path, weight) > theta) {
+  for (std::size_t i = 0; i < alternatives.size(); ++i) {
+    if (compute_similarity(candidate, alternatives[i], alternatives_edges[i],
+                           weight) > theta) {
       candidate_is_valid = false;
       break;
     }
@@ -590,10 +1056,8 @@ bool check_candidate_validity(
   return candidate_is_valid;
 }
 
-template <typename Edge>
-void move_to_dnr(Edge e,
-                 std::unordered_set<Edge, boost::hash<Edge>> &deleted_edges,
-                 std::unordered_set<Edge, boost::hash<Edge>> &dnr_edges) {
+template <typename Edge, typename EdgeSet>
+void move_to_dnr(Edge e, EdgeSet &deleted_edges, EdgeSet &dnr_edges) {
 #ifndef NDEBUG
   auto old_size = deleted_edges.size();
 #endif
@@ -613,24 +1077,27 @@ template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
 void esx(const Graph &G, WeightMap const &weight,
          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
          double theta, PriorityFunc &&priority_fn,
-         RoutingKernel &routing_kernel, Terminator &&terminator) {
+         RoutingKernel &routing_kernel, Terminator &&terminator,
+         std::vector<edge_of_t<Graph>> const *shortest_path = nullptr) {
   using namespace boost;
   using Edge = typename graph_traits<Graph>::edge_descriptor;
+  using Length = value_of_t<WeightMap>;
 
   BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
   BOOST_CONCEPT_ASSERT((LvaluePropertyMapConcept<WeightMap, Edge>));
 
+  // Sets of edges are bitsets over a dense numbering of the edges of G
+  auto edge_id = dense_edge_index<Graph>{G};
+
   // P_LO set of k paths
   auto resPathsEdges = std::vector<std::vector<Edge>>{};
-  auto resEdges = std::vector<std::unordered_set<Edge, boost::hash<Edge>>>{};
-
-  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
-  BOOST_CONCEPT_ASSERT((LvaluePropertyMapConcept<WeightMap, Edge>));
+  auto resEdges = std::vector<edge_set<Graph>>{};
 
   // P_LO set of k paths
   auto resPaths = std::vector<Path<Graph>>{};
-  // Compute shortest path from s to t
-  auto sp = details::compute_shortest_path(G, weight, s, t);
+  // Compute shortest path from s to t, unless it is known already
+  auto sp = shortest_path ? std::make_optional(*shortest_path)
+                          : details::compute_shortest_path(G, weight, s, t);
   if (!sp) {
     auto oss = std::ostringstream{};
     oss << "Vertex " << t << " is unreachable from " << s;
@@ -639,7 +1106,7 @@ void esx(const Graph &G, WeightMap const &weight,
 
   // P_LO <-- {shortest path p_0(s, t)};
   resPathsEdges.push_back(*sp);
-  resEdges.emplace_back(sp->begin(), sp->end());
+  resEdges.emplace_back(sp->begin(), sp->end(), edge_id);
 
   // If we need the shortest path only
   if (k == 1) {
@@ -648,6 +1115,12 @@ void esx(const Graph &G, WeightMap const &weight,
     return;
   }
 
+  // No alternative is longer than radius
+  auto radius = stretch_radius(
+      stretch_bound(terminator),
+      compute_length_from_edges(sp->begin(), sp->end(), weight));
+  bool bounded = radius != std::numeric_limits<Length>::max();
+
   // Every max-heap H_i is associated with p_i
   using Priority = std::pair<Edge, int>;
   using EdgePriorityQueue =
@@ -656,10 +1129,10 @@ void esx(const Graph &G, WeightMap const &weight,
   auto edge_priorities = std::vector<EdgePriorityQueue>(k);
 
   // We keep a set of non-removable edges
-  auto dnr_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
+  auto dnr_edges = edge_set<Graph>{edge_id};
 
   // We keep a set of deleted-edges
-  auto deleted_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
+  auto deleted_edges = edge_set<Graph>{edge_id};
 
   // Compute lower bounds for AStar
   // auto heuristic = details::distance_heuristic<Graph, Length>(G, t);
@@ -691,7 +1164,7 @@ void esx(const Graph &G, WeightMap const &weight,
       auto e_tmp = edge_priorities[p_max_idx].top().first;
 
       // If edge is in DO-NOT-REMOVE edges set, continue
-      if (dnr_edges.find(e_tmp) != std::end(dnr_edges)) {
+      if (dnr_edges.contains(e_tmp)) {
         edge_priorities[p_max_idx].pop();
         // Also, if H_{p_max_idx} queue is empty set its overlapping value to 0
         if (edge_priorities[p_max_idx].empty()) {
@@ -711,10 +1184,25 @@ void esx(const Graph &G, WeightMap const &weight,
             "discard partial output."};
       }
 
-      // Compute p_tmp shortest path
-      auto p_tmp = routing_kernel(G, s, t, weight, deleted_edges);
+      // Compute p_tmp shortest path, within radius if the kernel can
+      auto p_tmp = [&]() -> std::optional<std::vector<Edge>> {
+        if constexpr (std::is_invocable_v<RoutingKernel &, const Graph &,
+                                          Vertex, Vertex, const WeightMap &,
+                                          decltype(deleted_edges) &, Length>) {
+          return routing_kernel(G, s, t, weight, deleted_edges, radius);
+        } else {
+          auto path = routing_kernel(G, s, t, weight, deleted_edges);
+          if (bounded && path &&
+              compute_length_from_edges(path->begin(), path->end(), weight) >
+                  radius) {
+            return std::nullopt;
+          }
+          return path;
+        }
+      }();
 
-      // If shortest path did not find a path
+      // If shortest path did not find a path. Without e_tmp no path is
+      // within radius either, so it must never be deleted.
       if (!p_tmp) {
         move_to_dnr(e_tmp, deleted_edges, dnr_edges);
         continue;
@@ -729,17 +1217,19 @@ void esx(const Graph &G, WeightMap const &weight,
       if (edge_priorities[p_max_idx].empty()) {
         overlaps[p_max_idx] = 0;
       } else {
-        const auto &alt_path = resEdges[p_max_idx];
-        overlaps[p_max_idx] = compute_similarity(*p_tmp, alt_path, weight);
+        overlaps[p_max_idx] =
+            compute_similarity(*p_tmp, resPathsEdges[p_max_idx],
+                               resEdges[p_max_idx], weight);
       }
 
       // Checking if the resulting path is valid
       bool candidate_is_valid =
-          check_candidate_validity(*p_tmp, resEdges, weight, theta);
+          check_candidate_validity(*p_tmp, resPathsEdges, resEdges, weight,
+                                   theta);
       if (candidate_is_valid) {
         // Add p_tmp to P_LO
         resPathsEdges.emplace_back(*p_tmp);
-        resEdges.emplace_back(p_tmp->begin(), p_tmp->end());
+        resEdges.emplace_back(p_tmp->begin(), p_tmp->end(), edge_id);
 
         // Set p_c overlap with itself to 1
         std::ptrdiff_t p_c_idx = resPathsEdges.size() - 1;
@@ -758,45 +1248,55 @@ void esx(const Graph &G, WeightMap const &weight,
                          predecessors);
 }
 
+/**
+ * Run ESX with the routing kernel named by @p kernel, on @p workspace if
+ * given, or on a workspace of its own.
+ */
 template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
-          typename PriorityFunc, typename Terminator,
-          typename Vertex = vertex_of_t<Graph>>
-void esx_dispatch2(const Graph &G, WeightMap const &weight,
-                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
-                   double theta, PriorityFunc &&priority_fn,
-                   routing_kernels algorithm, Terminator &&terminator) {
-  using Edge = edge_of_t<Graph>;
+          typename PriorityFunc, typename Kernel, typename Terminator,
+          typename... Workspace, typename Vertex = vertex_of_t<Graph>>
+void esx_kernel_dispatch(const Graph &G, WeightMap const &weight,
+                         MultiPredecessorMap &predecessors, Vertex s, Vertex t,
+                         int k, double theta, PriorityFunc &&priority_fn,
+                         Kernel kernel, Terminator &&terminator,
+                         Workspace &... workspace) {
   using Length = length_of_t<Graph>;
 
-  auto deleted_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
-  if (algorithm == routing_kernels::astar) {
-    auto heuristic = details::distance_heuristic<Graph, Length>(G, t);
-    auto routing_kernel = details::build_shortest_path_fn(
-        algorithm, G, s, t, weight, heuristic, deleted_edges);
+  if constexpr (std::is_same_v<Kernel, kernels::astar_t>) {
+    auto heuristic = details::lazy_distance_heuristic<Graph, Length>(G, t);
+    auto routing_kernel = make_esx_kernel(kernel, G, heuristic, workspace...);
     esx(G, weight, predecessors, s, t, k, theta,
         std::forward<PriorityFunc>(priority_fn), routing_kernel,
         std::forward<Terminator>(terminator));
   } else {
-    auto routing_kernel = details::build_shortest_path_fn(
-        algorithm, G, s, t, weight, deleted_edges);
+    auto routing_kernel = make_esx_kernel(kernel, G, workspace...);
     esx(G, weight, predecessors, s, t, k, theta,
         std::forward<PriorityFunc>(priority_fn), routing_kernel,
         std::forward<Terminator>(terminator));
   }
 }
 
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename PriorityFunc, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void esx_dispatch2(const Graph &G, WeightMap const &weight,
+                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                   double theta, PriorityFunc &&priority_fn,
+                   routing_kernels algorithm, Terminator &&terminator) {
+  kernels::visit(algorithm, [&](auto kernel) {
+    esx_kernel_dispatch(G, weight, predecessors, s, t, k, theta,
+                        std::forward<PriorityFunc>(priority_fn), kernel,
+                        std::forward<Terminator>(terminator));
+  });
+}
+
 template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
           typename Terminator, typename Vertex = vertex_of_t<Graph>>
 void esx_dispatch(const Graph &G, WeightMap const &weight,
                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
                   double theta, routing_kernels algorithm,
                   Terminator &&terminator) {
-  auto priority_fn = [](auto const &alternative, auto &edge_priorities,
-                        auto alt_index, auto const &G, auto const &weight,
-                        auto const &deleted_edges) {
-    init_edge_priorities(alternative, edge_priorities, alt_index, G, weight,
-                         deleted_edges);
-  };
+  auto priority_fn = make_priority_fn(G);
   esx_dispatch2(G, weight, predecessors, s, t, k, theta, std::move(priority_fn),
                 algorithm, std::forward<Terminator>(terminator));
 }
@@ -822,6 +1322,58 @@ void esx_dispatch(const Graph &G, WeightMap const &weight,
   esx_dispatch2(G, weight, predecessors, s, t, k, theta, std::move(priority_fn),
                 algorithm, std::forward<Terminator>(terminator));
 }
+
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LandmarkLength, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void esx_landmark_dispatch(const Graph &G, WeightMap const &weight,
+                           MultiPredecessorMap &predecessors, Vertex s,
+                           Vertex t, int k, double theta,
+                           landmarks<LandmarkLength> const &lm,
+                           routing_kernels algorithm,
+                           Terminator &&terminator) {
+  auto priority_fn = make_priority_fn(G);
+  auto deleted_edges = edge_set<Graph>{G};
+  auto routing_kernel = details::build_landmark_shortest_path_fn(
+      algorithm, G, s, t, weight, lm, deleted_edges);
+  esx(G, weight, predecessors, s, t, k, theta, std::move(priority_fn),
+      routing_kernel, std::forward<Terminator>(terminator));
+}
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename AStarHeuristic, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void esx_heuristic_dispatch(const Graph &G, WeightMap const &weight,
+                            MultiPredecessorMap &predecessors, Vertex s,
+                            Vertex t, int k, double theta,
+                            AStarHeuristic const &heuristic,
+                            routing_kernels algorithm,
+                            Terminator &&terminator,
+                            std::vector<edge_of_t<Graph>> const *shortest_path =
+                                nullptr) {
+  auto priority_fn = make_priority_fn(G);
+  kernels::visit(algorithm, [&](auto kernel) {
+    // Only kernels::astar_t uses the heuristic
+    auto routing_kernel = make_esx_kernel(kernel, G, heuristic);
+    esx(G, weight, predecessors, s, t, k, theta, std::move(priority_fn),
+        routing_kernel, std::forward<Terminator>(terminator), shortest_path);
+  });
+}
+
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Length, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void esx_ch_dispatch(const Graph &G, WeightMap const &weight,
+                     MultiPredecessorMap &predecessors, Vertex s, Vertex t,
+                     int k, double theta,
+                     contraction_hierarchy<Graph, Length> const &ch,
+                     routing_kernels algorithm, Terminator &&terminator) {
+  auto priority_fn = make_priority_fn(G);
+  auto deleted_edges = edge_set<Graph>{G};
+  auto routing_kernel = details::build_ch_shortest_path_fn(
+      algorithm, G, s, t, weight, ch, deleted_edges);
+  esx(G, weight, predecessors, s, t, k, theta, std::move(priority_fn),
+      routing_kernel, std::forward<Terminator>(terminator));
+}
 } // namespace details
 } // namespace arlib
 #endif
@@ -0,0 +1,177 @@
+/**
+ * @file gr_parser.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_GR_PARSER_HPP
+#define ALTERNATIVE_ROUTING_LIB_GR_PARSER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                          .gr-format parsing
+//===----------------------------------------------------------------------===//
+
+/**
+ * The vertices, edges and weights of a .gr-format graph, ready to be handed
+ * to a graph constructor.
+ *
+ * @tparam Length The weight type.
+ */
+template <typename Length> struct gr_contents {
+  std::size_t nb_vertices = 0;
+  std::vector<std::pair<long unsigned, long unsigned>> edges;
+  std::vector<Length> weights;
+};
+
+/**
+ * A forward-only scanner of the lines of a .gr-format text, reading numbers
+ * in place with `std::from_chars`.
+ */
+class gr_scanner {
+public:
+  explicit gr_scanner(std::string_view text)
+      : first{text.data()}, last{text.data() + text.size()} {}
+
+  /**
+   * Move to the beginning of the next line holding some data, skipping blank
+   * lines and lines starting with '#'.
+   *
+   * @return false if the text is over.
+   */
+  bool next_line() {
+    while (first != last) {
+      skip_blanks();
+      if (first == last) {
+        return false;
+      }
+      if (*first != '\n' && *first != '#') {
+        return true;
+      }
+      skip_line();
+    }
+    return false;
+  }
+
+  /**
+   * Skip what is left of the current line, line terminator included.
+   */
+  void skip_line() {
+    while (first != last && *first++ != '\n') {
+    }
+    ++line;
+  }
+
+  /**
+   * Read the next number of the current line.
+   *
+   * @throw std::invalid_argument if there is no number of type @p T there.
+   */
+  template <typename T> T read() {
+    skip_blanks();
+    auto value = T{};
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc{}) {
+      throw std::invalid_argument{"Malformed .gr file at line " +
+                                  std::to_string(line)};
+    }
+    first = ptr;
+    return value;
+  }
+
+private:
+  char const *first;
+  char const *last;
+  std::size_t line = 1;
+
+  void skip_blanks() {
+    while (first != last &&
+           (*first == ' ' || *first == '\t' || *first == '\r')) {
+      ++first;
+    }
+  }
+};
+
+/**
+ * Parse a .gr-format text: a line with the graph type, a line with the
+ * number of vertices and of edges, then one line per edge with its source,
+ * target and weight. Further fields on a line are ignored.
+ *
+ * The text is read in place, and the edge and weight vectors are reserved
+ * from the header, so that the memory needed is close to the one of the
+ * result.
+ *
+ * @tparam Length The weight type.
+ * @param text A .gr-format text.
+ * @return The parsed graph.
+ * @throw std::invalid_argument if @p text is malformed.
+ */
+template <typename Length> gr_contents<Length> parse_gr(std::string_view text) {
+  auto scanner = gr_scanner{text};
+  auto result = gr_contents<Length>{};
+
+  // Drop graph type info
+  if (!scanner.next_line()) {
+    return result;
+  }
+  scanner.skip_line();
+
+  // Get number of nodes and edges
+  if (!scanner.next_line()) {
+    return result;
+  }
+  result.nb_vertices = scanner.read<std::size_t>();
+  auto nb_edges = scanner.read<std::size_t>();
+  scanner.skip_line();
+  result.edges.reserve(nb_edges);
+  result.weights.reserve(nb_edges);
+
+  // Get edges and weights
+  while (scanner.next_line()) {
+    auto s = scanner.read<long unsigned>();
+    auto t = scanner.read<long unsigned>();
+    auto w = scanner.read<Length>();
+    scanner.skip_line();
+    result.edges.emplace_back(s, t);
+    result.weights.push_back(w);
+  }
+  return result;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_GR_PARSER_HPP
@@ -0,0 +1,290 @@
+/**
+ * @file hub_labels_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_HUB_LABELS_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_HUB_LABELS_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                        Hub label intersection
+//===----------------------------------------------------------------------===//
+
+/**
+ * A read-only view of a vertex label: its hubs, by increasing rank, and the
+ * distance to or from each of them.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct label_view {
+  std::uint32_t const *hubs;
+  Length const *distances;
+  std::size_t size;
+};
+
+/**
+ * Merge two labels and return the shortest distance through a common hub.
+ *
+ * With SSE2 the labels are scanned four hubs at a time: one vector compare
+ * per rotation tests all 16 pairs of two blocks, so blocks without a common
+ * hub, the vast majority, are skipped without a single branch per hub.
+ *
+ * @param out The label of the source, with distances to its hubs.
+ * @param in The label of the target, with distances from its hubs.
+ * @return The distance from the source to the target, or
+ *         `std::numeric_limits<Length>::max()` if they share no hub.
+ */
+template <typename Length>
+Length label_intersection(label_view<Length> const &out,
+                          label_view<Length> const &in) {
+  auto best = std::numeric_limits<Length>::max();
+  std::size_t i = 0;
+  std::size_t j = 0;
+
+#if defined(__SSE2__)
+  while (i + 4 <= out.size && j + 4 <= in.size) {
+    auto a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(out.hubs + i));
+    auto b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in.hubs + j));
+    auto eq = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi32(a, b),
+            _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1)))),
+        _mm_or_si128(
+            _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2))),
+            _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3)))));
+    if (_mm_movemask_epi8(eq) != 0) {
+      for (std::size_t p = i; p < i + 4; ++p) {
+        for (std::size_t q = j; q < j + 4; ++q) {
+          if (out.hubs[p] == in.hubs[q] &&
+              out.distances[p] + in.distances[q] < best) {
+            best = out.distances[p] + in.distances[q];
+          }
+        }
+      }
+    }
+    // The block ending first cannot meet any later hub of the other label
+    auto out_last = out.hubs[i + 3];
+    auto in_last = in.hubs[j + 3];
+    if (out_last <= in_last) {
+      i += 4;
+    }
+    if (in_last <= out_last) {
+      j += 4;
+    }
+  }
+#endif
+
+  while (i < out.size && j < in.size) {
+    if (out.hubs[i] < in.hubs[j]) {
+      ++i;
+    } else if (in.hubs[j] < out.hubs[i]) {
+      ++j;
+    } else {
+      if (out.distances[i] + in.distances[j] < best) {
+        best = out.distances[i] + in.distances[j];
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return best;
+}
+
+//===----------------------------------------------------------------------===//
+//                        Pruned landmark labeling
+//===----------------------------------------------------------------------===//
+
+/**
+ * A label entry while labels are being built.
+ */
+template <typename Length> struct hub_entry {
+  std::uint32_t hub;
+  Length distance;
+};
+
+/**
+ * The labels of all the vertices while they are being built.
+ */
+template <typename Length> struct label_sets {
+  std::vector<std::vector<hub_entry<Length>>> out; /**< d(v, hub) */
+  std::vector<std::vector<hub_entry<Length>>> in;  /**< d(hub, v) */
+};
+
+/**
+ * Run the pruned Dijkstra's search of the hub of rank @p rank, in one
+ * direction, adding it to the label of every vertex it reaches.
+ *
+ * A vertex `v` settled at distance `d` is pruned, neither labeled nor
+ * expanded, if the labels built so far already give a distance of at most
+ * `d` between the hub and `v`. Hubs are processed by decreasing importance,
+ * so most searches die out after a few hops.
+ *
+ * @param forward true to search from the hub along the edges of @p G and
+ *        fill the labels "in", false to search backward and fill "out".
+ * @param root_distance Scratch space of one slot per rank, all max.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length>
+void pruned_search(const Graph &G, WeightMap weight, IndexMap index,
+                   std::size_t root, std::uint32_t rank, bool forward,
+                   label_sets<Length> &labels,
+                   std::vector<Length> &root_distance,
+                   d_ary_heap<Length> &fringe,
+                   stamped_vector<Length> &distance) {
+  using namespace boost;
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto &root_label = forward ? labels.out[root] : labels.in[root];
+  auto &reached_labels = forward ? labels.in : labels.out;
+  for (auto const &entry : root_label) {
+    root_distance[entry.hub] = entry.distance;
+  }
+
+  fringe.clear();
+  distance.clear();
+  distance.at(root) = Length{0};
+  fringe.push_or_decrease(root, Length{0});
+  while (!fringe.empty()) {
+    auto [d, v] = fringe.top();
+    fringe.pop();
+
+    auto &label = reached_labels[v];
+    auto known = inf;
+    for (auto const &entry : label) {
+      auto via = root_distance[entry.hub];
+      if (via != inf && via + entry.distance < known) {
+        known = via + entry.distance;
+      }
+    }
+    if (known <= d) {
+      continue;
+    }
+    label.push_back(hub_entry<Length>{rank, d});
+
+    auto relax = [&](std::size_t w, Length length) {
+      auto dw = d + length;
+      if (dw < d) {
+        throw std::domain_error{"Negative weight on edge"};
+      }
+      if (dw < distance[w]) {
+        distance.at(w) = dw;
+        fringe.push_or_decrease(w, dw);
+      }
+    };
+    auto u = vertex(v, G);
+    if (forward) {
+      for (auto [it, end] = out_edges(u, G); it != end; ++it) {
+        relax(get(index, target(*it, G)), get(weight, *it));
+      }
+    } else {
+      for (auto [it, end] = in_edges(u, G); it != end; ++it) {
+        relax(get(index, source(*it, G)), get(weight, *it));
+      }
+    }
+  }
+
+  for (auto const &entry : root_label) {
+    root_distance[entry.hub] = inf;
+  }
+}
+
+/**
+ * Build the labels of @p G by pruned landmark labeling, taking the vertices
+ * as hubs in @p order.
+ *
+ * @param order The vertex indices, by decreasing importance.
+ * @return The label of every vertex, with hubs by increasing rank.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length>
+label_sets<Length> pruned_landmark_labeling(const Graph &G, WeightMap weight,
+                                            IndexMap index,
+                                            std::vector<std::size_t> const
+                                                &order) {
+  auto n = order.size();
+  auto labels = label_sets<Length>{};
+  labels.out.resize(n);
+  labels.in.resize(n);
+  auto root_distance =
+      std::vector<Length>(n, std::numeric_limits<Length>::max());
+  auto fringe = d_ary_heap<Length>(n);
+  auto distance =
+      stamped_vector<Length>(n, std::numeric_limits<Length>::max());
+
+  for (std::size_t rank = 0; rank < n; ++rank) {
+    auto root = order[rank];
+    auto hub = static_cast<std::uint32_t>(rank);
+    pruned_search(G, weight, index, root, hub, true, labels, root_distance,
+                  fringe, distance);
+    pruned_search(G, weight, index, root, hub, false, labels, root_distance,
+                  fringe, distance);
+  }
+  return labels;
+}
+
+/**
+ * @return The vertex indices of @p G by decreasing total degree.
+ */
+template <typename Graph, typename IndexMap>
+std::vector<std::size_t> degree_order(const Graph &G, IndexMap index) {
+  using namespace boost;
+  auto n = num_vertices(G);
+  auto degree = std::vector<std::size_t>(n);
+  for (auto [it, end] = vertices(G); it != end; ++it) {
+    degree[get(index, *it)] = out_degree(*it, G) + in_degree(*it, G);
+  }
+  auto order = std::vector<std::size_t>(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    order[v] = v;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&degree](auto u, auto v) { return degree[u] > degree[v]; });
+  return order;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_HUB_LABELS_IMPL_HPP
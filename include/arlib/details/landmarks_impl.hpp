@@ -0,0 +1,343 @@
+/**
+ * @file landmarks_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_LANDMARKS_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_LANDMARKS_IMPL_HPP
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                      ALT landmarks support functions
+//===----------------------------------------------------------------------===//
+
+/**
+ * The lower bound on the distance `d(u, v)` given by the triangle
+ * inequality on a single landmark `L`:
+ * <tt>max(d(u, L) - d(v, L), d(L, v) - d(L, u))</tt>.
+ *
+ * Terms with an infinite distance carry no information and are skipped, so
+ * the bound is never negative.
+ *
+ * @param from_u The distance `d(L, u)`.
+ * @param to_u The distance `d(u, L)`.
+ * @param from_v The distance `d(L, v)`.
+ * @param to_v The distance `d(v, L)`.
+ * @return A lower bound on `d(u, v)`.
+ */
+template <typename Length>
+Length landmark_bound(Length from_u, Length to_u, Length from_v, Length to_v) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto bound = Length{};
+  if (to_u != inf && to_v != inf && to_u > to_v) {
+    bound = to_u - to_v;
+  }
+  if (from_u != inf && from_v != inf && from_v > from_u &&
+      from_v - from_u > bound) {
+    bound = from_v - from_u;
+  }
+  return bound;
+}
+
+/**
+ * The distances from and to one landmark, while landmarks are being selected.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct landmark_distances {
+  std::size_t landmark;
+  std::vector<Length> from; /**< d(landmark, v) for every vertex v. */
+  std::vector<Length> to;   /**< d(v, landmark) for every vertex v. */
+};
+
+/**
+ * Run a Dijkstra's search from the vertex of index @p root.
+ *
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param root The index of the root vertex.
+ * @param distance Upon return, the distance of each vertex from @p root.
+ * @param predecessor Upon return, the index of the parent of each vertex in
+ *        the shortest path tree of @p root.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length>
+void landmark_search(const Graph &G, WeightMap weight, IndexMap index,
+                     std::size_t root, std::vector<Length> &distance,
+                     std::vector<std::size_t> &predecessor) {
+  using namespace boost;
+  using Vertex = vertex_of_t<Graph>;
+  auto n = num_vertices(G);
+  auto vertex_predecessor = std::vector<Vertex>(n);
+  distance.assign(n, std::numeric_limits<Length>::max());
+
+  dijkstra_shortest_paths(
+      G, vertex(root, G),
+      weight_map(weight)
+          .vertex_index_map(index)
+          .distance_map(make_iterator_property_map(distance.begin(), index))
+          .predecessor_map(make_iterator_property_map(
+              vertex_predecessor.begin(), index)));
+
+  predecessor.resize(n);
+  for (auto [v_it, v_end] = vertices(G); v_it != v_end; ++v_it) {
+    auto v = get(index, *v_it);
+    predecessor[v] = get(index, vertex_predecessor[v]);
+  }
+}
+
+/**
+ * Compute the distances from and to the vertex of index @p landmark.
+ *
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param landmark The index of the landmark.
+ * @return The landmark distances of @p landmark.
+ */
+template <typename Length, typename Graph, typename WeightMap,
+          typename IndexMap>
+landmark_distances<Length> compute_landmark_distances(const Graph &G,
+                                                      WeightMap weight,
+                                                      IndexMap index,
+                                                      std::size_t landmark) {
+  using namespace boost;
+  auto result = landmark_distances<Length>{landmark, {}, {}};
+  auto predecessor = std::vector<std::size_t>{};
+  landmark_search(G, weight, index, landmark, result.from, predecessor);
+
+  // Distances to the landmark are distances from it on the reverse graph
+  auto rev_G = make_reverse_graph(G);
+  auto rev_weight = make_reverse_weight_map(weight, rev_G);
+  landmark_search(rev_G, rev_weight, index, landmark, result.to, predecessor);
+  return result;
+}
+
+/**
+ * @return The best lower bound on `d(u, v)` among @p selected landmarks.
+ */
+template <typename Length>
+Length selected_bound(std::vector<landmark_distances<Length>> const &selected,
+                      std::size_t u, std::size_t v) {
+  auto bound = Length{};
+  for (auto const &l : selected) {
+    bound = std::max(bound,
+                     landmark_bound(l.from[u], l.to[u], l.from[v], l.to[v]));
+  }
+  return bound;
+}
+
+/**
+ * @return A vertex index in [0, @p n) which is not a landmark yet, picked
+ *         uniformly at random.
+ */
+template <typename Length, typename RandomEngine>
+std::size_t
+random_non_landmark(std::vector<landmark_distances<Length>> const &selected,
+                    std::size_t n, RandomEngine &engine) {
+  auto is_landmark = std::vector<bool>(n, false);
+  for (auto const &l : selected) {
+    is_landmark[l.landmark] = true;
+  }
+  auto candidates = std::vector<std::size_t>{};
+  for (std::size_t v = 0; v < n; ++v) {
+    if (!is_landmark[v]) {
+      candidates.push_back(v);
+    }
+  }
+  auto pick = std::uniform_int_distribution<std::size_t>{
+      0, candidates.size() - 1};
+  return candidates[pick(engine)];
+}
+
+/**
+ * Farthest landmark selection: every new landmark is the vertex farthest
+ * from the ones already selected, where the distance between a vertex and a
+ * landmark is the shorter of the two directions. The first landmark is the
+ * vertex farthest from a random one.
+ *
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param count The number of landmarks to select.
+ * @param engine The source of randomness.
+ * @return The distances from and to each selected landmark.
+ */
+template <typename Length, typename Graph, typename WeightMap,
+          typename IndexMap, typename RandomEngine>
+std::vector<landmark_distances<Length>>
+farthest_landmarks(const Graph &G, WeightMap weight, IndexMap index,
+                   std::size_t count, RandomEngine &engine) {
+  using namespace boost;
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto n = num_vertices(G);
+  auto selected = std::vector<landmark_distances<Length>>{};
+
+  // Distance of each vertex from the closest landmark. Seed it with the
+  // distances from a random root, as if it was a landmark itself.
+  auto closest = compute_landmark_distances<Length>(
+                     G, weight, index, random_non_landmark(selected, n, engine))
+                     .from;
+  for (std::size_t i = 0; i < count && i < n; ++i) {
+    auto next = n;
+    for (std::size_t v = 0; v < n; ++v) {
+      if (closest[v] != inf && (next == n || closest[v] > closest[next])) {
+        next = v;
+      }
+    }
+    if (next == n || closest[next] == Length{}) {
+      // Every reachable vertex is a landmark already
+      next = random_non_landmark(selected, n, engine);
+    }
+
+    selected.push_back(
+        compute_landmark_distances<Length>(G, weight, index, next));
+    auto const &l = selected.back();
+    if (i == 0) {
+      closest.assign(n, inf);
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+      closest[v] = std::min(closest[v], std::min(l.from[v], l.to[v]));
+    }
+  }
+  return selected;
+}
+
+/**
+ * Avoid landmark selection, from Goldberg and Werneck, "Computing
+ * Point-to-Point Shortest Paths from External Memory" (ALENEX 2005).
+ *
+ * For each new landmark, grow a shortest path tree from a random root @c r
+ * and weight every vertex @c v with <tt>d(r, v) - LB(r, v)</tt>, how poorly
+ * the landmarks selected so far bound it. The size of a vertex is the total
+ * weight of its subtree, or zero if the subtree holds a landmark. Starting
+ * from the vertex of largest size, walk down to the child of largest size
+ * until a leaf is reached: the leaf is the new landmark.
+ *
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param count The number of landmarks to select.
+ * @param engine The source of randomness.
+ * @return The distances from and to each selected landmark.
+ */
+template <typename Length, typename Graph, typename WeightMap,
+          typename IndexMap, typename RandomEngine>
+std::vector<landmark_distances<Length>>
+avoid_landmarks(const Graph &G, WeightMap weight, IndexMap index,
+                std::size_t count, RandomEngine &engine) {
+  using namespace boost;
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto n = num_vertices(G);
+  auto selected = std::vector<landmark_distances<Length>>{};
+  auto distance = std::vector<Length>{};
+  auto predecessor = std::vector<std::size_t>{};
+  auto children = std::vector<std::vector<std::size_t>>(n);
+  auto size = std::vector<double>(n);
+  auto has_landmark = std::vector<bool>(n);
+  auto order = std::vector<std::size_t>{};
+
+  for (std::size_t i = 0; i < count && i < n; ++i) {
+    auto root = random_non_landmark(selected, n, engine);
+    landmark_search(G, weight, index, root, distance, predecessor);
+
+    // Shortest path tree of root
+    for (auto &c : children) {
+      c.clear();
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+      if (v != root && distance[v] != inf) {
+        children[predecessor[v]].push_back(v);
+      }
+    }
+
+    // Pre-order visit of the tree, so that children follow their parent
+    order.assign(1, root);
+    for (std::size_t j = 0; j < order.size(); ++j) {
+      auto const &c = children[order[j]];
+      order.insert(order.end(), c.begin(), c.end());
+    }
+
+    std::fill(has_landmark.begin(), has_landmark.end(), false);
+    for (auto const &l : selected) {
+      has_landmark[l.landmark] = true;
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      auto v = *it;
+      size[v] = static_cast<double>(distance[v]) -
+                static_cast<double>(selected_bound(selected, root, v));
+      for (auto c : children[v]) {
+        has_landmark[v] = has_landmark[v] || has_landmark[c];
+        size[v] += size[c];
+      }
+    }
+    for (auto v : order) {
+      if (has_landmark[v]) {
+        size[v] = 0;
+      }
+    }
+
+    auto next = *std::max_element(
+        order.begin(), order.end(),
+        [&size](auto u, auto v) { return size[u] < size[v]; });
+    if (size[next] <= 0) {
+      // The tree of root is already covered: fall back to a random vertex
+      next = random_non_landmark(selected, n, engine);
+    } else {
+      while (!children[next].empty()) {
+        next = *std::max_element(
+            children[next].begin(), children[next].end(),
+            [&size](auto u, auto v) { return size[u] < size[v]; });
+      }
+    }
+
+    selected.push_back(
+        compute_landmark_distances<Length>(G, weight, index, next));
+  }
+  return selected;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_LANDMARKS_IMPL_HPP
@@ -0,0 +1,126 @@
+/**
+ * @file mapped_file.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_MAPPED_FILE_HPP
+#define ALTERNATIVE_ROUTING_LIB_MAPPED_FILE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                          Memory-mapped files
+//===----------------------------------------------------------------------===//
+
+/**
+ * A read-only, private memory mapping of a whole file.
+ *
+ * Pages are loaded on first access and shared with the page cache, so a
+ * large precomputed structure can be opened in constant time and shared by
+ * several processes. The mapping is released on destruction.
+ */
+class mapped_file {
+public:
+  /**
+   * Map the file at @p path.
+   *
+   * @param path The path of the file.
+   * @throw std::system_error if the file cannot be opened or mapped.
+   */
+  explicit mapped_file(std::string const &path) {
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::system_error{errno, std::generic_category(),
+                              "Cannot open " + path};
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == -1) {
+      auto error = errno;
+      ::close(fd);
+      throw std::system_error{error, std::generic_category(),
+                              "Cannot stat " + path};
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    if (length > 0) {
+      auto addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(),
+                                "Cannot map " + path};
+      }
+      base = static_cast<char const *>(addr);
+    }
+    // The mapping outlives the descriptor
+    ::close(fd);
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+  mapped_file(mapped_file &&other) noexcept
+      : base{std::exchange(other.base, nullptr)},
+        length{std::exchange(other.length, 0)} {}
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    std::swap(base, other.base);
+    std::swap(length, other.length);
+    return *this;
+  }
+  ~mapped_file() {
+    if (base != nullptr) {
+      ::munmap(const_cast<char *>(base), length);
+    }
+  }
+
+  /**
+   * @return The first byte of the file. Page-aligned.
+   */
+  char const *data() const { return base; }
+  /**
+   * @return The size of the file in bytes.
+   */
+  std::size_t size() const { return length; }
+
+private:
+  char const *base = nullptr;
+  std::size_t length = 0;
+};
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_MAPPED_FILE_HPP
@@ -36,12 +36,18 @@
 #include <boost/graph/properties.hpp>
 
 #include <arlib/details/arlib_utils.hpp>
+#include <arlib/edge_index.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
+#include <arlib/terminators.hpp>
 #include <arlib/type_traits.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <queue>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -69,7 +75,8 @@ namespace details {
  * Labels can either be @c head labels if they are attached to source node, or
  * have a predecessor label, i.e. they are attached to a node @c n such that
  * there exist a label attached to a node @c n' and an edge <tt>(n', n)</tt> in
- * Graph.
+ * Graph. Such labels keep that edge, so the path is rebuilt in O(1) per edge
+ * and on multigraphs it is made of the very edges that were expanded.
  *
  * @tparam Graph A Boost::Graph
  * @tparam Vertex A vertex of Graph.
@@ -83,6 +90,7 @@ private:
   Length length;
   Length lower_bound;
   OnePassLabel *previous;
+  Edge incoming;
   std::vector<double> similarity_map;
   int k;
   int checked_at_step;
@@ -117,15 +125,17 @@ public:
    *        this label to the source's one.
    * @param lower_bound AStar heuristic of the distance of @p node from target.
    * @param previous Predecessor label.
+   * @param incoming The edge from the node of @p previous to @p node.
    * @param k Number of k alternative paths to compute.
    * @param checked_at_step The current time step (i.e. the number of
    *        alternative paths currently computed)
    */
   OnePassLabel(Vertex node, Length length, Length lower_bound,
-               OnePassLabel *previous, int k, int checked_at_step)
-      : node{node}, length{length},
-        lower_bound{lower_bound}, previous{previous},
-        similarity_map(k, 0), k{k}, checked_at_step{checked_at_step} {}
+               OnePassLabel *previous, Edge incoming, int k,
+               int checked_at_step)
+      : node{node}, length{length}, lower_bound{lower_bound},
+        previous{previous}, incoming{incoming}, similarity_map(k, 0), k{k},
+        checked_at_step{checked_at_step} {}
 
   /**
    * Construct a new OnePass Label object with no predecessor (i.e. a @c
@@ -142,26 +152,18 @@ public:
   OnePassLabel(Vertex node, Length length, Length lower_bound, int k,
                int checked_at_step)
       : node{node}, length{length}, lower_bound{lower_bound}, previous{nullptr},
-        similarity_map(k, 0), k{k}, checked_at_step{checked_at_step} {}
+        incoming{}, similarity_map(k, 0), k{k},
+        checked_at_step{checked_at_step} {}
 
-  std::vector<Edge> get_path(Graph const &G) const {
-    using namespace boost;
+  /**
+   * @return The edges of the path from this label back to the head label.
+   */
+  std::vector<Edge> get_path() const {
     auto edge_set = std::vector<Edge>{};
-
-    auto v = node;
-    auto prev = previous;
-    while (prev != nullptr) {
-      auto u = prev->node;
-      auto [e, is_ok] = edge(u, v, G);
-      assert(is_ok &&
-             "[arlib::details::OnePassLabel::get_path] Edge not found.");
-      edge_set.push_back(e);
-
-      // Shift label pointer back
-      v = u;
-      prev = prev->previous;
+    for (auto label = this; label->previous != nullptr;
+         label = label->previous) {
+      edge_set.push_back(label->incoming);
     }
-
     return edge_set;
   }
 
@@ -400,6 +402,48 @@ private:
  *
  * @tparam Graph A Boost::Graph
  */
+/**
+ * The alternative paths crossing each edge of a graph. Edges are looked up
+ * in a flat array over their dense_edge_index, holding the position of the
+ * list of paths of each edge crossed by some.
+ *
+ * @tparam Graph A Boost::IncidenceGraph with a vertex index.
+ * @tparam resPathIndex The index of an alternative path.
+ */
+template <typename Graph, typename resPathIndex> class ResEdgesMap {
+public:
+  using key_type = edge_of_t<Graph>;
+  using mapped_type = std::vector<resPathIndex>;
+
+  explicit ResEdgesMap(const Graph &G) : slot{G, 0}, paths{} {}
+
+  /**
+   * @param e An edge of the graph.
+   * @return The alternative paths crossing @p e, or nullptr if none does.
+   */
+  const mapped_type *find(const key_type &e) const {
+    auto i = slot[e];
+    return i == 0 ? nullptr : &paths[i - 1];
+  }
+
+  /**
+   * Record that the alternative path @p path crosses @p e.
+   */
+  void add(const key_type &e, resPathIndex path) {
+    auto &i = slot[e];
+    if (i == 0) {
+      paths.emplace_back();
+      i = static_cast<std::uint32_t>(paths.size());
+    }
+    paths[i - 1].push_back(path);
+  }
+
+private:
+  // 1 + the position in paths, or 0 for edges not crossed
+  edge_map<Graph, std::uint32_t> slot;
+  std::vector<mapped_type> paths;
+};
+
 template <typename Graph, typename Length> struct OnePassPlusASComparator {
   using LabelPtr = OnePassLabel<Graph, Length> *;
 
@@ -416,17 +460,10 @@ template <typename Graph, typename EdgeMap,
           typename resPathIndex = typename EdgeMap::mapped_type::size_type>
 void update_res_edges(const Graph &candidate, const Graph &graph,
                       EdgeMap &resEdges, resPathIndex paths_count) {
-  using mapped_type = typename EdgeMap::mapped_type;
   for (auto ei = edges(candidate).first; ei != edges(candidate).second; ++ei) {
     auto edge_in_g =
         edge(source(*ei, candidate), target(*ei, candidate), graph).first;
-
-    auto search = resEdges.find(edge_in_g);
-    if (search != std::end(resEdges)) { // edge found
-      search->second.push_back(paths_count - 1);
-    } else { // new edge, add it to resEdges
-      resEdges.insert(std::make_pair(edge_in_g, mapped_type{paths_count - 1}));
-    }
+    resEdges.add(edge_in_g, paths_count - 1);
   }
 }
 
@@ -434,33 +471,24 @@ template <typename EdgeMap, typename Edge,
           typename resPathIndex = typename EdgeMap::mapped_type::size_type>
 void update_res_edges(const std::vector<Edge> &candidate, EdgeMap &resEdges,
                       resPathIndex paths_count) {
-  using mapped_type = typename EdgeMap::mapped_type;
   for (auto &e : candidate) {
-
-    auto search = resEdges.find(e);
-    if (search != std::end(resEdges)) { // edge found
-      search->second.push_back(paths_count - 1);
-    } else { // new edge, add it to resEdges
-      resEdges.insert(std::make_pair(e, mapped_type{paths_count - 1}));
-    }
+    resEdges.add(e, paths_count - 1);
   }
 }
 
-template <typename Label, typename Graph, typename EdgesMap, typename PathsMap,
+template <typename Label, typename EdgesMap, typename PathsMap,
           typename WeightMap>
-bool update_label_similarity(Label &label, const Graph &G,
-                             const EdgesMap &resEdges, const PathsMap &resPaths,
-                             WeightMap &weight, double theta,
-                             std::size_t step) {
+bool update_label_similarity(Label &label, const EdgesMap &resEdges,
+                             const PathsMap &resPaths, WeightMap &weight,
+                             double theta, std::size_t step) {
   using namespace boost;
   bool below_sim_threshold = true;
-  auto tmpPath = label.get_path(G);
+  auto tmpPath = label.get_path();
   for (auto &e : tmpPath) {
-    auto search = resEdges.find(e);
     // if tmpPath share an edge with any k-th shortest path, update the
     // overlapping factor
-    if (search != std::end(resEdges)) {
-      for (auto index : search->second) {
+    if (auto paths = resEdges.find(e)) {
+      for (auto index : *paths) {
         if (static_cast<int>(index) > label.last_check() && index < step) {
           label.get_similarity_with(index) += weight[e];
 
@@ -480,14 +508,15 @@ bool update_label_similarity(Label &label, const Graph &G,
   return below_sim_threshold;
 }
 
-template <typename Label, typename Vertex = typename Label::Vertex,
+template <typename Label, typename Edge,
+          typename Vertex = typename Label::Vertex,
           typename length_type = typename Label::length_type>
-std::unique_ptr<Label> expand_path(Label *label, Vertex node,
+std::unique_ptr<Label> expand_path(Label *label, Vertex node, Edge const &e,
                                    length_type node_lower_bound,
                                    length_type edge_weight, int step) {
   auto tmpLength = label->get_length() + edge_weight;
   auto tmpLowerBound = tmpLength + node_lower_bound;
-  return std::make_unique<Label>(node, tmpLength, tmpLowerBound, label,
+  return std::make_unique<Label>(node, tmpLength, tmpLowerBound, label, e,
                                  label->num_paths_k(), step);
 }
 
@@ -497,10 +526,8 @@ bool is_below_sim_threshold(const Edge &c_edge,
                             std::vector<double> &similarity_map, double theta,
                             const EdgesMap &resEdges, const PathsList &resPaths,
                             const WeightMap &weight) {
-  auto search = resEdges.find(c_edge);
-  if (search != std::end(resEdges)) {
-    auto &res_paths_with_c_edge = search->second;
-    for (auto index : res_paths_with_c_edge) {
+  if (auto res_paths_with_c_edge = resEdges.find(c_edge)) {
+    for (auto index : *res_paths_with_c_edge) {
       similarity_map[index] += weight[c_edge];
       auto const &alt_path = resPaths[index];
       auto alt_len =
@@ -513,6 +540,198 @@ bool is_below_sim_threshold(const Edge &c_edge,
   }
   return true;
 }
+
+//===----------------------------------------------------------------------===//
+//                          OnePass+ algorithm
+//===----------------------------------------------------------------------===//
+
+/**
+ * The OnePass+ algorithm, pruning labels with the lower bounds of
+ * @p heuristic.
+ *
+ * @see arlib::onepass_plus(const Graph &G, WeightMap weight,
+ *                          MultiPredecessorMap &predecessors, Vertex s,
+ *                          Vertex t, int k, double theta)
+ *
+ * @tparam Heuristic A callable returning a lower bound on the distance of a
+ *         vertex from @p t.
+ * @param heuristic The lower bounds.
+ * @param shortest_path If not null, a shortest path from @p s to @p t already
+ *        known, e.g. from a query_context, so that it is not searched again.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Heuristic, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, Heuristic const &heuristic,
+                  Terminator &&terminator,
+                  std::vector<edge_of_t<Graph>> const *shortest_path =
+                      nullptr) {
+  using namespace boost;
+  using Edge = typename graph_traits<Graph>::edge_descriptor;
+  using Length = typename boost::property_traits<WeightMap>::value_type;
+
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((LvaluePropertyMapConcept<WeightMap, Edge>));
+  BOOST_CONCEPT_ASSERT(
+      (ReadablePropertyMapConcept<MultiPredecessorMap, Vertex>));
+
+  auto resPathsEdges = std::vector<std::vector<Edge>>{};
+
+  // resEdges keeps track of the edges that make the paths in resPaths and which
+  // path includes it.
+  using resPathIndex = typename decltype(resPathsEdges)::size_type;
+  auto resEdges = ResEdgesMap<Graph, resPathIndex>{G};
+
+  // Min-priority queue
+  using Label = OnePassLabel<Graph, Length>;
+  using LabelPtr = std::unique_ptr<Label>;
+  auto Q =
+      std::priority_queue<Label *, std::vector<Label *>,
+                          OnePassPlusASComparator<Graph, Length>>{};
+  auto created_labels = std::vector<LabelPtr>{};
+
+  // Skyline for dominance checkind (Lemma 2)
+  auto skyline = SkylineContainer<Graph, Length>{};
+
+  // Compute shortest path from s to t, unless it is known already
+  auto sp_path = shortest_path
+                     ? std::make_optional(*shortest_path)
+                     : compute_shortest_path(G, weight, s, t);
+  if (!sp_path) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << t << " is unreachable from " << s;
+    throw target_not_found{oss.str()};
+  }
+
+  // P_LO <-- {shortest path p_0(s, t)};
+  resPathsEdges.push_back(*sp_path);
+  resPathIndex paths_count = 1;
+
+  // If we need the shortest path only
+  if (k == 1) {
+    fill_multi_predecessor(resPathsEdges.begin(), resPathsEdges.end(),
+                                    G, predecessors);
+    return;
+  }
+
+  // For each edge in the candidate path, we check if it's already in any of the
+  // resPaths. If not, we add it to resEdges. If yes, we keep track of which
+  // path includes it.
+  update_res_edges(*sp_path, resEdges, paths_count);
+
+  // No alternative is longer than radius
+  auto radius = stretch_radius(
+      stretch_bound(terminator),
+      compute_length_from_edges(sp_path->begin(), sp_path->end(), weight));
+
+  // Initialize min-priority queue Q with <s, empty_set>
+  auto init_label =
+      std::make_unique<Label>(s, 0, heuristic(s), k, paths_count - 1);
+  Q.push(init_label.get());
+  created_labels.push_back(std::move(init_label));
+
+  // While Q is not empty
+  while (!Q.empty()) {
+    // The remainder code is the hot part of the algorithm. So we check here
+    // if the algorithm should terminate
+    if (terminator.should_stop()) {
+      throw terminator_stop_error{
+          "OnePass+ terminated before completing due to a Terminator. Please "
+          "discard partial output."};
+    }
+
+    // Current path
+    auto label = Q.top();
+    Q.pop();
+
+    // Perform lazy update of the similairty vector of 'label', since new paths
+    // might have been added to P_LO from the time this 'label' was pushed into
+    // priority queue.
+    if (label->is_outdated(paths_count - 1)) {
+      bool below_sim_threshold = update_label_similarity(
+          *label, resEdges, resPathsEdges, weight, theta, paths_count);
+
+      label->set_last_check(paths_count - 1); // Update last check time step
+      if (!below_sim_threshold) {
+        continue; // Skip candidate path
+      }
+    }
+
+    // If we found the target node
+    if (label->get_node() == t) {
+      // Build the new k-th shortest path
+      resPathsEdges.push_back(label->get_path());
+
+      auto &tmpPath = resPathsEdges.back();
+      ++paths_count;
+
+      if (static_cast<int>(paths_count) == k) { // we found k paths. End.
+        // Add computed alternatives to resPaths
+        fill_multi_predecessor(resPathsEdges.begin(),
+                                        resPathsEdges.end(), G, predecessors);
+        break;
+      }
+
+      // For each edge in the candidate path see if it's already in any of the
+      // P_LO paths. If not, add it to the resEdges. If so, keep track of which
+      // path includes it
+      update_res_edges(tmpPath, resEdges, paths_count);
+
+    } else { // Expand Search
+      if (skyline.dominates(*label)) {
+        continue; // Prune path by Lemma 2
+      }
+
+      skyline.insert(label);
+      auto node_n = label->get_node();
+      // For each outgoing edge
+      for (auto [out_it, out_end] = out_edges(node_n, G); out_it != out_end;
+           ++out_it) {
+        // Expand path
+        auto const &c_edge = *out_it;
+        auto c_node = target(c_edge, G);
+        auto c_lower_bound = heuristic(c_node);
+
+        // Drop paths that cannot reach t within radius
+        if (c_lower_bound == std::numeric_limits<Length>::max() ||
+            static_cast<double>(label->get_length()) + weight[c_edge] +
+                    c_lower_bound >
+                static_cast<double>(radius)) {
+          continue;
+        }
+
+        auto c_label = expand_path(label, c_node, c_edge, c_lower_bound,
+                                   weight[c_edge], paths_count - 1);
+
+        // Check for acyclicity
+        bool acyclic = label->is_path_acyclic(c_node);
+
+        if (acyclic) {
+          auto c_similarity_map = label->get_similarity_map();
+
+          // Check Lemma 1 for similarity thresholding
+          bool below_sim_threshold = is_below_sim_threshold(
+              c_edge, c_similarity_map, theta, resEdges, resPathsEdges, weight);
+
+          if (below_sim_threshold) {
+            c_label->set_similarities(std::begin(c_similarity_map),
+                                      std::end(c_similarity_map));
+            Q.push(c_label.get());
+            created_labels.push_back(std::move(c_label));
+          }
+        }
+      }
+    }
+  }
+
+  if (static_cast<int>(paths_count) != k) {
+    // Add computed alternatives to resPaths
+    fill_multi_predecessor(resPathsEdges.begin(), resPathsEdges.end(),
+                                    G, predecessors);
+  }
+}
 } // namespace details
 } // namespace arlib
 
@@ -39,15 +39,30 @@
 #include <boost/property_map/function_property_map.hpp>
 #include <boost/property_map/property_map.hpp>
 
+#include <arlib/customizable_contraction_hierarchy.hpp>
 #include <arlib/details/arlib_utils.hpp>
+#include <arlib/edge_index.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/routing_kernels/bidirectional_alt.hpp>
 #include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/cch_query.hpp>
+#include <arlib/routing_kernels/parallel_bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/phast.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
 #include <arlib/routing_kernels/types.hpp>
 #include <arlib/terminators.hpp>
+#include <arlib/thread_pool.hpp>
 #include <arlib/type_traits.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <queue>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -78,6 +93,29 @@ using PenBoundsMap = std::unordered_map<Edge, int, boost::hash<Edge>>;
 template <typename Edge, typename Length>
 using WeightMap = std::unordered_map<Edge, Length, boost::hash<Edge>>;
 
+/**
+ * @param penalty_bounds A PenBoundsMap.
+ * @param e An edge.
+ * @return The number of times @p e has been penalized so far.
+ */
+template <typename Edge>
+int times_penalized(const PenBoundsMap<Edge> &penalty_bounds, const Edge &e) {
+  auto search = penalty_bounds.find(e);
+  return search != std::end(penalty_bounds) ? search->second : 0;
+}
+
+/**
+ * @param penalty_bounds A map from each edge to the number of times it has
+ *        been penalized so far.
+ * @param e An edge.
+ * @return The number of times @p e has been penalized so far.
+ */
+template <typename Graph>
+int times_penalized(const edge_map<Graph, int> &penalty_bounds,
+                    const edge_of_t<Graph> &e) {
+  return penalty_bounds[e];
+}
+
 /**
  * A vector for tracking distance of a vertex from the source.
  *
@@ -96,13 +134,26 @@ template <typename Length> using DistanceMap = std::vector<Length>;
  * A functor to return the penalized weight of an edge, to avoid changing
  * the original graph weights.
  *
+ * Penalized weights are kept in a hash table keyed by edges or, given the
+ * dense_edge_index of the graph, in a flat array indexed by it.
+ *
  * @tparam PMap A Weight Property Map.
+ * @tparam EdgeIndex void, or a dense_edge_index.
  */
-template <typename PMap> class penalty_functor {
+template <typename PMap, typename EdgeIndex = void> class penalty_functor {
 public:
   using Edge = typename boost::property_traits<PMap>::key_type;
   using Length = double;
 
+private:
+  static constexpr bool hashed = std::is_void_v<EdgeIndex>;
+  using IndexMap = std::conditional_t<hashed, std::nullptr_t, EdgeIndex>;
+  // Edges not penalized yet are NaN in the flat array, and missing from the
+  // hash table
+  using Penalties =
+      std::conditional_t<hashed, WeightMap<Edge, Length>, std::vector<Length>>;
+
+public:
   /**
    * Construct a new penalty functor object.
    *
@@ -110,24 +161,38 @@ public:
    * @param weight The weight property map.
    */
   penalty_functor(PMap weight)
-      : weight{weight}, penalties{std::make_shared<WeightMap<Edge, Length>>()} {
-  }
+      : weight{weight}, index{}, penalties{std::make_shared<Penalties>()} {}
+
+  /**
+   * Construct a new penalty functor object keeping penalized weights in a
+   * flat array.
+   *
+   * @param weight The weight property map.
+   * @param index The dense_edge_index of the graph.
+   */
+  penalty_functor(PMap weight, IndexMap index)
+      : weight{weight}, index{index},
+        penalties{std::make_shared<Penalties>(
+            index.size(), std::numeric_limits<Length>::quiet_NaN())} {}
 
   /**
    * Copy constructor.
    *
    * @param other The penalty functor to copy from
    */
-  penalty_functor(const penalty_functor<PMap> &other)
-      : weight{other.weight}, penalties{other.penalties} {}
+  penalty_functor(const penalty_functor &other)
+      : weight{other.weight}, index{other.index}, penalties{other.penalties} {}
 
   /**
    * Returns the penalized weight of an edge.
    *
+   * Const access never modifies the functor, so concurrent reads are safe as
+   * long as no thread writes through operator[].
+   *
    * @param e The query edge.
    * @return The penalized weight for @p e.
    */
-  const Length &operator()(const Edge &e) const { return get_or_insert(e); }
+  Length operator()(const Edge &e) const { return get(e); }
 
   /**
    * Returns the penalized weight of an edge.
@@ -143,74 +208,97 @@ public:
    * @param e The query edge.
    * @return The penalized weight for @p e.
    */
-  const Length &operator[](const Edge &e) const { return get_or_insert(e); }
+  Length operator[](const Edge &e) const { return get(e); }
 
   penalty_functor clone() const {
     auto pf = *this;
-    pf.penalties = std::make_shared<WeightMap<Edge, Length>>(*penalties);
+    pf.penalties = std::make_shared<Penalties>(*penalties);
     return pf;
   }
 
 private:
   PMap weight;
-  mutable std::shared_ptr<WeightMap<Edge, Length>> penalties;
+  IndexMap index;
+  std::shared_ptr<Penalties> penalties;
 
-  Length &get_or_insert(const Edge &e) const {
-    if (auto search = penalties->find(e); search != penalties->end()) {
-      return search->second;
+  Length get(const Edge &e) const {
+    if constexpr (hashed) {
+      if (auto search = penalties->find(e); search != penalties->end()) {
+        return search->second;
+      }
+      return weight[e];
     } else {
-      auto [it, ok] = penalties->insert({e, weight[e]});
-      assert(ok && "[kspwlo::penalty_functor] Could not insert edge weight");
-      return it->second;
+      auto w = (*penalties)[index[e]];
+      return std::isnan(w) ? static_cast<Length>(weight[e]) : w;
+    }
+  }
+
+  Length &get_or_insert(const Edge &e) {
+    if constexpr (hashed) {
+      if (auto search = penalties->find(e); search != penalties->end()) {
+        return search->second;
+      } else {
+        auto [it, ok] = penalties->insert({e, weight[e]});
+        assert(ok && "[kspwlo::penalty_functor] Could not insert edge weight");
+        return it->second;
+      }
+    } else {
+      auto &w = (*penalties)[index[e]];
+      if (std::isnan(w)) {
+        w = weight[e];
+      }
+      return w;
     }
   }
 };
 
-template <typename PMap, typename Graph> class reverse_penalty_functor {
+template <typename PMap, typename EdgeIndex>
+penalty_functor(PMap, EdgeIndex) -> penalty_functor<PMap, EdgeIndex>;
+
+/**
+ * The penalty_functor of the weights @p PMap of @p Graph, keeping penalized
+ * weights in a flat array.
+ */
+template <typename Graph, typename PMap>
+using flat_penalty_functor = penalty_functor<PMap, dense_edge_index<Graph>>;
+
+/**
+ * A functor exposing the penalized weights of a forward graph to a search
+ * running on its `boost::reverse_graph`. Reverse edges are mapped to forward
+ * ones through forward_edge_map, so each weight read is O(1).
+ *
+ * @tparam PMap A Weight Property Map.
+ * @tparam Graph The forward graph type.
+ */
+template <typename PMap, typename EdgeIndex, typename Graph>
+class reverse_penalty_functor {
 public:
   using Edge = typename boost::graph_traits<
       boost::reverse_graph<Graph>>::edge_descriptor;
   using Length = double;
 
-  reverse_penalty_functor(penalty_functor<PMap> &penalty, const Graph &G,
+  reverse_penalty_functor(penalty_functor<PMap, EdgeIndex> &penalty,
+                          const Graph &,
                           const boost::reverse_graph<Graph> &rev_G)
-      : inner_pf{penalty}, G{G}, rev_G{rev_G} {}
+      : inner_pf{penalty}, forward_edge{get_forward_edge_map(rev_G)} {}
 
   reverse_penalty_functor(reverse_penalty_functor const &other)
-      : inner_pf{other.inner_pf}, G{other.G}, rev_G{other.rev_G} {}
-
-  const Length &operator()(const Edge &e) const {
-    auto forward_edge = get_forward_edge(e);
+      : inner_pf{other.inner_pf}, forward_edge{other.forward_edge} {}
 
-    return inner_pf(forward_edge);
+  Length operator()(const Edge &e) const {
+    return inner_pf(get(forward_edge, e));
   }
 
-  Length &operator[](const Edge &e) {
-    auto forward_edge = get_forward_edge(e);
+  Length &operator[](const Edge &e) { return inner_pf[get(forward_edge, e)]; }
 
-    return inner_pf[forward_edge];
-  }
-
-  const Length &operator[](const Edge &e) const {
-    auto forward_edge = get_forward_edge(e);
-
-    return inner_pf[forward_edge];
+  Length operator[](const Edge &e) const {
+    const auto &pf = inner_pf;
+    return pf[get(forward_edge, e)];
   }
 
 private:
-  auto get_forward_edge(const Edge &e) const {
-    using namespace boost;
-    auto u = source(e, rev_G);
-    auto v = target(e, rev_G);
-
-    auto [forward_edge, is_valid] = edge(v, u, G);
-    assert(is_valid);
-    return forward_edge;
-  }
-
-  penalty_functor<PMap> &inner_pf;
-  const Graph &G;
-  const boost::reverse_graph<Graph> &rev_G;
+  penalty_functor<PMap, EdgeIndex> &inner_pf;
+  forward_edge_map<Graph> forward_edge;
 };
 
 //===----------------------------------------------------------------------===//
@@ -230,6 +318,8 @@ private:
  * @param t The target vertex.
  * @param distance_s A map from Vertex to its distance from @p s
  * @param distance_t A map from Vertex to its distance from @p t
+ * @param pool If not null, the backward search runs Delta-stepping on its
+ *        threads.
  * @return A vector of the edges of the shortest path from s to t.
  *         An empty optional if t is not reachable from s.
  */
@@ -239,7 +329,8 @@ template <typename Graph, typename Vertex = vertex_of_t<Graph>,
 std::optional<std::vector<Edge>>
 dijkstra_shortest_path_two_ways(const Graph &G, Vertex s, Vertex t,
                                 DistanceMap<Length> &distance_s,
-                                DistanceMap<Length> &distance_t) {
+                                DistanceMap<Length> &distance_t,
+                                thread_pool *pool = nullptr) {
   using namespace boost;
 
   auto predecessor = std::vector<Vertex>(num_vertices(G), s);
@@ -254,7 +345,12 @@ dijkstra_shortest_path_two_ways(const Graph &G, Vertex s, Vertex t,
 
   // Backward step
   auto rev_G = make_reverse_graph(G);
-  dijkstra_shortest_paths(rev_G, t, distance_map(&distance_t[0]));
+  if (pool && pool->size() > 1) {
+    delta_stepping(rev_G, t, get(edge_weight, rev_G), get(vertex_index, rev_G),
+                   &distance_t[0], *pool);
+  } else {
+    dijkstra_shortest_paths(rev_G, t, distance_map(&distance_t[0]));
+  }
 
   if (exists_path_to<Length>(t, distance_s)) {
     return std::make_optional(edge_list);
@@ -266,107 +362,254 @@ dijkstra_shortest_path_two_ways(const Graph &G, Vertex s, Vertex t,
 
 } // namespace kspwlo_impl
 
+/**
+ * Computes the shortest path between two vertices s and t, and the distances
+ * from s and to t of every vertex, with two PHAST sweeps of @p ph instead of
+ * two Dijkstra's searches of the whole graph.
+ *
+ * The path is traced back from t along edges whose weight matches the
+ * difference of distances from s. Should zero-weight cycles lead this walk
+ * into a dead end, it falls back to dijkstra_shortest_path_two_ways().
+ *
+ * @see dijkstra_shortest_path_two_ways()
+ *
+ * @param ph The PHAST layout of a contraction hierarchy of @p G, built on
+ *        its `boost::edge_weight_t` property.
+ * @param pool If not null, the threads to sweep on.
+ */
+template <typename Graph, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
+std::optional<std::vector<Edge>>
+phast_shortest_path_two_ways(const Graph &G, Vertex s, Vertex t,
+                             DistanceMap<Length> &distance_s,
+                             DistanceMap<Length> &distance_t,
+                             phast_hierarchy<Length> const &ph,
+                             thread_pool *pool = nullptr) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<Graph>));
+
+  auto index = get(vertex_index, G);
+  auto weight = get(edge_weight, G);
+  auto workspace = PHASTWorkspace<Length>{num_vertices(G)};
+  phast_from(ph, get(index, s), distance_s.begin(), workspace, pool);
+  phast_to(ph, get(index, t), distance_t.begin(), workspace, pool);
+  if (!exists_path_to<Length>(t, distance_s)) {
+    return std::optional<std::vector<Edge>>{};
+  }
+
+  // Sums along shortcuts may round differently from sums along edges
+  auto tight = [](Length via, Length d) {
+    if constexpr (std::is_floating_point_v<Length>) {
+      return std::abs(via - d) <= 1e-9 * std::max(Length{1}, d);
+    } else {
+      return via == d;
+    }
+  };
+  auto edge_list = std::vector<Edge>{};
+  auto visited = std::vector<bool>(num_vertices(G), false);
+  visited[get(index, t)] = true;
+  for (auto v = t; v != s;) {
+    auto next = std::optional<Edge>{};
+    for (auto [it, end] = in_edges(v, G); it != end && !next; ++it) {
+      auto u = get(index, source(*it, G));
+      if (!visited[u] &&
+          distance_s[u] != std::numeric_limits<Length>::max() &&
+          tight(distance_s[u] + get(weight, *it), distance_s[get(index, v)])) {
+        next = *it;
+      }
+    }
+    if (!next) {
+      return dijkstra_shortest_path_two_ways(G, s, t, distance_s, distance_t,
+                                             pool);
+    }
+    edge_list.push_back(*next);
+    v = source(*next, G);
+    visited[get(index, v)] = true;
+  }
+  return std::make_optional(edge_list);
+}
+
 /**
  * Computes the Dijkstra shortest path from s to t using a
  *        penalty_functor to gather edges weight instead of the Graph's weight
- *        property map
+ *        property map, running on a reusable SearchWorkspace.
  *
  * @tparam Graph A Boost::PropertyGraph having at least one edge
  *               property with tag boost::edge_weight_t.
  * @tparam PMap The graph's weight property map.
  * @tparam Vertex A vertex_descriptor.
  * @tparam Edge An edge_descriptor.
- * @tparam Length The edge weight type.
  * @param G The graph
  * @param s The source vertex
  * @param t The target vertex
  * @param penalty A penalty_functor
+ * @param workspace The memory to run the search on.
  * @return A vector of the edges of the shortest path from s to t.
  *         An empty optional if t is not reachable from s.
  */
-template <typename Graph, typename PMap, typename Vertex = vertex_of_t<Graph>,
-          typename Edge = edge_of_t<Graph>,
-          typename Length = length_of_t<Graph>>
+template <typename Graph, typename PMap, typename EdgeIndex, typename Vertex,
+          typename QueuePolicy, typename TreeEdge,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty,
+    SearchWorkspace<Vertex, double, QueuePolicy, TreeEdge> &workspace) {
+  using namespace boost;
+  auto weight = make_function_property_map<Edge, double>(std::cref(penalty));
+  return workspace_shortest_path(G, G, s, t, weight, get(vertex_index, G),
+                                 zero_potential{}, workspace);
+}
+
+/**
+ * Computes the Dijkstra shortest path from s to t using a
+ *        penalty_functor to gather edges weight instead of the Graph's weight
+ *        property map
+ *
+ * @see dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
+ *                             penalty_functor<PMap, EdgeIndex> &penalty,
+ *                             SearchWorkspace<Vertex, double, QueuePolicy,
+ *                                             TreeEdge> &workspace)
+ */
+template <typename Graph, typename PMap, typename EdgeIndex,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
 std::optional<std::vector<Edge>>
 dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
-                       penalty_functor<PMap> &penalty) {
+                       penalty_functor<PMap, EdgeIndex> &penalty) {
+  auto workspace = PathWorkspace<Graph, double>{num_vertices(G)};
+  return dijkstra_shortest_path(G, s, t, penalty, workspace);
+}
+
+/**
+ * Computes the A* shortest path from s to t using a penalty_functor to
+ * gather edges weight, running on a reusable SearchWorkspace.
+ *
+ * Penalties only make weights heavier, so a consistent heuristic of the
+ * original weights stays consistent.
+ *
+ * @see dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
+ *                             penalty_functor<PMap, EdgeIndex> &penalty,
+ *                             SearchWorkspace<Vertex, double, QueuePolicy,
+ *                                             TreeEdge> &workspace)
+ *
+ * @param heuristic The consistent A* heuristic.
+ */
+template <typename Graph, typename PMap, typename EdgeIndex,
+          typename AStarHeuristic, typename Vertex, typename QueuePolicy,
+          typename TreeEdge,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> astar_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty,
+    const AStarHeuristic &heuristic,
+    SearchWorkspace<Vertex, double, QueuePolicy, TreeEdge> &workspace) {
   using namespace boost;
+  auto weight = make_function_property_map<Edge, double>(std::cref(penalty));
+  return workspace_shortest_path(G, G, s, t, weight, get(vertex_index, G),
+                                 heuristic, workspace);
+}
 
-  auto predecessor = std::vector<Vertex>(num_vertices(G), s);
-  auto vertex_id = get(vertex_index, G);
+template <typename Graph, typename PMap, typename EdgeIndex,
+          typename AStarHeuristic, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>>
+astar_shortest_path(const Graph &G, Vertex s, Vertex t,
+                    penalty_functor<PMap, EdgeIndex> &penalty,
+                    const AStarHeuristic &heuristic) {
+  auto workspace = PathWorkspace<Graph, double>{num_vertices(G)};
+  return astar_shortest_path(G, s, t, penalty, heuristic, workspace);
+}
 
-  auto weight = make_function_property_map<Edge>(penalty);
-  try {
-    dijkstra_shortest_paths(
-        G, s,
-        weight_map(weight)
-            .predecessor_map(make_iterator_property_map(std::begin(predecessor),
-                                                        vertex_id, s))
-            .visitor(make_dijkstra_visitor(
-                make_target_visitor(t, on_examine_vertex{}))));
-  } catch (target_found tf) {
-    auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
-    return std::make_optional(edge_list);
-  }
+template <typename Graph, typename PMap, typename EdgeIndex, typename Vertex,
+          typename QueuePolicy, typename Edge>
+std::optional<std::vector<Edge>> bidirectional_dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty,
+    SearchWorkspace<Vertex, double, QueuePolicy, Edge> &workspace) {
+  using namespace boost;
+
+  auto weight = make_function_property_map<Edge, double>(std::cref(penalty));
 
-  // In case t could not be found from astar_search and target_found is not
-  // thrown, return empty optional
-  return std::optional<std::vector<Edge>>{};
+  auto rev_G = make_reverse_graph(G);
+  auto rev_weight_ = reverse_penalty_functor(penalty, G, rev_G);
+  using RevEdge = typename boost::graph_traits<
+      boost::reverse_graph<Graph>>::edge_descriptor;
+  auto rev_weight = make_function_property_map<RevEdge>(rev_weight_);
+
+  return workspace_bidirectional_path(G, G, s, t, weight, rev_G, rev_weight,
+                                      get(vertex_index, G), workspace);
 }
 
-template <typename Graph, typename PMap, typename AStarHeuristic,
+template <typename Graph, typename PMap, typename EdgeIndex,
           typename Vertex = vertex_of_t<Graph>,
-          typename Edge = edge_of_t<Graph>,
-          typename Length = length_of_t<Graph>>
-std::optional<std::vector<Edge>>
-astar_shortest_path(const Graph &G, Vertex s, Vertex t,
-                    penalty_functor<PMap> &penalty,
-                    const AStarHeuristic &heuristic) {
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> bidirectional_dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty) {
+  auto workspace = PathWorkspace<Graph, double>{num_vertices(G)};
+  return bidirectional_dijkstra_shortest_path(G, s, t, penalty, workspace);
+}
+
+template <typename Graph, typename PMap, typename EdgeIndex,
+          typename LandmarkLength, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> bidirectional_alt_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty,
+    landmarks<LandmarkLength> const &lm,
+    BiDijkstraWorkspace<Vertex, double> &workspace) {
   using namespace boost;
-  auto predecessor = std::vector<Vertex>(num_vertices(G), s);
-  auto vertex_id = get(vertex_index, G);
 
-  auto weight = make_function_property_map<Edge>(penalty);
+  // Penalties only make weights heavier, so landmark bounds stay valid.
+  auto index = get(vertex_index, G);
+  auto predecessor_vec = std::vector<Vertex>(num_vertices(G), s);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+  auto weight = make_function_property_map<Edge, double>(std::cref(penalty));
+
+  auto rev_G = make_reverse_graph(G);
+  auto rev_weight_ = reverse_penalty_functor(penalty, G, rev_G);
+  using RevEdge = typename boost::graph_traits<
+      boost::reverse_graph<Graph>>::edge_descriptor;
+  auto rev_weight = make_function_property_map<RevEdge>(rev_weight_);
+
   try {
-    astar_search(G, s, heuristic,
-                 predecessor_map(make_iterator_property_map(
-                                     std::begin(predecessor), vertex_id, s))
-                     .visitor(astar_target_visitor{t})
-                     .weight_map(weight));
-  } catch (target_found &tf) {
-    auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
-    return std::make_optional(edge_list);
+    bidirectional_alt(G, s, t, predecessor, weight, rev_G, rev_weight, index,
+                      lm, workspace);
+  } catch (details::target_not_found &) {
+    // In case t could not be found return empty optional
+    return std::optional<std::vector<Edge>>{};
   }
-  // In case t could not be found from astar_search and target_found is not
-  // thrown, return empty optional
-  return std::optional<std::vector<Edge>>{};
+
+  auto edge_list = build_edge_list_from_dijkstra(G, s, t, predecessor);
+  return std::make_optional(edge_list);
 }
 
-template <typename Graph, typename PMap, typename Vertex = vertex_of_t<Graph>,
-          typename Edge = edge_of_t<Graph>,
-          typename Length = length_of_t<Graph>>
-std::optional<std::vector<Edge>>
-bidirectional_dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
-                                     penalty_functor<PMap> &penalty) {
+template <typename Graph, typename PMap, typename EdgeIndex,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> parallel_bidirectional_dijkstra_shortest_path(
+    const Graph &G, Vertex s, Vertex t,
+    penalty_functor<PMap, EdgeIndex> &penalty) {
   using namespace boost;
 
+  // Both threads only read penalties, which never modifies penalty.
   auto index = get(vertex_index, G);
   auto predecessor_vec = std::vector<Vertex>(num_vertices(G), s);
   auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
-  auto distance_vec = std::vector<Length>(num_vertices(G));
+  auto distance_vec = std::vector<double>(num_vertices(G));
   auto distance = make_iterator_property_map(distance_vec.begin(), index);
-  auto weight = make_function_property_map<Edge>(penalty);
+  auto weight = make_function_property_map<Edge, double>(std::cref(penalty));
 
   auto rev_G = make_reverse_graph(G);
   auto rev_weight_ = reverse_penalty_functor(penalty, G, rev_G);
   using RevEdge = typename boost::graph_traits<
       boost::reverse_graph<Graph>>::edge_descriptor;
   auto rev_weight = make_function_property_map<RevEdge>(rev_weight_);
-  auto rev_index = get(vertex_index, rev_G);
 
   try {
-    bidirectional_dijkstra(G, s, t, predecessor, distance, weight, rev_G,
-                           rev_weight, rev_index);
+    parallel_bidirectional_dijkstra(G, s, t, predecessor, distance, weight,
+                                    rev_G, rev_weight, index);
   } catch (details::target_not_found &) {
     // In case t could not be found return empty optional
     return std::optional<std::vector<Edge>>{};
@@ -376,23 +619,161 @@ bidirectional_dijkstra_shortest_path(const Graph &G, Vertex s, Vertex t,
   return std::make_optional(edge_list);
 }
 
+//===----------------------------------------------------------------------===//
+//                       Compile-time routing kernels
+//===----------------------------------------------------------------------===//
+/**
+ * The routing kernel of Penalty named by a tag: a callable computing a
+ * shortest path on @p G under the current penalties, owning the workspace
+ * that all the queries of a penalty run share.
+ *
+ * @param G The graph.
+ * @return A callable invoked as `kernel(G, s, t, penalty)`.
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::dijkstra_t, const Graph &G) {
+  using Workspace = PathWorkspace<Graph, double>;
+  return [workspace = Workspace{num_vertices(G)}](
+             const auto &G, auto s, auto t, auto &penalty) mutable {
+    return dijkstra_shortest_path(G, s, t, penalty, workspace);
+  };
+}
+
+/**
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G)
+ *
+ * @param heuristic The consistent A* heuristic, which must outlive the
+ *        kernel.
+ */
+template <typename Graph, typename AStarHeuristic>
+auto make_penalty_kernel(kernels::astar_t, const Graph &G,
+                         const AStarHeuristic &heuristic) {
+  using Workspace = PathWorkspace<Graph, double>;
+  return [workspace = Workspace{num_vertices(G)}, &heuristic](
+             const auto &G, auto s, auto t, auto &penalty) mutable {
+    return astar_shortest_path(G, s, t, penalty, heuristic, workspace);
+  };
+}
+
+/**
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G)
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::bidirectional_dijkstra_t, const Graph &G) {
+  using Workspace = PathWorkspace<Graph, double>;
+  return [workspace = Workspace{num_vertices(G)}](
+             const auto &G, auto s, auto t, auto &penalty) mutable {
+    return bidirectional_dijkstra_shortest_path(G, s, t, penalty, workspace);
+  };
+}
+
+/**
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G)
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::parallel_bidirectional_dijkstra_t,
+                         const Graph &) {
+  return [](const auto &G, auto s, auto t, auto &penalty) {
+    return parallel_bidirectional_dijkstra_shortest_path(G, s, t, penalty);
+  };
+}
+
+/**
+ * The routing kernel of Penalty named by @p kernel, guided by @p heuristic
+ * if it is kernels::astar_t.
+ */
+template <typename Kernel, typename Graph, typename AStarHeuristic>
+auto make_penalty_kernel(Kernel kernel, const Graph &G,
+                         const AStarHeuristic &) {
+  return make_penalty_kernel(kernel, G);
+}
+
+/**
+ * The routing kernel of Penalty named by a tag, running on @p workspace
+ * instead of a workspace of its own, so that it is reused across penalty
+ * runs.
+ *
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G)
+ *
+ * @param workspace The workspace of the searches, which must outlive the
+ *        kernel.
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::dijkstra_t, const Graph &,
+                         PathWorkspace<Graph, double> &workspace) {
+  return [&workspace](const auto &G, auto s, auto t, auto &penalty) {
+    return dijkstra_shortest_path(G, s, t, penalty, workspace);
+  };
+}
+
+/**
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G,
+ *                          PathWorkspace<Graph, double> &workspace)
+ *
+ * @param heuristic The consistent A* heuristic, which must outlive the
+ *        kernel.
+ */
+template <typename Graph, typename AStarHeuristic>
+auto make_penalty_kernel(kernels::astar_t, const Graph &,
+                         const AStarHeuristic &heuristic,
+                         PathWorkspace<Graph, double> &workspace) {
+  return [&workspace, &heuristic](const auto &G, auto s, auto t,
+                                  auto &penalty) {
+    return astar_shortest_path(G, s, t, penalty, heuristic, workspace);
+  };
+}
+
+/**
+ * @see make_penalty_kernel(kernels::dijkstra_t, const Graph &G,
+ *                          PathWorkspace<Graph, double> &workspace)
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::bidirectional_dijkstra_t, const Graph &,
+                         PathWorkspace<Graph, double> &workspace) {
+  return [&workspace](const auto &G, auto s, auto t, auto &penalty) {
+    return bidirectional_dijkstra_shortest_path(G, s, t, penalty, workspace);
+  };
+}
+
+/**
+ * Parallel Bidirectional Dijkstra runs on workspaces of its own threads:
+ * @p workspace is ignored.
+ */
+template <typename Graph>
+auto make_penalty_kernel(kernels::parallel_bidirectional_dijkstra_t kernel,
+                         const Graph &G, PathWorkspace<Graph, double> &) {
+  return make_penalty_kernel(kernel, G);
+}
+
+/**
+ * The routing kernel of Penalty named by @p kernel on @p workspace, guided
+ * by @p heuristic if it is kernels::astar_t.
+ */
+template <typename Kernel, typename Graph, typename AStarHeuristic>
+auto make_penalty_kernel(Kernel kernel, const Graph &G,
+                         const AStarHeuristic &,
+                         PathWorkspace<Graph, double> &workspace) {
+  return make_penalty_kernel(kernel, G, workspace);
+}
+
 template <typename Graph, typename PMap, typename Vertex = vertex_of_t<Graph>,
           typename Edge = edge_of_t<Graph>>
 constexpr std::function<std::optional<std::vector<Edge>>(
-    const Graph &, Vertex, Vertex, penalty_functor<PMap> &)>
-build_shortest_path_fn(routing_kernels algorithm, const Graph &, const PMap &) {
+    const Graph &, Vertex, Vertex, flat_penalty_functor<Graph, PMap> &)>
+build_shortest_path_fn(routing_kernels algorithm, const Graph &G,
+                       const PMap &) {
   switch (algorithm) {
   case routing_kernels::dijkstra:
-    return [](const auto &G, auto s, auto t, auto &penalty) {
-      return dijkstra_shortest_path(G, s, t, penalty);
-    };
+    return make_penalty_kernel(kernels::dijkstra, G);
   case routing_kernels::bidirectional_dijkstra:
-    return [](const auto &G, auto s, auto t, auto &penalty) {
-      return bidirectional_dijkstra_shortest_path(G, s, t, penalty);
-    };
+    return make_penalty_kernel(kernels::bidirectional_dijkstra, G);
+  case routing_kernels::parallel_bidirectional_dijkstra:
+    return make_penalty_kernel(kernels::parallel_bidirectional_dijkstra, G);
   default:
     throw std::invalid_argument{
-        "Invalid algorithm. Only [dijkstra|bidirectional_dijkstra] allowed."};
+        "Invalid algorithm. Only "
+        "[dijkstra|bidirectional_dijkstra|parallel_bidirectional_dijkstra] "
+        "allowed."};
   }
 }
 
@@ -400,19 +781,148 @@ template <typename Graph, typename PMap, typename AStarHeuristic,
           typename Vertex = vertex_of_t<Graph>,
           typename Edge = edge_of_t<Graph>>
 constexpr std::function<std::optional<std::vector<Edge>>(
-    const Graph &, Vertex, Vertex, penalty_functor<PMap> &)>
-build_shortest_path_fn(routing_kernels algorithm, const Graph &, const PMap &,
+    const Graph &, Vertex, Vertex, flat_penalty_functor<Graph, PMap> &)>
+build_shortest_path_fn(routing_kernels algorithm, const Graph &G, const PMap &,
                        const AStarHeuristic &heuristic) {
   switch (algorithm) {
   case routing_kernels::astar:
-    return [&heuristic](const auto &G, auto s, auto t, auto &penalty) {
-      return astar_shortest_path(G, s, t, penalty, heuristic);
-    };
+    return make_penalty_kernel(kernels::astar, G, heuristic);
   default:
     throw std::invalid_argument{"Invalid algorithm. Only [astar] allowed."};
   }
 }
 
+template <typename Graph, typename PMap, typename LandmarkLength,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::function<std::optional<std::vector<Edge>>(
+    const Graph &, Vertex, Vertex, flat_penalty_functor<Graph, PMap> &)>
+build_landmark_shortest_path_fn(routing_kernels algorithm, const Graph &G,
+                                const PMap &weight, Vertex t,
+                                landmarks<LandmarkLength> const &lm) {
+  switch (algorithm) {
+  case routing_kernels::astar: {
+    auto heuristic = make_alt_heuristic(G, lm, t);
+    auto workspace =
+        std::make_shared<PathWorkspace<Graph, double>>(num_vertices(G));
+    return [heuristic, workspace](const auto &G, auto s, auto t,
+                                  auto &penalty) {
+      return astar_shortest_path(G, s, t, penalty, heuristic, *workspace);
+    };
+  }
+  case routing_kernels::bidirectional_alt: {
+    // Share one workspace among all the queries of this penalty run
+    auto workspace =
+        std::make_shared<BiDijkstraWorkspace<Vertex, double>>(num_vertices(G));
+    return [workspace, &lm](const auto &G, auto s, auto t, auto &penalty) {
+      return bidirectional_alt_shortest_path(G, s, t, penalty, lm, *workspace);
+    };
+  }
+  default:
+    // Kernels which do not use landmarks
+    return build_shortest_path_fn(algorithm, G, weight);
+  }
+}
+
+/**
+ * The metric of a customizable contraction hierarchy following the penalized
+ * weights of a penalty run, with the candidate path of its last query.
+ *
+ * Between two queries, penalty() only penalizes the candidate path returned
+ * by the first one: the edges of the path and the edges entering or leaving
+ * its vertices. Only these edges are customized again, and the metric is
+ * customized in full only for the first query.
+ *
+ * @tparam Graph The graph the hierarchy was built on.
+ * @tparam Length The arc weight type.
+ */
+template <typename Graph, typename Length> struct CCHPenaltyMetric {
+  using Edge = edge_of_t<Graph>;
+
+  CCHPenaltyMetric(const Graph &G,
+                   customizable_contraction_hierarchy<Graph> const &cch)
+      : metric{cch}, workspace{num_vertices(G)}, edge_id{G},
+        ordinal(edge_id.size()) {
+    for (std::size_t i = 0; i < cch.num_edges(); ++i) {
+      ordinal[edge_id[cch.edge(i)]] = i;
+    }
+  }
+
+  /**
+   * Customize the metric for @p penalty, after penalty() penalized the
+   * candidate of the last query, if any.
+   */
+  template <typename PenaltyFunctor>
+  void customize(const Graph &G, PenaltyFunctor &penalty,
+                 thread_pool &threads) {
+    auto weight = boost::make_function_property_map<Edge>(penalty);
+    if (!candidate) {
+      metric.customize(weight, threads);
+      return;
+    }
+    changed.clear();
+    for (auto const &e : *candidate) {
+      changed.push_back(ordinal[edge_id[e]]);
+      for (auto [it, end] = in_edges(source(e, G), G); it != end; ++it) {
+        changed.push_back(ordinal[edge_id[*it]]);
+      }
+      for (auto [it, end] = out_edges(target(e, G), G); it != end; ++it) {
+        changed.push_back(ordinal[edge_id[*it]]);
+      }
+    }
+    metric.customize_edges(weight, changed.begin(), changed.end());
+  }
+
+  cch_metric<Graph, Length> metric;
+  CCHWorkspace<Length> workspace;
+  dense_edge_index<Graph> edge_id;
+  // The ordinal in the hierarchy of each edge, by dense_edge_index
+  std::vector<std::size_t> ordinal;
+  std::optional<std::vector<Edge>> candidate;
+  std::vector<std::size_t> changed;
+};
+
+/**
+ * @param pool If not null, the threads to customize the metric on. Otherwise
+ *        the kernel starts its own pool, shared by all the queries of this
+ *        penalty run.
+ */
+template <typename Graph, typename PMap, typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>>
+std::function<std::optional<std::vector<Edge>>(
+    const Graph &, Vertex, Vertex, flat_penalty_functor<Graph, PMap> &)>
+build_cch_shortest_path_fn(routing_kernels algorithm, const Graph &G,
+                           const PMap &weight,
+                           customizable_contraction_hierarchy<Graph> const &cch,
+                           thread_pool *pool = nullptr) {
+  switch (algorithm) {
+  case routing_kernels::cch: {
+    // Penalized weights grow by fractions of the graph's ones, so the metric
+    // needs at least the precision of the penalty_functor
+    using Length =
+        std::common_type_t<length_of_t<Graph>,
+                           typename flat_penalty_functor<Graph, PMap>::Length>;
+    // Share one metric, workspace and thread pool among all the queries of
+    // this penalty run. Penalties change between queries, so each one
+    // customizes first.
+    auto metric = std::make_shared<CCHPenaltyMetric<Graph, Length>>(G, cch);
+    auto own_pool = pool ? nullptr : std::make_shared<thread_pool>();
+    auto &threads = pool ? *pool : *own_pool;
+    return [metric, own_pool, &threads](const auto &G, auto s, auto t,
+                                        auto &penalty) {
+      metric->customize(G, penalty, threads);
+      metric->candidate =
+          cch_shortest_path(metric->metric, s, t, get(boost::vertex_index, G),
+                            metric->workspace);
+      return metric->candidate;
+    };
+  }
+  default:
+    // Kernels which do not use the hierarchy
+    return build_shortest_path_fn(algorithm, G, weight);
+  }
+}
+
 /**
  * Apply penalization step to the candidate path.
  *
@@ -451,52 +961,43 @@ build_shortest_path_fn(routing_kernels algorithm, const Graph &, const PMap &,
  * @param penalty A penalty_functor.
  * @param distance_s A DistanceMap from s.
  * @param distance_t A DistanceMap from t.
- * @param penalty_bounds A PenBoundsMap.
+ * @param penalty_bounds A PenBoundsMap, or an edge_map to int.
  * @param bound_limit The maximum number of times an edge can be penalized.
  */
 template <typename Graph, typename DistanceMap, typename PMap,
+          typename EdgeIndex, typename PenaltyBounds,
           typename Vertex = vertex_of_t<Graph>,
           typename Edge = edge_of_t<Graph>,
           typename Length = length_of_t<Graph>>
 void penalize_candidate_path(const std::vector<Edge> &candidate, const Graph &G,
                              Vertex s, Vertex t, double p, double r,
-                             penalty_functor<PMap> &penalty,
+                             penalty_functor<PMap, EdgeIndex> &penalty,
                              const DistanceMap &distance_s,
                              const DistanceMap &distance_t,
-                             PenBoundsMap<Edge> &penalty_bounds,
-                             int bound_limit) {
+                             PenaltyBounds &penalty_bounds, int bound_limit) {
   using namespace boost;
 
   // Keep track of candidate vertices to exclude them from incoming/outgoing
   // edges update
   auto candidate_vertices = std::unordered_set<Vertex, boost::hash<Vertex>>{};
-  auto candidate_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
 
   for (const auto &e : candidate) {
-    candidate_edges.insert(e);
-
     auto u = source(e, G);
     auto v = target(e, G);
     candidate_vertices.insert(u);
     candidate_vertices.insert(v);
   }
 
-  for (auto &e : candidate_edges) {
+  // The candidate is a simple path: each of its edges is penalized once
+  for (auto &e : candidate) {
     auto u = source(e, G);
     auto v = target(e, G);
 
-    // Check if 'e' is already part of the alternative graph
-    if (auto search = penalty_bounds.find(e);
-        search != std::end(penalty_bounds)) {
-      // If so, penalize only if limit isnt reached
-      auto n_updates = search->second;
-      if (n_updates < bound_limit) {
-        penalty[e] += p * penalty[e];
-        ++penalty_bounds[e];
-      }
-    } else { // Penalize and create a nb_updates counter for e
+    // Penalize e only if limit isnt reached, the first time regardless
+    if (auto n_updates = times_penalized(penalty_bounds, e);
+        n_updates == 0 || n_updates < bound_limit) {
       penalty[e] += p * penalty[e];
-      penalty_bounds.insert({e, 1});
+      ++penalty_bounds[e];
     }
 
     // Update incoming edges
@@ -506,22 +1007,16 @@ void penalize_candidate_path(const std::vector<Edge> &candidate, const Graph &G,
       // Incoming edge (a, u) is updated only if 'a' is not part of candidate
       // path
       if (candidate_vertices.find(a) == std::end(candidate_vertices)) {
-        // Check if '*it' is already part of the alternative graph
-        if (auto search = penalty_bounds.find(*it);
-            search != std::end(penalty_bounds)) {
-          auto n_updates = search->second;
-          // penalize only if limit isnt reached
-          if (n_updates < bound_limit) {
-            auto closeness = distance_t[u] / distance_t[s];
-            auto pen_factor = 0.1 + r * closeness;
-            penalty[*it] += pen_factor * penalty[*it];
-            ++penalty_bounds[*it];
-          }
-        } else {
-          // Else, just update it
+        auto n_updates = times_penalized(penalty_bounds, *it);
+        // Edges not in the alternative graph are always updated, the other
+        // ones only if limit isnt reached
+        if (n_updates == 0 || n_updates < bound_limit) {
           auto closeness = distance_t[u] / distance_t[s];
           auto pen_factor = 0.1 + r * closeness;
           penalty[*it] += pen_factor * penalty[*it];
+          if (n_updates != 0) {
+            ++penalty_bounds[*it];
+          }
         }
       }
     }
@@ -533,66 +1028,61 @@ void penalize_candidate_path(const std::vector<Edge> &candidate, const Graph &G,
       // Outgoing edge (v, b) is updated only if 'b' is not part of candidate
       // path
       if (candidate_vertices.find(b) == std::end(candidate_vertices)) {
-        // Check if '*it' is already part of the alternative graph
-        if (auto search = penalty_bounds.find(*it);
-            search != std::end(penalty_bounds)) {
-          auto n_updates = search->second;
-          // penalize only if limit isnt reached
-          if (n_updates < bound_limit) {
-            auto closeness = distance_s[v] / distance_s[t];
-            auto pen_factor = 0.1 + r * closeness;
-            penalty[*it] += pen_factor * penalty[*it];
-            ++penalty_bounds[*it];
-          }
-        } else {
-          // Else, just update it
+        auto n_updates = times_penalized(penalty_bounds, *it);
+        // Edges not in the alternative graph are always updated, the other
+        // ones only if limit isnt reached
+        if (n_updates == 0 || n_updates < bound_limit) {
           auto closeness = distance_s[v] / distance_s[t];
           auto pen_factor = 0.1 + r * closeness;
           penalty[*it] += pen_factor * penalty[*it];
+          if (n_updates != 0) {
+            ++penalty_bounds[*it];
+          }
         }
       }
     }
   }
 }
 
+/**
+ * The Penalty method, given the shortest path from @p s to @p t and the
+ * distances of every vertex from @p s and to @p t.
+ *
+ * @pre @p sp is a shortest path from @p s to @p t.
+ * @param distance_s The distances of the vertices from @p s.
+ * @param distance_t The distances of the vertices to @p t.
+ * @param sp The shortest path from @p s to @p t.
+ */
 template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
           typename RoutingKernel, typename Terminator,
-          typename Vertex = vertex_of_t<Graph>>
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = length_of_t<Graph>>
 void penalty(const Graph &G, WeightMap const &original_weight,
              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
              double theta, double p, double r, int max_nb_updates,
              int max_nb_steps, RoutingKernel &routing_kernel,
-             Terminator &&terminator) {
+             Terminator &&terminator, const DistanceMap<Length> &distance_s,
+             const DistanceMap<Length> &distance_t,
+             const std::vector<edge_of_t<Graph>> &sp) {
   using namespace boost;
   using Edge = typename graph_traits<Graph>::edge_descriptor;
-  using Length = typename boost::property_traits<typename boost::property_map<
-      Graph, boost::edge_weight_t>::type>::value_type;
 
   BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
   BOOST_CONCEPT_ASSERT((LvaluePropertyMapConcept<WeightMap, Edge>));
 
+  // Data about edges is kept in flat arrays over a dense numbering of them
+  auto edge_id = dense_edge_index<Graph>{G};
+
   // P_LO set of k paths
   auto resPathsEdges = std::vector<std::vector<Edge>>{};
-  auto resEdges = std::vector<std::unordered_set<Edge, boost::hash<Edge>>>{};
+  auto resEdges = std::vector<edge_set<Graph>>{};
 
-  // P_LO set of k paths
-  auto resPaths = std::vector<Path<Graph>>{};
   // Make a local weight map to avoid modifying existing graph.
-  auto pen_fctor = details::penalty_functor{original_weight};
-
-  // Compute shortest path from s to t
-  auto distance_s = std::vector<Length>(num_vertices(G));
-  auto distance_t = std::vector<Length>(num_vertices(G));
-  auto sp = dijkstra_shortest_path_two_ways(G, s, t, distance_s, distance_t);
-  if (!sp) {
-    auto oss = std::ostringstream{};
-    oss << "Vertex " << t << " is unreachable from " << s;
-    throw details::target_not_found{oss.str()};
-  }
+  auto pen_fctor = details::penalty_functor{original_weight, edge_id};
 
   // P_LO <-- {shortest path p_0(s, t)};
-  resPathsEdges.push_back(*sp);
-  resEdges.emplace_back(sp->begin(), sp->end());
+  resPathsEdges.push_back(sp);
+  resEdges.emplace_back(sp.begin(), sp.end(), edge_id);
 
   // If we need the shortest path only
   if (k == 1) {
@@ -602,12 +1092,22 @@ void penalty(const Graph &G, WeightMap const &original_weight,
   }
 
   // Initialize map for penalty bounds
-  auto penalty_bounds = std::unordered_map<Edge, int, boost::hash<Edge>>{};
+  auto penalty_bounds = edge_map<Graph, int>{edge_id, 0};
 
   // Penalize sp edges
-  penalize_candidate_path(*sp, G, s, t, p, r, pen_fctor, distance_s, distance_t,
+  penalize_candidate_path(sp, G, s, t, p, r, pen_fctor, distance_s, distance_t,
                           penalty_bounds, max_nb_updates);
 
+  // No alternative is longer than radius. Penalized lengths only bound the
+  // original ones from above, so neither the searches nor the loop can be cut
+  // at radius: a candidate penalized past it may still be followed by a
+  // shorter one. Longer candidates are only filtered out.
+  auto radius = stretch_radius(
+      stretch_bound(terminator),
+      compute_length_from_edges(sp.begin(), sp.end(), original_weight));
+  using Radius = decltype(radius);
+  bool bounded = radius != std::numeric_limits<Radius>::max();
+
   int step = 0;
   using Index = std::size_t;
   while (resPathsEdges.size() < static_cast<Index>(k) && step < max_nb_steps) {
@@ -626,10 +1126,14 @@ void penalty(const Graph &G, WeightMap const &original_weight,
                             distance_t, penalty_bounds, max_nb_updates);
     ++step;
 
-    // If p_tmp is sufficiently dissimilar to other alternative paths, accept it
-    bool is_valid_path = true;
-    for (const auto &alt_path : resEdges) {
-      if (compute_similarity(*p_tmp, alt_path, original_weight) > theta) {
+    // If p_tmp is sufficiently dissimilar to other alternative paths, and not
+    // too long, accept it
+    bool is_valid_path =
+        !bounded || compute_length_from_edges(p_tmp->begin(), p_tmp->end(),
+                                              original_weight) <= radius;
+    for (std::size_t i = 0; is_valid_path && i < resEdges.size(); ++i) {
+      if (compute_similarity(*p_tmp, resPathsEdges[i], resEdges[i],
+                             original_weight) > theta) {
         is_valid_path = false;
         break;
       }
@@ -637,7 +1141,7 @@ void penalty(const Graph &G, WeightMap const &original_weight,
 
     if (is_valid_path) {
       resPathsEdges.push_back(*p_tmp);
-      resEdges.emplace_back(p_tmp->begin(), p_tmp->end());
+      resEdges.emplace_back(p_tmp->begin(), p_tmp->end(), edge_id);
     }
   }
 
@@ -645,6 +1149,63 @@ void penalty(const Graph &G, WeightMap const &original_weight,
   fill_multi_predecessor(resPathsEdges.begin(), resPathsEdges.end(), G,
                          predecessors);
 }
+
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename RoutingKernel, typename Terminator,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, RoutingKernel &routing_kernel,
+             Terminator &&terminator, thread_pool *pool = nullptr,
+             phast_hierarchy<length_of_t<Graph>> const *phast = nullptr) {
+  using Length = length_of_t<Graph>;
+
+  // Compute shortest path from s to t
+  auto distance_s = std::vector<Length>(num_vertices(G));
+  auto distance_t = std::vector<Length>(num_vertices(G));
+  auto sp = phast ? phast_shortest_path_two_ways(G, s, t, distance_s,
+                                                 distance_t, *phast, pool)
+                 : dijkstra_shortest_path_two_ways(G, s, t, distance_s,
+                                                   distance_t, pool);
+  if (!sp) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << t << " is unreachable from " << s;
+    throw details::target_not_found{oss.str()};
+  }
+
+  penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+          max_nb_updates, max_nb_steps, routing_kernel,
+          std::forward<Terminator>(terminator), distance_s, distance_t, *sp);
+}
+/**
+ * Run Penalty with the routing kernel named by @p kernel, on @p workspace if
+ * given, or on a workspace of its own.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator, typename... Workspace,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty_kernel_dispatch(const Graph &G, WeightMap const &original_weight,
+                             MultiPredecessorMap &predecessors, Vertex s,
+                             Vertex t, int k, double theta, double p, double r,
+                             int max_nb_updates, int max_nb_steps,
+                             Kernel kernel, Terminator &&terminator,
+                             Workspace &... workspace) {
+  using Length = length_of_t<Graph>;
+  if constexpr (std::is_same_v<Kernel, kernels::astar_t>) {
+    auto heuristic = lazy_distance_heuristic<Graph, Length>(G, t);
+    auto routing_kernel =
+        make_penalty_kernel(kernel, G, heuristic, workspace...);
+    penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+            max_nb_updates, max_nb_steps, routing_kernel,
+            std::forward<Terminator>(terminator));
+  } else {
+    auto routing_kernel = make_penalty_kernel(kernel, G, workspace...);
+    penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+            max_nb_updates, max_nb_steps, routing_kernel,
+            std::forward<Terminator>(terminator));
+  }
+}
 } // namespace details
 } // namespace arlib
 
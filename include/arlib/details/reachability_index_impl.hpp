@@ -0,0 +1,186 @@
+/**
+ * @file reachability_index_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_IMPL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                   Condensation graph support functions
+//===----------------------------------------------------------------------===//
+
+/**
+ * The condensation of a graph: one vertex per strongly connected component,
+ * and an arc between two components joined by at least one edge.
+ */
+struct condensation {
+  std::vector<std::size_t> offsets; /**< The arcs of `c` start here. */
+  std::vector<std::uint32_t> heads; /**< Without duplicates. */
+
+  std::size_t size() const { return offsets.size() - 1; }
+};
+
+/**
+ * Build the condensation of @p num_components components from the
+ * component of the endpoints of each edge, in @p arcs. Self-loops are
+ * dropped.
+ */
+inline condensation
+make_condensation(std::size_t num_components,
+                  std::vector<std::pair<std::uint32_t, std::uint32_t>> arcs) {
+  arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                            [](auto const &a) { return a.first == a.second; }),
+             arcs.end());
+  std::sort(arcs.begin(), arcs.end());
+  arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+  auto dag = condensation{};
+  dag.offsets.assign(num_components + 1, 0);
+  dag.heads.reserve(arcs.size());
+  for (auto const &[tail, head] : arcs) {
+    ++dag.offsets[tail + 1];
+    dag.heads.push_back(head);
+  }
+  for (std::size_t c = 0; c < num_components; ++c) {
+    dag.offsets[c + 1] += dag.offsets[c];
+  }
+  return dag;
+}
+
+/**
+ * Sort the components of @p dag topologically with Kahn's algorithm.
+ *
+ * @return The components, tails before heads.
+ */
+inline std::vector<std::uint32_t> topological_order(condensation const &dag) {
+  auto n = dag.size();
+  auto in_degree = std::vector<std::uint32_t>(n, 0);
+  for (auto head : dag.heads) {
+    ++in_degree[head];
+  }
+  auto order = std::vector<std::uint32_t>{};
+  order.reserve(n);
+  for (std::uint32_t c = 0; c < n; ++c) {
+    if (in_degree[c] == 0) {
+      order.push_back(c);
+    }
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    auto c = order[i];
+    for (auto a = dag.offsets[c]; a < dag.offsets[c + 1]; ++a) {
+      if (--in_degree[dag.heads[a]] == 0) {
+        order.push_back(dag.heads[a]);
+      }
+    }
+  }
+  return order;
+}
+
+/**
+ * Label every component of @p dag with an interval `[low, post]`, such that
+ * the interval of any component reachable from `c` lies within the one of
+ * `c`.
+ *
+ * `post` is the post-order number of `c` in a depth-first traversal from
+ * the sources of @p dag, and `low` the smallest post-order number among the
+ * components reachable from `c`. Traversing children in @p reversed order
+ * gives a different labeling, ruling out other unreachable pairs.
+ *
+ * This labeling refers to the following publication:
+ * Hilmi Yildirim, Vineet Chaoji, Mohammed J. Zaki. GRAIL: Scalable
+ * Reachability Index for Large Graphs. PVLDB, 3(1), pp. 276-284, 2010.
+ *
+ * @param dag The condensation.
+ * @param order A topological order of @p dag.
+ * @param reversed If true, children are visited last to first.
+ * @param low Receives the `low` bound of each component.
+ * @param post Receives the `post` bound of each component.
+ */
+inline void interval_labeling(condensation const &dag,
+                              std::vector<std::uint32_t> const &order,
+                              bool reversed, std::uint32_t *low,
+                              std::uint32_t *post) {
+  auto n = dag.size();
+  auto visited = std::vector<bool>(n, false);
+  auto next_post = std::uint32_t{0};
+  // Components and the number of children already visited
+  auto stack = std::vector<std::pair<std::uint32_t, std::size_t>>{};
+
+  auto child = [&](std::uint32_t c, std::size_t i) {
+    return reversed ? dag.heads[dag.offsets[c + 1] - 1 - i]
+                    : dag.heads[dag.offsets[c] + i];
+  };
+
+  // Sources come first in a topological order. Any component left
+  // unvisited after them is reachable from a source.
+  for (auto root : order) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = true;
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+      auto &[c, i] = stack.back();
+      auto degree = dag.offsets[c + 1] - dag.offsets[c];
+      while (i < degree && visited[child(c, i)]) {
+        ++i;
+      }
+      if (i == degree) {
+        post[c] = next_post++;
+        stack.pop_back();
+      } else {
+        auto next = child(c, i++);
+        visited[next] = true;
+        stack.emplace_back(next, 0);
+      }
+    }
+  }
+
+  // Children come after their parents in a topological order
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    auto c = *it;
+    auto l = post[c];
+    for (auto a = dag.offsets[c]; a < dag.offsets[c + 1]; ++a) {
+      l = std::min(l, low[dag.heads[a]]);
+    }
+    low[c] = l;
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_IMPL_HPP
@@ -0,0 +1,335 @@
+/**
+ * @file edge_index.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_EDGE_INDEX_HPP
+#define ALTERNATIVE_ROUTING_LIB_EDGE_INDEX_HPP
+
+#include <boost/functional/hash.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/road_graph.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+namespace details {
+/**
+ * True if the edges of @p Graph carry their own `boost::edge_index`,
+ * numbering them from 0 to `num_edges(G) - 1`.
+ *
+ * @tparam Graph A Boost::Graph.
+ */
+template <typename Graph> struct has_intrinsic_edge_index : std::false_type {};
+
+template <typename Length>
+struct has_intrinsic_edge_index<road_graph<Length>> : std::true_type {};
+
+template <typename Directed, typename VertexProperty, typename EdgeProperty,
+          typename GraphProperty, typename Vertex, typename EdgeIndex>
+struct has_intrinsic_edge_index<boost::compressed_sparse_row_graph<
+    Directed, VertexProperty, EdgeProperty, GraphProperty, Vertex, EdgeIndex>>
+    : std::true_type {};
+} // namespace details
+
+//===----------------------------------------------------------------------===//
+//                            Dense edge index
+//===----------------------------------------------------------------------===//
+
+/**
+ * A Readable Property Map numbering the edges of a graph with consecutive
+ * integers, so that data about edges can be kept in flat arrays instead of
+ * hash tables keyed by edge descriptors.
+ *
+ * If the graph has an intrinsic `boost::edge_index`, e.g. a road_graph or a
+ * `boost::compressed_sparse_row_graph`, this is a thin wrapper around it.
+ * Otherwise the edges are numbered once at construction, in the order of
+ * `out_edges` of each vertex, and stored in a hash table keyed by edge
+ * descriptor: for a `boost::adjacency_list` this hashes the address of the
+ * edge property, so every lookup is a single O(1) probe.
+ *
+ * Indices are in [0, size()). Copies share the same table, and stay valid
+ * as long as the graph is alive and not modified.
+ *
+ * @tparam Graph A Boost::IncidenceGraph with a vertex index.
+ */
+template <typename Graph,
+          bool Intrinsic = details::has_intrinsic_edge_index<Graph>::value>
+class dense_edge_index;
+
+template <typename Graph>
+class dense_edge_index<Graph, true>
+    : public boost::put_get_helper<std::size_t,
+                                   dense_edge_index<Graph, true>> {
+public:
+  using key_type = edge_of_t<Graph>;
+  using value_type = std::size_t;
+  using reference = std::size_t;
+  using category = boost::readable_property_map_tag;
+
+  /**
+   * Wrap the intrinsic edge index of @p G.
+   *
+   * @param G The graph.
+   */
+  explicit dense_edge_index(const Graph &G)
+      : index{get(boost::edge_index, G)}, count{num_edges(G)} {}
+
+  /**
+   * @return One past the greatest index of an edge.
+   */
+  std::size_t size() const { return count; }
+
+  /**
+   * @param e An edge of the graph.
+   * @return The index of @p e.
+   */
+  std::size_t operator[](const key_type &e) const {
+    return static_cast<std::size_t>(get(index, e));
+  }
+
+private:
+  typename boost::property_map<Graph, boost::edge_index_t>::const_type index;
+  std::size_t count;
+};
+
+template <typename Graph>
+class dense_edge_index<Graph, false>
+    : public boost::put_get_helper<std::size_t,
+                                   dense_edge_index<Graph, false>> {
+public:
+  using key_type = edge_of_t<Graph>;
+  using value_type = std::size_t;
+  using reference = std::size_t;
+  using category = boost::readable_property_map_tag;
+
+  /**
+   * Number the edges of @p G.
+   *
+   * @param G The graph.
+   */
+  explicit dense_edge_index(const Graph &G)
+      : ids{std::make_shared<id_table>()} {
+    ids->reserve(num_edges(G));
+    auto id = std::size_t{0};
+    for (auto [v_it, v_last] = vertices(G); v_it != v_last; ++v_it) {
+      for (auto [it, last] = out_edges(*v_it, G); it != last; ++it) {
+        ids->emplace(*it, id++);
+      }
+    }
+  }
+
+  /**
+   * @return One past the greatest index of an edge.
+   */
+  std::size_t size() const { return ids->size(); }
+
+  /**
+   * @param e An edge of the graph.
+   * @return The index of @p e.
+   */
+  std::size_t operator[](const key_type &e) const {
+    return ids->find(e)->second;
+  }
+
+private:
+  using id_table =
+      std::unordered_map<key_type, std::size_t, boost::hash<key_type>>;
+
+  std::shared_ptr<id_table> ids;
+};
+
+//===----------------------------------------------------------------------===//
+//                         Containers keyed by edges
+//===----------------------------------------------------------------------===//
+
+/**
+ * A set of edges of a graph stored as a bitset over their dense_edge_index:
+ * insertions, deletions and lookups are a bit operation, and never
+ * allocate.
+ *
+ * It has the same interface as `std::unordered_set` for the operations
+ * that do not iterate over the elements.
+ *
+ * @tparam Graph A Boost::IncidenceGraph with a vertex index.
+ */
+template <typename Graph> class edge_set {
+public:
+  using key_type = edge_of_t<Graph>;
+  using index_map = dense_edge_index<Graph>;
+
+  /**
+   * Construct an empty set of edges of @p G.
+   *
+   * @param G The graph.
+   */
+  explicit edge_set(const Graph &G) : edge_set{index_map{G}} {}
+
+  /**
+   * Construct an empty set of edges numbered by @p index.
+   *
+   * @param index The edge index of the graph.
+   */
+  explicit edge_set(index_map index)
+      : index{std::move(index)}, words((this->index.size() + 63) / 64, 0),
+        count_{0} {}
+
+  /**
+   * Construct the set of the edges in [@p first, @p last).
+   *
+   * @param index The edge index of the graph.
+   */
+  template <typename InputIt>
+  edge_set(InputIt first, InputIt last, index_map index)
+      : edge_set{std::move(index)} {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  /**
+   * @return true if @p e was not in the set.
+   */
+  bool insert(const key_type &e) {
+    auto [word, bit] = locate(e);
+    if ((words[word] & bit) != 0) {
+      return false;
+    }
+    words[word] |= bit;
+    ++count_;
+    return true;
+  }
+
+  /**
+   * @return The number of elements removed, 0 or 1.
+   */
+  std::size_t erase(const key_type &e) {
+    auto [word, bit] = locate(e);
+    if ((words[word] & bit) == 0) {
+      return 0;
+    }
+    words[word] &= ~bit;
+    --count_;
+    return 1;
+  }
+
+  /**
+   * @return The number of elements equal to @p e, 0 or 1.
+   */
+  std::size_t count(const key_type &e) const {
+    auto [word, bit] = locate(e);
+    return (words[word] & bit) != 0 ? 1 : 0;
+  }
+
+  bool contains(const key_type &e) const { return count(e) != 0; }
+
+  std::size_t size() const { return count_; }
+
+  bool empty() const { return count_ == 0; }
+
+  void clear() {
+    std::fill(words.begin(), words.end(), 0);
+    count_ = 0;
+  }
+
+private:
+  index_map index;
+  std::vector<std::uint64_t> words;
+  std::size_t count_;
+
+  std::pair<std::size_t, std::uint64_t> locate(const key_type &e) const {
+    auto id = index[e];
+    return {id / 64, std::uint64_t{1} << (id % 64)};
+  }
+};
+
+/**
+ * A Lvalue Property Map from the edges of a graph to values of type @p T,
+ * stored in a flat array over their dense_edge_index.
+ *
+ * Like `boost::shared_array_property_map`, copies share the same values.
+ *
+ * @tparam Graph A Boost::IncidenceGraph with a vertex index.
+ * @tparam T The value type.
+ */
+template <typename Graph, typename T>
+class edge_map : public boost::put_get_helper<T &, edge_map<Graph, T>> {
+public:
+  using key_type = edge_of_t<Graph>;
+  using value_type = T;
+  using reference = T &;
+  using category = boost::lvalue_property_map_tag;
+  using index_map = dense_edge_index<Graph>;
+
+  /**
+   * Construct a map from each edge of @p G to @p value.
+   *
+   * @param G The graph.
+   * @param value The initial value of every edge.
+   */
+  explicit edge_map(const Graph &G, const T &value = T{})
+      : edge_map{index_map{G}, value} {}
+
+  /**
+   * Construct a map from each edge numbered by @p index to @p value.
+   *
+   * @param index The edge index of the graph.
+   * @param value The initial value of every edge.
+   */
+  explicit edge_map(index_map index, const T &value = T{})
+      : index{std::move(index)},
+        values{std::make_shared<std::vector<T>>(this->index.size(), value)} {}
+
+  /**
+   * @param e An edge of the graph.
+   * @return The value of @p e.
+   */
+  T &operator[](const key_type &e) const { return (*values)[index[e]]; }
+
+private:
+  index_map index;
+  std::shared_ptr<std::vector<T>> values;
+};
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_EDGE_INDEX_HPP
@@ -35,7 +35,16 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
 
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/hub_labels.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/query_context.hpp>
+#include <arlib/reachability_index.hpp>
+#include <arlib/routing_kernels/phast.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
+#include <arlib/routing_kernels/types.hpp>
 #include <arlib/terminators.hpp>
+#include <arlib/thread_pool.hpp>
 #include <arlib/type_traits.hpp>
 
 #include <arlib/details/esx_impl.hpp>
@@ -106,6 +115,262 @@ void esx(const Graph &G, WeightMap const &weight,
                         std::forward<Terminator>(terminator));
 }
 
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, with the routing kernel bound at compile time.
+ *
+ * The runtime routing_kernels overload dispatches here: @p kernel fixes the
+ * type of every shortest path search, which is thus a direct call the
+ * compiler can inline, instead of a call through a `std::function`.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @tparam Kernel A routing kernel tag, e.g. kernels::bidirectional_dijkstra_t.
+ * @param kernel The routing kernel to employ.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, Kernel kernel, Terminator &&terminator = Terminator{}) {
+  auto priority_fn = details::make_priority_fn(G);
+  details::esx_kernel_dispatch(G, weight, predecessors, s, t, k, theta,
+                               std::move(priority_fn), kernel,
+                               std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, with the routing kernel bound at compile time and its
+ * searches running on a caller-owned @p workspace.
+ *
+ * Each ESX run otherwise allocates the O(|V|) arrays of its searches: a
+ * thread answering many queries on the same graph can keep one workspace
+ * and pay for them once. kernels::parallel_bidirectional_dijkstra_t runs on
+ * workspaces of its own threads and ignores @p workspace.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, Kernel kernel)
+ *
+ * @param workspace The workspace of the shortest path searches, for the
+ *        vertices of @p G. It is not thread-safe: give each thread its own.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, Kernel kernel, PathWorkspace<Graph> &workspace,
+         Terminator &&terminator = Terminator{}) {
+  auto priority_fn = details::make_priority_fn(G);
+  details::esx_kernel_dispatch(G, weight, predecessors, s, t, k, theta,
+                               std::move(priority_fn), kernel,
+                               std::forward<Terminator>(terminator),
+                               workspace);
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, guided by precomputed landmarks.
+ *
+ * With routing_kernels::astar the shortest path searches use an
+ * alt_heuristic instead of running a full reverse Dijkstra's search from
+ * @p t, and routing_kernels::bidirectional_alt runs bidirectional_alt().
+ * Other kernels ignore @p lm.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param lm The landmarks of @p G, computed on @p weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LandmarkLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<std::is_same_v<
+              typename boost::property_traits<MultiPredecessorMap>::key_type,
+              Vertex>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, landmarks<LandmarkLength> const &lm,
+         routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  details::esx_landmark_dispatch(G, weight, predecessors, s, t, k, theta, lm,
+                                 algorithm,
+                                 std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, guided by hub labels.
+ *
+ * With routing_kernels::astar the shortest path searches use a
+ * hub_label_heuristic, exact distances to @p t on the graph before any
+ * edge is deleted, instead of running a full reverse Dijkstra's search from
+ * @p t. Other kernels ignore @p labels.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param labels The hub labels of @p G, computed on @p weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LabelLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<std::is_same_v<
+              typename boost::property_traits<MultiPredecessorMap>::key_type,
+              Vertex>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, hub_labels<LabelLength> const &labels,
+         routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  auto heuristic = make_hub_label_heuristic(G, labels, t);
+  details::esx_heuristic_dispatch(G, weight, predecessors, s, t, k, theta,
+                                  heuristic, algorithm,
+                                  std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, computing its A* lower bounds with a PHAST sweep.
+ *
+ * With routing_kernels::astar the distances to @p t are computed by a
+ * reverse sweep of @p ph, a linear pass over the vertices, instead of a
+ * full reverse Dijkstra's search from @p t. Other kernels ignore @p ph.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param ph The PHAST layout of a contraction hierarchy of @p G, built on
+ *        its `boost::edge_weight_t` property.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<std::is_same_v<
+              typename boost::property_traits<MultiPredecessorMap>::key_type,
+              Vertex>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, phast_hierarchy<length_of_t<Graph>> const &ph,
+         routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  auto heuristic =
+      details::distance_heuristic<Graph, length_of_t<Graph>>(G, t, ph);
+  details::esx_heuristic_dispatch(G, weight, predecessors, s, t, k, theta,
+                                  heuristic, algorithm,
+                                  std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, computing its A* lower bounds with a parallel
+ * delta_stepping() search from @p t on the threads of @p pool.
+ *
+ * Only routing_kernels::astar needs the lower bounds: other kernels run as
+ * in the overload without @p pool, and no search from @p t is made.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param pool The threads to run the reverse search on.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<std::is_same_v<
+              typename boost::property_traits<MultiPredecessorMap>::key_type,
+              Vertex>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, thread_pool &pool,
+         routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  if (algorithm != routing_kernels::astar) {
+    details::esx_dispatch(G, weight, predecessors, s, t, k, theta, algorithm,
+                          std::forward<Terminator>(terminator));
+    return;
+  }
+  auto heuristic =
+      details::distance_heuristic<Graph, length_of_t<Graph>>(G, t, pool);
+  details::esx_heuristic_dispatch(G, weight, predecessors, s, t, k, theta,
+                                  heuristic, algorithm,
+                                  std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, guiding its A* searches with @p heuristic instead of
+ * running a full reverse Dijkstra's search from @p t.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param heuristic A consistent A* heuristic of the distance to @p t on
+ *        @p weight, e.g. a geometric_heuristic or a max_heuristic. Other
+ *        kernels than routing_kernels::astar ignore it.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename AStarHeuristic, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<
+              std::is_same_v<key_of_t<MultiPredecessorMap>, Vertex> &&
+              details::is_astar_heuristic_v<Graph, length_of_t<Graph>,
+                                            AStarHeuristic>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, AStarHeuristic const &heuristic,
+         routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  details::esx_heuristic_dispatch(G, weight, predecessors, s, t, k, theta,
+                                  heuristic, algorithm,
+                                  std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, running its shortest path searches on a contraction
+ * hierarchy.
+ *
+ * With routing_kernels::ch every search is a ch_query() on @p ch. When the
+ * path it finds crosses an edge ESX has deleted, the search falls back to
+ * Bidirectional Dijkstra on the filtered graph. Since ESX deletes edges of
+ * the paths it finds, this happens from the second search on in most
+ * queries: the hierarchy is then only queried once, and mostly pays off on
+ * the first path. Other kernels ignore @p ch.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param ch The contraction hierarchy of @p G, built on @p weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Length, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<std::is_same_v<
+              typename boost::property_traits<MultiPredecessorMap>::key_type,
+              Vertex>>>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+         double theta, contraction_hierarchy<Graph, Length> const &ch,
+         routing_kernels algorithm = routing_kernels::ch,
+         Terminator &&terminator = Terminator{}) {
+  details::esx_ch_dispatch(G, weight, predecessors, s, t, k, theta, ch,
+                           algorithm, std::forward<Terminator>(terminator));
+}
+
 template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
           typename EdgeCentralityMap,
           typename Terminator = arlib::always_continue,
@@ -161,6 +426,23 @@ void esx(const PropertyGraph &G, MultiPredecessorMap &predecessors, Vertex s,
                         std::forward<Terminator>(terminator));
 }
 
+template <typename PropertyGraph, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<PropertyGraph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void esx(const PropertyGraph &G, MultiPredecessorMap &predecessors, Vertex s,
+         Vertex t, int k, double theta, Kernel kernel,
+         Terminator &&terminator = Terminator{}) {
+  using namespace boost;
+  using Edge = typename graph_traits<PropertyGraph>::edge_descriptor;
+
+  BOOST_CONCEPT_ASSERT(
+      (PropertyGraphConcept<PropertyGraph, Edge, edge_weight_t>));
+
+  esx(G, get(edge_weight, G), predecessors, s, t, k, theta, kernel,
+      std::forward<Terminator>(terminator));
+}
+
 template <typename PropertyGraph, typename MultiPredecessorMap,
           typename EdgeCentralityMap,
           typename Terminator = arlib::always_continue,
@@ -182,6 +464,64 @@ void esx(const PropertyGraph &G, MultiPredecessorMap &predecessors,
   esx(G, weight, predecessors, edge_centrality, s, t, k, theta, algorithm,
       std::forward<Terminator>(terminator));
 }
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, rejecting in constant time the queries whose target
+ * @p reachability tells unreachable, before any search starts.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param reachability The reachability index of @p G.
+ * @param args The trailing arguments of any other `esx()` overload taking a
+ *        weight map, e.g. landmarks, a routing kernel and a terminator.
+ * @throw details::target_not_found if @p t is unreachable from @p s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename... Args>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors, vertex_of_t<Graph> s,
+         vertex_of_t<Graph> t, int k, double theta,
+         reachability_index const &reachability, Args &&... args) {
+  details::throw_if_unreachable(G, reachability, s, t);
+  esx(G, weight, predecessors, s, t, k, theta, std::forward<Args>(args)...);
+}
+
+/**
+ * An implementation of `ESX` k-shortest path with limited overlap for
+ * `Boost::Graph`, answering the query of @p ctx with the shortest path
+ * trees it already holds.
+ *
+ * The first path is read off @p ctx instead of being searched, and with
+ * routing_kernels::astar the shortest path searches are guided by its exact
+ * distances to the target, instead of running a reverse Dijkstra's search
+ * of their own.
+ *
+ * @see esx(const Graph &G, WeightMap const &weight,
+ *          MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *          double theta, routing_kernels algorithm)
+ *
+ * @param ctx The context of the query from @c s to @c t, computed on
+ *        @p weight.
+ * @throw details::target_not_found if @c t is unreachable from @c s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename ContextWeightMap,
+          typename Terminator = arlib::always_continue>
+void esx(const Graph &G, WeightMap const &weight,
+         MultiPredecessorMap &predecessors,
+         query_context<Graph, ContextWeightMap> const &ctx, int k,
+         double theta, routing_kernels algorithm = routing_kernels::astar,
+         Terminator &&terminator = Terminator{}) {
+  details::throw_if_unreachable(ctx);
+  details::esx_heuristic_dispatch(G, weight, predecessors, ctx.source(),
+                                  ctx.target(), k, theta, ctx.heuristic(),
+                                  algorithm,
+                                  std::forward<Terminator>(terminator),
+                                  &ctx.shortest_path());
+}
 } // namespace arlib
 
 #endif
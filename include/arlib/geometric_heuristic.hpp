@@ -0,0 +1,317 @@
+/**
+ * @file geometric_heuristic.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_GEOMETRIC_HEURISTIC_HPP
+#define ALTERNATIVE_ROUTING_LIB_GEOMETRIC_HEURISTIC_HPP
+
+#include <boost/graph/astar_search.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/graph_types.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                              Metrics
+//===----------------------------------------------------------------------===//
+
+/**
+ * The straight-line distance between two points of the plane.
+ */
+struct euclidean_distance {
+  /**
+   * @return The Euclidean distance between @p a and @p b, in the unit of
+   *         their coordinates.
+   */
+  double operator()(coordinate const &a, coordinate const &b) const {
+    return std::hypot(a.x - b.x, a.y - b.y);
+  }
+};
+
+/**
+ * The great-circle distance between two points of the Earth, given their
+ * longitude (`x`) and latitude (`y`) in degrees.
+ */
+struct great_circle_distance {
+  /**
+   * The mean radius of the Earth, in meters.
+   */
+  static constexpr double earth_radius = 6371000.0;
+
+  /**
+   * @return The haversine distance between @p a and @p b, in meters.
+   */
+  double operator()(coordinate const &a, coordinate const &b) const {
+    constexpr double to_radians = 3.14159265358979323846 / 180.0;
+    auto d_lat = (b.y - a.y) * to_radians;
+    auto d_lon = (b.x - a.x) * to_radians;
+    auto s_lat = std::sin(d_lat / 2);
+    auto s_lon = std::sin(d_lon / 2);
+    auto h = s_lat * s_lat + std::cos(a.y * to_radians) *
+                                 std::cos(b.y * to_radians) * s_lon * s_lon;
+    return 2 * earth_radius * std::asin(std::sqrt(std::min(h, 1.0)));
+  }
+};
+
+/**
+ * Compute the maximum speed over the edges of @p G: the largest ratio of
+ * the distance between the endpoints of an edge to its weight.
+ *
+ * Dividing the @p metric distance between two vertices by this speed never
+ * overestimates the weight of a path between them.
+ *
+ * @tparam Graph A Boost::EdgeListGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @tparam Metric A distance between two coordinates.
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param coordinates The coordinates of every vertex of @p G, by index.
+ * @param metric The distance between two coordinates.
+ * @return The maximum speed, infinite if an edge of weight zero joins two
+ *         distinct points.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Metric = euclidean_distance>
+double max_speed(const Graph &G, WeightMap weight, IndexMap index,
+                 std::vector<coordinate> const &coordinates,
+                 Metric metric = Metric{}) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((EdgeListGraphConcept<Graph>));
+
+  auto speed = 0.0;
+  for (auto [it, end] = edges(G); it != end; ++it) {
+    auto distance = metric(coordinates[get(index, source(*it, G))],
+                           coordinates[get(index, target(*it, G))]);
+    auto w = static_cast<double>(get(weight, *it));
+    if (distance > 0) {
+      speed = std::max(speed, w > 0 ? distance / w
+                                    : std::numeric_limits<double>::infinity());
+    }
+  }
+  return speed;
+}
+
+/**
+ * Compute the maximum speed over the edges of @p G, using its
+ * `boost::edge_weight_t` and `boost::vertex_index_t` properties.
+ *
+ * @see max_speed(const Graph &G, WeightMap weight, IndexMap index,
+ *                std::vector<coordinate> const &coordinates, Metric metric)
+ */
+template <typename PropertyGraph, typename Metric = euclidean_distance>
+double max_speed(const PropertyGraph &G,
+                 std::vector<coordinate> const &coordinates,
+                 Metric metric = Metric{}) {
+  return max_speed(G, get(boost::edge_weight, G), get(boost::vertex_index, G),
+                   coordinates, metric);
+}
+
+//===----------------------------------------------------------------------===//
+//                          Geometric heuristic
+//===----------------------------------------------------------------------===//
+
+/**
+ * An A* heuristic bounding the distance to the target by the distance as
+ * the crow flies, travelled at the maximum speed of the graph.
+ *
+ * It needs no preprocessing but the coordinates of the vertices and a
+ * max_speed() computed once per graph, and holds nothing but the target
+ * coordinates per query. The bound is consistent, as @p Metric satisfies
+ * the triangle inequality, and stays so when edges are deleted or their
+ * weights grow, so it serves ESX and Penalty throughout their runs. It is
+ * much looser than the reverse distances of `details::distance_heuristic`:
+ * combine it with a landmark bound through max_heuristic for tighter ones.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam Length The edge weight type.
+ * @tparam Metric A distance between two coordinates.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ */
+template <typename Graph, typename Length, typename Metric = euclidean_distance,
+          typename IndexMap = typename boost::property_map<
+              Graph, boost::vertex_index_t>::const_type>
+class geometric_heuristic : public boost::astar_heuristic<Graph, Length> {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<Graph>;
+  /**
+   * Construct a new geometric_heuristic object.
+   *
+   * @param coordinates The coordinates of every vertex, by index. They must
+   *        outlive the heuristic.
+   * @param speed The maximum speed of the graph, see max_speed().
+   * @param index The IndexMap of the graph.
+   * @param t The target vertex.
+   * @param metric The distance between two coordinates.
+   */
+  geometric_heuristic(std::vector<coordinate> const &coordinates, double speed,
+                      IndexMap index, Vertex t, Metric metric = Metric{})
+      : coordinates{&coordinates}, index{index},
+        target{coordinates[get(index, t)]}, metric{metric},
+        inverse_speed{speed > 0 ? 1.0 / speed : 0.0} {}
+
+  /**
+   * @param u The Vertex
+   * @return A lower bound on the distance from @p u to the target.
+   */
+  Length operator()(Vertex u) const {
+    auto bound =
+        metric((*coordinates)[get(index, u)], target) * inverse_speed;
+    if constexpr (std::is_integral_v<Length>) {
+      // Rounding down keeps the bound admissible and consistent
+      return static_cast<Length>(std::floor(bound));
+    } else {
+      return static_cast<Length>(bound);
+    }
+  }
+
+private:
+  std::vector<coordinate> const *coordinates;
+  IndexMap index;
+  coordinate target;
+  Metric metric;
+  double inverse_speed;
+};
+
+/**
+ * @param G The graph.
+ * @param coordinates The coordinates of every vertex of @p G, by index.
+ * @param speed The maximum speed of @p G, see max_speed().
+ * @param t The target vertex.
+ * @param metric The distance between two coordinates.
+ * @return The geometric_heuristic of @p t on @p G.
+ */
+template <typename Graph, typename Metric = euclidean_distance>
+geometric_heuristic<Graph, length_of_t<Graph>, Metric>
+make_geometric_heuristic(const Graph &G,
+                         std::vector<coordinate> const &coordinates,
+                         double speed, vertex_of_t<Graph> t,
+                         Metric metric = Metric{}) {
+  return {coordinates, speed, get(boost::vertex_index, G), t, metric};
+}
+
+//===----------------------------------------------------------------------===//
+//                            Max heuristic
+//===----------------------------------------------------------------------===//
+
+namespace details {
+template <typename Graph, typename Length>
+std::pair<Graph *, Length>
+astar_heuristic_signature(boost::astar_heuristic<Graph, Length> const &);
+
+/**
+ * The graph of the `boost::astar_heuristic` @p Heuristic derives from.
+ */
+template <typename Heuristic>
+using heuristic_graph_t = std::remove_pointer_t<
+    typename decltype(astar_heuristic_signature(
+        std::declval<Heuristic const &>()))::first_type>;
+
+/**
+ * The cost type of the `boost::astar_heuristic` @p Heuristic derives from.
+ */
+template <typename Heuristic>
+using heuristic_length_t = typename decltype(astar_heuristic_signature(
+    std::declval<Heuristic const &>()))::second_type;
+} // namespace details
+
+/**
+ * An A* heuristic taking the largest of two lower bounds.
+ *
+ * The maximum of two admissible, consistent heuristics is admissible and
+ * consistent, and at least as tight as either of them: e.g. a
+ * geometric_heuristic, which is free, and an alt_heuristic, which is
+ * tighter where the landmarks are well placed.
+ *
+ * @tparam First An A* heuristic.
+ * @tparam Second An A* heuristic on the same graph and cost type.
+ */
+template <typename First, typename Second>
+class max_heuristic
+    : public boost::astar_heuristic<details::heuristic_graph_t<First>,
+                                    details::heuristic_length_t<First>> {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<details::heuristic_graph_t<First>>;
+  /**
+   * The cost type.
+   */
+  using Length = details::heuristic_length_t<First>;
+  static_assert(std::is_same_v<Length, details::heuristic_length_t<Second>>,
+                "Both heuristics must have the same cost type");
+
+  /**
+   * Construct a new max_heuristic object, holding copies of @p first and
+   * @p second.
+   */
+  max_heuristic(First first, Second second)
+      : first{std::move(first)}, second{std::move(second)} {}
+
+  /**
+   * @param u The Vertex
+   * @return The largest of the two lower bounds of @p u.
+   */
+  Length operator()(Vertex u) const { return std::max(first(u), second(u)); }
+
+private:
+  First first;
+  Second second;
+};
+
+/**
+ * @return The max_heuristic of @p first and @p second.
+ */
+template <typename First, typename Second>
+max_heuristic<First, Second> make_max_heuristic(First first, Second second) {
+  return {std::move(first), std::move(second)};
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_GEOMETRIC_HEURISTIC_HPP
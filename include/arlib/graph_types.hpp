@@ -35,6 +35,15 @@
 
 namespace arlib {
 using VPair = std::pair<long unsigned int, long unsigned int>;
+
+/**
+ * The position of a vertex: its `x` and `y` coordinates on the plane, or its
+ * longitude and latitude.
+ */
+struct coordinate {
+  double x;
+  double y;
+};
 } // namespace arlib
 
 #endif
\ No newline at end of file
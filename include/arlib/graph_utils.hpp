@@ -48,6 +48,8 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
 
+#include <arlib/details/gr_parser.hpp>
+#include <arlib/details/mapped_file.hpp>
 #include <arlib/graph_types.hpp>
 #include <arlib/path.hpp>
 #include <arlib/type_traits.hpp>
@@ -63,9 +65,74 @@ using CSRGraph = boost::compressed_sparse_row_graph<
     boost::bidirectionalS, boost::no_property,
     boost::property<boost::edge_weight_t, double>>;
 
+/**
+ * Constructs a CSRGraph from a .gr-format string.
+ *
+ * @see read_graph_from_string(const std::string &graph)
+ *
+ * @throw std::invalid_argument if @p graph is malformed.
+ */
 CSRGraph read_csr_graph_from_string(const std::string &graph);
+
+/**
+ * Constructs a CSRGraph from a .gr file. The file is memory-mapped and
+ * parsed in place.
+ *
+ * @return the constructed graph, or nothing if @p path is not a non-empty
+ *         regular file.
+ * @throw std::invalid_argument if the file is malformed.
+ */
 std::optional<CSRGraph> read_csr_graph_from_file(const std::string_view path);
 
+/**
+ * Reads the coordinates of the vertices of a graph from a DIMACS .co-format
+ * string. An example of .co-format string is the following:
+ * ```
+ * c comments
+ * p aux sp co 3
+ * v 1 -73530767 41085396
+ * v 2 -73530538 41086098
+ * v 3 -73519366 41048796
+ * ```
+ *
+ * Vertex ids are shifted so that the smallest one has index 0: 1-based
+ * DIMACS ids and 0-based ones both map to vertex indices. DIMACS files store
+ * longitudes and latitudes in millionths of a degree, hence @p scale.
+ *
+ * @param coordinates A .co-format string.
+ * @param scale The factor applied to every coordinate read, e.g. 1e-6 to
+ *        turn DIMACS coordinates into degrees.
+ * @return The coordinates of every vertex, by index.
+ */
+std::vector<coordinate>
+read_coordinates_from_string(const std::string &coordinates,
+                             double scale = 1.0);
+
+/**
+ * Reads the coordinates of the vertices of a graph from a DIMACS .co file.
+ *
+ * @see read_coordinates_from_string(const std::string &coordinates,
+ *                                   double scale)
+ *
+ * @param path The path of the .co file.
+ * @return The coordinates of every vertex, by index, or nothing if @p path
+ *         is not a non-empty regular file.
+ */
+std::optional<std::vector<coordinate>>
+read_coordinates_from_file(const std::string_view path, double scale = 1.0);
+
+namespace details {
+/**
+ * Build a PropertyGraph out of a .gr-format text, parsed in place.
+ */
+template <typename PropertyGraph>
+PropertyGraph read_graph_from_gr(std::string_view text) {
+  auto gr = parse_gr<length_of_t<CSRGraph>>(text);
+  return PropertyGraph(std::begin(gr.edges), std::end(gr.edges),
+                       std::begin(gr.weights), gr.nb_vertices);
+}
+} // namespace details
+
 /**
  * Constructs a PropertyGraph from vertices, edges and weights contained in a
  * .gr-format string. An example of .gr-format string is the following:
@@ -81,45 +148,25 @@ std::optional<CSRGraph> read_csr_graph_from_file(const std::string_view path);
  * @tparam PropertyGraph The Graph type
  * @param graph A .gr-format string defining the graph.
  * @return the constructed graph.
+ * @throw std::invalid_argument if @p graph is malformed.
  */
 template <typename PropertyGraph>
 PropertyGraph read_graph_from_string(const std::string &graph) {
-  auto ss = std::stringstream{graph};
-  std::string line{};
-
-  // Drop graph type info
-  std::getline(ss, line);
-
-  // Get number of nodes and edges
-  std::getline(ss, line);
-  auto line_s = std::stringstream{line};
-  int nb_nodes, nb_edges;
-  line_s >> nb_nodes >> nb_edges;
-
-  // Get edges and weights
-  // Get edges and weights
-  using Length = typename arlib::length_of_t<CSRGraph>;
-  auto edges = std::vector<std::pair<long unsigned, long unsigned>>{};
-  auto weights = std::vector<Length>{};
-
-  long unsigned s, t;
-  Length w;
-  while (std::getline(ss, line)) {
-    line_s.str(line);
-    line_s.seekg(std::ios_base::beg);
-    line_s >> s >> t >> w;
-
-    edges.emplace_back(s, t);
-    weights.push_back(w);
-  }
-
-  // Return a PropertyGraph from data
-  auto G = PropertyGraph(std::begin(edges), std::end(edges),
-                         std::begin(weights), nb_nodes);
-
-  return G;
+  return details::read_graph_from_gr<PropertyGraph>(graph);
 }
 
+/**
+ * Constructs a PropertyGraph from a .gr file. The file is memory-mapped and
+ * parsed in place.
+ *
+ * @see read_graph_from_string(const std::string &graph)
+ *
+ * @tparam PropertyGraph The Graph type
+ * @param path The path of the .gr file.
+ * @return the constructed graph, or nothing if @p path is not a non-empty
+ *         regular file.
+ * @throw std::invalid_argument if the file is malformed.
+ */
 template <typename PropertyGraph>
 std::optional<PropertyGraph> read_graph_from_file(const std::string_view path) {
   namespace fs = std::filesystem;
@@ -135,11 +182,9 @@ std::optional<PropertyGraph> read_graph_from_file(const std::string_view path) {
     return {};
   }
 
-  auto buffer = std::stringstream{};
-  auto input = std::ifstream{fs_path.string()};
-  buffer << input.rdbuf();
-
-  return {read_graph_from_string<PropertyGraph>(buffer.str())};
+  auto file = details::mapped_file{fs_path.string()};
+  return {details::read_graph_from_gr<PropertyGraph>(
+      std::string_view{file.data(), file.size()})};
 }
 
 /**
@@ -224,8 +269,8 @@ Graph build_AG(const std::vector<Path<Graph>> &paths, const Graph &g) {
       auto u = source(*it, g);
       auto v = target(*it, g);
 
-      auto e = edge(u, v, g).first; // Assume it exists
-      auto w = weight[e];
+      // Edges of a Path are edges of g
+      auto w = weight[*it];
 
       es.emplace_back(u, v);
       weights.push_back(w);
@@ -0,0 +1,565 @@
+/**
+ * @file hub_labels.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_HUB_LABELS_HPP
+#define ALTERNATIVE_ROUTING_LIB_HUB_LABELS_HPP
+
+#include <boost/graph/astar_search.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/binary_io.hpp>
+#include <arlib/details/hub_labels_impl.hpp>
+#include <arlib/details/mapped_file.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                             Hub labels
+//===----------------------------------------------------------------------===//
+
+namespace details {
+/**
+ * The flat arrays of a set of hub labels, wherever they are stored.
+ */
+template <typename Length> struct hub_label_arrays {
+  std::uint64_t const *out_offsets;
+  std::uint32_t const *out_hubs;
+  Length const *out_distances;
+  std::uint64_t const *in_offsets;
+  std::uint32_t const *in_hubs;
+  Length const *in_distances;
+};
+
+/**
+ * Hub label arrays owned by the labels themselves.
+ */
+template <typename Length> struct hub_label_storage {
+  std::vector<std::uint64_t> out_offsets;
+  std::vector<std::uint32_t> out_hubs;
+  std::vector<Length> out_distances;
+  std::vector<std::uint64_t> in_offsets;
+  std::vector<std::uint32_t> in_hubs;
+  std::vector<Length> in_distances;
+};
+} // namespace details
+
+/**
+ * A 2-hop labeling of a graph: an exact distance oracle.
+ *
+ * Every vertex `v` has a forward label, a few hubs with the distance from
+ * `v` to each of them, and a backward label, a few hubs with the distance
+ * from each of them to `v`. Labels are built so that some shortest path
+ * from `u` to `v` always passes through a hub of both the forward label of
+ * `u` and the backward label of `v`. Then `d(u, v)` is the minimum of
+ * `d(u, h) + d(h, v)` over their common hubs: one merge of two sorted
+ * arrays of a few dozen entries on road networks, instead of a search.
+ *
+ * Labels are stored as flat arrays: per-vertex offsets, then hub ranks and
+ * distances. The arrays are either owned, or read in place from a file
+ * mapped by map_hub_labels(). Copies share the same arrays, which never
+ * change.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class hub_labels {
+public:
+  hub_labels() = default;
+  /**
+   * Construct a new hub_labels object owning its arrays.
+   *
+   * @param num_vertices The number of vertices of the graph.
+   * @param storage The label arrays. Offsets have `num_vertices + 1`
+   *        entries, and the label of vertex `v` spans
+   *        `[offsets[v], offsets[v + 1])` of the hubs and distances.
+   */
+  hub_labels(std::size_t num_vertices,
+             details::hub_label_storage<Length> storage)
+      : n{num_vertices} {
+    auto owned = std::make_shared<details::hub_label_storage<Length>>(
+        std::move(storage));
+    arrays = details::hub_label_arrays<Length>{
+        owned->out_offsets.data(), owned->out_hubs.data(),
+        owned->out_distances.data(), owned->in_offsets.data(),
+        owned->in_hubs.data(), owned->in_distances.data()};
+    keep_alive = std::move(owned);
+  }
+  /**
+   * Construct a new hub_labels object reading arrays owned by @p owner,
+   * e.g. a details::mapped_file.
+   *
+   * @param num_vertices The number of vertices of the graph.
+   * @param arrays The label arrays.
+   * @param owner The owner of @p arrays, kept alive by the labels.
+   */
+  hub_labels(std::size_t num_vertices,
+             details::hub_label_arrays<Length> arrays,
+             std::shared_ptr<void const> owner)
+      : n{num_vertices}, arrays{arrays}, keep_alive{std::move(owner)} {}
+
+  /**
+   * @return The number of vertices of the graph.
+   */
+  std::size_t num_vertices() const { return n; }
+  /**
+   * @return The total number of forward label entries.
+   */
+  std::size_t num_out_entries() const {
+    return n == 0 ? 0 : static_cast<std::size_t>(arrays.out_offsets[n]);
+  }
+  /**
+   * @return The total number of backward label entries.
+   */
+  std::size_t num_in_entries() const {
+    return n == 0 ? 0 : static_cast<std::size_t>(arrays.in_offsets[n]);
+  }
+  /**
+   * @param v A vertex index.
+   * @return The forward label of @p v: distances to its hubs.
+   */
+  details::label_view<Length> out_label(std::size_t v) const {
+    auto first = arrays.out_offsets[v];
+    return {arrays.out_hubs + first, arrays.out_distances + first,
+            static_cast<std::size_t>(arrays.out_offsets[v + 1] - first)};
+  }
+  /**
+   * @param v A vertex index.
+   * @return The backward label of @p v: distances from its hubs.
+   */
+  details::label_view<Length> in_label(std::size_t v) const {
+    auto first = arrays.in_offsets[v];
+    return {arrays.in_hubs + first, arrays.in_distances + first,
+            static_cast<std::size_t>(arrays.in_offsets[v + 1] - first)};
+  }
+  /**
+   * @param u A vertex index.
+   * @param v A vertex index.
+   * @return The distance from @p u to @p v, or
+   *         `std::numeric_limits<Length>::max()` if @p v is not reachable
+   *         from @p u.
+   */
+  Length distance(std::size_t u, std::size_t v) const {
+    return details::label_intersection(out_label(u), in_label(v));
+  }
+  /**
+   * @return The label arrays.
+   */
+  details::hub_label_arrays<Length> const &data() const { return arrays; }
+
+private:
+  std::size_t n = 0;
+  details::hub_label_arrays<Length> arrays{};
+  std::shared_ptr<void const> keep_alive;
+};
+
+namespace details {
+/**
+ * Pack the labels built by pruned_landmark_labeling() into the flat arrays
+ * of arlib::hub_labels.
+ */
+template <typename Length>
+hub_labels<Length> flatten_labels(label_sets<Length> const &labels) {
+  auto n = labels.out.size();
+  auto storage = hub_label_storage<Length>{};
+  auto flatten = [n](auto const &sets, auto &offsets, auto &hubs,
+                     auto &distances) {
+    offsets.resize(n + 1);
+    offsets[0] = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+      offsets[v + 1] = offsets[v] + sets[v].size();
+    }
+    hubs.reserve(offsets[n]);
+    distances.reserve(offsets[n]);
+    for (auto const &label : sets) {
+      for (auto const &entry : label) {
+        hubs.push_back(entry.hub);
+        distances.push_back(entry.distance);
+      }
+    }
+  };
+  flatten(labels.out, storage.out_offsets, storage.out_hubs,
+          storage.out_distances);
+  flatten(labels.in, storage.in_offsets, storage.in_hubs,
+          storage.in_distances);
+  return hub_labels<Length>{n, std::move(storage)};
+}
+} // namespace details
+
+/**
+ * Build the hub labels of @p G by pruned landmark labeling.
+ *
+ * Vertices are taken as hubs one at a time. Each runs a forward and a
+ * backward Dijkstra's search, pruned at every vertex whose distance the
+ * labels built so far already cover. The earlier a vertex is taken, the
+ * more it prunes: this overload takes them by decreasing degree.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::BidirectionalGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @throw std::domain_error if a negative weight is detected.
+ * @return The hub labels of @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length = value_of_t<WeightMap>>
+hub_labels<Length> build_hub_labels(const Graph &G, WeightMap weight,
+                                    IndexMap index) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<Graph>));
+
+  auto order = details::degree_order(G, index);
+  auto labels = details::pruned_landmark_labeling<Graph, WeightMap, IndexMap,
+                                                  Length>(G, weight, index,
+                                                          order);
+  return details::flatten_labels(labels);
+}
+
+/**
+ * Build the hub labels of @p G by pruned landmark labeling, taking the
+ * vertices as hubs from the top of a contraction hierarchy down.
+ *
+ * The contraction order ranks vertices by how many shortest paths they
+ * cover, so on road networks these labels are several times smaller, and
+ * faster to build and query, than with a degree order.
+ *
+ * @see build_hub_labels(const Graph &G, WeightMap weight, IndexMap index)
+ *
+ * @param ch A contraction hierarchy of @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename CHLength, typename Length = value_of_t<WeightMap>>
+hub_labels<Length>
+build_hub_labels(const Graph &G, WeightMap weight, IndexMap index,
+                 contraction_hierarchy<Graph, CHLength> const &ch) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<Graph>));
+
+  auto n = num_vertices(G);
+  auto order = std::vector<std::size_t>(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    order[n - 1 - ch.rank(v)] = v;
+  }
+  auto labels = details::pruned_landmark_labeling<Graph, WeightMap, IndexMap,
+                                                  Length>(G, weight, index,
+                                                          order);
+  return details::flatten_labels(labels);
+}
+
+/**
+ * Build the hub labels of a `PropertyGraph`, using its
+ * `boost::edge_weight_t` and `boost::vertex_index_t` properties.
+ *
+ * @see build_hub_labels(const Graph &G, WeightMap weight, IndexMap index)
+ */
+template <typename PropertyGraph>
+auto build_hub_labels(const PropertyGraph &G) {
+  return build_hub_labels(G, get(boost::edge_weight, G),
+                          get(boost::vertex_index, G));
+}
+
+//===----------------------------------------------------------------------===//
+//                        Hub labels serialization
+//===----------------------------------------------------------------------===//
+
+namespace details {
+constexpr char hub_labels_magic[4] = {'A', 'R', 'H', 'L'};
+constexpr std::uint32_t hub_labels_version = 1;
+
+/**
+ * The fixed-size header of a hub labels file.
+ */
+struct hub_labels_header {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t length_size;
+  std::uint32_t reserved;
+  std::uint64_t num_vertices;
+  std::uint64_t num_out_entries;
+  std::uint64_t num_in_entries;
+};
+
+/**
+ * @return true if @p header is the header of hub labels of @p Length.
+ */
+template <typename Length>
+bool valid_header(hub_labels_header const &header) {
+  return std::equal(header.magic, header.magic + 4, hub_labels_magic) &&
+         header.version == hub_labels_version &&
+         header.length_size == sizeof(Length);
+}
+} // namespace details
+
+/**
+ * Write @p labels to @p os in a binary format: a header with a magic number,
+ * a version, `sizeof(Length)`, the number of vertices and of label entries,
+ * then the offsets, hubs and distances of the forward and backward labels,
+ * each padded to 8 bytes, in native byte order.
+ *
+ * The layout is the same in memory and on disk, so map_hub_labels() reads
+ * the file in place.
+ *
+ * @param os The stream to write to. Open it in binary mode.
+ * @param labels The hub labels.
+ */
+template <typename Length>
+void write_hub_labels(std::ostream &os, hub_labels<Length> const &labels) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto n = labels.num_vertices();
+  auto header = details::hub_labels_header{};
+  std::copy(details::hub_labels_magic, details::hub_labels_magic + 4,
+            header.magic);
+  header.version = details::hub_labels_version;
+  header.length_size = static_cast<std::uint32_t>(sizeof(Length));
+  header.num_vertices = n;
+  header.num_out_entries = labels.num_out_entries();
+  header.num_in_entries = labels.num_in_entries();
+  details::write_raw(os, &header, 1);
+  if (n == 0) {
+    return;
+  }
+
+  auto const &arrays = labels.data();
+  details::write_raw(os, arrays.out_offsets, n + 1);
+  details::write_raw(os, arrays.in_offsets, n + 1);
+  details::write_padded(os, arrays.out_hubs, header.num_out_entries);
+  details::write_padded(os, arrays.out_distances, header.num_out_entries);
+  details::write_padded(os, arrays.in_hubs, header.num_in_entries);
+  details::write_padded(os, arrays.in_distances, header.num_in_entries);
+}
+
+/**
+ * Read hub labels written by write_hub_labels() into memory.
+ *
+ * @param is The stream to read from. Open it in binary mode.
+ * @return The hub labels, or an empty optional if @p is does not hold hub
+ *         labels of the same `Length` type.
+ */
+template <typename Length>
+std::optional<hub_labels<Length>> read_hub_labels(std::istream &is) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto header = details::hub_labels_header{};
+  if (!details::read_raw(is, &header, 1) ||
+      !details::valid_header<Length>(header)) {
+    return {};
+  }
+  auto n = static_cast<std::size_t>(header.num_vertices);
+  if (n == 0) {
+    return hub_labels<Length>{};
+  }
+
+  auto storage = details::hub_label_storage<Length>{};
+  auto num_out = static_cast<std::size_t>(header.num_out_entries);
+  auto num_in = static_cast<std::size_t>(header.num_in_entries);
+  if (!details::read_padded(is, storage.out_offsets, n + 1) ||
+      !details::read_padded(is, storage.in_offsets, n + 1) ||
+      !details::read_padded(is, storage.out_hubs, num_out) ||
+      !details::read_padded(is, storage.out_distances, num_out) ||
+      !details::read_padded(is, storage.in_hubs, num_in) ||
+      !details::read_padded(is, storage.in_distances, num_in) ||
+      storage.out_offsets[n] != num_out || storage.in_offsets[n] != num_in) {
+    return {};
+  }
+  return hub_labels<Length>{n, std::move(storage)};
+}
+
+/**
+ * Map hub labels written by write_hub_labels() to a file, and read them in
+ * place.
+ *
+ * Opening costs a few system calls whatever the size of the labels: pages
+ * are loaded as queries touch them and are shared with every other process
+ * mapping the same file.
+ *
+ * @param path The path of the file.
+ * @throw std::system_error if the file cannot be opened or mapped.
+ * @return The hub labels, or an empty optional if the file does not hold
+ *         hub labels of the same `Length` type.
+ */
+template <typename Length>
+std::optional<hub_labels<Length>> map_hub_labels(std::string const &path) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto file = std::make_shared<details::mapped_file>(path);
+  auto header = details::hub_labels_header{};
+  if (file->size() < sizeof(header)) {
+    return {};
+  }
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (!details::valid_header<Length>(header)) {
+    return {};
+  }
+  auto n = static_cast<std::size_t>(header.num_vertices);
+  if (n == 0) {
+    return hub_labels<Length>{};
+  }
+
+  // Every array starts on an 8-byte boundary of the page-aligned mapping
+  auto num_out = static_cast<std::size_t>(header.num_out_entries);
+  auto num_in = static_cast<std::size_t>(header.num_in_entries);
+  auto offsets_bytes = (n + 1) * sizeof(std::uint64_t);
+  auto section = std::vector<std::size_t>{
+      sizeof(header),
+      offsets_bytes,
+      offsets_bytes,
+      details::padded_size(num_out * sizeof(std::uint32_t)),
+      details::padded_size(num_out * sizeof(Length)),
+      details::padded_size(num_in * sizeof(std::uint32_t)),
+      details::padded_size(num_in * sizeof(Length))};
+  auto start = std::vector<char const *>{};
+  auto position = std::size_t{0};
+  for (auto bytes : section) {
+    start.push_back(file->data() + position);
+    position += bytes;
+  }
+  if (position != file->size()) {
+    return {};
+  }
+
+  auto arrays = details::hub_label_arrays<Length>{
+      reinterpret_cast<std::uint64_t const *>(start[1]),
+      reinterpret_cast<std::uint32_t const *>(start[3]),
+      reinterpret_cast<Length const *>(start[4]),
+      reinterpret_cast<std::uint64_t const *>(start[2]),
+      reinterpret_cast<std::uint32_t const *>(start[5]),
+      reinterpret_cast<Length const *>(start[6])};
+  if (arrays.out_offsets[n] != num_out || arrays.in_offsets[n] != num_in) {
+    return {};
+  }
+  return hub_labels<Length>{n, arrays, std::move(file)};
+}
+
+//===----------------------------------------------------------------------===//
+//                          Hub label heuristic
+//===----------------------------------------------------------------------===//
+
+/**
+ * An A* heuristic reading exact distances to the target from hub labels.
+ *
+ * It replaces `details::distance_heuristic`, which runs a full reverse
+ * Dijkstra's search per query, with one label merge per vertex visited.
+ * Distances on the labeled graph remain consistent lower bounds when edges
+ * are deleted or their weights grow, so the same labels serve ESX and
+ * Penalty throughout their runs. Like `details::distance_heuristic`, it is
+ * `std::numeric_limits<Length>::max()` for vertices that cannot reach the
+ * target.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam Length The edge weight type.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ */
+template <typename Graph, typename Length,
+          typename IndexMap = typename boost::property_map<
+              Graph, boost::vertex_index_t>::const_type>
+class hub_label_heuristic : public boost::astar_heuristic<Graph, Length> {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<Graph>;
+  /**
+   * Construct a new hub_label_heuristic object.
+   *
+   * @param labels The hub labels. They must outlive the heuristic.
+   * @param index The IndexMap of the graph.
+   * @param t The target vertex.
+   */
+  hub_label_heuristic(hub_labels<Length> const &labels, IndexMap index,
+                      Vertex t)
+      : labels{&labels}, index{index}, t_label{labels.in_label(get(index, t))} {
+  }
+
+  /**
+   * @param u The Vertex
+   * @return The distance from @p u to the target.
+   */
+  Length operator()(Vertex u) const {
+    return details::label_intersection(labels->out_label(get(index, u)),
+                                       t_label);
+  }
+
+private:
+  hub_labels<Length> const *labels;
+  IndexMap index;
+  details::label_view<Length> t_label;
+};
+
+/**
+ * @param G The graph.
+ * @param labels The hub labels of @p G.
+ * @param t The target vertex.
+ * @return The hub_label_heuristic of @p t on @p G.
+ */
+template <typename Graph, typename Length>
+hub_label_heuristic<Graph, Length>
+make_hub_label_heuristic(const Graph &G, hub_labels<Length> const &labels,
+                         vertex_of_t<Graph> t) {
+  return hub_label_heuristic<Graph, Length>{labels, get(boost::vertex_index, G),
+                                            t};
+}
+
+namespace details {
+template <typename T> struct is_hub_labels : std::false_type {};
+template <typename Length>
+struct is_hub_labels<hub_labels<Length>> : std::true_type {};
+/**
+ * True if @p T is a specialization of arlib::hub_labels.
+ */
+template <typename T>
+constexpr bool is_hub_labels_v = is_hub_labels<std::decay_t<T>>::value;
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_HUB_LABELS_HPP
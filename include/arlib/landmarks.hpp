@@ -0,0 +1,453 @@
+/**
+ * @file landmarks.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_LANDMARKS_HPP
+#define ALTERNATIVE_ROUTING_LIB_LANDMARKS_HPP
+
+#include <boost/graph/astar_search.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/details/binary_io.hpp>
+#include <arlib/details/landmarks_impl.hpp>
+#include <arlib/routing_kernels/multi_source_dijkstra.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                          ALT landmarks
+//===----------------------------------------------------------------------===//
+
+/**
+ * Landmark selection strategies of select_landmarks().
+ */
+enum class landmark_selection {
+  farthest = 1, /**< Pick the vertex farthest from the current landmarks. */
+  avoid /**< Pick a leaf of the region worst covered by current landmarks. */
+};
+
+/**
+ * The distances from and to a set of landmarks, the preprocessing of ALT
+ * (A*, Landmarks, Triangle inequality).
+ *
+ * For any landmark `L` and vertices `u`, `v` the triangle inequality gives
+ * <tt>d(u, v) >= d(u, L) - d(v, L)</tt> and
+ * <tt>d(u, v) >= d(L, v) - d(L, u)</tt>, so a lower bound on the distance
+ * between any two vertices is a handful of array reads away. Unlike
+ * `details::distance_heuristic`, which runs a full reverse Dijkstra's search
+ * per query, landmarks are computed once per graph and can be saved with
+ * write_landmarks() and loaded back with read_landmarks().
+ *
+ * Distances are stored vertex-major: the distances of a vertex to all the
+ * landmarks are contiguous in memory, which is how lower_bound() reads them.
+ * Unreachable pairs store `std::numeric_limits<Length>::max()`.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class landmarks {
+public:
+  landmarks() = default;
+  /**
+   * Construct a new landmarks object.
+   *
+   * @param num_vertices The number of vertices of the graph.
+   * @param ids The vertex index of each landmark.
+   * @param from The distance from landmark `i` to vertex `v` at
+   *        `v * ids.size() + i`.
+   * @param to The distance from vertex `v` to landmark `i` at
+   *        `v * ids.size() + i`.
+   */
+  landmarks(std::size_t num_vertices, std::vector<std::size_t> ids,
+            std::vector<Length> from, std::vector<Length> to)
+      : n{num_vertices}, ids{std::move(ids)}, from{std::move(from)},
+        to{std::move(to)} {}
+
+  /**
+   * @return The number of landmarks.
+   */
+  std::size_t size() const { return ids.size(); }
+  /**
+   * @return The number of vertices of the graph.
+   */
+  std::size_t num_vertices() const { return n; }
+  /**
+   * @return The vertex index of each landmark.
+   */
+  std::vector<std::size_t> const &vertices() const { return ids; }
+  /**
+   * @param i A landmark.
+   * @param v A vertex index.
+   * @return The distance from landmark @p i to @p v.
+   */
+  Length from_landmark(std::size_t i, std::size_t v) const {
+    return from[v * ids.size() + i];
+  }
+  /**
+   * @param i A landmark.
+   * @param v A vertex index.
+   * @return The distance from @p v to landmark @p i.
+   */
+  Length to_landmark(std::size_t i, std::size_t v) const {
+    return to[v * ids.size() + i];
+  }
+  /**
+   * @param u A vertex index.
+   * @param v A vertex index.
+   * @return A lower bound on the distance from @p u to @p v.
+   */
+  Length lower_bound(std::size_t u, std::size_t v) const {
+    auto k = ids.size();
+    auto bound = Length{};
+    for (std::size_t i = 0; i < k; ++i) {
+      auto b = details::landmark_bound(from[u * k + i], to[u * k + i],
+                                       from[v * k + i], to[v * k + i]);
+      bound = b > bound ? b : bound;
+    }
+    return bound;
+  }
+  /**
+   * @return The distances from the landmarks, vertex-major.
+   */
+  std::vector<Length> const &from_distances() const { return from; }
+  /**
+   * @return The distances to the landmarks, vertex-major.
+   */
+  std::vector<Length> const &to_distances() const { return to; }
+
+private:
+  std::size_t n = 0;
+  std::vector<std::size_t> ids;
+  std::vector<Length> from;
+  std::vector<Length> to;
+};
+
+namespace details {
+/**
+ * Interleave per-landmark distance arrays into the vertex-major arrays of
+ * arlib::landmarks.
+ */
+template <typename Length>
+landmarks<Length>
+interleave_landmarks(std::size_t n,
+                     std::vector<landmark_distances<Length>> const &selected) {
+  auto k = selected.size();
+  auto ids = std::vector<std::size_t>(k);
+  auto from = std::vector<Length>(n * k);
+  auto to = std::vector<Length>(n * k);
+  for (std::size_t i = 0; i < k; ++i) {
+    ids[i] = selected[i].landmark;
+    for (std::size_t v = 0; v < n; ++v) {
+      from[v * k + i] = selected[i].from[v];
+      to[v * k + i] = selected[i].to[v];
+    }
+  }
+  return landmarks<Length>{n, std::move(ids), std::move(from), std::move(to)};
+}
+} // namespace details
+
+/**
+ * Select @p count landmarks of @p G and compute the distances from and to
+ * each of them: 2 * @p count Dijkstra's searches, plus one per landmark with
+ * landmark_selection::avoid.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::IncidenceGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param count The number of landmarks.
+ * @param selection The landmark selection strategy.
+ * @param seed The seed of the random choices of the strategy.
+ * @return The landmarks of @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length = value_of_t<WeightMap>>
+landmarks<Length>
+select_landmarks(const Graph &G, WeightMap weight, IndexMap index,
+                 std::size_t count,
+                 landmark_selection selection = landmark_selection::avoid,
+                 unsigned seed = 0) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+
+  auto n = num_vertices(G);
+  auto engine = std::mt19937{seed};
+  auto selected = selection == landmark_selection::farthest
+                      ? details::farthest_landmarks<Length>(G, weight, index,
+                                                            count, engine)
+                      : details::avoid_landmarks<Length>(G, weight, index,
+                                                         count, engine);
+
+  return details::interleave_landmarks(n, selected);
+}
+
+/**
+ * Compute the distances from and to each vertex of @p vertices, chosen as
+ * landmarks by the caller, e.g. depots or a selection made elsewhere.
+ *
+ * Distances are computed by multi_source_dijkstra(), on @p G and on its
+ * reverse graph, for 8 landmarks per pass.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::BidirectionalGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param vertices The landmark vertices.
+ * @return The landmarks of @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+landmarks<Length> make_landmarks(const Graph &G, WeightMap weight,
+                                 IndexMap index,
+                                 std::vector<Vertex> const &vertices) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<Graph>));
+
+  auto from = multi_source_distances(G, vertices, weight, index);
+  auto rev_G = make_reverse_graph(G);
+  auto to = multi_source_distances(
+      rev_G, vertices, details::make_reverse_weight_map(weight, rev_G), index);
+
+  auto selected = std::vector<details::landmark_distances<Length>>{};
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    selected.push_back(details::landmark_distances<Length>{
+        static_cast<std::size_t>(get(index, vertices[i])), std::move(from[i]),
+        std::move(to[i])});
+  }
+  return details::interleave_landmarks(num_vertices(G), selected);
+}
+
+/**
+ * Select @p count landmarks of a `PropertyGraph`, using its
+ * `boost::edge_weight_t` and `boost::vertex_index_t` properties.
+ *
+ * @see select_landmarks(const Graph &G, WeightMap weight, IndexMap index,
+ *                       std::size_t count, landmark_selection selection,
+ *                       unsigned seed)
+ */
+template <typename PropertyGraph>
+auto select_landmarks(const PropertyGraph &G, std::size_t count,
+                      landmark_selection selection = landmark_selection::avoid,
+                      unsigned seed = 0) {
+  return select_landmarks(G, get(boost::edge_weight, G),
+                          get(boost::vertex_index, G), count, selection, seed);
+}
+
+//===----------------------------------------------------------------------===//
+//                        Landmarks serialization
+//===----------------------------------------------------------------------===//
+
+namespace details {
+constexpr char landmarks_magic[4] = {'A', 'R', 'L', 'M'};
+constexpr std::uint32_t landmarks_version = 1;
+} // namespace details
+
+/**
+ * Write @p lm to @p os in a binary format: a header with a magic number, a
+ * version, `sizeof(Length)`, the number of vertices and of landmarks, then
+ * the landmark ids and the distance arrays, in native byte order.
+ *
+ * @param os The stream to write to. Open it in binary mode.
+ * @param lm The landmarks.
+ */
+template <typename Length>
+void write_landmarks(std::ostream &os, landmarks<Length> const &lm) {
+  static_assert(std::is_trivially_copyable_v<Length>,
+                "Only trivially copyable lengths can be serialized.");
+  auto header = std::vector<std::uint64_t>{lm.num_vertices(), lm.size()};
+  auto length_size = static_cast<std::uint32_t>(sizeof(Length));
+  auto ids = std::vector<std::uint64_t>(lm.vertices().begin(),
+                                        lm.vertices().end());
+
+  os.write(details::landmarks_magic, sizeof(details::landmarks_magic));
+  details::write_raw(os, &details::landmarks_version, 1);
+  details::write_raw(os, &length_size, 1);
+  details::write_raw(os, header.data(), header.size());
+  details::write_raw(os, ids.data(), ids.size());
+  details::write_raw(os, lm.from_distances().data(),
+                     lm.from_distances().size());
+  details::write_raw(os, lm.to_distances().data(), lm.to_distances().size());
+}
+
+/**
+ * Read landmarks written by write_landmarks().
+ *
+ * @param is The stream to read from. Open it in binary mode.
+ * @return The landmarks, or an empty optional if @p is does not hold
+ *         landmarks of the same `Length` type.
+ */
+template <typename Length>
+std::optional<landmarks<Length>> read_landmarks(std::istream &is) {
+  static_assert(std::is_trivially_copyable_v<Length>,
+                "Only trivially copyable lengths can be serialized.");
+  char magic[4];
+  auto version = std::uint32_t{};
+  auto length_size = std::uint32_t{};
+  std::uint64_t header[2];
+  if (!details::read_raw(is, magic, 4) ||
+      !std::equal(magic, magic + 4, details::landmarks_magic) ||
+      !details::read_raw(is, &version, 1) ||
+      version != details::landmarks_version ||
+      !details::read_raw(is, &length_size, 1) ||
+      length_size != sizeof(Length) || !details::read_raw(is, header, 2)) {
+    return {};
+  }
+
+  auto n = static_cast<std::size_t>(header[0]);
+  auto k = static_cast<std::size_t>(header[1]);
+  auto raw_ids = std::vector<std::uint64_t>(k);
+  auto from = std::vector<Length>(n * k);
+  auto to = std::vector<Length>(n * k);
+  if (!details::read_raw(is, raw_ids.data(), k) ||
+      !details::read_raw(is, from.data(), from.size()) ||
+      !details::read_raw(is, to.data(), to.size())) {
+    return {};
+  }
+
+  auto ids = std::vector<std::size_t>(raw_ids.begin(), raw_ids.end());
+  return landmarks<Length>{n, std::move(ids), std::move(from), std::move(to)};
+}
+
+//===----------------------------------------------------------------------===//
+//                          ALT heuristic
+//===----------------------------------------------------------------------===//
+
+/**
+ * An A* heuristic using landmark lower bounds.
+ *
+ * Construction reads the distances of the target from each landmark and
+ * nothing else, so, unlike `details::distance_heuristic`, it costs
+ * O(#landmarks) per query. Landmark bounds stay admissible when edges are
+ * deleted or their weights grow, so the same landmarks serve ESX and
+ * Penalty throughout their runs.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam Length The edge weight type.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ */
+template <typename Graph, typename Length,
+          typename IndexMap = typename boost::property_map<
+              Graph, boost::vertex_index_t>::const_type>
+class alt_heuristic : public boost::astar_heuristic<Graph, Length> {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<Graph>;
+  /**
+   * Construct a new alt_heuristic object.
+   *
+   * @param lm The landmarks. They must outlive the heuristic.
+   * @param index The IndexMap of the graph.
+   * @param t The target vertex.
+   */
+  alt_heuristic(landmarks<Length> const &lm, IndexMap index, Vertex t)
+      : lm{&lm}, index{index}, from_t(lm.size()), to_t(lm.size()) {
+    auto t_index = get(index, t);
+    for (std::size_t i = 0; i < lm.size(); ++i) {
+      from_t[i] = lm.from_landmark(i, t_index);
+      to_t[i] = lm.to_landmark(i, t_index);
+    }
+  }
+
+  /**
+   * @param u The Vertex
+   * @return A lower bound on the distance from @p u to the target.
+   */
+  Length operator()(Vertex u) const {
+    auto u_index = get(index, u);
+    auto bound = Length{};
+    for (std::size_t i = 0; i < from_t.size(); ++i) {
+      auto b = details::landmark_bound(lm->from_landmark(i, u_index),
+                                       lm->to_landmark(i, u_index), from_t[i],
+                                       to_t[i]);
+      bound = b > bound ? b : bound;
+    }
+    return bound;
+  }
+
+private:
+  landmarks<Length> const *lm;
+  IndexMap index;
+  std::vector<Length> from_t;
+  std::vector<Length> to_t;
+};
+
+/**
+ * @param G The graph.
+ * @param lm The landmarks of @p G.
+ * @param t The target vertex.
+ * @return The alt_heuristic of @p t on @p G.
+ */
+template <typename Graph, typename Length>
+alt_heuristic<Graph, Length> make_alt_heuristic(const Graph &G,
+                                                landmarks<Length> const &lm,
+                                                vertex_of_t<Graph> t) {
+  return alt_heuristic<Graph, Length>{lm, get(boost::vertex_index, G), t};
+}
+
+namespace details {
+template <typename T> struct is_landmarks : std::false_type {};
+template <typename Length>
+struct is_landmarks<landmarks<Length>> : std::true_type {};
+/**
+ * True if @p T is a specialization of arlib::landmarks.
+ */
+template <typename T>
+constexpr bool is_landmarks_v = is_landmarks<std::decay_t<T>>::value;
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_LANDMARKS_HPP
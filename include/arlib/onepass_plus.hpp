@@ -35,7 +35,13 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
 
+#include <arlib/hub_labels.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/query_context.hpp>
+#include <arlib/reachability_index.hpp>
+#include <arlib/routing_kernels/phast.hpp>
 #include <arlib/terminators.hpp>
+#include <arlib/thread_pool.hpp>
 #include <arlib/type_traits.hpp>
 
 #include <arlib/details/onepass_plus_impl.hpp>
@@ -44,6 +50,7 @@
 #include <iostream>
 #include <memory>
 #include <queue>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -61,6 +68,11 @@ namespace arlib {
  * Overlap , In Proc. of the 20th Int. Conf. on Extending Database Technology
  * (EDBT) (2017)
  *
+ * Unlike esx() and penalty(), OnePass+ takes no SearchWorkspace: it runs a
+ * single point-to-point search, for the shortest path, and then one label
+ * search whose labels and skyline grow with the alternatives, not with
+ * |V|. Its memory is thus allocated per query.
+ *
  * @tparam Graph A Boost::VertexAndEdgeListGraph
  * @tparam WeightMap The weight or "length" of each edge in the graph. The
  *         weights must all be non-negative, and the algorithm will throw a
@@ -94,160 +106,144 @@ namespace arlib {
  */
 template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
           typename Terminator = arlib::always_continue,
-          typename Vertex = vertex_of_t<Graph>>
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<
+              !details::is_landmarks_v<Terminator> &&
+              !details::is_hub_labels_v<Terminator> &&
+              !details::is_phast_hierarchy_v<Terminator> &&
+              !details::is_reachability_index_v<Terminator> &&
+              !details::is_astar_heuristic_v<Graph, value_of_t<WeightMap>,
+                                             Terminator> &&
+              !std::is_same_v<std::decay_t<Terminator>, thread_pool>>>
 void onepass_plus(const Graph &G, WeightMap weight,
                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
                   double theta, Terminator &&terminator = Terminator{}) {
-  using namespace boost;
-  using Edge = typename graph_traits<Graph>::edge_descriptor;
   using Length = typename boost::property_traits<WeightMap>::value_type;
+  // Lower bounds for AStar, computed as far as the search needs them
+  auto heuristic = details::lazy_distance_heuristic<Graph, Length>(G, t);
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
+}
 
-  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
-  BOOST_CONCEPT_ASSERT((LvaluePropertyMapConcept<WeightMap, Edge>));
-  BOOST_CONCEPT_ASSERT(
-      (ReadablePropertyMapConcept<MultiPredecessorMap, Vertex>));
-
-  auto resPathsEdges = std::vector<std::vector<Edge>>{};
-
-  // resEdges keeps track of the edges that make the paths in resPaths and which
-  // path includes it.
-  using resPathIndex = typename decltype(resPathsEdges)::size_type;
-  auto resEdges =
-      std::unordered_map<Edge, std::vector<resPathIndex>, boost::hash<Edge>>{};
-
-  // Min-priority queue
-  using Label = details::OnePassLabel<Graph, Length>;
-  using LabelPtr = std::unique_ptr<Label>;
-  auto Q =
-      std::priority_queue<Label *, std::vector<Label *>,
-                          details::OnePassPlusASComparator<Graph, Length>>{};
-  auto created_labels = std::vector<LabelPtr>{};
-
-  // Skyline for dominance checkind (Lemma 2)
-  auto skyline = details::SkylineContainer<Graph, Length>{};
-
-  // Compute lower bounds for AStar
-  auto lower_bounds = details::distance_from_target<Length>(G, t);
-
-  // Compute shortest path from s to t
-  auto sp_path = details::compute_shortest_path(G, weight, s, t);
-  if (!sp_path) {
-    auto oss = std::ostringstream{};
-    oss << "Vertex " << t << " is unreachable from " << s;
-    throw details::target_not_found{oss.str()};
-  }
-
-  // P_LO <-- {shortest path p_0(s, t)};
-  resPathsEdges.push_back(*sp_path);
-  resPathIndex paths_count = 1;
-
-  // If we need the shortest path only
-  if (k == 1) {
-    details::fill_multi_predecessor(resPathsEdges.begin(), resPathsEdges.end(),
-                                    G, predecessors);
-    return;
-  }
-
-  // For each edge in the candidate path, we check if it's already in any of the
-  // resPaths. If not, we add it to resEdges. If yes, we keep track of which
-  // path includes it.
-  details::update_res_edges(*sp_path, resEdges, paths_count);
-
-  // Initialize min-priority queue Q with <s, empty_set>
-  auto init_label =
-      std::make_unique<Label>(s, 0, lower_bounds[s], k, paths_count - 1);
-  Q.push(init_label.get());
-  created_labels.push_back(std::move(init_label));
-
-  // While Q is not empty
-  while (!Q.empty()) {
-    // The remainder code is the hot part of the algorithm. So we check here
-    // if the algorithm should terminate
-    if (terminator.should_stop()) {
-      throw terminator_stop_error{
-          "OnePass+ terminated before completing due to a Terminator. Please "
-          "discard partial output."};
-    }
-
-    // Current path
-    auto label = Q.top();
-    Q.pop();
-
-    // Perform lazy update of the similairty vector of 'label', since new paths
-    // might have been added to P_LO from the time this 'label' was pushed into
-    // priority queue.
-    if (label->is_outdated(paths_count - 1)) {
-      bool below_sim_threshold = details::update_label_similarity(
-          *label, G, resEdges, resPathsEdges, weight, theta, paths_count);
-
-      label->set_last_check(paths_count - 1); // Update last check time step
-      if (!below_sim_threshold) {
-        continue; // Skip candidate path
-      }
-    }
-
-    // If we found the target node
-    if (label->get_node() == t) {
-      // Build the new k-th shortest path
-      resPathsEdges.push_back(label->get_path(G));
-
-      auto &tmpPath = resPathsEdges.back();
-      ++paths_count;
-
-      if (static_cast<int>(paths_count) == k) { // we found k paths. End.
-        // Add computed alternatives to resPaths
-        details::fill_multi_predecessor(resPathsEdges.begin(),
-                                        resPathsEdges.end(), G, predecessors);
-        break;
-      }
-
-      // For each edge in the candidate path see if it's already in any of the
-      // P_LO paths. If not, add it to the resEdges. If so, keep track of which
-      // path includes it
-      details::update_res_edges(tmpPath, resEdges, paths_count);
-
-    } else { // Expand Search
-      if (skyline.dominates(*label)) {
-        continue; // Prune path by Lemma 2
-      }
-
-      skyline.insert(label);
-      auto node_n = label->get_node();
-      // For each outgoing edge
-      for (auto adj_it = adjacent_vertices(node_n, G).first;
-           adj_it != adjacent_vertices(node_n, G).second; ++adj_it) {
-        // Expand path
-        auto c_edge = edge(node_n, *adj_it, G).first;
-        auto c_label =
-            details::expand_path(label, *adj_it, lower_bounds[*adj_it],
-                                 weight[c_edge], paths_count - 1);
-
-        // Check for acyclicity
-        bool acyclic = label->is_path_acyclic(*adj_it);
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, computing its lower bounds with a parallel delta_stepping()
+ * search from @p t on the threads of @p pool.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param pool The threads to run the reverse search on.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, thread_pool &pool,
+                  Terminator &&terminator = Terminator{}) {
+  using Length = typename boost::property_traits<WeightMap>::value_type;
+  auto heuristic = details::distance_heuristic<Graph, Length>(G, t, pool);
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
+}
 
-        if (acyclic) {
-          auto c_similarity_map = label->get_similarity_map();
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, pruning labels with the lower bounds of precomputed
+ * landmarks instead of running a full reverse Dijkstra's search from @p t.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param lm The landmarks of @p G, computed on @p weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LandmarkLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, landmarks<LandmarkLength> const &lm,
+                  Terminator &&terminator = Terminator{}) {
+  auto heuristic = make_alt_heuristic(G, lm, t);
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
+}
 
-          // Check Lemma 1 for similarity thresholding
-          bool below_sim_threshold = details::is_below_sim_threshold(
-              c_edge, c_similarity_map, theta, resEdges, resPathsEdges, weight);
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, pruning labels with exact distances to @p t read from hub
+ * labels instead of running a full reverse Dijkstra's search from @p t.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param labels The hub labels of @p G, computed on @p weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LabelLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, hub_labels<LabelLength> const &labels,
+                  Terminator &&terminator = Terminator{}) {
+  auto heuristic = make_hub_label_heuristic(G, labels, t);
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
+}
 
-          if (below_sim_threshold) {
-            c_label->set_similarities(std::begin(c_similarity_map),
-                                      std::end(c_similarity_map));
-            Q.push(c_label.get());
-            created_labels.push_back(std::move(c_label));
-          }
-        }
-      }
-    }
-  }
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, computing its lower bounds with a reverse PHAST sweep from
+ * @p t, a linear pass over the vertices, instead of a full reverse
+ * Dijkstra's search.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param ph The PHAST layout of a contraction hierarchy of @p G, built on
+ *        its `boost::edge_weight_t` property.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, phast_hierarchy<length_of_t<Graph>> const &ph,
+                  Terminator &&terminator = Terminator{}) {
+  auto heuristic =
+      details::distance_heuristic<Graph, length_of_t<Graph>>(G, t, ph);
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
+}
 
-  if (static_cast<int>(paths_count) != k) {
-    // Add computed alternatives to resPaths
-    details::fill_multi_predecessor(resPathsEdges.begin(), resPathsEdges.end(),
-                                    G, predecessors);
-  }
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, pruning labels with the lower bounds of @p heuristic
+ * instead of running a full reverse Dijkstra's search from @p t.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param heuristic A consistent A* heuristic of the distance to @p t on
+ *        @p weight, e.g. a geometric_heuristic or a max_heuristic.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename AStarHeuristic, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<details::is_astar_heuristic_v<
+              Graph, value_of_t<WeightMap>, AStarHeuristic>>>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+                  double theta, AStarHeuristic const &heuristic,
+                  Terminator &&terminator = Terminator{}) {
+  details::onepass_plus(G, weight, predecessors, s, t, k, theta, heuristic,
+                        std::forward<Terminator>(terminator));
 }
 
 /**
@@ -283,6 +279,59 @@ void onepass_plus(const PropertyGraph &G, MultiPredecessorMap &predecessors,
   onepass_plus(G, weight, predecessors, s, t, k, theta,
                std::forward<Terminator>(terminator));
 }
+
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, rejecting in constant time the queries whose target
+ * @p reachability tells unreachable, before any search starts.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param reachability The reachability index of @p G.
+ * @param args The trailing arguments of any other `onepass_plus()`
+ *        overload taking a weight map, e.g. landmarks and a terminator.
+ * @throw details::target_not_found if @p t is unreachable from @p s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename... Args>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors, vertex_of_t<Graph> s,
+                  vertex_of_t<Graph> t, int k, double theta,
+                  reachability_index const &reachability, Args &&... args) {
+  details::throw_if_unreachable(G, reachability, s, t);
+  onepass_plus(G, weight, predecessors, s, t, k, theta,
+               std::forward<Args>(args)...);
+}
+
+/**
+ * An implementation of OnePass+ k-shortest path with limited overlap for
+ * Boost::Graph, answering the query of @p ctx with the shortest path trees
+ * it already holds: labels are pruned with its exact distances to the
+ * target, and the first path is read off it instead of being searched.
+ *
+ * @see onepass_plus(const Graph &G, WeightMap weight,
+ *                   MultiPredecessorMap &predecessors, Vertex s, Vertex t, int
+ *                   k, double theta)
+ *
+ * @param ctx The context of the query from @c s to @c t, computed on
+ *        @p weight.
+ * @throw details::target_not_found if @c t is unreachable from @c s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename ContextWeightMap,
+          typename Terminator = arlib::always_continue>
+void onepass_plus(const Graph &G, WeightMap weight,
+                  MultiPredecessorMap &predecessors,
+                  query_context<Graph, ContextWeightMap> const &ctx, int k,
+                  double theta, Terminator &&terminator = Terminator{}) {
+  details::throw_if_unreachable(ctx);
+  details::onepass_plus(G, weight, predecessors, ctx.source(), ctx.target(),
+                        k, theta, ctx.heuristic(),
+                        std::forward<Terminator>(terminator),
+                        &ctx.shortest_path());
+}
 } // namespace arlib
 
 #endif
\ No newline at end of file
@@ -169,6 +169,12 @@ public:
   static vertex_descriptor null_vertex() {
     return boost::graph_traits<FilteredGraph>::null_vertex();
   }
+  /**
+   * @param e An edge of the original `Graph`.
+   * @return true if @p e is an edge of the path. Unlike `edge(u, v, path)`
+   *         this is a single lookup, and it tells parallel edges apart.
+   */
+  bool contains(edge_descriptor e) const { return graph_->m_edge_pred(e); }
 
   //===-------------------------------------------------------------------===//
   //                         IncidenceGraph concept
@@ -35,7 +35,16 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/properties.hpp>
 
+#include <arlib/customizable_contraction_hierarchy.hpp>
+#include <arlib/hub_labels.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/query_context.hpp>
+#include <arlib/reachability_index.hpp>
+#include <arlib/routing_kernels/phast.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
+#include <arlib/routing_kernels/types.hpp>
 #include <arlib/terminators.hpp>
+#include <arlib/thread_pool.hpp>
 #include <arlib/type_traits.hpp>
 
 #include <arlib/details/penalty_impl.hpp>
@@ -50,6 +59,72 @@
  */
 namespace arlib {
 
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, with the routing kernel bound at compile time.
+ *
+ * The runtime routing_kernels overload dispatches here: @p kernel fixes the
+ * type of every shortest path search, which is thus a direct call the
+ * compiler can inline, instead of a call through a `std::function`.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @tparam Kernel A routing kernel tag, e.g. kernels::bidirectional_dijkstra_t.
+ * @param kernel The routing kernel to employ.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, Kernel kernel,
+             Terminator &&terminator = Terminator{}) {
+  details::penalty_kernel_dispatch(G, original_weight, predecessors, s, t, k,
+                                   theta, p, r, max_nb_updates, max_nb_steps,
+                                   kernel,
+                                   std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, with the routing kernel bound at compile time and its
+ * searches running on a caller-owned @p workspace.
+ *
+ * Each penalty run otherwise allocates the O(|V|) arrays of its searches: a
+ * thread answering many queries on the same graph can keep one workspace
+ * and pay for them once. Penalized weights are `double`, and so are the
+ * distances of @p workspace. kernels::parallel_bidirectional_dijkstra_t
+ * runs on workspaces of its own threads and ignores @p workspace.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, Kernel kernel)
+ *
+ * @param workspace The workspace of the shortest path searches, for the
+ *        vertices of @p G. It is not thread-safe: give each thread its own.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, Kernel kernel,
+             PathWorkspace<Graph, double> &workspace,
+             Terminator &&terminator = Terminator{}) {
+  details::penalty_kernel_dispatch(G, original_weight, predecessors, s, t, k,
+                                   theta, p, r, max_nb_updates, max_nb_steps,
+                                   kernel, std::forward<Terminator>(terminator),
+                                   workspace);
+}
+
 /**
  * An implementation of Penalty method to compute alternative routes for
  * Boost::Graph.
@@ -107,9 +182,115 @@ void penalty(const Graph &G, WeightMap const &original_weight,
              int max_nb_steps,
              routing_kernels algorithm = routing_kernels::dijkstra,
              Terminator &&terminator = Terminator{}) {
+  kernels::visit(algorithm, [&](auto kernel) {
+    penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+            max_nb_updates, max_nb_steps, kernel,
+            std::forward<Terminator>(terminator));
+  });
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, running its full-graph searches on a thread pool.
+ *
+ * The distances from @p t used to penalize edges, and the lower bounds of
+ * routing_kernels::astar, are computed with parallel delta_stepping() on
+ * the threads of @p pool.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param pool The threads to run the full-graph searches on.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, thread_pool &pool,
+             routing_kernels algorithm = routing_kernels::dijkstra,
+             Terminator &&terminator = Terminator{}) {
   using Length = length_of_t<Graph>;
+  kernels::visit(algorithm, [&](auto kernel) {
+    using Kernel = decltype(kernel);
+    if constexpr (std::is_same_v<Kernel, kernels::astar_t>) {
+      auto heuristic = details::distance_heuristic<Graph, Length>(G, t, pool);
+      auto routing_kernel = details::make_penalty_kernel(kernel, G, heuristic);
+      details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                       max_nb_updates, max_nb_steps, routing_kernel,
+                       std::forward<Terminator>(terminator), &pool);
+    } else {
+      auto routing_kernel = details::make_penalty_kernel(kernel, G);
+      details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                       max_nb_updates, max_nb_steps, routing_kernel,
+                       std::forward<Terminator>(terminator), &pool);
+    }
+  });
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, guided by precomputed landmarks.
+ *
+ * With routing_kernels::astar the shortest path searches use an
+ * alt_heuristic instead of running a full reverse Dijkstra's search from
+ * @p t, and routing_kernels::bidirectional_alt runs bidirectional_alt().
+ * Other kernels ignore @p lm.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param lm The landmarks of @p G, computed on @p original_weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LandmarkLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, landmarks<LandmarkLength> const &lm,
+             routing_kernels algorithm = routing_kernels::astar,
+             Terminator &&terminator = Terminator{}) {
+  auto routing_kernel = details::build_landmark_shortest_path_fn(
+      algorithm, G, original_weight, t, lm);
+  details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                   max_nb_updates, max_nb_steps, routing_kernel,
+                   std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, guided by hub labels.
+ *
+ * With routing_kernels::astar the shortest path searches use a
+ * hub_label_heuristic, exact distances to @p t before any penalty, instead
+ * of running a full reverse Dijkstra's search from @p t. Penalties only
+ * increase weights, so these distances stay consistent lower bounds. Other
+ * kernels ignore @p labels.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param labels The hub labels of @p G, computed on @p original_weight.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename LabelLength, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, hub_labels<LabelLength> const &labels,
+             routing_kernels algorithm = routing_kernels::astar,
+             Terminator &&terminator = Terminator{}) {
   if (algorithm == routing_kernels::astar) {
-    auto heuristic = details::distance_heuristic<Graph, Length>(G, t);
+    auto heuristic = make_hub_label_heuristic(G, labels, t);
     auto routing_kernel = details::build_shortest_path_fn(
         algorithm, G, original_weight, heuristic);
     details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
@@ -124,6 +305,157 @@ void penalty(const Graph &G, WeightMap const &original_weight,
   }
 }
 
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, guiding its A* searches with @p heuristic instead of
+ * running a full reverse Dijkstra's search from @p t.
+ *
+ * Penalties only make weights heavier, so the bounds of @p heuristic stay
+ * admissible throughout the run.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param heuristic A consistent A* heuristic of the distance to @p t on
+ *        @p original_weight, e.g. a geometric_heuristic or a max_heuristic.
+ *        Other kernels than routing_kernels::astar ignore it.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename AStarHeuristic, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>,
+          typename = std::enable_if_t<details::is_astar_heuristic_v<
+              Graph, length_of_t<Graph>, AStarHeuristic>>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, AStarHeuristic const &heuristic,
+             routing_kernels algorithm = routing_kernels::astar,
+             Terminator &&terminator = Terminator{}) {
+  kernels::visit(algorithm, [&](auto kernel) {
+    // Only kernels::astar_t uses the heuristic
+    auto routing_kernel = details::make_penalty_kernel(kernel, G, heuristic);
+    details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                     max_nb_updates, max_nb_steps, routing_kernel,
+                     std::forward<Terminator>(terminator));
+  });
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, computing its full-graph distances with PHAST sweeps.
+ *
+ * The distances from @p s and to @p t of the first step come from two
+ * sweeps of @p ph, linear passes over the vertices, instead of two full
+ * Dijkstra's searches. With routing_kernels::astar the distances to @p t
+ * also serve as lower bounds; other kernels run as usual.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param ph The PHAST layout of a contraction hierarchy of @p G, built on
+ *        its `boost::edge_weight_t` property.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps, phast_hierarchy<length_of_t<Graph>> const &ph,
+             routing_kernels algorithm = routing_kernels::astar,
+             Terminator &&terminator = Terminator{}) {
+  using Length = length_of_t<Graph>;
+  if (algorithm == routing_kernels::astar) {
+    auto heuristic = details::distance_heuristic<Graph, Length>(G, t, ph);
+    auto routing_kernel = details::build_shortest_path_fn(
+        algorithm, G, original_weight, heuristic);
+    details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                     max_nb_updates, max_nb_steps, routing_kernel,
+                     std::forward<Terminator>(terminator), nullptr, &ph);
+  } else {
+    auto routing_kernel =
+        details::build_shortest_path_fn(algorithm, G, original_weight);
+    details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                     max_nb_updates, max_nb_steps, routing_kernel,
+                     std::forward<Terminator>(terminator), nullptr, &ph);
+  }
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, running its shortest path searches on a Customizable
+ * Contraction Hierarchy.
+ *
+ * With routing_kernels::cch every iteration customizes a metric of @p cch
+ * for the current penalized weights, then runs cch_query(). The first
+ * customization runs in parallel on a thread pool started once for the
+ * whole run, the following ones only update the arcs depending on the edges
+ * penalized since. Other kernels ignore @p cch.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param cch The customizable contraction hierarchy of @p G.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps,
+             customizable_contraction_hierarchy<Graph> const &cch,
+             routing_kernels algorithm = routing_kernels::cch,
+             Terminator &&terminator = Terminator{}) {
+  auto routing_kernel =
+      details::build_cch_shortest_path_fn(algorithm, G, original_weight, cch);
+  details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                   max_nb_updates, max_nb_steps, routing_kernel,
+                   std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, running its shortest path searches on a Customizable
+ * Contraction Hierarchy customized on the threads of @p pool.
+ *
+ * The metric of @p cch is customized on @p pool for the first search, then
+ * only around the edges penalized since the previous one. The distances used
+ * to penalize edges are computed with parallel delta_stepping() on @p pool.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps,
+ *              customizable_contraction_hierarchy<Graph> const &cch,
+ *              routing_kernels algorithm)
+ *
+ * @param pool The threads to customize and run the full-graph searches on.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<Graph>>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps,
+             customizable_contraction_hierarchy<Graph> const &cch,
+             thread_pool &pool,
+             routing_kernels algorithm = routing_kernels::cch,
+             Terminator &&terminator = Terminator{}) {
+  auto routing_kernel = details::build_cch_shortest_path_fn(
+      algorithm, G, original_weight, cch, &pool);
+  details::penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+                   max_nb_updates, max_nb_steps, routing_kernel,
+                   std::forward<Terminator>(terminator), &pool);
+}
+
 /**
  * An implementation of Penalty method to compute alternative routes for
  * Boost::Graph.
@@ -159,6 +491,104 @@ void penalty(const PropertyGraph &G, MultiPredecessorMap &predecessors,
   penalty(G, weight, predecessors, s, t, k, theta, p, r, max_nb_updates,
           max_nb_steps, algorithm, std::forward<Terminator>(terminator));
 }
+
+template <typename PropertyGraph, typename MultiPredecessorMap,
+          typename Kernel, typename Terminator = arlib::always_continue,
+          typename Vertex = vertex_of_t<PropertyGraph>,
+          typename = std::enable_if_t<kernels::is_kernel_v<Kernel>>>
+void penalty(const PropertyGraph &G, MultiPredecessorMap &predecessors,
+             Vertex s, Vertex t, int k, double theta, double p, double r,
+             int max_nb_updates, int max_nb_steps, Kernel kernel,
+             Terminator &&terminator = Terminator{}) {
+  using namespace boost;
+  using Edge = typename graph_traits<PropertyGraph>::edge_descriptor;
+
+  BOOST_CONCEPT_ASSERT(
+      (PropertyGraphConcept<PropertyGraph, Edge, edge_weight_t>));
+
+  penalty(G, get(edge_weight, G), predecessors, s, t, k, theta, p, r,
+          max_nb_updates, max_nb_steps, kernel,
+          std::forward<Terminator>(terminator));
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, rejecting in constant time the queries whose target
+ * @p reachability tells unreachable, before any search starts.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param reachability The reachability index of @p G.
+ * @param args The trailing arguments of any other `penalty()` overload
+ *        taking a weight map, e.g. landmarks, a routing kernel and a
+ *        terminator.
+ * @throw details::target_not_found if @p t is unreachable from @p s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename... Args>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors, vertex_of_t<Graph> s,
+             vertex_of_t<Graph> t, int k, double theta, double p, double r,
+             int max_nb_updates, int max_nb_steps,
+             reachability_index const &reachability, Args &&... args) {
+  details::throw_if_unreachable(G, reachability, s, t);
+  penalty(G, original_weight, predecessors, s, t, k, theta, p, r,
+          max_nb_updates, max_nb_steps, std::forward<Args>(args)...);
+}
+
+/**
+ * An implementation of Penalty method to compute alternative routes for
+ * Boost::Graph, answering the query of @p ctx with the shortest path trees
+ * it already holds.
+ *
+ * The first path and the distances from @c s and to @c t used to penalize
+ * edges are read off @p ctx instead of being computed by two searches of
+ * the whole graph, and routing_kernels::astar is guided by its exact
+ * distances to the target.
+ *
+ * @see penalty(const Graph &G, WeightMap const &original_weight,
+ *              MultiPredecessorMap &predecessors, Vertex s, Vertex t, int k,
+ *              double theta, double p, double r, int max_nb_updates, int
+ *              max_nb_steps, routing_kernels algorithm)
+ *
+ * @param ctx The context of the query from @c s to @c t, computed on the
+ *        `boost::edge_weight_t` property of @p G with its forward tree.
+ * @throw std::invalid_argument if @p ctx has no forward tree.
+ * @throw details::target_not_found if @c t is unreachable from @c s.
+ */
+template <typename Graph, typename WeightMap, typename MultiPredecessorMap,
+          typename ContextWeightMap,
+          typename Terminator = arlib::always_continue>
+void penalty(const Graph &G, WeightMap const &original_weight,
+             MultiPredecessorMap &predecessors,
+             query_context<Graph, ContextWeightMap> const &ctx, int k,
+             double theta, double p, double r, int max_nb_updates,
+             int max_nb_steps,
+             routing_kernels algorithm = routing_kernels::dijkstra,
+             Terminator &&terminator = Terminator{}) {
+  static_assert(std::is_same_v<value_of_t<ContextWeightMap>,
+                               length_of_t<Graph>>,
+                "The query context must be computed on the edge weights of "
+                "the graph");
+  if (!ctx.has_forward_tree()) {
+    throw std::invalid_argument{
+        "Penalty needs the forward tree of the query context."};
+  }
+  details::throw_if_unreachable(ctx);
+  auto heuristic = ctx.heuristic();
+  kernels::visit(algorithm, [&](auto kernel) {
+    auto routing_kernel = details::make_penalty_kernel(kernel, G, heuristic);
+    details::penalty(G, original_weight, predecessors, ctx.source(),
+                     ctx.target(), k, theta, p, r, max_nb_updates,
+                     max_nb_steps, routing_kernel,
+                     std::forward<Terminator>(terminator),
+                     ctx.distances_from_source(), ctx.distances_to_target(),
+                     ctx.shortest_path());
+  });
+}
 } // namespace arlib
 
 #endif
\ No newline at end of file
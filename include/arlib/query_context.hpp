@@ -0,0 +1,353 @@
+/**
+ * @file query_context.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_QUERY_CONTEXT_HPP
+#define ALTERNATIVE_ROUTING_LIB_QUERY_CONTEXT_HPP
+
+#include <boost/graph/astar_search.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+namespace details {
+// query_context::source() and target() hide the free functions from ADL
+template <typename Edge, typename Graph>
+auto edge_source(const Edge &e, const Graph &G) {
+  return source(e, G);
+}
+
+template <typename Edge, typename Graph>
+auto edge_target(const Edge &e, const Graph &G) {
+  return target(e, G);
+}
+} // namespace details
+
+//===----------------------------------------------------------------------===//
+//                            Per-query context
+//===----------------------------------------------------------------------===//
+/**
+ * The shortest path trees of a single query from @c s to @c t, computed once
+ * and shared by every algorithm answering it.
+ *
+ * Upon construction a full Dijkstra's search is run from @c t on the reverse
+ * of the graph and, if asked for, another one from @c s on the graph. They
+ * give the exact distance of every vertex to @c t and from @c s, hence:
+ *   - a consistent and exact A* heuristic toward @c t, see heuristic();
+ *   - the shortest path from @c s to @c t, read off the reverse tree;
+ *   - whether @c t is reachable from @c s at all;
+ *   - the distances Uninformed Bidirectional Pruning and Penalty need.
+ *
+ * The overloads of onepass_plus(), esx(), penalty() and
+ * uninformed_bidirectional_pruner() taking a query_context in place of the
+ * source and target reuse these trees instead of running their own
+ * searches, so that a query runs at most one full-graph search per
+ * direction however many algorithms are run on it.
+ *
+ * Copies share the same trees, and stay valid as long as the graph is alive
+ * and neither it nor its weights are modified.
+ *
+ * @tparam Graph A Boost::BidirectionalGraph with a vertex index.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ */
+template <typename Graph,
+          typename WeightMap = typename boost::property_map<
+              Graph, boost::edge_weight_t>::const_type>
+class query_context {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<Graph>;
+  /**
+   * Graph edge descriptor.
+   */
+  using Edge = edge_of_t<Graph>;
+  /**
+   * The edge weight type.
+   */
+  using Length = value_of_t<WeightMap>;
+  /**
+   * The distances of the vertices, indexed by their vertex index.
+   */
+  using DistanceMap = std::vector<Length>;
+
+  /**
+   * An exact A* heuristic of the distance to the target, read from the
+   * reverse tree of a query_context.
+   */
+  class heuristic_type : public boost::astar_heuristic<Graph, Length> {
+  public:
+    heuristic_type(std::shared_ptr<const DistanceMap> distance_t,
+                   typename boost::property_map<
+                       Graph, boost::vertex_index_t>::const_type index)
+        : distance_t{std::move(distance_t)}, index{index} {}
+
+    /**
+     * @param u The Vertex
+     * @return The distance from @p u to the target.
+     */
+    Length operator()(Vertex u) const {
+      return (*distance_t)[boost::get(index, u)];
+    }
+
+  private:
+    std::shared_ptr<const DistanceMap> distance_t;
+    typename boost::property_map<Graph, boost::vertex_index_t>::const_type
+        index;
+  };
+
+  /**
+   * Compute the shortest path trees of the query from @p s to @p t.
+   *
+   * @param G The graph.
+   * @param weight The WeightMap of @p G.
+   * @param s The source vertex.
+   * @param t The target vertex.
+   * @param with_forward_tree If true, also compute the distances from @p s.
+   * @throw std::domain_error if a negative weight is detected.
+   */
+  query_context(const Graph &G, WeightMap weight, Vertex s, Vertex t,
+                bool with_forward_tree = false)
+      : G{std::addressof(G)}, weight_{weight},
+        index{get(boost::vertex_index, G)}, s{s}, t{t} {
+    BOOST_CONCEPT_ASSERT((boost::BidirectionalGraphConcept<Graph>));
+    BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<Graph>));
+
+    auto next = std::vector<Edge>(num_vertices(G));
+    auto distance_t = std::make_shared<DistanceMap>();
+    sweep<false>(t, *distance_t, next);
+    to_target = std::move(distance_t);
+    if (with_forward_tree) {
+      from_source = std::make_shared<DistanceMap>();
+      auto prev = std::vector<Edge>(num_vertices(G));
+      sweep<true>(s, *from_source, prev);
+    }
+
+    // Follow the reverse tree from s down to t
+    auto path = std::make_shared<std::vector<Edge>>();
+    if (reachable()) {
+      for (auto v = s; v != t;) {
+        auto e = next[boost::get(index, v)];
+        path->push_back(e);
+        v = details::edge_target(e, G);
+      }
+    }
+    sp = std::move(path);
+  }
+
+  /**
+   * Compute the shortest path trees of the query from @p s to @p t on the
+   * `boost::edge_weight_t` property of @p G.
+   *
+   * @see query_context(const Graph &G, WeightMap weight, Vertex s, Vertex t,
+   *                    bool with_forward_tree)
+   */
+  query_context(const Graph &G, Vertex s, Vertex t,
+                bool with_forward_tree = false)
+      : query_context{G, get(boost::edge_weight, G), s, t,
+                      with_forward_tree} {}
+
+  const Graph &graph() const { return *G; }
+  WeightMap weight() const { return weight_; }
+  Vertex source() const { return s; }
+  Vertex target() const { return t; }
+
+  /**
+   * @return True if the distances from the source were computed.
+   */
+  bool has_forward_tree() const { return static_cast<bool>(from_source); }
+
+  /**
+   * @return True if the target is reachable from the source.
+   */
+  bool reachable() const { return distance_to_target(s) != infinity(); }
+
+  /**
+   * @param v The vertex.
+   * @return The distance from @p v to the target, or
+   *         `std::numeric_limits<Length>::max()` if it cannot reach it.
+   */
+  Length distance_to_target(Vertex v) const {
+    return (*to_target)[boost::get(index, v)];
+  }
+
+  /**
+   * @pre has_forward_tree()
+   * @param v The vertex.
+   * @return The distance from the source to @p v, or
+   *         `std::numeric_limits<Length>::max()` if it cannot be reached.
+   */
+  Length distance_from_source(Vertex v) const {
+    assert(has_forward_tree());
+    return (*from_source)[boost::get(index, v)];
+  }
+
+  /**
+   * @return The length of the shortest path from the source to the target.
+   */
+  Length shortest_distance() const { return distance_to_target(s); }
+
+  /**
+   * @return The edges of a shortest path from the source to the target,
+   *         empty if the target is unreachable.
+   */
+  const std::vector<Edge> &shortest_path() const { return *sp; }
+
+  /**
+   * @return The distances of every vertex to the target.
+   */
+  const DistanceMap &distances_to_target() const { return *to_target; }
+
+  /**
+   * @pre has_forward_tree()
+   * @return The distances of every vertex from the source.
+   */
+  const DistanceMap &distances_from_source() const {
+    assert(has_forward_tree());
+    return *from_source;
+  }
+
+  /**
+   * @return An exact A* heuristic of the distance to the target.
+   */
+  heuristic_type heuristic() const { return heuristic_type{to_target, index}; }
+
+  static constexpr Length infinity() {
+    return std::numeric_limits<Length>::max();
+  }
+
+private:
+  const Graph *G;
+  WeightMap weight_;
+  typename boost::property_map<Graph, boost::vertex_index_t>::const_type index;
+  Vertex s;
+  Vertex t;
+  std::shared_ptr<const DistanceMap> to_target;
+  std::shared_ptr<DistanceMap> from_source;
+  std::shared_ptr<const std::vector<Edge>> sp;
+
+  /**
+   * Run a Dijkstra's search from @p root, along the out-edges of the graph
+   * if @p Forward, along its in-edges otherwise, recording in @p tree the
+   * edge each vertex is reached through.
+   */
+  template <bool Forward>
+  void sweep(Vertex root, DistanceMap &distance, std::vector<Edge> &tree) {
+    auto n = num_vertices(*G);
+    distance.assign(n, infinity());
+    auto settled = std::vector<bool>(n, false);
+    auto vertex = std::vector<Vertex>(n);
+    auto fringe = details::d_ary_heap<Length>{n};
+
+    auto root_index = boost::get(index, root);
+    distance[root_index] = Length{0};
+    vertex[root_index] = root;
+    fringe.push_or_decrease(root_index, Length{0});
+    while (!fringe.empty()) {
+      auto u_index = fringe.top().key;
+      fringe.pop();
+      settled[u_index] = true;
+      auto u = vertex[u_index];
+      auto dist = distance[u_index];
+
+      auto relax = [&](const Edge &e, Vertex w) {
+        auto w_index = boost::get(index, w);
+        auto w_length = dist + boost::get(weight_, e);
+        if (w_length < dist) {
+          throw std::domain_error{"Negative weight on edge"};
+        }
+        if (!settled[w_index] && w_length < distance[w_index]) {
+          distance[w_index] = w_length;
+          vertex[w_index] = w;
+          tree[w_index] = e;
+          fringe.push_or_decrease(w_index, w_length);
+        }
+      };
+      if constexpr (Forward) {
+        for (auto [it, end] = out_edges(u, *G); it != end; ++it) {
+          relax(*it, details::edge_target(*it, *G));
+        }
+      } else {
+        for (auto [it, end] = in_edges(u, *G); it != end; ++it) {
+          relax(*it, details::edge_source(*it, *G));
+        }
+      }
+    }
+  }
+};
+
+namespace details {
+/**
+ * True if @p T is an arlib::query_context.
+ */
+template <typename T> struct is_query_context : std::false_type {};
+
+template <typename Graph, typename WeightMap>
+struct is_query_context<query_context<Graph, WeightMap>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_query_context_v = is_query_context<std::decay_t<T>>::value;
+
+/**
+ * Throw if @p ctx tells that its target cannot be reached from its source.
+ *
+ * @throw target_not_found if the target is unreachable from the source.
+ */
+template <typename Graph, typename WeightMap>
+void throw_if_unreachable(query_context<Graph, WeightMap> const &ctx) {
+  if (!ctx.reachable()) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << ctx.target() << " is unreachable from "
+        << ctx.source();
+    throw target_not_found{oss.str()};
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_QUERY_CONTEXT_HPP
@@ -0,0 +1,342 @@
+/**
+ * @file reachability_index.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_HPP
+#define ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/strong_components.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/details/binary_io.hpp>
+#include <arlib/details/reachability_index_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                          Reachability index
+//===----------------------------------------------------------------------===//
+
+/**
+ * The strongly connected components of a graph and a labeling of their
+ * condensation, telling in constant time that a vertex cannot reach
+ * another.
+ *
+ * Two vertices of the same component reach each other. Between components,
+ * a topological order of the condensation and two interval labelings (see
+ * details::interval_labeling()) rule out almost every unreachable pair: a
+ * query to a vertex snapped onto a disconnected island or a dead-end
+ * component is rejected before any search, instead of after exhausting the
+ * component of the source. The few unreachable pairs the labels cannot tell
+ * apart are still caught by the search itself.
+ *
+ * The index is computed once per graph by build_reachability_index(), does
+ * not depend on the edge weights, and can be saved with
+ * write_reachability_index() and loaded back with read_reachability_index().
+ */
+class reachability_index {
+public:
+  /**
+   * The number of interval labelings per component.
+   */
+  static constexpr std::size_t num_labelings = 2;
+
+  reachability_index() = default;
+  /**
+   * Construct a new reachability_index object.
+   *
+   * @param component The component of each vertex, by index.
+   * @param rank The position of each component in a topological order of
+   *        the condensation.
+   * @param low The `low` bound of component `c` in labeling `i`, at
+   *        `c * num_labelings + i`.
+   * @param post The `post` bound of component `c` in labeling `i`, at
+   *        `c * num_labelings + i`.
+   */
+  reachability_index(std::vector<std::uint32_t> component,
+                     std::vector<std::uint32_t> rank,
+                     std::vector<std::uint32_t> low,
+                     std::vector<std::uint32_t> post)
+      : component{std::move(component)}, rank{std::move(rank)},
+        low{std::move(low)}, post{std::move(post)} {}
+
+  /**
+   * @return The number of vertices of the graph.
+   */
+  std::size_t num_vertices() const { return component.size(); }
+  /**
+   * @return The number of strongly connected components of the graph.
+   */
+  std::size_t num_components() const { return rank.size(); }
+  /**
+   * @param v A vertex index.
+   * @return The strongly connected component of @p v.
+   */
+  std::uint32_t component_of(std::size_t v) const { return component[v]; }
+  /**
+   * @param u A vertex index.
+   * @param v A vertex index.
+   * @return True if @p u and @p v reach each other.
+   */
+  bool same_component(std::size_t u, std::size_t v) const {
+    return component[u] == component[v];
+  }
+  /**
+   * @param u A vertex index.
+   * @param v A vertex index.
+   * @return False if @p u certainly cannot reach @p v. True if it does, or,
+   *         rarely, if the index cannot tell.
+   */
+  bool may_reach(std::size_t u, std::size_t v) const {
+    auto cu = component[u];
+    auto cv = component[v];
+    if (cu == cv) {
+      return true;
+    }
+    if (rank[cu] > rank[cv]) {
+      return false;
+    }
+    for (std::size_t i = 0; i < num_labelings; ++i) {
+      auto u_label = cu * num_labelings + i;
+      auto v_label = cv * num_labelings + i;
+      if (low[v_label] < low[u_label] || post[v_label] > post[u_label]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return The component of each vertex, by index.
+   */
+  std::vector<std::uint32_t> const &components() const { return component; }
+  /**
+   * @return The topological rank of each component.
+   */
+  std::vector<std::uint32_t> const &ranks() const { return rank; }
+  /**
+   * @return The `low` bounds, component-major.
+   */
+  std::vector<std::uint32_t> const &low_bounds() const { return low; }
+  /**
+   * @return The `post` bounds, component-major.
+   */
+  std::vector<std::uint32_t> const &post_bounds() const { return post; }
+
+private:
+  std::vector<std::uint32_t> component;
+  std::vector<std::uint32_t> rank;
+  std::vector<std::uint32_t> low;
+  std::vector<std::uint32_t> post;
+};
+
+/**
+ * Build the reachability_index of @p G.
+ *
+ * Runs in linear time: Tarjan's strongly connected components, then a
+ * topological sort and two depth-first traversals of the condensation.
+ *
+ * @tparam Graph A Boost::VertexListGraph and Boost::IncidenceGraph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param index The IndexMap of @p G.
+ * @return The reachability index of @p G.
+ */
+template <typename Graph, typename IndexMap>
+reachability_index build_reachability_index(const Graph &G, IndexMap index) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+
+  auto n = num_vertices(G);
+  auto component = std::vector<std::uint32_t>(n);
+  auto num_components = strong_components(
+      G, make_iterator_property_map(component.begin(), index),
+      vertex_index_map(index));
+
+  auto arcs = std::vector<std::pair<std::uint32_t, std::uint32_t>>{};
+  for (auto [v_it, v_end] = vertices(G); v_it != v_end; ++v_it) {
+    auto cu = component[get(index, *v_it)];
+    for (auto [it, end] = out_edges(*v_it, G); it != end; ++it) {
+      auto cv = component[get(index, target(*it, G))];
+      if (cu != cv) {
+        arcs.emplace_back(cu, cv);
+      }
+    }
+  }
+  auto dag = details::make_condensation(num_components, std::move(arcs));
+  auto order = details::topological_order(dag);
+
+  auto rank = std::vector<std::uint32_t>(num_components);
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    rank[order[i]] = static_cast<std::uint32_t>(i);
+  }
+  constexpr auto k = reachability_index::num_labelings;
+  auto low = std::vector<std::uint32_t>(num_components * k);
+  auto post = std::vector<std::uint32_t>(num_components * k);
+  auto label_low = std::vector<std::uint32_t>(num_components);
+  auto label_post = std::vector<std::uint32_t>(num_components);
+  for (std::size_t i = 0; i < k; ++i) {
+    details::interval_labeling(dag, order, i % 2 == 1, label_low.data(),
+                               label_post.data());
+    for (std::size_t c = 0; c < num_components; ++c) {
+      low[c * k + i] = label_low[c];
+      post[c * k + i] = label_post[c];
+    }
+  }
+  return reachability_index{std::move(component), std::move(rank),
+                            std::move(low), std::move(post)};
+}
+
+/**
+ * Build the reachability_index of a `PropertyGraph`, using its
+ * `boost::vertex_index_t` property.
+ *
+ * @see build_reachability_index(const Graph &G, IndexMap index)
+ */
+template <typename PropertyGraph>
+reachability_index build_reachability_index(const PropertyGraph &G) {
+  return build_reachability_index(G, get(boost::vertex_index, G));
+}
+
+//===----------------------------------------------------------------------===//
+//                     Reachability index serialization
+//===----------------------------------------------------------------------===//
+
+namespace details {
+constexpr char reachability_index_magic[4] = {'A', 'R', 'R', 'I'};
+constexpr std::uint32_t reachability_index_version = 1;
+} // namespace details
+
+/**
+ * Write @p index to @p os in a binary format: a header with a magic number,
+ * a version, the number of vertices and of components, then the component
+ * of each vertex and the labels of each component, in native byte order.
+ *
+ * @param os The stream to write to. Open it in binary mode.
+ * @param index The reachability index.
+ */
+inline void write_reachability_index(std::ostream &os,
+                                     reachability_index const &index) {
+  std::uint64_t header[2] = {index.num_vertices(), index.num_components()};
+  os.write(details::reachability_index_magic,
+           sizeof(details::reachability_index_magic));
+  details::write_raw(os, &details::reachability_index_version, 1);
+  details::write_raw(os, header, 2);
+  details::write_raw(os, index.components().data(), index.num_vertices());
+  details::write_raw(os, index.ranks().data(), index.num_components());
+  details::write_raw(os, index.low_bounds().data(),
+                     index.low_bounds().size());
+  details::write_raw(os, index.post_bounds().data(),
+                     index.post_bounds().size());
+}
+
+/**
+ * Read a reachability index written by write_reachability_index().
+ *
+ * @param is The stream to read from. Open it in binary mode.
+ * @return The reachability index, or an empty optional if @p is does not
+ *         hold one.
+ */
+inline std::optional<reachability_index>
+read_reachability_index(std::istream &is) {
+  char magic[4];
+  auto version = std::uint32_t{};
+  std::uint64_t header[2];
+  if (!details::read_raw(is, magic, 4) ||
+      !std::equal(magic, magic + 4, details::reachability_index_magic) ||
+      !details::read_raw(is, &version, 1) ||
+      version != details::reachability_index_version ||
+      !details::read_raw(is, header, 2)) {
+    return {};
+  }
+
+  auto n = static_cast<std::size_t>(header[0]);
+  auto c = static_cast<std::size_t>(header[1]);
+  constexpr auto k = reachability_index::num_labelings;
+  auto component = std::vector<std::uint32_t>(n);
+  auto rank = std::vector<std::uint32_t>(c);
+  auto low = std::vector<std::uint32_t>(c * k);
+  auto post = std::vector<std::uint32_t>(c * k);
+  if (!details::read_raw(is, component.data(), n) ||
+      !details::read_raw(is, rank.data(), c) ||
+      !details::read_raw(is, low.data(), low.size()) ||
+      !details::read_raw(is, post.data(), post.size())) {
+    return {};
+  }
+  return reachability_index{std::move(component), std::move(rank),
+                            std::move(low), std::move(post)};
+}
+
+namespace details {
+/**
+ * Throw if @p index tells that @p t cannot be reached from @p s.
+ *
+ * @throw target_not_found if @p t is certainly unreachable from @p s.
+ */
+template <typename Graph, typename Vertex = vertex_of_t<Graph>>
+void throw_if_unreachable(const Graph &G, reachability_index const &index,
+                          Vertex s, Vertex t) {
+  auto vertex_index = get(boost::vertex_index, G);
+  if (!index.may_reach(get(vertex_index, s), get(vertex_index, t))) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << t << " is unreachable from " << s;
+    throw target_not_found{oss.str()};
+  }
+}
+
+/**
+ * True if @p T is arlib::reachability_index.
+ */
+template <typename T>
+constexpr bool is_reachability_index_v =
+    std::is_same_v<std::decay_t<T>, reachability_index>;
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_REACHABILITY_INDEX_HPP
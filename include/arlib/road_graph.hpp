@@ -0,0 +1,1052 @@
+/**
+ * @file road_graph.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_ROAD_GRAPH_HPP
+#define ALTERNATIVE_ROUTING_LIB_ROAD_GRAPH_HPP
+
+#include <boost/graph/adjacency_iterator.hpp>
+#include <boost/graph/graph_selectors.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/binary_io.hpp>
+#include <arlib/details/mapped_file.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                          Road graph storage
+//===----------------------------------------------------------------------===//
+
+/**
+ * An entry of the forward adjacency array: the head of an out-edge next to
+ * its weight, so that relaxing the edge touches a single cache line. Its
+ * position in the array is the index of the edge.
+ */
+template <typename Length> struct road_graph_out_arc {
+  std::uint32_t target;
+  Length weight;
+};
+
+/**
+ * An entry of the backward adjacency array: the tail of an in-edge next to
+ * a copy of its weight, and the index of the edge.
+ */
+template <typename Length> struct road_graph_in_arc {
+  std::uint32_t source;
+  std::uint32_t edge;
+  Length weight;
+};
+
+/**
+ * The arrays of a road_graph, owned by it.
+ */
+template <typename Length> struct road_graph_storage {
+  // out_arcs[out_offsets[v]..out_offsets[v + 1]) are the out-edges of v
+  std::vector<std::uint32_t> out_offsets;
+  std::vector<road_graph_out_arc<Length>> out_arcs;
+  // in_arcs[in_offsets[v]..in_offsets[v + 1]) are the in-edges of v
+  std::vector<std::uint32_t> in_offsets;
+  std::vector<road_graph_in_arc<Length>> in_arcs;
+  // The position of each edge in in_arcs, to keep both weights in sync
+  std::vector<std::uint32_t> in_position;
+};
+
+/**
+ * The arrays a road_graph reads, either its own road_graph_storage or the
+ * ones of a file mapped by map_road_graph().
+ */
+template <typename Length> struct road_graph_arrays {
+  const std::uint32_t *out_offsets;
+  const road_graph_out_arc<Length> *out_arcs;
+  const std::uint32_t *in_offsets;
+  const road_graph_in_arc<Length> *in_arcs;
+  std::uint32_t num_vertices;
+  std::uint32_t num_edges;
+};
+
+/**
+ * The edge descriptor of a road_graph: its endpoints, its position in the
+ * dense edge index and the weight slot of the adjacency entry it was read
+ * from. Two descriptors are the same edge if they have the same index, so
+ * parallel edges stay distinct.
+ *
+ * Reading the weight of an edge found scanning in-edges does not touch the
+ * forward adjacency array.
+ */
+template <typename Length> struct road_graph_edge {
+  std::uint32_t source;
+  std::uint32_t target;
+  std::uint32_t index;
+  const Length *weight;
+
+  friend bool operator==(const road_graph_edge &a, const road_graph_edge &b) {
+    return a.index == b.index;
+  }
+  friend bool operator!=(const road_graph_edge &a, const road_graph_edge &b) {
+    return a.index != b.index;
+  }
+  friend bool operator<(const road_graph_edge &a, const road_graph_edge &b) {
+    return a.index < b.index;
+  }
+  friend std::size_t hash_value(const road_graph_edge &e) { return e.index; }
+  friend std::ostream &operator<<(std::ostream &os, const road_graph_edge &e) {
+    return os << "(" << e.source << "," << e.target << ")";
+  }
+};
+
+/**
+ * Iterates over the out-edges of a vertex, in the forward adjacency array.
+ */
+template <typename Length>
+class road_graph_out_edge_iterator
+    : public boost::iterator_facade<road_graph_out_edge_iterator<Length>,
+                                    road_graph_edge<Length>,
+                                    boost::random_access_traversal_tag,
+                                    road_graph_edge<Length>> {
+public:
+  road_graph_out_edge_iterator() = default;
+  road_graph_out_edge_iterator(const road_graph_out_arc<Length> *arcs,
+                               std::uint32_t source, std::uint32_t index)
+      : arcs{arcs}, source{source}, index{index} {}
+
+private:
+  friend class boost::iterator_core_access;
+
+  road_graph_edge<Length> dereference() const {
+    return {source, arcs[index].target, index, &arcs[index].weight};
+  }
+  bool equal(const road_graph_out_edge_iterator &other) const {
+    return index == other.index;
+  }
+  void increment() { ++index; }
+  void decrement() { --index; }
+  void advance(std::ptrdiff_t n) {
+    index = static_cast<std::uint32_t>(index + n);
+  }
+  std::ptrdiff_t
+  distance_to(const road_graph_out_edge_iterator &other) const {
+    return static_cast<std::ptrdiff_t>(other.index) -
+           static_cast<std::ptrdiff_t>(index);
+  }
+
+  const road_graph_out_arc<Length> *arcs = nullptr;
+  std::uint32_t source = 0;
+  std::uint32_t index = 0;
+};
+
+/**
+ * Iterates over the in-edges of a vertex, in the backward adjacency array.
+ */
+template <typename Length>
+class road_graph_in_edge_iterator
+    : public boost::iterator_facade<road_graph_in_edge_iterator<Length>,
+                                    road_graph_edge<Length>,
+                                    boost::random_access_traversal_tag,
+                                    road_graph_edge<Length>> {
+public:
+  road_graph_in_edge_iterator() = default;
+  road_graph_in_edge_iterator(const road_graph_in_arc<Length> *arc,
+                              std::uint32_t target)
+      : arc{arc}, target{target} {}
+
+private:
+  friend class boost::iterator_core_access;
+
+  road_graph_edge<Length> dereference() const {
+    return {arc->source, target, arc->edge, &arc->weight};
+  }
+  bool equal(const road_graph_in_edge_iterator &other) const {
+    return arc == other.arc;
+  }
+  void increment() { ++arc; }
+  void decrement() { --arc; }
+  void advance(std::ptrdiff_t n) { arc += n; }
+  std::ptrdiff_t distance_to(const road_graph_in_edge_iterator &other) const {
+    return other.arc - arc;
+  }
+
+  const road_graph_in_arc<Length> *arc = nullptr;
+  std::uint32_t target = 0;
+};
+
+/**
+ * Iterates over all the edges of the graph, by index.
+ */
+template <typename Length>
+class road_graph_edge_iterator
+    : public boost::iterator_facade<road_graph_edge_iterator<Length>,
+                                    road_graph_edge<Length>,
+                                    boost::forward_traversal_tag,
+                                    road_graph_edge<Length>> {
+public:
+  road_graph_edge_iterator() = default;
+  road_graph_edge_iterator(const road_graph_out_arc<Length> *arcs,
+                           const std::uint32_t *offsets,
+                           std::uint32_t num_vertices, std::uint32_t index)
+      : arcs{arcs}, offsets{offsets}, num_vertices{num_vertices},
+        index{index} {
+    find_source();
+  }
+
+private:
+  friend class boost::iterator_core_access;
+
+  road_graph_edge<Length> dereference() const {
+    return {source, arcs[index].target, index, &arcs[index].weight};
+  }
+  bool equal(const road_graph_edge_iterator &other) const {
+    return index == other.index;
+  }
+  void increment() {
+    ++index;
+    find_source();
+  }
+  // Move to the tail of the edge, skipping vertices with no out-edges
+  void find_source() {
+    while (source < num_vertices && offsets[source + 1] <= index) {
+      ++source;
+    }
+  }
+
+  const road_graph_out_arc<Length> *arcs = nullptr;
+  const std::uint32_t *offsets = nullptr;
+  std::uint32_t num_vertices = 0;
+  std::uint32_t index = 0;
+  std::uint32_t source = 0;
+};
+} // namespace details
+
+//===----------------------------------------------------------------------===//
+//                          Road graph
+//===----------------------------------------------------------------------===//
+
+template <typename Length> class road_graph;
+
+/**
+ * The `boost::edge_weight_t` property map of a road_graph.
+ *
+ * Weights are read through the edge descriptor, from the adjacency entry
+ * the edge was found in. Writing a weight with put() updates both copies of
+ * it, in the forward and backward adjacency arrays.
+ *
+ * @tparam Graph The road_graph type, const-qualified for a read-only map.
+ */
+template <typename Graph>
+class road_graph_weight_map
+    : public boost::put_get_helper<
+          const typename std::remove_const_t<Graph>::length_type &,
+          road_graph_weight_map<Graph>> {
+public:
+  using key_type = typename std::remove_const_t<Graph>::edge_descriptor;
+  using value_type = typename std::remove_const_t<Graph>::length_type;
+  using reference = const value_type &;
+  using category = boost::lvalue_property_map_tag;
+
+  road_graph_weight_map() = default;
+  explicit road_graph_weight_map(Graph &G) : G{&G} {}
+
+  reference operator[](const key_type &e) const { return *e.weight; }
+  friend void put(const road_graph_weight_map &weight, const key_type &e,
+                  value_type w) {
+    weight.G->set_weight(e.index, w);
+  }
+
+private:
+  Graph *G = nullptr;
+};
+
+/**
+ * The `boost::edge_index_t` property map of a road_graph.
+ *
+ * @tparam Graph The road_graph type.
+ */
+template <typename Graph>
+struct road_graph_edge_index_map
+    : public boost::put_get_helper<std::uint32_t,
+                                   road_graph_edge_index_map<Graph>> {
+  using key_type = typename Graph::edge_descriptor;
+  using value_type = std::uint32_t;
+  using reference = std::uint32_t;
+  using category = boost::readable_property_map_tag;
+
+  std::uint32_t operator[](const key_type &e) const { return e.index; }
+};
+
+/**
+ * A static directed graph laid out for point-to-point searches on road
+ * networks, to be used in place of CSRGraph.
+ *
+ * Out-edges and in-edges are stored in two compressed sparse row arrays,
+ * sorted by tail and by head. Unlike CSRGraph, each entry keeps the weight of
+ * the edge next to its other endpoint instead of in a separate property
+ * vector, and vertex and edge ids are 32 bits wide: relaxing an edge, in
+ * either direction, reads a single slot of the array being scanned. The
+ * position of an edge in the forward array is its dense
+ * `boost::edge_index_t`, in `[0, num_edges(G))`. Search kernels prefetch the
+ * adjacency of each vertex they queue (see details::prefetch_out_edges()).
+ *
+ * road_graph models VertexAndEdgeListGraph, BidirectionalGraph,
+ * AdjacencyGraph and PropertyGraph for `boost::edge_weight_t`,
+ * `boost::vertex_index_t` and `boost::edge_index_t`, so it can be passed to
+ * every algorithm of the library. Parallel edges are allowed. Once built,
+ * only the edge weights can be changed, with put().
+ *
+ * The arrays are either owned, or read in place from a file mapped by
+ * map_road_graph(): such a graph is read-only.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length = double> class road_graph {
+public:
+  using length_type = Length;
+
+  // Graph
+  using vertex_descriptor = std::uint32_t;
+  using edge_descriptor = details::road_graph_edge<Length>;
+  using directed_category = boost::bidirectional_tag;
+  using edge_parallel_category = boost::allow_parallel_edge_tag;
+  struct traversal_category : public boost::bidirectional_graph_tag,
+                              public boost::adjacency_graph_tag,
+                              public boost::vertex_list_graph_tag,
+                              public boost::edge_list_graph_tag {};
+  static vertex_descriptor null_vertex() {
+    return std::numeric_limits<vertex_descriptor>::max();
+  }
+
+  // Sizes
+  using vertices_size_type = std::uint32_t;
+  using edges_size_type = std::uint32_t;
+  using degree_size_type = std::uint32_t;
+
+  // Iterators
+  using vertex_iterator = boost::counting_iterator<vertex_descriptor>;
+  using edge_iterator = details::road_graph_edge_iterator<Length>;
+  using out_edge_iterator = details::road_graph_out_edge_iterator<Length>;
+  using in_edge_iterator = details::road_graph_in_edge_iterator<Length>;
+  using adjacency_iterator =
+      typename boost::adjacency_iterator_generator<road_graph,
+                                                   vertex_descriptor,
+                                                   out_edge_iterator>::type;
+
+  /**
+   * Construct an empty road_graph.
+   */
+  road_graph() { bind(); }
+
+  /**
+   * Construct a new road_graph owning @p storage.
+   *
+   * @param storage The adjacency arrays. Offsets have `num_vertices + 1`
+   *        entries, and in_position has one entry per edge.
+   */
+  explicit road_graph(details::road_graph_storage<Length> storage)
+      : storage{std::move(storage)} {
+    bind();
+  }
+
+  /**
+   * Construct a new read-only road_graph reading arrays owned by @p owner,
+   * e.g. a details::mapped_file.
+   *
+   * @param arrays The adjacency arrays.
+   * @param owner The owner of @p arrays, kept alive by the graph and its
+   *        copies.
+   */
+  road_graph(details::road_graph_arrays<Length> arrays,
+             std::shared_ptr<void const> owner)
+      : arrays{arrays}, keep_alive{std::move(owner)} {}
+
+  road_graph(const road_graph &other)
+      : storage{other.storage}, arrays{other.arrays},
+        keep_alive{other.keep_alive} {
+    if (!keep_alive) {
+      bind();
+    }
+  }
+  road_graph(road_graph &&other) noexcept
+      : storage{std::move(other.storage)}, arrays{other.arrays},
+        keep_alive{std::move(other.keep_alive)} {
+    other.arrays = empty_arrays();
+  }
+  road_graph &operator=(const road_graph &other) {
+    auto copy = other;
+    return *this = std::move(copy);
+  }
+  road_graph &operator=(road_graph &&other) noexcept {
+    storage = std::move(other.storage);
+    arrays = std::exchange(other.arrays, empty_arrays());
+    keep_alive = std::move(other.keep_alive);
+    return *this;
+  }
+
+  /**
+   * Construct a new road_graph from a list of edges, in any order.
+   *
+   * Out-edges of the same vertex keep their relative order, so the edge
+   * index of the i-th edge of the list is i when the list is sorted by
+   * tail.
+   *
+   * @param first The first edge, a pair of vertex ids.
+   * @param last Past the last edge.
+   * @param weight The weight of the first edge, then of the following ones.
+   * @param n The number of vertices.
+   * @throw std::length_error if vertex or edge ids do not fit in 32 bits.
+   * @throw std::out_of_range if an edge endpoint is not less than @p n.
+   */
+  template <typename EdgeIterator, typename WeightIterator>
+  road_graph(EdgeIterator first, EdgeIterator last, WeightIterator weight,
+             std::size_t n) {
+    constexpr auto max_id = std::numeric_limits<std::uint32_t>::max();
+    auto in_range = [n](auto v) {
+      if constexpr (std::is_signed_v<decltype(v)>) {
+        if (v < 0) {
+          return false;
+        }
+      }
+      return static_cast<std::size_t>(v) < n;
+    };
+    if (n >= max_id) {
+      throw std::length_error{"Too many vertices for a road_graph"};
+    }
+    auto sources = std::vector<std::uint32_t>{};
+    auto targets = std::vector<std::uint32_t>{};
+    auto weights = std::vector<Length>{};
+    for (; first != last; ++first, ++weight) {
+      if (sources.size() == max_id) {
+        throw std::length_error{"Too many edges for a road_graph"};
+      }
+      auto u = first->first;
+      auto v = first->second;
+      if (!in_range(u) || !in_range(v)) {
+        throw std::out_of_range{"Edge endpoint out of range"};
+      }
+      sources.push_back(static_cast<std::uint32_t>(u));
+      targets.push_back(static_cast<std::uint32_t>(v));
+      weights.push_back(static_cast<Length>(*weight));
+    }
+
+    // Counting sort of the edges by tail, then of the in-arcs by head
+    auto &[out_offsets, out_arcs, in_offsets, in_arcs, in_position] = storage;
+    auto m = sources.size();
+    out_offsets.assign(n + 1, 0);
+    in_offsets.assign(n + 1, 0);
+    for (std::size_t i = 0; i < m; ++i) {
+      ++out_offsets[sources[i] + 1];
+      ++in_offsets[targets[i] + 1];
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+      out_offsets[v + 1] += out_offsets[v];
+      in_offsets[v + 1] += in_offsets[v];
+    }
+
+    out_arcs.resize(m);
+    auto next = std::vector<std::uint32_t>(out_offsets.begin(),
+                                           std::prev(out_offsets.end()));
+    for (std::size_t i = 0; i < m; ++i) {
+      out_arcs[next[sources[i]]++] = {targets[i], weights[i]};
+    }
+
+    in_arcs.resize(m);
+    in_position.resize(m);
+    next.assign(in_offsets.begin(), std::prev(in_offsets.end()));
+    for (std::uint32_t u = 0; u < n; ++u) {
+      for (auto e = out_offsets[u]; e < out_offsets[u + 1]; ++e) {
+        auto pos = next[out_arcs[e].target]++;
+        in_arcs[pos] = {u, e, out_arcs[e].weight};
+        in_position[e] = pos;
+      }
+    }
+    bind();
+  }
+
+  /**
+   * @return The forward adjacency array, indexed by edge index.
+   */
+  const details::road_graph_out_arc<Length> *forward_arcs() const {
+    return arrays.out_arcs;
+  }
+  /**
+   * @param v A vertex, or num_vertices(G).
+   * @return The index of the first out-edge of @p v. Out-edges of @p v are
+   *         indexed up to `out_offset(v + 1)`, excluded.
+   */
+  edges_size_type out_offset(vertex_descriptor v) const {
+    return arrays.out_offsets[v];
+  }
+  /**
+   * @param v A vertex.
+   * @param e The index of an out-edge of @p v.
+   * @return The descriptor of edge @p e.
+   */
+  edge_descriptor out_edge(vertex_descriptor v, edges_size_type e) const {
+    return edge_descriptor{v, arrays.out_arcs[e].target, e,
+                           &arrays.out_arcs[e].weight};
+  }
+
+  /**
+   * Set the weight of edge @p e, in both adjacency arrays.
+   *
+   * @param e An edge index.
+   * @param w The new weight.
+   * @throw std::logic_error if the graph is read-only.
+   */
+  void set_weight(edges_size_type e, Length w) {
+    if (read_only()) {
+      throw std::logic_error{"Cannot change a mapped road_graph"};
+    }
+    storage.out_arcs[e].weight = w;
+    storage.in_arcs[storage.in_position[e]].weight = w;
+  }
+
+  /**
+   * @return True if the arrays are read in place from a mapped file.
+   */
+  bool read_only() const { return static_cast<bool>(keep_alive); }
+
+  /**
+   * @return The adjacency arrays.
+   */
+  const details::road_graph_arrays<Length> &data() const { return arrays; }
+
+  //===--------------------------------------------------------------------===//
+  //                    VertexListGraph and EdgeListGraph
+  //===--------------------------------------------------------------------===//
+
+  friend vertices_size_type num_vertices(const road_graph &G) {
+    return G.arrays.num_vertices;
+  }
+  friend std::pair<vertex_iterator, vertex_iterator>
+  vertices(const road_graph &G) {
+    return {vertex_iterator{0}, vertex_iterator{num_vertices(G)}};
+  }
+  friend edges_size_type num_edges(const road_graph &G) {
+    return G.arrays.num_edges;
+  }
+  friend std::pair<edge_iterator, edge_iterator> edges(const road_graph &G) {
+    auto arcs = G.arrays.out_arcs;
+    auto offsets = G.arrays.out_offsets;
+    auto n = num_vertices(G);
+    return {edge_iterator{arcs, offsets, n, 0},
+            edge_iterator{arcs, offsets, n, num_edges(G)}};
+  }
+  friend vertex_descriptor source(const edge_descriptor &e,
+                                  const road_graph &) {
+    return e.source;
+  }
+  friend vertex_descriptor target(const edge_descriptor &e,
+                                  const road_graph &) {
+    return e.target;
+  }
+
+  //===--------------------------------------------------------------------===//
+  //                  BidirectionalGraph and AdjacencyGraph
+  //===--------------------------------------------------------------------===//
+
+  friend std::pair<out_edge_iterator, out_edge_iterator>
+  out_edges(vertex_descriptor v, const road_graph &G) {
+    auto arcs = G.arrays.out_arcs;
+    return {out_edge_iterator{arcs, v, G.arrays.out_offsets[v]},
+            out_edge_iterator{arcs, v, G.arrays.out_offsets[v + 1]}};
+  }
+  friend degree_size_type out_degree(vertex_descriptor v,
+                                     const road_graph &G) {
+    return G.arrays.out_offsets[v + 1] - G.arrays.out_offsets[v];
+  }
+  friend std::pair<in_edge_iterator, in_edge_iterator>
+  in_edges(vertex_descriptor v, const road_graph &G) {
+    auto arcs = G.arrays.in_arcs;
+    return {in_edge_iterator{arcs + G.arrays.in_offsets[v], v},
+            in_edge_iterator{arcs + G.arrays.in_offsets[v + 1], v}};
+  }
+  friend degree_size_type in_degree(vertex_descriptor v,
+                                    const road_graph &G) {
+    return G.arrays.in_offsets[v + 1] - G.arrays.in_offsets[v];
+  }
+  friend degree_size_type degree(vertex_descriptor v, const road_graph &G) {
+    return out_degree(v, G) + in_degree(v, G);
+  }
+  friend std::pair<adjacency_iterator, adjacency_iterator>
+  adjacent_vertices(vertex_descriptor v, const road_graph &G) {
+    auto [first, last] = out_edges(v, G);
+    return {adjacency_iterator{first, &G}, adjacency_iterator{last, &G}};
+  }
+  /**
+   * @return The first edge from @p u to @p v, if any, and whether it
+   *         exists.
+   */
+  friend std::pair<edge_descriptor, bool>
+  edge(vertex_descriptor u, vertex_descriptor v, const road_graph &G) {
+    auto arcs = G.arrays.out_arcs;
+    for (auto e = G.arrays.out_offsets[u]; e < G.arrays.out_offsets[u + 1];
+         ++e) {
+      if (arcs[e].target == v) {
+        return {edge_descriptor{u, v, e, &arcs[e].weight}, true};
+      }
+    }
+    return {edge_descriptor{u, v, 0, nullptr}, false};
+  }
+
+  //===--------------------------------------------------------------------===//
+  //                              PropertyGraph
+  //===--------------------------------------------------------------------===//
+
+  friend road_graph_weight_map<road_graph> get(boost::edge_weight_t,
+                                               road_graph &G) {
+    return road_graph_weight_map<road_graph>{G};
+  }
+  friend road_graph_weight_map<const road_graph> get(boost::edge_weight_t,
+                                                     const road_graph &G) {
+    return road_graph_weight_map<const road_graph>{G};
+  }
+  friend const Length &get(boost::edge_weight_t, const road_graph &,
+                           const edge_descriptor &e) {
+    return *e.weight;
+  }
+  friend void put(boost::edge_weight_t, road_graph &G,
+                  const edge_descriptor &e, Length w) {
+    G.set_weight(e.index, w);
+  }
+  friend boost::typed_identity_property_map<vertex_descriptor>
+  get(boost::vertex_index_t, const road_graph &) {
+    return {};
+  }
+  friend vertex_descriptor get(boost::vertex_index_t, const road_graph &,
+                               vertex_descriptor v) {
+    return v;
+  }
+  friend road_graph_edge_index_map<road_graph> get(boost::edge_index_t,
+                                                   const road_graph &) {
+    return {};
+  }
+  friend edges_size_type get(boost::edge_index_t, const road_graph &,
+                             const edge_descriptor &e) {
+    return e.index;
+  }
+
+  /**
+   * Bring the out-edges of @p v into the cache.
+   *
+   * @see details::prefetch_out_edges()
+   */
+  friend void prefetch_out_edges(vertex_descriptor v, const road_graph &G) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(G.arrays.out_arcs + G.arrays.out_offsets[v]);
+#else
+    static_cast<void>(v);
+    static_cast<void>(G);
+#endif
+  }
+  /**
+   * Bring the in-edges of @p v into the cache.
+   *
+   * @see details::prefetch_in_edges()
+   */
+  friend void prefetch_in_edges(vertex_descriptor v, const road_graph &G) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(G.arrays.in_arcs + G.arrays.in_offsets[v]);
+#else
+    static_cast<void>(v);
+    static_cast<void>(G);
+#endif
+  }
+
+private:
+  details::road_graph_storage<Length> storage;
+  details::road_graph_arrays<Length> arrays = empty_arrays();
+  // The owner of the arrays when they are not in storage
+  std::shared_ptr<void const> keep_alive;
+
+  // The arrays of a graph with no vertices
+  static details::road_graph_arrays<Length> empty_arrays() {
+    static const std::uint32_t no_offsets[1] = {0};
+    return {no_offsets, nullptr, no_offsets, nullptr, 0, 0};
+  }
+
+  // Read the arrays from storage
+  void bind() {
+    if (storage.out_offsets.empty()) {
+      arrays = empty_arrays();
+      return;
+    }
+    arrays = details::road_graph_arrays<Length>{
+        storage.out_offsets.data(),
+        storage.out_arcs.data(),
+        storage.in_offsets.data(),
+        storage.in_arcs.data(),
+        static_cast<std::uint32_t>(storage.out_offsets.size() - 1),
+        static_cast<std::uint32_t>(storage.out_arcs.size())};
+  }
+};
+
+//===----------------------------------------------------------------------===//
+//                        Road graph serialization
+//===----------------------------------------------------------------------===//
+
+namespace details {
+constexpr char road_graph_magic[4] = {'A', 'R', 'R', 'G'};
+// Version 2 changed the checksum, see details::checksum()
+constexpr std::uint32_t road_graph_version = 2;
+
+/**
+ * The fixed-size header of a road graph file.
+ */
+struct road_graph_header {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t length_size;
+  std::uint32_t reserved;
+  std::uint64_t num_vertices;
+  std::uint64_t num_edges;
+  // Of the arrays following the header, see details::checksum()
+  std::uint64_t checksum;
+};
+
+/**
+ * @return true if @p header is the header of a road graph of @p Length.
+ */
+template <typename Length>
+bool valid_header(road_graph_header const &header) {
+  return std::equal(header.magic, header.magic + 4, road_graph_magic) &&
+         header.version == road_graph_version &&
+         header.length_size == sizeof(Length) &&
+         header.num_vertices < std::numeric_limits<std::uint32_t>::max() &&
+         header.num_edges < std::numeric_limits<std::uint32_t>::max();
+}
+
+/**
+ * Check that the arrays of a road graph describe a graph: both offset
+ * arrays start at 0, never decrease and end at the number of edges, arcs
+ * lead to vertices and in-arcs name edges.
+ *
+ * Each array is read once without hashing, in O(|V| + |E|): corrupted
+ * weights go unnoticed, but searches on arrays passing the check never read
+ * out of bounds.
+ *
+ * @return true if @p arrays pass the check.
+ */
+template <typename Length>
+bool valid_arrays(road_graph_arrays<Length> const &arrays) {
+  auto n = std::size_t{arrays.num_vertices};
+  auto m = std::size_t{arrays.num_edges};
+  auto valid_offsets = [n, m](std::uint32_t const *offsets) {
+    if (offsets[0] != 0 || offsets[n] != m) {
+      return false;
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+      if (offsets[v] > offsets[v + 1]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!valid_offsets(arrays.out_offsets) ||
+      !valid_offsets(arrays.in_offsets)) {
+    return false;
+  }
+  for (std::size_t e = 0; e < m; ++e) {
+    if (arrays.out_arcs[e].target >= n || arrays.in_arcs[e].source >= n ||
+        arrays.in_arcs[e].edge >= m) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @return The checksum of the arrays of a road graph, in file order.
+ */
+template <typename Length>
+std::uint64_t road_graph_checksum(road_graph_arrays<Length> const &arrays) {
+  auto n = std::size_t{arrays.num_vertices};
+  auto m = std::size_t{arrays.num_edges};
+  auto hash = checksum(arrays.out_offsets, (n + 1) * sizeof(std::uint32_t));
+  hash = checksum(arrays.out_arcs, m * sizeof(*arrays.out_arcs), hash);
+  hash = checksum(arrays.in_offsets, (n + 1) * sizeof(std::uint32_t), hash);
+  return checksum(arrays.in_arcs, m * sizeof(*arrays.in_arcs), hash);
+}
+} // namespace details
+
+/**
+ * Write @p G to @p os in a binary format: a header with a magic number, a
+ * version, `sizeof(Length)`, the number of vertices and of edges and a
+ * checksum, then the offsets and entries of the forward and backward
+ * adjacency arrays, each padded to 8 bytes, in native byte order.
+ *
+ * The layout is the same in memory and on disk, so map_road_graph() reads
+ * the file in place. The in-arcs carry the index of their edge, so the
+ * dense edge index of the graph is saved along with it.
+ *
+ * @param os The stream to write to. Open it in binary mode.
+ * @param G The graph.
+ */
+template <typename Length>
+void write_road_graph(std::ostream &os, road_graph<Length> const &G) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto const &arrays = G.data();
+  auto n = std::size_t{arrays.num_vertices};
+  auto m = std::size_t{arrays.num_edges};
+  auto header = details::road_graph_header{};
+  std::copy(details::road_graph_magic, details::road_graph_magic + 4,
+            header.magic);
+  header.version = details::road_graph_version;
+  header.length_size = static_cast<std::uint32_t>(sizeof(Length));
+  header.num_vertices = n;
+  header.num_edges = m;
+  header.checksum = details::road_graph_checksum(arrays);
+  details::write_raw(os, &header, 1);
+  details::write_padded(os, arrays.out_offsets, n + 1);
+  details::write_padded(os, arrays.out_arcs, m);
+  details::write_padded(os, arrays.in_offsets, n + 1);
+  details::write_padded(os, arrays.in_arcs, m);
+}
+
+/**
+ * Read a road graph written by write_road_graph() into memory.
+ *
+ * @param is The stream to read from. Open it in binary mode.
+ * @return The graph, or an empty optional if @p is does not hold a road
+ *         graph of the same `Length` type, its arrays do not describe a
+ *         graph or its checksum does not match.
+ */
+template <typename Length>
+std::optional<road_graph<Length>> read_road_graph(std::istream &is) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto header = details::road_graph_header{};
+  if (!details::read_raw(is, &header, 1) ||
+      !details::valid_header<Length>(header)) {
+    return {};
+  }
+  auto n = static_cast<std::size_t>(header.num_vertices);
+  auto m = static_cast<std::size_t>(header.num_edges);
+  auto storage = details::road_graph_storage<Length>{};
+  if (!details::read_padded(is, storage.out_offsets, n + 1) ||
+      !details::read_padded(is, storage.out_arcs, m) ||
+      !details::read_padded(is, storage.in_offsets, n + 1) ||
+      !details::read_padded(is, storage.in_arcs, m)) {
+    return {};
+  }
+
+  // The positions of the edges among the in-arcs are not saved
+  storage.in_position.resize(m);
+  for (std::size_t pos = 0; pos < m; ++pos) {
+    auto e = storage.in_arcs[pos].edge;
+    if (e >= m) {
+      return {};
+    }
+    storage.in_position[e] = static_cast<std::uint32_t>(pos);
+  }
+  auto G = road_graph<Length>{std::move(storage)};
+  if (!details::valid_arrays(G.data()) ||
+      details::road_graph_checksum(G.data()) != header.checksum) {
+    return {};
+  }
+  return G;
+}
+
+/**
+ * Map a road graph written by write_road_graph() to a file, and read it in
+ * place as a read-only graph.
+ *
+ * Pages are shared with every other process mapping the same file. The
+ * arrays are always checked to describe a graph, see
+ * details::valid_arrays(): a truncated or corrupted file cannot make
+ * searches read out of bounds. This scan is much cheaper than hashing the
+ * whole file against its checksum, which is optional.
+ *
+ * @param path The path of the file.
+ * @param verify If true, also check the arrays against the checksum.
+ * @throw std::system_error if the file cannot be opened or mapped.
+ * @return The graph, or an empty optional if the file does not hold a road
+ *         graph of the same `Length` type, its arrays do not describe a
+ *         graph or, if @p verify, its checksum does not match.
+ */
+template <typename Length>
+std::optional<road_graph<Length>> map_road_graph(std::string const &path,
+                                                 bool verify = false) {
+  static_assert(std::is_trivially_copyable_v<Length> && alignof(Length) <= 8,
+                "Only trivially copyable lengths can be serialized.");
+  auto file = std::make_shared<details::mapped_file>(path);
+  auto header = details::road_graph_header{};
+  if (file->size() < sizeof(header)) {
+    return {};
+  }
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (!details::valid_header<Length>(header)) {
+    return {};
+  }
+
+  // Every array starts on an 8-byte boundary of the page-aligned mapping
+  auto n = static_cast<std::size_t>(header.num_vertices);
+  auto m = static_cast<std::size_t>(header.num_edges);
+  auto offsets_bytes = details::padded_size((n + 1) * sizeof(std::uint32_t));
+  auto section = std::vector<std::size_t>{
+      sizeof(header), offsets_bytes,
+      details::padded_size(m * sizeof(details::road_graph_out_arc<Length>)),
+      offsets_bytes,
+      details::padded_size(m * sizeof(details::road_graph_in_arc<Length>))};
+  auto start = std::vector<char const *>{};
+  auto position = std::size_t{0};
+  for (auto bytes : section) {
+    start.push_back(file->data() + position);
+    position += bytes;
+  }
+  if (position != file->size()) {
+    return {};
+  }
+
+  auto arrays = details::road_graph_arrays<Length>{
+      reinterpret_cast<std::uint32_t const *>(start[1]),
+      reinterpret_cast<details::road_graph_out_arc<Length> const *>(start[2]),
+      reinterpret_cast<std::uint32_t const *>(start[3]),
+      reinterpret_cast<details::road_graph_in_arc<Length> const *>(start[4]),
+      static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(m)};
+  if (!details::valid_arrays(arrays) ||
+      (verify && details::road_graph_checksum(arrays) != header.checksum)) {
+    return {};
+  }
+  return road_graph<Length>{arrays, std::move(file)};
+}
+
+/**
+ * Save a snapshot of @p G to the file at @p path, so that later processes
+ * can load it with load_csr_graph() instead of parsing and building the
+ * graph again.
+ *
+ * @p G is stored as a road_graph: the same compressed sparse row layout as
+ * CSRGraph, with both adjacency arrays. Edges keep their order, so the edge
+ * index of a CSRGraph is the one of the loaded graph.
+ *
+ * @tparam Graph A Boost::EdgeListGraph with the `boost::edge_weight_t` and
+ *         `boost::vertex_index_t` properties, e.g. a CSRGraph.
+ * @param path The path of the file, overwritten if it exists.
+ * @param G The graph.
+ * @throw std::system_error if the file cannot be written.
+ */
+template <typename Graph>
+void save_csr_graph(std::string const &path, Graph const &G) {
+  auto os = std::ofstream{path, std::ios::binary | std::ios::trunc};
+  if (!os) {
+    throw std::system_error{errno, std::generic_category(),
+                            "Cannot open " + path};
+  }
+  using Length = length_of_t<Graph>;
+  if constexpr (std::is_same_v<Graph, road_graph<Length>>) {
+    write_road_graph(os, G);
+  } else {
+    auto index = get(boost::vertex_index, G);
+    auto weight = get(boost::edge_weight, G);
+    auto es = std::vector<std::pair<std::size_t, std::size_t>>{};
+    auto ws = std::vector<Length>{};
+    es.reserve(num_edges(G));
+    ws.reserve(num_edges(G));
+    for (auto [it, end] = edges(G); it != end; ++it) {
+      es.emplace_back(get(index, source(*it, G)), get(index, target(*it, G)));
+      ws.push_back(get(weight, *it));
+    }
+    write_road_graph(os, road_graph<Length>{es.begin(), es.end(), ws.begin(),
+                                            num_vertices(G)});
+  }
+  os.flush();
+  if (!os) {
+    throw std::system_error{errno, std::generic_category(),
+                            "Cannot write " + path};
+  }
+}
+
+/**
+ * Load a snapshot saved by save_csr_graph(), reading it in place.
+ *
+ * @see map_road_graph(std::string const &path, bool verify)
+ *
+ * @tparam Length The edge weight type of the saved graph.
+ * @param path The path of the file.
+ * @param verify If true, also check the arrays against the checksum.
+ * @throw std::system_error if the file cannot be opened or mapped.
+ * @return A read-only view of the graph, or an empty optional if the file
+ *         is not a valid snapshot of a graph of `Length` weights.
+ */
+template <typename Length = double>
+std::optional<road_graph<Length>> load_csr_graph(std::string const &path,
+                                                 bool verify = false) {
+  return map_road_graph<Length>(path, verify);
+}
+} // namespace arlib
+
+namespace boost {
+template <typename Length>
+struct property_map<arlib::road_graph<Length>, edge_weight_t> {
+  using type = arlib::road_graph_weight_map<arlib::road_graph<Length>>;
+  using const_type =
+      arlib::road_graph_weight_map<const arlib::road_graph<Length>>;
+};
+
+template <typename Length>
+struct property_map<arlib::road_graph<Length>, vertex_index_t> {
+  using type = typed_identity_property_map<std::uint32_t>;
+  using const_type = type;
+};
+
+template <typename Length>
+struct property_map<arlib::road_graph<Length>, edge_index_t> {
+  using type = arlib::road_graph_edge_index_map<arlib::road_graph<Length>>;
+  using const_type = type;
+};
+} // namespace boost
+
+#endif // ALTERNATIVE_ROUTING_LIB_ROAD_GRAPH_HPP
@@ -0,0 +1,157 @@
+/**
+ * @file bidirectional_alt.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_HPP
+#define ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/landmarks.hpp>
+#include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/details/bidirectional_alt_impl.hpp>
+#include <arlib/routing_kernels/types.hpp>
+#include <arlib/type_traits.hpp>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                      Bidirectional ALT algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Bidirectional ALT: Bidirectional Dijkstra guided by landmark lower bounds
+ * toward both search roots.
+ *
+ * This implementation refers to the following publication:
+ *
+ * Andrew V. Goldberg and Chris Harrelson, Computing the Shortest Path: A*
+ * Search Meets Graph Theory, In Proc. of the 16th Annual ACM-SIAM Symposium on
+ * Discrete Algorithms (SODA) (2005)
+ *
+ * The search is bidirectional_dijkstra() on edge weights reduced by the
+ * average landmark potential, so it shares its workspace, direction policies
+ * and predecessor output. Reduced weights are doubled to keep integer lengths
+ * exact: @p Length must be a signed type, able to hold twice the s-t
+ * distance.
+ *
+ * @see bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                             PredecessorMap predecessor, WeightMap weight,
+ *                             const BackGraph &G_b, BackWeightMap weight_b,
+ *                             IndexMap index_map,
+ *                             BiDijkstraWorkspace<Vertex, Length,
+ *                                 QueuePolicy> &workspace,
+ *                             direction_policy policy)
+ *
+ * @tparam LandmarkLength The value type of the landmark distances.
+ * @param lm The landmarks of @p G. Their bounds must not exceed the
+ *        distances on @p weight.
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename IndexMap,
+          typename LandmarkLength, typename Vertex, typename Length,
+          typename QueuePolicy>
+Length bidirectional_alt(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    WeightMap weight, const BackGraph &G_b, BackWeightMap weight_b,
+    IndexMap index_map, landmarks<LandmarkLength> const &lm,
+    BiDijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace,
+    direction_policy policy = direction_policy::alternating) {
+  using namespace boost;
+  using Edge = edge_of_t<Graph>;
+  using RevEdge = edge_of_t<BackGraph>;
+
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
+
+  auto potential = details::alt_potential<Length, LandmarkLength>{
+      lm, get(index_map, s), get(index_map, t)};
+  auto reduced =
+      details::make_alt_reduced_weight_map<Length>(G, weight, index_map,
+                                                   potential, 1);
+  auto reduced_b =
+      details::make_alt_reduced_weight_map<Length>(G_b, weight_b, index_map,
+                                                   potential, -1);
+
+  auto reduced_distance =
+      bidirectional_dijkstra(G, s, t, predecessor, reduced, G_b, reduced_b,
+                             index_map, workspace, policy);
+
+  // A reduced s-t path length is 2 * length - p(s) + p(t)
+  return (reduced_distance + potential(get(index_map, s)) -
+          potential(get(index_map, t))) /
+         2;
+}
+
+/**
+ * Bidirectional ALT on a fresh workspace, reading weights from the
+ * `boost::edge_weight_t` property of @p G and indices from its
+ * `boost::vertex_index_t` property.
+ *
+ * @tparam QueuePolicy The priority queue of the fringes. Defaults to a 4-ary
+ *         heap.
+ *
+ * @see bidirectional_alt(const Graph &G, Vertex s, Vertex t,
+ *                        PredecessorMap predecessor, WeightMap weight,
+ *                        const BackGraph &G_b, BackWeightMap weight_b,
+ *                        IndexMap index_map,
+ *                        landmarks<LandmarkLength> const &lm,
+ *                        BiDijkstraWorkspace<Vertex, Length, QueuePolicy>
+ *                            &workspace,
+ *                        direction_policy policy)
+ */
+template <typename QueuePolicy = d_ary_heap_policy<>, typename PropertyGraph,
+          typename PredecessorMap, typename LandmarkLength,
+          typename Vertex = vertex_of_t<PropertyGraph>>
+length_of_t<PropertyGraph>
+bidirectional_alt(const PropertyGraph &G, Vertex s, Vertex t,
+                  PredecessorMap predecessor,
+                  landmarks<LandmarkLength> const &lm,
+                  direction_policy policy = direction_policy::alternating) {
+  using namespace boost;
+  using Length = length_of_t<PropertyGraph>;
+
+  auto weight = get(edge_weight, G);
+  auto G_b = make_reverse_graph(G);
+  auto weight_b = details::make_reverse_weight_map(weight, G_b);
+  auto workspace =
+      BiDijkstraWorkspace<Vertex, Length, QueuePolicy>{num_vertices(G)};
+  return bidirectional_alt(G, s, t, predecessor, weight, G_b, weight_b,
+                           get(vertex_index, G), lm, workspace, policy);
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_HPP
@@ -38,10 +38,11 @@
 
 #include <arlib/details/arlib_utils.hpp>
 #include <arlib/routing_kernels/details/bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/queue_policies.hpp>
+#include <arlib/routing_kernels/types.hpp>
 #include <arlib/routing_kernels/visitor.hpp>
 #include <arlib/type_traits.hpp>
 
-#include <deque>
 #include <limits>
 #include <vector>
 
@@ -49,6 +50,64 @@
  * An Alternative-Routing library for Boost.Graph
  */
 namespace arlib {
+//===----------------------------------------------------------------------===//
+//                   Bidirectional Dijkstra workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory bidirectional_dijkstra() works on: for each direction, a dense
+ * array of vertex labels and an indexed priority queue, by default a 4-ary
+ * heap.
+ *
+ * Labels are generation-stamped, so a workspace can be reused by any number
+ * of queries on graphs of the same order, paying O(|V|) allocation once
+ * instead of once per query. A workspace is not thread-safe: use one per
+ * thread.
+ *
+ * @tparam Vertex The vertex_descriptor.
+ * @tparam Length The weight value type.
+ * @tparam QueuePolicy The priority queue of the fringes, e.g.
+ *         radix_heap_policy for integer weights.
+ */
+template <typename Vertex, typename Length,
+          typename QueuePolicy = d_ary_heap_policy<>>
+class BiDijkstraWorkspace {
+public:
+  /**
+   * The state of one search direction.
+   */
+  using Search = details::BiDijkstraSearch<Vertex, Length,
+                                           queue_of_t<QueuePolicy, Length>>;
+
+  BiDijkstraWorkspace() = default;
+  /**
+   * Construct a new BiDijkstraWorkspace for graphs of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit BiDijkstraWorkspace(std::size_t n) : forward{n}, backward{n} {}
+
+  /**
+   * @return The state of the forward search.
+   */
+  Search &forward_search() { return forward; }
+  /**
+   * @return The state of the forward search.
+   */
+  const Search &forward_search() const { return forward; }
+  /**
+   * @return The state of the backward search.
+   */
+  Search &backward_search() { return backward; }
+  /**
+   * @return The state of the backward search.
+   */
+  const Search &backward_search() const { return backward; }
+
+private:
+  Search forward;
+  Search backward;
+};
+
 //===----------------------------------------------------------------------===//
 //                   Bidirectional Dijkstra algorithm
 //===----------------------------------------------------------------------===//
@@ -92,6 +151,8 @@ namespace arlib {
  * @tparam BackWeightMap A WeightMap of a boost::reverse_graph<Graph>
  * @tparam BiDijkstraVisitorImpl An implementation of a BiDijkstraVisitor.
  * @tparam Vertex a vertex_descriptor.
+ * @tparam QueuePolicy The priority queue of the fringes, e.g.
+ *         radix_heap_policy for integer weights. Defaults to a 4-ary heap.
  * @param G The graph.
  * @param s The source vertex.
  * @param t The target vertex.
@@ -103,17 +164,19 @@ namespace arlib {
  * @param distance_b The DistanceMap for the backward step.
  * @param weight_b The WeightMap for the backward step.
  * @param visitor An implementation of a BiDijkstraVisitor.
+ * @param policy How to pick the direction of each step.
  */
-template <typename Graph, typename PredecessorMap, typename DistanceMap,
-          typename WeightMap, typename BackGraph, typename BackPredecessorMap,
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackPredecessorMap,
           typename BackDistanceMap, typename BackWeightMap,
           typename BiDijkstraVisitorImpl, typename Vertex = vertex_of_t<Graph>>
-void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
-                            PredecessorMap predecessor, DistanceMap distance,
-                            WeightMap weight, const BackGraph &G_b,
-                            BackPredecessorMap predecessor_b,
-                            BackDistanceMap distance_b, BackWeightMap weight_b,
-                            BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor) {
+void bidirectional_dijkstra(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    DistanceMap distance, WeightMap weight, const BackGraph &G_b,
+    BackPredecessorMap predecessor_b, BackDistanceMap distance_b,
+    BackWeightMap weight_b, BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor,
+    direction_policy policy = direction_policy::alternating) {
   using namespace boost;
   using Length = typename property_traits<DistanceMap>::value_type;
   using Edge = edge_of_t<Graph>;
@@ -124,8 +187,6 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
   BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
   BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
 
-  constexpr Length inf = std::numeric_limits<Length>::max();
-
   // Initialize distance structures
   details::init_distance_vector(G, distance);
   details::init_distance_vector(G_b, distance_b);
@@ -134,70 +195,24 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
   predecessor[s] = s;
   predecessor_b[t] = t;
 
-  // Init fringe structures
-  auto fringe = details::Fringe<Vertex, Length>{};
-  auto fringe_b = details::Fringe<Vertex, Length>{};
-  fringe.push(std::make_pair(s, 0));
-  fringe_b.push(std::make_pair(t, 0));
-
-  // Init distances to nodes seen
-  auto seen = details::Seen<Vertex, Length>{};
-  auto seen_b = details::Seen<Vertex, Length>{};
-  seen.insert({s, 0});
-  seen_b.insert({t, 0});
+  auto index = get(vertex_index, G);
+  auto workspace =
+      BiDijkstraWorkspace<Vertex, Length, QueuePolicy>{num_vertices(G)};
+  auto &forward = workspace.forward_search();
+  auto &backward = workspace.backward_search();
+  auto [meeting, st_distance] = details::bi_dijkstra_search(
+      G, s, t, weight, G_b, weight_b, index, forward, backward, visitor,
+      policy, [&distance](Vertex v, Length d) { distance[v] = d; },
+      [&predecessor](Vertex w, Vertex v, const auto &) { predecessor[w] = v; },
+      [&distance_b](Vertex v, Length d) { distance_b[v] = d; },
+      [&predecessor_b](Vertex w, Vertex v, const auto &) {
+        predecessor_b[w] = v;
+      });
+  (void)st_distance;
 
-  using details::BiDijkStepRes;
-  using details::Direction;
-
-  Length final_distance = inf;
-  auto final_path = std::deque<Vertex>{};
-  auto direction = Direction::backward;
-  while (!fringe.empty() && !fringe_b.empty()) {
-    direction = details::switch_direction(direction);
-    auto result = BiDijkStepRes::next;
-
-    // Run a step
-    if (direction == Direction::forward) {
-      result = details::bi_dijkstra_step(
-          G, s, t, predecessor, distance, weight, fringe, seen, predecessor_b,
-          distance_b, fringe_b, seen_b, direction, final_distance, final_path,
-          visitor);
-    } else {
-      result = details::bi_dijkstra_step(
-          G_b, s, t, predecessor_b, distance_b, weight_b, fringe_b, seen_b,
-          predecessor, distance, fringe, seen, direction, final_distance,
-          final_path, visitor);
-    }
-
-    // Handle the outcome of this step
-    switch (result) {
-    case BiDijkStepRes::next:
-      // Go next
-      break;
-    case BiDijkStepRes::end:
-      // Fill predecessor map
-      details::fill_predecessor(predecessor, final_path);
-      return;
-    case BiDijkStepRes::negative_weights:
-      throw std::domain_error{"Contradictory paths found: negative weights?"};
-    default:
-      // Unexpected result
-      throw std::invalid_argument{"Unexpected result. Exiting..."};
-    }
-  }
-
-  if (fringe.empty() || fringe_b.empty()) {
-    if (final_path.empty()) {
-      throw details::target_not_found{"No path found!"};
-    } else {
-      // Clean exit
-      details::fill_predecessor(predecessor, final_path);
-      return;
-    }
-  } else {
-    // Otherwise
-    throw details::target_not_found{"No path found!"};
-  }
+  // Fill predecessor map
+  details::fill_predecessor(predecessor, index, s, t, meeting, forward,
+                            backward);
 }
 
 /**
@@ -223,10 +238,10 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
  *         must be an integer type. The vertex descriptor type of the graph
  *         needs to be usable as the key type of the map.
  */
-template <typename Graph, typename PredecessorMap, typename DistanceMap,
-          typename WeightMap, typename BackGraph, typename BackWeightMap,
-          typename BackIndexMap, typename BiDijkstraVisitorImpl,
-          typename Vertex = vertex_of_t<Graph>>
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename BackIndexMap,
+          typename BiDijkstraVisitorImpl, typename Vertex = vertex_of_t<Graph>>
 void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
                             PredecessorMap predecessor, DistanceMap distance,
                             WeightMap weight, const BackGraph &G_b,
@@ -243,17 +258,24 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
   BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
   BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
 
-  auto predecessor_b_vec =
-      std::vector<Vertex>(vertices(G_b).first, vertices(G_b).second);
-  auto predecessor_b =
-      make_iterator_property_map(std::begin(predecessor_b_vec), index_map_b);
+  details::init_distance_vector(G, distance);
+  predecessor[s] = s;
 
-  auto distance_b_vec = std::vector<Length>(num_vertices(G_b));
-  auto distance_b =
-      make_iterator_property_map(std::begin(distance_b_vec), index_map_b);
+  auto workspace =
+      BiDijkstraWorkspace<Vertex, Length, QueuePolicy>{num_vertices(G)};
+  auto &forward = workspace.forward_search();
+  auto &backward = workspace.backward_search();
+  auto no_op = details::bi_dijkstra_no_op{};
+  auto [meeting, st_distance] = details::bi_dijkstra_search(
+      G, s, t, weight, G_b, weight_b, index_map_b, forward, backward, visitor,
+      direction_policy::alternating,
+      [&distance](Vertex v, Length d) { distance[v] = d; },
+      [&predecessor](Vertex w, Vertex v, const auto &) { predecessor[w] = v; },
+      no_op, no_op);
+  (void)st_distance;
 
-  bidirectional_dijkstra(G, s, t, predecessor, distance, weight, G_b,
-                         predecessor_b, distance_b, weight_b, visitor);
+  details::fill_predecessor(predecessor, index_map_b, s, t, meeting, forward,
+                            backward);
 }
 
 /**
@@ -280,9 +302,10 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
  *         must be an integer type. The vertex descriptor type of the graph
  *         needs to be usable as the key type of the map.
  */
-template <typename Graph, typename PredecessorMap, typename DistanceMap,
-          typename WeightMap, typename BackGraph, typename BackWeightMap,
-          typename BackIndexMap, typename Vertex = vertex_of_t<Graph>>
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename BackIndexMap,
+          typename Vertex = vertex_of_t<Graph>>
 void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
                             PredecessorMap predecessor, DistanceMap distance,
                             WeightMap weight, const BackGraph &G_b,
@@ -298,8 +321,98 @@ void bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
   BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
 
   auto visitor = IdentityBiDijkstraVisitor{};
-  bidirectional_dijkstra(G, s, t, predecessor, distance, weight, G_b, weight_b,
-                         index_map_b, visitor);
+  bidirectional_dijkstra<QueuePolicy>(G, s, t, predecessor, distance, weight,
+                                      G_b, weight_b, index_map_b, visitor);
+}
+
+/**
+ * Implementation of Bidirectional Dijkstra method for Boost::Graph to
+ * compute the shortest path between two vertices, running on a reusable
+ * BiDijkstraWorkspace.
+ *
+ * This is the overload to call in a loop: it allocates nothing, and writes
+ * @p predecessor only for the vertices on the shortest path, once the search
+ * is over.
+ *
+ * @see bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                             PredecessorMap predecessor, DistanceMap distance,
+ *                             WeightMap weight, const BackGraph &G_b,
+ *                             BackPredecessorMap predecessor_b,
+ *                             BackDistanceMap distance_b,
+ *                             BackWeightMap weight_b,
+ *                             BiDijkstraVisitor<BiDijkstraVisitorImpl>
+ *                                 &visitor,
+ *                             direction_policy policy)
+ *
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param index_map The IndexMap of @p G and @p G_b.
+ * @param workspace The memory to run the search on.
+ * @param visitor An implementation of a BiDijkstraVisitor.
+ * @param policy How to pick the direction of each step.
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename IndexMap,
+          typename BiDijkstraVisitorImpl, typename Vertex, typename Length,
+          typename QueuePolicy>
+Length bidirectional_dijkstra(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    WeightMap weight, const BackGraph &G_b, BackWeightMap weight_b,
+    IndexMap index_map,
+    BiDijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace,
+    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor,
+    direction_policy policy = direction_policy::alternating) {
+  using namespace boost;
+  using Edge = edge_of_t<Graph>;
+  using RevEdge = edge_of_t<boost::reverse_graph<Graph>>;
+
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<BackGraph>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
+
+  auto &forward = workspace.forward_search();
+  auto &backward = workspace.backward_search();
+  auto no_op = details::bi_dijkstra_no_op{};
+  auto [meeting, st_distance] = details::bi_dijkstra_search(
+      G, s, t, weight, G_b, weight_b, index_map, forward, backward, visitor,
+      policy, no_op, no_op, no_op, no_op);
+
+  predecessor[s] = s;
+  details::fill_predecessor(predecessor, index_map, s, t, meeting, forward,
+                            backward);
+  return st_distance;
+}
+
+/**
+ * Implementation of Bidirectional Dijkstra method for Boost::Graph to
+ * compute the shortest path between two vertices, running on a reusable
+ * BiDijkstraWorkspace. This simply runs Bidirectional Dijkstra.
+ *
+ * @see bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                             PredecessorMap predecessor, WeightMap weight,
+ *                             const BackGraph &G_b, BackWeightMap weight_b,
+ *                             IndexMap index_map,
+ *                             BiDijkstraWorkspace<Vertex, Length,
+ *                                 QueuePolicy> &workspace,
+ *                             BiDijkstraVisitor<BiDijkstraVisitorImpl>
+ *                                 &visitor,
+ *                             direction_policy policy)
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename IndexMap,
+          typename Vertex, typename Length, typename QueuePolicy>
+Length bidirectional_dijkstra(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    WeightMap weight, const BackGraph &G_b, BackWeightMap weight_b,
+    IndexMap index_map,
+    BiDijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace,
+    direction_policy policy = direction_policy::alternating) {
+  auto visitor = IdentityBiDijkstraVisitor{};
+  return bidirectional_dijkstra(G, s, t, predecessor, weight, G_b, weight_b,
+                                index_map, workspace, visitor, policy);
 }
 } // namespace arlib
 
@@ -0,0 +1,150 @@
+/**
+ * @file cch_query.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CCH_QUERY_HPP
+#define ALTERNATIVE_ROUTING_LIB_CCH_QUERY_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/customizable_contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/cch_query_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <iterator>
+#include <optional>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                           CCH query workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory cch_query() works on, reusable by any number of queries on
+ * metrics of the same hierarchy. A workspace is not thread-safe: use one per
+ * thread.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class CCHWorkspace {
+public:
+  /**
+   * The state of one search direction.
+   */
+  using Search = details::CCHSearch<Length>;
+
+  CCHWorkspace() = default;
+  /**
+   * Construct a new CCHWorkspace for hierarchies of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit CCHWorkspace(std::size_t n) : forward{n}, backward{n} {}
+
+  /**
+   * @return The state of the forward search.
+   */
+  Search &forward_search() { return forward; }
+  /**
+   * @return The state of the backward search.
+   */
+  Search &backward_search() { return backward; }
+
+private:
+  Search forward;
+  Search backward;
+};
+
+//===----------------------------------------------------------------------===//
+//                            CCH query algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Compute the shortest path from @p s to @p t on a customized
+ * customizable_contraction_hierarchy, with an elimination tree query: both
+ * searches scan the ancestors of their root in the elimination tree, with
+ * no priority queue, then the shortest path is unpacked into edges of the
+ * original graph.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @tparam OutputIt An OutputIterator of edge descriptors.
+ * @param metric The customized metric.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @param index The IndexMap of the graph.
+ * @param workspace The memory to run the search on.
+ * @param path Where to write the edges of the shortest path, in order.
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename Length, typename IndexMap,
+          typename OutputIt, typename Vertex = vertex_of_t<Graph>>
+Length cch_query(cch_metric<Graph, Length> const &metric, Vertex s, Vertex t,
+                 IndexMap index, CCHWorkspace<Length> &workspace,
+                 OutputIt path) {
+  auto const &cch = metric.topology();
+  return details::cch_search(metric, cch.rank(get(index, s)),
+                             cch.rank(get(index, t)),
+                             workspace.forward_search(),
+                             workspace.backward_search(), path);
+}
+
+/**
+ * Compute the shortest path from @p s to @p t on a customized
+ * customizable_contraction_hierarchy.
+ *
+ * @see cch_query(cch_metric<Graph, Length> const &metric, Vertex s,
+ *                Vertex t, IndexMap index, CCHWorkspace<Length> &workspace,
+ *                OutputIt path)
+ *
+ * @return The edges of the shortest path from @p s to @p t, or an empty
+ *         optional if @p t is not reachable from @p s.
+ */
+template <typename Graph, typename Length, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>>
+std::optional<std::vector<edge_of_t<Graph>>>
+cch_shortest_path(cch_metric<Graph, Length> const &metric, Vertex s, Vertex t,
+                  IndexMap index, CCHWorkspace<Length> &workspace) {
+  auto path = std::vector<edge_of_t<Graph>>{};
+  try {
+    cch_query(metric, s, t, index, workspace, std::back_inserter(path));
+  } catch (details::target_not_found &) {
+    return {};
+  }
+  return path;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CCH_QUERY_HPP
@@ -0,0 +1,147 @@
+/**
+ * @file ch_query.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CH_QUERY_HPP
+#define ALTERNATIVE_ROUTING_LIB_CH_QUERY_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/ch_query_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <iterator>
+#include <optional>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                           CH query workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory ch_query() works on, reusable by any number of queries on the
+ * same hierarchy. A workspace is not thread-safe: use one per thread.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class CHWorkspace {
+public:
+  /**
+   * The state of one search direction.
+   */
+  using Search = details::CHSearch<Length>;
+
+  CHWorkspace() = default;
+  /**
+   * Construct a new CHWorkspace for hierarchies of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit CHWorkspace(std::size_t n) : forward{n}, backward{n} {}
+
+  /**
+   * @return The state of the forward search.
+   */
+  Search &forward_search() { return forward; }
+  /**
+   * @return The state of the backward search.
+   */
+  Search &backward_search() { return backward; }
+
+private:
+  Search forward;
+  Search backward;
+};
+
+//===----------------------------------------------------------------------===//
+//                            CH query algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Compute the shortest path from @p s to @p t on a contraction_hierarchy,
+ * with a bidirectional search that only ever climbs the hierarchy, then
+ * unpack its shortcuts into edges of the original graph.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @tparam OutputIt An OutputIterator of edge descriptors.
+ * @param ch The contraction hierarchy.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @param index The IndexMap of the graph.
+ * @param workspace The memory to run the search on.
+ * @param path Where to write the edges of the shortest path, in order.
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename Length, typename IndexMap,
+          typename OutputIt, typename Vertex = vertex_of_t<Graph>>
+Length ch_query(contraction_hierarchy<Graph, Length> const &ch, Vertex s,
+                Vertex t, IndexMap index, CHWorkspace<Length> &workspace,
+                OutputIt path) {
+  auto &forward = workspace.forward_search();
+  auto &backward = workspace.backward_search();
+  auto [meeting, distance] =
+      details::ch_search(ch, get(index, s), get(index, t), forward, backward);
+  details::ch_unpack_path(ch, meeting, forward, backward, path);
+  return distance;
+}
+
+/**
+ * Compute the shortest path from @p s to @p t on a contraction_hierarchy.
+ *
+ * @see ch_query(contraction_hierarchy<Graph, Length> const &ch, Vertex s,
+ *               Vertex t, IndexMap index, CHWorkspace<Length> &workspace,
+ *               OutputIt path)
+ *
+ * @return The edges of the shortest path from @p s to @p t, or an empty
+ *         optional if @p t is not reachable from @p s.
+ */
+template <typename Graph, typename Length, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>>
+std::optional<std::vector<edge_of_t<Graph>>>
+ch_shortest_path(contraction_hierarchy<Graph, Length> const &ch, Vertex s,
+                 Vertex t, IndexMap index, CHWorkspace<Length> &workspace) {
+  auto path = std::vector<edge_of_t<Graph>>{};
+  try {
+    ch_query(ch, s, t, index, workspace, std::back_inserter(path));
+  } catch (details::target_not_found &) {
+    return {};
+  }
+  return path;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CH_QUERY_HPP
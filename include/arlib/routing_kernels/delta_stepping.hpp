@@ -0,0 +1,137 @@
+/**
+ * @file delta_stepping.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_HPP
+#define ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/routing_kernels/details/delta_stepping_impl.hpp>
+#include <arlib/thread_pool.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                          Delta-stepping algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Compute the distances from @p s to every vertex of @p G with parallel
+ * Delta-stepping, on the threads of @p pool.
+ *
+ * This implementation refers to the following publication:
+ * Ulrich Meyer, Peter Sanders. Delta-stepping: a parallelizable shortest path
+ * algorithm. Journal of Algorithms, 49(1), pp. 114-152, 2003.
+ *
+ * Vertices are kept in buckets of width @p delta instead of a priority
+ * queue. All the vertices of the lowest bucket are scanned in parallel,
+ * relaxing their light edges (weight at most @p delta) until the bucket
+ * stays empty, then their heavy edges once. Every thread owns a share of the
+ * vertices and their buckets, and receives the relaxations of its vertices
+ * from the other threads between two phases, so no locks nor atomics are
+ * involved.
+ *
+ * The distances are the same as `boost::dijkstra_shortest_paths()`,
+ * unreachable vertices included. It is worth it on full-graph searches of
+ * large graphs: on small ones, or with a single thread, a Dijkstra's search
+ * is faster.
+ *
+ * @tparam Graph A Boost::IncidenceGraph and Boost::VertexListGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @tparam DistanceMap A writable DistanceMap.
+ * @param G The graph.
+ * @param s The source vertex.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param distance Receives the distance of every vertex from @p s.
+ * @param pool The threads to run on.
+ * @param delta The bucket width. If not positive, the mean edge weight of
+ *        @p G is used.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename DistanceMap, typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+void delta_stepping(const Graph &G, Vertex s, WeightMap weight, IndexMap index,
+                    DistanceMap distance, thread_pool &pool,
+                    Length delta = Length{}) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto vertex = std::vector<Vertex>(num_vertices(G));
+  for (auto [it, end] = vertices(G); it != end; ++it) {
+    vertex[get(index, *it)] = *it;
+  }
+  auto result = std::vector<Length>{};
+  details::delta_stepping_search(G, weight, index, vertex, get(index, s), delta,
+                                 pool, result);
+  using boost::put; // Also for raw pointers, hidden by arlib::put
+  for (std::size_t v = 0; v < vertex.size(); ++v) {
+    put(distance, vertex[v], result[v]);
+  }
+}
+
+/**
+ * Compute the distances from @p s to every vertex of @p G with parallel
+ * Delta-stepping.
+ *
+ * @see delta_stepping(const Graph &G, Vertex s, WeightMap weight,
+ *                     IndexMap index, DistanceMap distance, thread_pool
+ *                     &pool, Length delta)
+ *
+ * @return The distances of every vertex by vertex index.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+std::vector<Length> delta_stepping_distances(const Graph &G, Vertex s,
+                                             WeightMap weight, IndexMap index,
+                                             thread_pool &pool,
+                                             Length delta = Length{}) {
+  auto distance = std::vector<Length>(num_vertices(G));
+  delta_stepping(G, s, weight, index,
+                 boost::make_iterator_property_map(distance.begin(), index),
+                 pool, delta);
+  return distance;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_HPP
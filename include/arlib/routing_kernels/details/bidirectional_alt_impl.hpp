@@ -0,0 +1,142 @@
+/**
+ * @file bidirectional_alt_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+#include <arlib/landmarks.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cstddef>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                    Bidirectional ALT support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * The average potential of bidirectional ALT:
+ * <tt>p(v) = LB(v, t) - LB(s, v)</tt>, twice the usual
+ * <tt>(LB(v, t) - LB(s, v)) / 2</tt> so that integer lengths stay exact.
+ *
+ * Searching forward with potential `p` and backward with `-p` keeps the two
+ * searches consistent with each other, so the usual bidirectional Dijkstra
+ * stopping criterion still holds on the reduced weights.
+ *
+ * @tparam Length The value type of the reduced weights.
+ * @tparam LandmarkLength The value type of the landmark distances.
+ */
+template <typename Length, typename LandmarkLength> class alt_potential {
+public:
+  alt_potential(landmarks<LandmarkLength> const &lm, std::size_t s,
+                std::size_t t)
+      : lm{&lm}, s{s}, t{t} {}
+
+  /**
+   * @param v A vertex index.
+   * @return The potential of @p v.
+   */
+  Length operator()(std::size_t v) const {
+    return static_cast<Length>(lm->lower_bound(v, t)) -
+           static_cast<Length>(lm->lower_bound(s, v));
+  }
+
+private:
+  landmarks<LandmarkLength> const *lm;
+  std::size_t s;
+  std::size_t t;
+};
+
+/**
+ * A functor computing the reduced weight
+ * <tt>2 * w(u, v) - sign * p(u) + sign * p(v)</tt> of an edge of @p Graph.
+ * Use `sign = 1` on the forward graph, and `sign = -1` on the reverse one.
+ *
+ * Landmark potentials are only consistent on the vertices lying on some
+ * s-t path, where every landmark distance they read is finite. Edges off
+ * those paths may get a negative reduced weight: they are clamped to zero,
+ * which leaves s-t path lengths untouched.
+ *
+ * @tparam Graph A Boost::Graph.
+ * @tparam WeightMap The WeightMap of @p Graph.
+ * @tparam IndexMap The IndexMap of @p Graph.
+ * @tparam Potential An alt_potential.
+ * @tparam Length The value type of the reduced weights. It must be signed.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Potential, typename Length>
+class alt_reduced_weight {
+public:
+  alt_reduced_weight(const Graph &G, WeightMap weight, IndexMap index,
+                     Potential const &potential, int sign)
+      : G{&G}, weight{weight}, index{index}, potential{potential}, sign{sign} {}
+
+  /**
+   * @param e An edge of the graph.
+   * @return The reduced weight of @p e.
+   */
+  Length operator()(edge_of_t<Graph> const &e) const {
+    using namespace boost;
+    auto p_u = potential(get(index, source(e, *G)));
+    auto p_v = potential(get(index, target(e, *G)));
+    auto w = static_cast<Length>(get(weight, e));
+    auto reduced = w + w + (sign > 0 ? p_v - p_u : p_u - p_v);
+    return reduced < Length{} ? Length{} : reduced;
+  }
+
+private:
+  const Graph *G;
+  WeightMap weight;
+  IndexMap index;
+  Potential potential;
+  int sign;
+};
+
+/**
+ * @return A Readable Property Map of the reduced weights of @p G.
+ */
+template <typename Length, typename Graph, typename WeightMap,
+          typename IndexMap, typename Potential>
+auto make_alt_reduced_weight_map(const Graph &G, WeightMap weight,
+                                 IndexMap index, Potential const &potential,
+                                 int sign) {
+  using Functor =
+      alt_reduced_weight<Graph, WeightMap, IndexMap, Potential, Length>;
+  return boost::make_function_property_map<edge_of_t<Graph>, Length>(
+      Functor{G, weight, index, potential, sign});
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_BIDIRECTIONAL_ALT_IMPL_HPP
@@ -37,14 +37,18 @@
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/property_map/property_map.hpp>
 
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/prefetch.hpp>
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+#include <arlib/routing_kernels/types.hpp>
 #include <arlib/routing_kernels/visitor.hpp>
 #include <arlib/type_traits.hpp>
 
-#include <deque>
-#include <iostream>
+#include <cassert>
 #include <limits>
-#include <queue>
-#include <unordered_map>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace arlib {
@@ -84,30 +88,73 @@ enum class BiDijkStepRes {
                         preconditions are violated. */
 };
 
-//===----------------------------------------------------------------------===//
-//                      Bidirectional Dijkstra  aliases
-//===----------------------------------------------------------------------===//
-template <typename Vertex>
-using PathMap =
-    std::unordered_map<Vertex, std::vector<Vertex>, boost::hash<Vertex>>;
+/**
+ * The search state of a vertex in one direction of bidirectional dijkstra.
+ *
+ * @tparam Vertex A vertex_descriptor.
+ * @tparam Length The weight value type.
+ */
+template <typename Vertex, typename Length> struct BiDijkstraLabel {
+  Length distance;  /**< Tentative distance from the search root. */
+  Vertex vertex;    /**< The vertex this label belongs to. */
+  Vertex parent;    /**< Predecessor in the search tree. */
+  bool settled;     /**< Whether distance is final. */
+};
 
-template <typename Vertex, typename Length>
-using FringeElem = std::pair<Vertex, Length>;
+/**
+ * The state of one direction of bidirectional dijkstra: a dense,
+ * generation-stamped array of labels indexed by vertex index and an indexed
+ * priority queue of the fringe, a 4-ary heap by default. Both are emptied
+ * between queries without touching every vertex.
+ *
+ * @tparam Vertex A vertex_descriptor.
+ * @tparam Length The weight value type.
+ * @tparam Queue The fringe type, with the interface of d_ary_heap.
+ */
+template <typename Vertex, typename Length,
+          typename Queue = d_ary_heap<Length>>
+class BiDijkstraSearch {
+public:
+  using Label = BiDijkstraLabel<Vertex, Length>;
+  static constexpr Length inf = std::numeric_limits<Length>::max();
+
+  BiDijkstraSearch() = default;
+  explicit BiDijkstraSearch(std::size_t n)
+      : labels(n, Label{inf, Vertex{}, Vertex{}, false}), fringe(n) {}
+
+  /**
+   * Prepare for a new search on a graph of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  void reset(std::size_t n) {
+    labels.resize(n);
+    fringe.resize(n);
+  }
 
-template <typename Vertex, typename Length> struct FringeComparator {
-  using Elem = FringeElem<Vertex, Length>;
-  bool operator()(const Elem &lhs, const Elem &rhs) const {
-    return lhs.second > rhs.second;
+  /**
+   * Make @p root the only vertex in the fringe, at distance 0.
+   *
+   * @param root The root vertex.
+   * @param root_index The index of @p root.
+   */
+  void init(Vertex root, std::size_t root_index) {
+    labels.at(root_index) = Label{Length{0}, root, root, false};
+    fringe.push_or_decrease(root_index, Length{0});
   }
+
+  stamped_vector<Label> labels =
+      stamped_vector<Label>(0, Label{inf, Vertex{}, Vertex{}, false});
+  Queue fringe;
 };
 
-template <typename Vertex, typename Length>
-using Fringe = std::priority_queue<FringeElem<Vertex, Length>,
-                                   std::vector<FringeElem<Vertex, Length>>,
-                                   FringeComparator<Vertex, Length>>;
+/**
+ * A do-nothing callback of bi_dijkstra_search().
+ */
+struct bi_dijkstra_no_op {
+  template <typename... Args> void operator()(Args &&...) const {}
+};
 
-template <typename Vertex, typename Length>
-using Seen = std::unordered_map<Vertex, Length, boost::hash<Vertex>>;
 //===----------------------------------------------------------------------===//
 //                      Bidirectional Dijkstra routines
 //===----------------------------------------------------------------------===//
@@ -133,92 +180,55 @@ void init_distance_vector(Graph &G, DistanceMap distance) {
   }
 }
 
-template <typename Vertex, typename PredecessorMap, typename BackPredecessorMap>
-void merge_paths(Vertex s, Vertex t, Vertex w, PredecessorMap predecessor_f,
-                 BackPredecessorMap predecessor_b,
-                 std::deque<Vertex> &final_path) {
-  final_path.clear();
-  final_path.push_front(w);
-  // Fill with forward partial result
-  auto cur_f = w;
-  while (cur_f != s) {
-    auto pred_f = predecessor_f[cur_f];
-    assert(pred_f != cur_f); // otherwise cur_f wouldnt be reachable, but if
-                             // cur_f wouldnt be reachable we shouldnt be here.
-    final_path.push_front(pred_f);
-    cur_f = pred_f;
-  }
-
-  auto cur_b = w;
-  while (cur_b != t) {
-    auto pred_b = predecessor_b[cur_b];
-    assert(pred_b != cur_b); // otherwise cur_b wouldnt be reachable, but if
-                             // cur_b wouldnt be reachable we shouldnt be here.
-    final_path.push_back(pred_b);
-    cur_b = pred_b;
-  }
-}
-
-template <typename Vertex, typename Length, typename PredecessorMap,
-          typename BackPredecessorMap>
-void compare_and_update_shortest_path(Seen<Vertex, Length> &seen_f,
-                                      Seen<Vertex, Length> &seen_b,
-                                      PredecessorMap predecessor_f,
-                                      BackPredecessorMap predecessor_b,
-                                      Vertex s, Vertex t, Vertex w,
-                                      Length &final_distance,
-                                      std::deque<Vertex> &final_path) {
-  auto search_w_f = seen_f.find(w);
-  auto search_w_b = seen_b.find(w);
-  if (search_w_f != std::end(seen_f) && search_w_b != std::end(seen_b)) {
-    auto total_distance = search_w_f->second + search_w_b->second;
-    if (final_distance > total_distance) {
-      final_distance = total_distance;
-      // With predecessor map
-      merge_paths(s, t, w, predecessor_f, predecessor_b, final_path);
-    }
-  }
-}
-
-template <typename Graph, typename PredecessorMap, typename DistanceMap,
-          typename WeightMap, typename OtherPredecessorMap,
-          typename OtherDistanceMap, typename BiDijkstraVisitorImpl,
-          typename Vertex = vertex_of_t<Graph>,
-          typename Length = value_of_t<DistanceMap>>
-BiDijkStepRes bi_dijkstra_step(
-    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
-    DistanceMap distance, WeightMap weight, Fringe<Vertex, Length> &fringe,
-    Seen<Vertex, Length> &seen, OtherPredecessorMap other_predecessor,
-    OtherDistanceMap other_distance, Fringe<Vertex, Length> &other_fringe,
-    Seen<Vertex, Length> &other_seen, Direction direction,
-    Length &final_distance, std::deque<Vertex> &final_path,
-    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor) {
+/**
+ * Run one step of bidirectional dijkstra in the direction of @p search: settle
+ * the closest vertex of its fringe and relax its out-edges.
+ *
+ * Instead of materialising a path every time the source-target distance
+ * improves, only the best meeting vertex @p meeting is recorded.
+ *
+ * @param on_settle Callback invoked as <tt>on_settle(v, distance)</tt> when a
+ *        vertex is settled.
+ * @param on_relax Callback invoked as <tt>on_relax(w, v, e)</tt> when edge
+ *        e = (v, w) improves the distance of w.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename BiDijkstraVisitorImpl, typename OnSettle, typename OnRelax,
+          typename Vertex, typename Length, typename Queue>
+BiDijkStepRes
+bi_dijkstra_step(const Graph &G, WeightMap weight, IndexMap index,
+                 BiDijkstraSearch<Vertex, Length, Queue> &search,
+                 BiDijkstraSearch<Vertex, Length, Queue> &other_search,
+                 Length &final_distance, Vertex &meeting,
+                 BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor,
+                 OnSettle &on_settle, OnRelax &on_relax) {
   constexpr Length inf = std::numeric_limits<Length>::max();
+  auto &fringe = search.fringe;
+  auto &other_fringe = other_search.fringe;
+
   // Extract closest node to expand
-  const auto [v, dist] = fringe.top();
+  const auto v_index = fringe.top().key;
+  const auto dist = fringe.top().priority;
   fringe.pop();
-
-  if (distance[v] != inf) {
-    // Shortest path to 'node' already found. Continue.
-    return BiDijkStepRes::next;
-  }
+  auto &v_label = search.labels.at(v_index);
+  const auto v = v_label.vertex;
 
   // Ask the visitor if vertex should be expanded
-  auto lower_bound_v = other_fringe.top().second;
+  assert(!other_fringe.empty());
+  auto lower_bound_v = other_fringe.top().priority;
   if (!visitor.expand_vertex(v, dist, lower_bound_v, final_distance)) {
     return BiDijkStepRes::next;
   }
 
-  // Update distance
-  distance[v] = dist; // Equal to seen[v]
-  if (other_distance[v] != inf) {
+  v_label.settled = true;
+  on_settle(v, dist);
+  if (other_search.labels[v_index].settled) {
     // If we have scanned v in both directions we are done,
     // we have now discovered the shortest path. But the visitor may ask to keep
     // on searching.
-
-    // Check terminating condition:
-    auto min_dist = fringe.top().second;
-    auto other_min_dist = other_fringe.top().second;
+    // Anything pushed later in this direction is at least dist away.
+    auto min_dist = fringe.empty() ? dist : fringe.top().priority;
+    auto other_min_dist = other_fringe.top().priority;
 
     if (visitor.terminating_condition(min_dist, other_min_dist,
                                       final_distance)) {
@@ -229,39 +239,35 @@ BiDijkStepRes bi_dijkstra_step(
     // Planning. Daniele Frigioni and Sebastian Stiller. ATMOS - 13th Workshop
     // on Algorithmic Approaches for Transportation Modelling, Optimizations and
     // Systems - 2013
-    // auto terminating_condition = min_dist + other_min_dist > d_s_t;
   }
 
   // Compute neighbor distances
   for (auto [it, end] = out_edges(v, G); it != end; ++it) {
     using boost::get;
     auto w = target(*it, G);
-    auto min_weight = get(weight, *it);
-    auto vw_length = distance[v] + min_weight;
+    auto w_index = get(index, w);
+    auto vw_length = dist + get(weight, *it);
+    auto &w_label = search.labels.at(w_index);
 
-    if (distance[w] != inf) {
-      if (vw_length < distance[v]) {
-        // Throw some exception "Contradictory paths found: negative weights?"
+    if (w_label.settled) {
+      if (vw_length < dist) {
         return BiDijkStepRes::negative_weights;
       }
-    } else if (auto search_w = seen.find(w);
-               search_w == std::end(seen) || vw_length < search_w->second) {
+    } else if (vw_length < w_label.distance) {
       // Relax v-w edge
-      seen.insert_or_assign(w, vw_length);
-      fringe.push(std::make_pair(w, vw_length));
-
-      // Build new path to w
-      predecessor[w] = v;
+      w_label.distance = vw_length;
+      w_label.vertex = w;
+      w_label.parent = v;
+      fringe.push_or_decrease(w_index, vw_length);
+      prefetch_out_edges(w, G);
+      on_relax(w, v, *it);
 
       // See if this path is better than the already discovered shortests path
-      if (direction == Direction::forward) {
-        compare_and_update_shortest_path(seen, other_seen, predecessor,
-                                         other_predecessor, s, t, w,
-                                         final_distance, final_path);
-      } else {
-        compare_and_update_shortest_path(other_seen, seen, other_predecessor,
-                                         predecessor, s, t, w, final_distance,
-                                         final_path);
+      auto other_w_distance = other_search.labels[w_index].distance;
+      if (other_w_distance != inf &&
+          vw_length + other_w_distance < final_distance) {
+        final_distance = vw_length + other_w_distance;
+        meeting = w;
       }
     }
   }
@@ -269,16 +275,116 @@ BiDijkStepRes bi_dijkstra_step(
   return BiDijkStepRes::next;
 }
 
-template <typename PredecessorMap, typename Vertex>
-void fill_predecessor(PredecessorMap predecessor,
-                      const std::deque<Vertex> &final_path) {
-  if (!final_path.empty()) {
-    for (std::size_t i = 0; i < final_path.size() - 1; ++i) {
-      predecessor[final_path[i + 1]] = final_path[i];
+/**
+ * Choose the direction of the next bidirectional dijkstra step.
+ *
+ * @param policy The direction policy.
+ * @param prev_dir The direction of the previous step.
+ * @param forward_size The size of the forward fringe.
+ * @param backward_size The size of the backward fringe.
+ * @return The direction of the next step.
+ */
+inline Direction next_direction(direction_policy policy, Direction prev_dir,
+                                std::size_t forward_size,
+                                std::size_t backward_size) {
+  if (policy == direction_policy::smaller_frontier) {
+    return (forward_size <= backward_size) ? Direction::forward
+                                           : Direction::backward;
+  }
+  return switch_direction(prev_dir);
+}
+
+/**
+ * Run bidirectional dijkstra from @p s to @p t on the state held by @p forward
+ * and @p backward.
+ *
+ * @throw target_not_found if @p t is not reachable from @p s.
+ * @throw std::domain_error if a negative weight is detected.
+ * @return A pair (meeting vertex, s-t distance).
+ */
+template <typename Graph, typename WeightMap, typename BackGraph,
+          typename BackWeightMap, typename IndexMap,
+          typename BiDijkstraVisitorImpl, typename OnSettle, typename OnRelax,
+          typename OnSettleBack, typename OnRelaxBack, typename Vertex,
+          typename Length, typename Queue>
+std::pair<Vertex, Length> bi_dijkstra_search(
+    const Graph &G, Vertex s, Vertex t, WeightMap weight, const BackGraph &G_b,
+    BackWeightMap weight_b, IndexMap index,
+    BiDijkstraSearch<Vertex, Length, Queue> &forward,
+    BiDijkstraSearch<Vertex, Length, Queue> &backward,
+    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor, direction_policy policy,
+    OnSettle on_settle, OnRelax on_relax, OnSettleBack on_settle_b,
+    OnRelaxBack on_relax_b) {
+  using boost::get;
+  constexpr Length inf = std::numeric_limits<Length>::max();
+
+  forward.reset(num_vertices(G));
+  backward.reset(num_vertices(G));
+  forward.init(s, get(index, s));
+  backward.init(t, get(index, t));
+
+  Length final_distance = (s == t) ? Length{0} : inf;
+  Vertex meeting = s;
+  auto direction = Direction::backward;
+  while (!forward.fringe.empty() && !backward.fringe.empty()) {
+    direction = next_direction(policy, direction, forward.fringe.size(),
+                               backward.fringe.size());
+    auto result = BiDijkStepRes::next;
+
+    // Run a step
+    if (direction == Direction::forward) {
+      result = bi_dijkstra_step(G, weight, index, forward, backward,
+                                final_distance, meeting, visitor, on_settle,
+                                on_relax);
+    } else {
+      result = bi_dijkstra_step(G_b, weight_b, index, backward, forward,
+                                final_distance, meeting, visitor, on_settle_b,
+                                on_relax_b);
     }
+
+    // Handle the outcome of this step
+    if (result == BiDijkStepRes::end) {
+      break;
+    } else if (result == BiDijkStepRes::negative_weights) {
+      throw std::domain_error{"Contradictory paths found: negative weights?"};
+    }
+  }
+
+  if (final_distance == inf) {
+    throw target_not_found{"No path found!"};
+  }
+  return {meeting, final_distance};
+}
+
+/**
+ * Materialise the s-t path through @p meeting into @p predecessor, following
+ * the search trees in @p forward and @p backward.
+ *
+ * @post predecessor[v] is set for each vertex v on the path but @p s.
+ */
+template <typename PredecessorMap, typename IndexMap, typename Vertex,
+          typename Length, typename Queue>
+void fill_predecessor(PredecessorMap predecessor, IndexMap index, Vertex s,
+                      Vertex t, Vertex meeting,
+                      const BiDijkstraSearch<Vertex, Length, Queue> &forward,
+                      const BiDijkstraSearch<Vertex, Length, Queue> &backward) {
+  using boost::get;
+  // Forward half: s ~> meeting
+  for (auto cur = meeting; cur != s;) {
+    auto pred = forward.labels[get(index, cur)].parent;
+    assert(pred != cur);
+    predecessor[cur] = pred;
+    cur = pred;
+  }
+  // Backward half: meeting ~> t
+  for (auto cur = meeting; cur != t;) {
+    auto next = backward.labels[get(index, cur)].parent;
+    assert(next != cur);
+    predecessor[next] = cur;
+    cur = next;
   }
 }
 } // namespace details
 } // namespace arlib
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file bucket_queue.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_BUCKET_QUEUE_HPP
+#define ALTERNATIVE_ROUTING_LIB_BUCKET_QUEUE_HPP
+
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+/**
+ * An indexed monotone bucket queue (Dial's algorithm), for small
+ * non-negative integer priorities.
+ *
+ * Every priority has its own bucket in a cyclic array, so push is O(1) and
+ * pop walks the buckets upward from the last minimum. The array grows to
+ * the next power of two above the spread of the queued priorities, i.e. a
+ * little more than the largest edge weight in a Dijkstra's search: this
+ * queue pays off when weights are small integers, such as seconds or
+ * decimeters on short edges.
+ *
+ * It has the same interface as d_ary_heap. Decrease-key pushes a new entry
+ * and leaves the old one behind, to be dropped when met: an entry is live if
+ * its key is in the queue with the same priority.
+ *
+ * @pre Priorities are never less than the last popped one (e.g. Dijkstra's
+ *      distances, or A* keys with a consistent heuristic), until the queue
+ *      is cleared.
+ *
+ * @tparam Priority An integral priority type, e.g. a distance.
+ */
+template <typename Priority> class bucket_queue {
+  static_assert(std::is_integral_v<Priority>,
+                "A bucket queue needs integral priorities: scale "
+                "floating-point weights to fixed point");
+
+public:
+  using size_type = std::size_t;
+  using key_type = size_type;
+  using priority_type = Priority;
+
+  /**
+   * A queue entry.
+   */
+  struct value_type {
+    Priority priority; /**< The priority of key. */
+    key_type key;      /**< The key. */
+  };
+
+  bucket_queue() = default;
+  /**
+   * Construct a new empty bucket_queue for keys in [0, @p n).
+   *
+   * @param n The number of keys.
+   */
+  explicit bucket_queue(size_type n) : current(n, none) {}
+
+  /**
+   * Resize the key space to [0, @p n) and empty the queue.
+   *
+   * @param n The number of keys.
+   */
+  void resize(size_type n) {
+    clear_buckets();
+    current.resize(n);
+    last = cursor = Priority{0};
+  }
+
+  /**
+   * Empty the queue.
+   */
+  void clear() {
+    clear_buckets();
+    current.clear();
+    last = cursor = Priority{0};
+  }
+
+  bool empty() const { return count == 0; }
+  size_type size() const { return count; }
+
+  /**
+   * @param key A key.
+   * @return true if @p key is in the queue.
+   */
+  bool contains(key_type key) const { return current[key] != none; }
+
+  /**
+   * @pre !empty()
+   * @return The entry with minimum priority.
+   */
+  const value_type &top() const {
+    assert(!empty());
+    normalize();
+    return buckets[slot_of(cursor)].back();
+  }
+
+  /**
+   * Remove the entry with minimum priority.
+   *
+   * @pre !empty()
+   */
+  void pop() {
+    auto const &popped = top();
+    current.at(popped.key) = none;
+    last = popped.priority;
+    buckets[slot_of(cursor)].pop_back();
+    if (--count == 0) {
+      // Only stale entries are left
+      clear_buckets();
+    }
+  }
+
+  /**
+   * Insert @p key with @p priority, or lower its priority to @p priority if
+   * it is already in the queue with a greater one.
+   *
+   * @param key A key.
+   * @param priority The new priority of @p key.
+   * @return true if the queue changed.
+   */
+  bool push_or_decrease(key_type key, Priority priority) {
+    assert(priority >= Priority{0} && priority != none);
+    auto &slot = current.at(key);
+    if (slot != none && !(priority < slot)) {
+      return false;
+    }
+    if (slot == none) {
+      ++count;
+    }
+    assert(!(priority < last) && "bucket_queue priorities must be monotone");
+    slot = priority;
+    auto spread = static_cast<size_type>(priority - last);
+    if (spread >= buckets.size()) {
+      grow(spread);
+    }
+    buckets[slot_of(priority)].push_back(value_type{priority, key});
+    if (priority < cursor) {
+      cursor = priority;
+    }
+    return true;
+  }
+
+private:
+  static constexpr Priority none = std::numeric_limits<Priority>::max();
+
+  size_type slot_of(Priority priority) const {
+    return static_cast<size_type>(priority) & (buckets.size() - 1);
+  }
+
+  bool is_live(value_type const &entry) const {
+    return current[entry.key] == entry.priority;
+  }
+
+  // Move the cursor to the bucket of a live minimum, dropping stale entries.
+  // The cursor never passes a live entry, and pushes below it move it back.
+  void normalize() const {
+    for (;;) {
+      auto &bucket = buckets[slot_of(cursor)];
+      while (!bucket.empty() && !is_live(bucket.back())) {
+        bucket.pop_back();
+      }
+      // Live priorities span less than the array, so this one equals cursor
+      if (!bucket.empty()) {
+        assert(bucket.back().priority == cursor);
+        return;
+      }
+      ++cursor;
+    }
+  }
+
+  // Make room for priorities up to last + spread
+  void grow(size_type spread) {
+    auto size = std::max<size_type>(buckets.size(), 16);
+    while (size <= spread) {
+      size *= 2;
+    }
+    auto old = std::vector<std::vector<value_type>>(size);
+    std::swap(old, buckets);
+    for (auto &bucket : old) {
+      for (auto const &entry : bucket) {
+        if (is_live(entry)) {
+          buckets[slot_of(entry.priority)].push_back(entry);
+        }
+      }
+    }
+  }
+
+  void clear_buckets() {
+    for (auto &bucket : buckets) {
+      bucket.clear();
+    }
+    count = 0;
+  }
+
+  mutable std::vector<std::vector<value_type>> buckets;
+  stamped_vector<Priority> current = stamped_vector<Priority>(0, none);
+  size_type count = 0;
+  Priority last = Priority{0};
+  mutable Priority cursor = Priority{0};
+};
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_BUCKET_QUEUE_HPP
@@ -0,0 +1,175 @@
+/**
+ * @file cch_query_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CCH_QUERY_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_CCH_QUERY_IMPL_HPP
+
+#include <arlib/customizable_contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                       CCH query support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * The state of one direction of a CCH query, indexed by rank. Between
+ * queries every distance is infinite: a query only touches the elimination
+ * tree path of its root, and resets it when done.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct CCHSearch {
+  CCHSearch() = default;
+  explicit CCHSearch(std::size_t n)
+      : distance(n, std::numeric_limits<Length>::max()), parent(n, ch_none),
+        arc(n, ch_none) {}
+
+  void resize(std::size_t n) {
+    if (distance.size() != n) {
+      distance.assign(n, std::numeric_limits<Length>::max());
+      parent.assign(n, ch_none);
+      arc.assign(n, ch_none);
+    }
+  }
+
+  std::vector<Length> distance;
+  std::vector<std::size_t> parent; /**< The rank the search came from. */
+  std::vector<std::size_t> arc;    /**< The arc it came through. */
+};
+
+/**
+ * Relax the upward arcs of every vertex on the elimination tree path from
+ * @p root, in order. Arcs only lead to ancestors, so each vertex is final by
+ * the time it is scanned.
+ */
+template <typename Graph, typename Length>
+void cch_tree_search(cch_metric<Graph, Length> const &metric, std::size_t root,
+                     bool upward, CCHSearch<Length> &search) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto const &cch = metric.topology();
+  search.distance[root] = Length{};
+  for (auto x = root; x != ch_none; x = cch.parent(x)) {
+    auto d_x = search.distance[x];
+    if (d_x == inf) {
+      continue;
+    }
+    auto [first, last] = cch.up_arcs(x);
+    for (auto a = first; a != last; ++a) {
+      auto w = metric.weight(a, upward);
+      auto z = cch.head(a);
+      if (w != inf && d_x + w < search.distance[z]) {
+        search.distance[z] = d_x + w;
+        search.parent[z] = x;
+        search.arc[z] = a;
+      }
+    }
+  }
+}
+
+/**
+ * Reset the labels on the elimination tree path from @p root.
+ */
+template <typename Graph, typename Length>
+void cch_reset(customizable_contraction_hierarchy<Graph> const &cch,
+               std::size_t root, CCHSearch<Length> &search) {
+  for (auto x = root; x != ch_none; x = cch.parent(x)) {
+    search.distance[x] = std::numeric_limits<Length>::max();
+    search.parent[x] = ch_none;
+    search.arc[x] = ch_none;
+  }
+}
+
+/**
+ * Run an elimination tree query from rank @p s to rank @p t, unpack the
+ * shortest path to @p out and reset both searches.
+ *
+ * @throw target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename Length, typename OutputIt>
+Length cch_search(cch_metric<Graph, Length> const &metric, std::size_t s,
+                  std::size_t t, CCHSearch<Length> &forward,
+                  CCHSearch<Length> &backward, OutputIt out) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto const &cch = metric.topology();
+  forward.resize(cch.num_vertices());
+  backward.resize(cch.num_vertices());
+  cch_tree_search(metric, s, true, forward);
+  cch_tree_search(metric, t, false, backward);
+
+  // Both searches only reach common ancestors of s and t
+  auto best = inf;
+  auto meeting = ch_none;
+  for (auto x = s; x != ch_none; x = cch.parent(x)) {
+    auto d = cch_add(forward.distance[x], backward.distance[x]);
+    if (d < best) {
+      best = d;
+      meeting = x;
+    }
+  }
+
+  if (meeting != ch_none) {
+    // Forward arcs are met from the meeting vertex back to s
+    auto forward_arcs = std::vector<std::pair<std::size_t, std::size_t>>{};
+    for (auto v = meeting; forward.parent[v] != ch_none;
+         v = forward.parent[v]) {
+      forward_arcs.emplace_back(forward.parent[v], forward.arc[v]);
+    }
+    for (auto it = forward_arcs.rbegin(); it != forward_arcs.rend(); ++it) {
+      out = metric.unpack(it->first, it->second, true, out);
+    }
+    for (auto v = meeting; backward.parent[v] != ch_none;
+         v = backward.parent[v]) {
+      out = metric.unpack(backward.parent[v], backward.arc[v], false, out);
+    }
+  }
+  cch_reset(cch, s, forward);
+  cch_reset(cch, t, backward);
+
+  if (meeting == ch_none) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << cch.vertex(t) << " is unreachable from "
+        << cch.vertex(s);
+    throw target_not_found{oss.str()};
+  }
+  return best;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CCH_QUERY_IMPL_HPP
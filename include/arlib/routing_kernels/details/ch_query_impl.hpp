@@ -0,0 +1,197 @@
+/**
+ * @file ch_query_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_CH_QUERY_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_CH_QUERY_IMPL_HPP
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                       CH query support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * The label of a vertex reached by a CH search.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct CHLabel {
+  Length distance = std::numeric_limits<Length>::max();
+  std::size_t parent = ch_none; /**< The vertex the search came from. */
+  ch_arc<Length> const *arc = nullptr; /**< The arc it came through. */
+};
+
+/**
+ * The state of one direction of a CH search: a dense array of labels and an
+ * indexed 4-ary heap, both reset in O(1).
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct CHSearch {
+  CHSearch() = default;
+  explicit CHSearch(std::size_t n) : labels(n), fringe(n) {}
+
+  /**
+   * Prepare a search on a hierarchy of @p n vertices rooted at @p root.
+   */
+  void init(std::size_t n, std::size_t root) {
+    if (labels.size() != n) {
+      labels.resize(n);
+      fringe.resize(n);
+    }
+    labels.clear();
+    fringe.clear();
+    labels.at(root).distance = Length{};
+    fringe.push_or_decrease(root, Length{});
+  }
+
+  stamped_vector<CHLabel<Length>> labels;
+  d_ary_heap<Length> fringe;
+};
+
+/**
+ * Settle the next vertex of @p search, relaxing the arcs returned by
+ * @p arcs_of, and update the tentative distance @p best through @p meeting
+ * if @p other reached it too.
+ */
+template <typename Length, typename ArcsOf>
+void ch_step(CHSearch<Length> &search, CHSearch<Length> const &other,
+             ArcsOf arcs_of, Length &best, std::size_t &meeting) {
+  auto [d_u, u] = search.fringe.top();
+  search.fringe.pop();
+
+  if (other.labels.contains(u)) {
+    auto d_other = other.labels[u].distance;
+    if (d_other != std::numeric_limits<Length>::max() &&
+        d_u + d_other < best) {
+      best = d_u + d_other;
+      meeting = u;
+    }
+  }
+
+  auto [first, last] = arcs_of(u);
+  for (; first != last; ++first) {
+    auto v = first->head;
+    auto d_v = d_u + first->weight;
+    if (d_v < search.labels[v].distance) {
+      auto &label = search.labels.at(v);
+      label.distance = d_v;
+      label.parent = u;
+      label.arc = first;
+      search.fringe.push_or_decrease(v, d_v);
+    }
+  }
+}
+
+/**
+ * Run a bidirectional CH search: the forward search from @p s only follows
+ * upward arcs, the backward search from @p t only downward arcs. A direction
+ * stops once its minimum key reaches the best distance found.
+ *
+ * @throw target_not_found if @p t is not reachable from @p s.
+ * @return The meeting vertex and the distance from @p s to @p t.
+ */
+template <typename Graph, typename Length>
+std::pair<std::size_t, Length>
+ch_search(contraction_hierarchy<Graph, Length> const &ch, std::size_t s,
+          std::size_t t, CHSearch<Length> &forward,
+          CHSearch<Length> &backward) {
+  auto n = ch.num_vertices();
+  forward.init(n, s);
+  backward.init(n, t);
+
+  auto best = std::numeric_limits<Length>::max();
+  auto meeting = ch_none;
+  auto up = [&ch](std::size_t v) { return ch.up_arcs(v); };
+  auto down = [&ch](std::size_t v) { return ch.down_arcs(v); };
+  auto done = [&best](CHSearch<Length> const &search) {
+    return search.fringe.empty() || search.fringe.top().priority >= best;
+  };
+
+  bool forward_turn = true;
+  while (!done(forward) || !done(backward)) {
+    if ((forward_turn && !done(forward)) || done(backward)) {
+      ch_step(forward, backward, up, best, meeting);
+    } else {
+      ch_step(backward, forward, down, best, meeting);
+    }
+    forward_turn = !forward_turn;
+  }
+
+  if (meeting == ch_none) {
+    auto oss = std::ostringstream{};
+    oss << "Vertex " << t << " is unreachable from " << s;
+    throw target_not_found{oss.str()};
+  }
+  return {meeting, best};
+}
+
+/**
+ * Unpack the path found by ch_search() into the edges of the original graph.
+ */
+template <typename Graph, typename Length, typename OutputIt>
+OutputIt ch_unpack_path(contraction_hierarchy<Graph, Length> const &ch,
+                        std::size_t meeting, CHSearch<Length> const &forward,
+                        CHSearch<Length> const &backward, OutputIt out) {
+  // Forward arcs, as (tail, head) pairs, are met from the meeting vertex back
+  // to s
+  auto forward_arcs = std::vector<std::pair<std::size_t, std::size_t>>{};
+  for (auto v = meeting; forward.labels[v].parent != ch_none;
+       v = forward.labels[v].parent) {
+    forward_arcs.emplace_back(forward.labels[v].parent, v);
+  }
+  for (auto it = forward_arcs.rbegin(); it != forward_arcs.rend(); ++it) {
+    out = ch.unpack(it->first, it->second, *forward.labels[it->second].arc,
+                    out);
+  }
+
+  for (auto v = meeting; backward.labels[v].parent != ch_none;
+       v = backward.labels[v].parent) {
+    out = ch.unpack(v, backward.labels[v].parent, *backward.labels[v].arc,
+                    out);
+  }
+  return out;
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_CH_QUERY_IMPL_HPP
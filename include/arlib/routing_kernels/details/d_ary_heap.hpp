@@ -0,0 +1,207 @@
+/**
+ * @file d_ary_heap.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_D_ARY_HEAP_HPP
+#define ALTERNATIVE_ROUTING_LIB_D_ARY_HEAP_HPP
+
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+/**
+ * An indexed min-heap of @c Arity children per node supporting decrease-key.
+ *
+ * Keys are integers in the range [0, n), i.e. vertex indices. The position of
+ * each key in the heap is tracked in a stamped_vector, so a key is never
+ * stored twice and clear() is O(1). Compared to a lazy-deletion
+ * std::priority_queue, the heap holds at most one entry per vertex and its
+ * top() is always a live entry.
+ *
+ * @tparam Priority The priority type, e.g. a distance.
+ * @tparam Arity The number of children of each heap node.
+ */
+template <typename Priority, std::size_t Arity = 4> class d_ary_heap {
+  static_assert(Arity >= 2, "A d-ary heap needs at least two children");
+
+public:
+  using size_type = std::size_t;
+  using key_type = size_type;
+  using priority_type = Priority;
+
+  /**
+   * A heap entry.
+   */
+  struct value_type {
+    Priority priority; /**< The priority of key. */
+    key_type key;      /**< The key. */
+  };
+
+  d_ary_heap() = default;
+  /**
+   * Construct a new empty d_ary_heap for keys in [0, @p n).
+   *
+   * @param n The number of keys.
+   */
+  explicit d_ary_heap(size_type n) : position(n, npos) {}
+
+  /**
+   * Resize the key space to [0, @p n) and empty the heap.
+   *
+   * @param n The number of keys.
+   */
+  void resize(size_type n) {
+    heap.clear();
+    position.resize(n);
+  }
+
+  /**
+   * Empty the heap in O(1) amortized time.
+   */
+  void clear() {
+    heap.clear();
+    position.clear();
+  }
+
+  bool empty() const { return heap.empty(); }
+  size_type size() const { return heap.size(); }
+
+  /**
+   * @param key A key.
+   * @return true if @p key is in the heap.
+   */
+  bool contains(key_type key) const { return position[key] != npos; }
+
+  /**
+   * @pre !empty()
+   * @return The entry with minimum priority.
+   */
+  const value_type &top() const {
+    assert(!empty());
+    return heap.front();
+  }
+
+  /**
+   * Remove the entry with minimum priority.
+   *
+   * @pre !empty()
+   */
+  void pop() {
+    assert(!empty());
+    position.at(heap.front().key) = npos;
+    if (heap.size() > 1) {
+      heap.front() = heap.back();
+      heap.pop_back();
+      sift_down(0);
+    } else {
+      heap.pop_back();
+    }
+  }
+
+  /**
+   * Insert @p key with @p priority, or lower its priority to @p priority if
+   * it is already in the heap with a greater one.
+   *
+   * @param key A key.
+   * @param priority The new priority of @p key.
+   * @return true if the heap changed.
+   */
+  bool push_or_decrease(key_type key, Priority priority) {
+    auto pos = position[key];
+    if (pos == npos) {
+      heap.push_back(value_type{priority, key});
+      sift_up(heap.size() - 1);
+      return true;
+    }
+    if (priority < heap[pos].priority) {
+      heap[pos].priority = priority;
+      sift_up(pos);
+      return true;
+    }
+    return false;
+  }
+
+private:
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  void place(size_type pos, value_type const &elem) {
+    heap[pos] = elem;
+    position.at(elem.key) = pos;
+  }
+
+  void sift_up(size_type pos) {
+    auto elem = heap[pos];
+    while (pos > 0) {
+      auto parent = (pos - 1) / Arity;
+      if (!(elem.priority < heap[parent].priority)) {
+        break;
+      }
+      place(pos, heap[parent]);
+      pos = parent;
+    }
+    place(pos, elem);
+  }
+
+  void sift_down(size_type pos) {
+    auto elem = heap[pos];
+    auto const n = heap.size();
+    for (;;) {
+      auto first_child = pos * Arity + 1;
+      if (first_child >= n) {
+        break;
+      }
+      auto last_child = std::min(first_child + Arity, n);
+      auto best = first_child;
+      for (auto c = first_child + 1; c < last_child; ++c) {
+        if (heap[c].priority < heap[best].priority) {
+          best = c;
+        }
+      }
+      if (!(heap[best].priority < elem.priority)) {
+        break;
+      }
+      place(pos, heap[best]);
+      pos = best;
+    }
+    place(pos, elem);
+  }
+
+  std::vector<value_type> heap;
+  stamped_vector<size_type> position = stamped_vector<size_type>(0, npos);
+};
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_D_ARY_HEAP_HPP
@@ -0,0 +1,266 @@
+/**
+ * @file delta_stepping_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+/**
+ * Implementation details of arlib
+ */
+namespace details {
+//===----------------------------------------------------------------------===//
+//                      Delta-stepping support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * A tentative distance for the vertex index @c vertex, sent to the thread
+ * owning it.
+ */
+template <typename Length> struct delta_request {
+  std::size_t vertex;
+  Length distance;
+};
+
+/**
+ * The state of one thread of a Delta-stepping search.
+ *
+ * Vertex index @c v is owned by thread `v % num_threads`: only its owner
+ * writes its distance and keeps it in its buckets, so that no distance is
+ * ever written concurrently. The other threads send it requests through
+ * their outbox.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct delta_worker {
+  /**
+   * Cyclic array of buckets, the vertex indices with a tentative distance in
+   * `[i * delta, (i + 1) * delta)` are in `buckets[i % buckets.size()]`.
+   * Entries whose distance moved to another bucket are skipped when popped.
+   */
+  std::vector<std::vector<std::size_t>> buckets;
+  /**
+   * The entries of the current bucket being scanned.
+   */
+  std::vector<std::size_t> current;
+  /**
+   * The vertices removed from the current bucket, whose heavy edges are
+   * relaxed once the bucket is empty.
+   */
+  std::vector<std::size_t> settled;
+  /**
+   * `outbox[j]` holds the requests for the vertices owned by thread @c j.
+   */
+  std::vector<std::vector<delta_request<Length>>> outbox;
+  /**
+   * The largest edge weight and the sum of weights seen by this thread.
+   */
+  Length max_weight = Length{};
+  double total_weight = 0;
+  std::size_t num_edges = 0;
+};
+
+/**
+ * Compute the distances from the vertex index @p root to every vertex of
+ * @p G with Delta-stepping, on all the threads of @p pool.
+ *
+ * Edges of weight at most @p delta are light and relaxed repeatedly while
+ * the current bucket refills, heavy edges once per settled vertex. Each
+ * phase is one thread_pool::run(): threads scan the vertices they own in
+ * the current bucket and emit requests, then apply the requests sent to
+ * them, filling their own buckets.
+ *
+ * @param vertex The vertex of each vertex index.
+ * @param delta The bucket width. If not positive, the mean edge weight is
+ *        used.
+ * @param distance Receives the distance of each vertex index, the maximum
+ *        `Length` if unreachable.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex, typename Length>
+void delta_stepping_search(const Graph &G, WeightMap weight, IndexMap index,
+                           std::vector<Vertex> const &vertex, std::size_t root,
+                           Length delta, thread_pool &pool,
+                           std::vector<Length> &distance) {
+  using namespace boost;
+  constexpr auto inf = std::numeric_limits<Length>::max();
+
+  auto n = vertex.size();
+  auto num_threads = pool.size();
+  auto workers = std::vector<delta_worker<Length>>(num_threads);
+  distance.assign(n, inf);
+  if (root >= n) {
+    return;
+  }
+
+  // Edge weight statistics, to size the buckets
+  pool.run([&](unsigned id) {
+    auto &self = workers[id];
+    for (auto v = std::size_t{id}; v < n; v += num_threads) {
+      for (auto [it, end] = out_edges(vertex[v], G); it != end; ++it) {
+        auto w = get(weight, *it);
+        self.max_weight = std::max(self.max_weight, w);
+        self.total_weight += static_cast<double>(w);
+        ++self.num_edges;
+      }
+    }
+  });
+  auto max_weight = Length{};
+  auto total_weight = 0.0;
+  auto num_edges = std::size_t{0};
+  for (auto const &worker : workers) {
+    max_weight = std::max(max_weight, worker.max_weight);
+    total_weight += worker.total_weight;
+    num_edges += worker.num_edges;
+  }
+  if (!(delta > Length{})) {
+    delta = num_edges == 0
+                ? Length{}
+                : static_cast<Length>(total_weight /
+                                      static_cast<double>(num_edges));
+    if (!(delta > Length{})) {
+      delta = Length{1};
+    }
+  }
+  auto bucket_of = [delta](Length d) {
+    return static_cast<std::size_t>(d / delta);
+  };
+  // A relaxation reaches at most max_weight past the current bucket
+  auto num_buckets = bucket_of(max_weight) + 2;
+  for (auto &worker : workers) {
+    worker.buckets.resize(num_buckets);
+    worker.outbox.resize(num_threads);
+  }
+
+  auto owner = [num_threads](std::size_t v) { return v % num_threads; };
+  auto in_settled = std::vector<char>(n, 0);
+  auto current_bucket = std::size_t{0};
+
+  // Emit requests for the edges of u accepted by is_relaxed
+  auto relax = [&](delta_worker<Length> &self, std::size_t u,
+                   auto is_relaxed) {
+    auto d_u = distance[u];
+    for (auto [it, end] = out_edges(vertex[u], G); it != end; ++it) {
+      auto w = get(weight, *it);
+      if (!is_relaxed(w)) {
+        continue;
+      }
+      auto v = get(index, target(*it, G));
+      auto d_v = d_u + w;
+      if (d_v < distance[v]) {
+        self.outbox[owner(v)].push_back({v, d_v});
+      }
+    }
+  };
+  // Apply the requests sent to thread id
+  auto apply = [&](unsigned id) {
+    auto &self = workers[id];
+    for (auto &sender : workers) {
+      auto &requests = sender.outbox[id];
+      for (auto const &request : requests) {
+        if (request.distance < distance[request.vertex]) {
+          distance[request.vertex] = request.distance;
+          self.buckets[bucket_of(request.distance) % num_buckets].push_back(
+              request.vertex);
+        }
+      }
+      requests.clear();
+    }
+  };
+  auto bucket_empty = [&](std::size_t i) {
+    return std::all_of(workers.begin(), workers.end(), [&](auto const &w) {
+      return w.buckets[i % num_buckets].empty();
+    });
+  };
+
+  distance[root] = Length{};
+  workers[owner(root)].buckets[0].push_back(root);
+  for (;;) {
+    // Light edges, until the current bucket stops refilling
+    while (!bucket_empty(current_bucket)) {
+      pool.run([&](unsigned id) {
+        auto &self = workers[id];
+        self.current.clear();
+        std::swap(self.current,
+                  self.buckets[current_bucket % num_buckets]);
+        for (auto u : self.current) {
+          if (bucket_of(distance[u]) != current_bucket) {
+            continue; // Stale entry
+          }
+          if (!in_settled[u]) {
+            in_settled[u] = 1;
+            self.settled.push_back(u);
+          }
+          relax(self, u, [delta](Length w) { return w <= delta; });
+        }
+      });
+      pool.run(apply);
+    }
+
+    // Heavy edges, once per settled vertex
+    pool.run([&](unsigned id) {
+      auto &self = workers[id];
+      for (auto u : self.settled) {
+        in_settled[u] = 0;
+        relax(self, u, [delta](Length w) { return w > delta; });
+      }
+      self.settled.clear();
+    });
+    pool.run(apply);
+
+    // Every pending entry is at most num_buckets - 1 buckets ahead
+    auto step = std::size_t{1};
+    while (step < num_buckets && bucket_empty(current_bucket + step)) {
+      ++step;
+    }
+    if (step == num_buckets) {
+      return;
+    }
+    current_bucket += step;
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_DELTA_STEPPING_IMPL_HPP
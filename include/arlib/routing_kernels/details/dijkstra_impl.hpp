@@ -0,0 +1,176 @@
+/**
+ * @file dijkstra_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_DIJKSTRA_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_DIJKSTRA_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/details/prefetch.hpp>
+#include <arlib/routing_kernels/details/vector_relax.hpp>
+
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                     Point-to-point search routines
+//===----------------------------------------------------------------------===//
+/**
+ * A zero potential, turning a goal-directed search into Dijkstra's.
+ */
+struct zero_potential {
+  template <typename Vertex> int operator()(Vertex const &) const { return 0; }
+};
+
+/**
+ * Search from @p s until @p t is settled, keying each vertex by its distance
+ * plus `potential(v)`, on the state held by @p search.
+ *
+ * With a zero potential this is Dijkstra's algorithm, and A* with a
+ * consistent heuristic: no settled vertex is ever improved, so each vertex
+ * is scanned once and the queue keys never decrease. Vertices of infinite
+ * potential cannot reach @p t and are never queued. The out-edges of a
+ * road_graph are relaxed in batches by relax_out_arcs().
+ *
+ * @param on_relax Callback invoked as <tt>on_relax(w, v, e)</tt> when edge
+ *        e = (v, w) improves the distance of w.
+ * @param radius The greatest key to settle: with a consistent potential, the
+ *        search gives up once no path from @p s to @p t within @p radius is
+ *        left.
+ * @throw target_not_found if @p t is not reachable from @p s within
+ *        @p radius.
+ * @throw std::domain_error if a negative weight is detected.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Potential, typename OnRelax, typename Vertex,
+          typename Length, typename Queue>
+Length point_to_point_search(
+    const Graph &G, Vertex s, Vertex t, WeightMap weight, IndexMap index,
+    Potential const &potential,
+    BiDijkstraSearch<Vertex, Length, Queue> &search, OnRelax on_relax,
+    Length radius = std::numeric_limits<Length>::max()) {
+  using boost::get;
+  using Label = BiDijkstraLabel<Vertex, Length>;
+
+  search.reset(num_vertices(G));
+  auto s_index = get(index, s);
+  search.labels.at(s_index) = Label{Length{0}, s, s, false};
+  search.fringe.push_or_decrease(s_index,
+                                 static_cast<Length>(potential(s)));
+
+  auto &fringe = search.fringe;
+  while (!fringe.empty() && fringe.top().priority <= radius) {
+    auto v_index = fringe.top().key;
+    fringe.pop();
+    auto &v_label = search.labels.at(v_index);
+    v_label.settled = true;
+    auto v = v_label.vertex;
+    auto dist = v_label.distance;
+    if (v == t) {
+      return dist;
+    }
+
+    if constexpr (has_packed_arcs_v<Graph, WeightMap, IndexMap>) {
+      relax_out_arcs(G, v, dist, potential, search, on_relax);
+    } else {
+      for (auto [it, end] = out_edges(v, G); it != end; ++it) {
+        auto w = target(*it, G);
+        auto w_index = get(index, w);
+        auto vw_length = dist + get(weight, *it);
+        if (vw_length < dist) {
+          throw std::domain_error{"Negative weight on edge"};
+        }
+        auto w_potential = potential(w);
+        if (w_potential ==
+            std::numeric_limits<decltype(w_potential)>::max()) {
+          // t is not reachable from w
+          continue;
+        }
+        auto &w_label = search.labels.at(w_index);
+        if (!w_label.settled && vw_length < w_label.distance) {
+          w_label = Label{vw_length, w, v, false};
+          fringe.push_or_decrease(
+              w_index, static_cast<Length>(vw_length + w_potential));
+          prefetch_out_edges(w, G);
+          on_relax(w, v, *it);
+        }
+      }
+    }
+  }
+  throw target_not_found{"No path found!"};
+}
+
+/**
+ * @see point_to_point_search(const Graph &G, Vertex s, Vertex t,
+ *                            WeightMap weight, IndexMap index,
+ *                            Potential const &potential,
+ *                            BiDijkstraSearch<Vertex, Length, Queue> &search,
+ *                            OnRelax on_relax)
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Potential, typename Vertex, typename Length, typename Queue>
+Length point_to_point_search(const Graph &G, Vertex s, Vertex t,
+                             WeightMap weight, IndexMap index,
+                             Potential const &potential,
+                             BiDijkstraSearch<Vertex, Length, Queue> &search) {
+  return point_to_point_search(G, s, t, weight, index, potential, search,
+                               bi_dijkstra_no_op{});
+}
+
+/**
+ * Write the s-t path found by point_to_point_search() into @p predecessor.
+ *
+ * @post predecessor[v] is set for each vertex v on the path, @p s included.
+ */
+template <typename PredecessorMap, typename IndexMap, typename Vertex,
+          typename Length, typename Queue>
+void fill_predecessor(PredecessorMap predecessor, IndexMap index, Vertex s,
+                      Vertex t,
+                      const BiDijkstraSearch<Vertex, Length, Queue> &search) {
+  using boost::get;
+  predecessor[s] = s;
+  for (auto cur = t; cur != s;) {
+    auto pred = search.labels[get(index, cur)].parent;
+    assert(pred != cur);
+    predecessor[cur] = pred;
+    cur = pred;
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_DIJKSTRA_IMPL_HPP
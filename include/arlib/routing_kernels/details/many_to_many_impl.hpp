@@ -0,0 +1,229 @@
+/**
+ * @file many_to_many_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_IMPL_HPP
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                     Many-to-many support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * An entry of the bucket of a vertex v: v reaches @c target at distance
+ * @c distance.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct bucket_entry {
+  std::size_t target; /**< The position of the target in the target list. */
+  Length distance;    /**< The distance from v to the target. */
+};
+
+/**
+ * The buckets of all vertices, filled by the backward searches and then
+ * grouped by vertex for the forward ones.
+ *
+ * Only the vertices settled by the backward searches have a bucket, so the
+ * index can be filled and emptied again in time proportional to their
+ * number, and reused by any number of computations on the same graph.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class bucket_index {
+public:
+  using Entry = bucket_entry<Length>;
+
+  /**
+   * Record that vertex index @p v reaches target @p target at @p distance.
+   */
+  void add(std::size_t v, std::size_t target, Length distance) {
+    pending.emplace_back(v, Entry{target, distance});
+  }
+
+  /**
+   * Group the recorded entries by vertex, for vertex indices in [0, @p n),
+   * forgetting those of the previous computation.
+   */
+  void finalize(std::size_t n) {
+    ranges.resize(n);
+    std::sort(pending.begin(), pending.end(),
+              [](auto const &x, auto const &y) { return x.first < y.first; });
+    entries.clear();
+    for (auto const &[v, entry] : pending) {
+      auto &range = ranges.at(v);
+      if (range.first == range.second) {
+        range.first = entries.size();
+      }
+      entries.push_back(entry);
+      range.second = entries.size();
+    }
+    pending.clear();
+  }
+
+  /**
+   * @return The bucket of vertex index @p v.
+   */
+  std::pair<Entry const *, Entry const *> operator[](std::size_t v) const {
+    auto [first, last] = ranges[v];
+    return {entries.data() + first, entries.data() + last};
+  }
+
+private:
+  std::vector<std::pair<std::size_t, Entry>> pending;
+  stamped_vector<std::pair<std::size_t, std::size_t>> ranges;
+  std::vector<Entry> entries;
+};
+
+/**
+ * The state of one Dijkstra's search of a many-to-many computation, reset in
+ * O(1) between searches.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct BucketSearch {
+  explicit BucketSearch(std::size_t n)
+      : distance(n, std::numeric_limits<Length>::max()), fringe(n) {}
+
+  stamped_vector<Length> distance;
+  d_ary_heap<Length> fringe;
+};
+
+/**
+ * @return The index of each vertex of @p vs.
+ */
+template <typename Vertex, typename IndexMap>
+std::vector<std::size_t> vertex_indices(std::vector<Vertex> const &vs,
+                                        IndexMap const &index) {
+  auto result = std::vector<std::size_t>{};
+  result.reserve(vs.size());
+  for (auto const &v : vs) {
+    result.push_back(get(index, v));
+  }
+  return result;
+}
+
+/**
+ * Run a Dijkstra's search from vertex index @p root, settling vertices up to
+ * distance @p radius.
+ *
+ * @param arcs_of Called as <tt>arcs_of(u, relax)</tt>, it must call
+ *        <tt>relax(v, w)</tt> for every arc from @c u to @c v of weight @c w.
+ * @param on_settle Called as <tt>on_settle(v, distance)</tt> for every
+ *        settled vertex index.
+ */
+template <typename Length, typename ArcsOf, typename OnSettle>
+void bucket_search(BucketSearch<Length> &search, std::size_t root,
+                   Length radius, ArcsOf &arcs_of, OnSettle &&on_settle) {
+  auto &distance = search.distance;
+  auto &fringe = search.fringe;
+  distance.clear();
+  fringe.clear();
+  distance.at(root) = Length{};
+  fringe.push_or_decrease(root, Length{});
+
+  while (!fringe.empty()) {
+    auto [d_u, u] = fringe.top();
+    if (d_u > radius) {
+      break;
+    }
+    fringe.pop();
+    on_settle(u, d_u);
+    arcs_of(u, [&, d_u = d_u](std::size_t v, Length w) {
+      auto d_v = d_u + w;
+      if (d_v < distance[v]) {
+        distance.at(v) = d_v;
+        fringe.push_or_decrease(v, d_v);
+      }
+    });
+  }
+}
+
+/**
+ * Compute the distances from every source to every target with buckets:
+ * a backward search from each target leaves (target, distance) in the
+ * bucket of each vertex it settles, then a forward search from each source
+ * scans the buckets of the vertices it settles.
+ *
+ * @param n The number of vertices.
+ * @param sources The vertex indices of the sources.
+ * @param targets The vertex indices of the targets.
+ * @param forward_arcs The arcs_of callback of the forward searches.
+ * @param backward_arcs The arcs_of callback of the backward searches.
+ * @param radius The searches settle vertices up to this distance only, and
+ *        farther pairs are left unreachable.
+ * @param table A distance_table of @p sources x @p targets to relax.
+ * @param search The state of the searches, for @p n vertices.
+ * @param buckets The buckets to fill.
+ */
+template <typename Length, typename ForwardArcs, typename BackwardArcs,
+          typename Table>
+void bucket_many_to_many(std::size_t n,
+                         std::vector<std::size_t> const &sources,
+                         std::vector<std::size_t> const &targets,
+                         ForwardArcs forward_arcs, BackwardArcs backward_arcs,
+                         Length radius, Table &table,
+                         BucketSearch<Length> &search,
+                         bucket_index<Length> &buckets) {
+  for (std::size_t j = 0; j < targets.size(); ++j) {
+    bucket_search(search, targets[j], radius, backward_arcs,
+                  [&buckets, j](std::size_t v, Length d) {
+                    buckets.add(v, j, d);
+                  });
+  }
+  buckets.finalize(n);
+
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    bucket_search(search, sources[i], radius, forward_arcs,
+                  [&buckets, &table, i, radius](std::size_t v, Length d) {
+                    auto [first, last] = buckets[v];
+                    for (; first != last; ++first) {
+                      if (first->distance <= radius - d) {
+                        table.relax(i, first->target, d + first->distance, v);
+                      }
+                    }
+                  });
+  }
+}
+
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_IMPL_HPP
@@ -0,0 +1,157 @@
+/**
+ * @file multi_source_dijkstra_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                  Multi-source Dijkstra support classes
+//===----------------------------------------------------------------------===//
+
+/**
+ * @param bytes The size of a distance_lanes.
+ * @return The alignment of a distance_lanes of @p bytes: the smallest power
+ *         of two not less than @p bytes, up to a cache line.
+ */
+constexpr std::size_t lanes_alignment(std::size_t bytes) {
+  auto alignment = std::size_t{1};
+  while (alignment < bytes && alignment < 64) {
+    alignment *= 2;
+  }
+  return alignment;
+}
+
+/**
+ * The tentative distances of one vertex from each of the @p Lanes sources of
+ * a multi-source search. Lanes are contiguous and aligned so that
+ * relax_lanes() compiles to a handful of vector instructions.
+ *
+ * @tparam Length The edge weight type.
+ * @tparam Lanes The number of sources searched at once.
+ */
+template <typename Length, std::size_t Lanes>
+struct alignas(lanes_alignment(sizeof(Length) * Lanes)) distance_lanes {
+  Length lane[Lanes];
+};
+
+/**
+ * Relax the edge (u, v) of weight @p w in every lane at once:
+ * <tt>to[l] = min(to[l], from[l] + w)</tt>. Infinite distances stay
+ * infinite.
+ *
+ * Both loops have no early exit and only take minima, so compilers turn them
+ * into vector adds, compares and blends; the improvements are reduced in a
+ * second loop because a conditional reduction blocks vectorization.
+ *
+ * @return The smallest improved distance, or the maximum `Length` if no lane
+ *         improved.
+ */
+template <typename Length, std::size_t Lanes>
+Length relax_lanes(distance_lanes<Length, Lanes> &to,
+                   distance_lanes<Length, Lanes> const &from, Length w) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  // min(d, inf - w) + w saturates at inf without branching
+  auto limit = inf - w;
+  Length improved[Lanes];
+  for (std::size_t l = 0; l < Lanes; ++l) {
+    auto candidate = (from.lane[l] < limit ? from.lane[l] : limit) + w;
+    auto current = to.lane[l];
+    improved[l] = candidate < current ? candidate : inf;
+    to.lane[l] = candidate < current ? candidate : current;
+  }
+  auto best = inf;
+  for (std::size_t l = 0; l < Lanes; ++l)
+    best = improved[l] < best ? improved[l] : best;
+  return best;
+}
+
+/**
+ * Run up to @p Lanes Dijkstra's searches at once, from the vertex indices in
+ * `[first, last)`.
+ *
+ * A vertex is queued with the smallest of its distances that improved, and
+ * scanning it relaxes its out-edges in all lanes. A vertex may be scanned
+ * more than once, when a lane improves after it was scanned for another;
+ * searches from nearby sources mostly settle vertices together, and the
+ * adjacency of each vertex is read once for all of them.
+ *
+ * @param vertex The vertex of each vertex index.
+ * @param distance The lanes of each vertex index, overwritten.
+ * @param fringe An empty heap on vertex indices.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Length, std::size_t Lanes, typename Vertex>
+void multi_source_search(const Graph &G, WeightMap const &weight,
+                         IndexMap const &index,
+                         std::vector<Vertex> const &vertex,
+                         std::size_t const *first, std::size_t const *last,
+                         std::vector<distance_lanes<Length, Lanes>> &distance,
+                         d_ary_heap<Length> &fringe) {
+  using namespace boost;
+  auto unreached = distance_lanes<Length, Lanes>{};
+  std::fill(std::begin(unreached.lane), std::end(unreached.lane),
+            std::numeric_limits<Length>::max());
+  std::fill(distance.begin(), distance.end(), unreached);
+
+  for (std::size_t l = 0; first + l != last; ++l) {
+    distance[first[l]].lane[l] = Length{};
+    fringe.push_or_decrease(first[l], Length{});
+  }
+
+  while (!fringe.empty()) {
+    auto u = fringe.top().key;
+    fringe.pop();
+    auto const &d_u = distance[u];
+    for (auto [it, end] = out_edges(vertex[u], G); it != end; ++it) {
+      auto v = get(index, target(*it, G));
+      auto best = relax_lanes(distance[v], d_u,
+                              static_cast<Length>(get(weight, *it)));
+      if (best != std::numeric_limits<Length>::max()) {
+        fringe.push_or_decrease(v, best);
+      }
+    }
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_IMPL_HPP
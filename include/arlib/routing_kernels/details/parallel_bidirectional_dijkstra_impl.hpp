@@ -0,0 +1,391 @@
+/**
+ * @file parallel_bidirectional_dijkstra_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_IMPL_HPP
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/prefetch.hpp>
+#include <arlib/routing_kernels/visitor.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                 Parallel Bidirectional Dijkstra types
+//===----------------------------------------------------------------------===//
+
+/**
+ * The state of one direction of parallel bidirectional dijkstra.
+ *
+ * Tentative distances, settled flags and the minimum key of the fringe are
+ * atomics, because the thread running the opposite direction reads them.
+ * Everything else is only touched by the thread owning this direction.
+ *
+ * @tparam Vertex A vertex_descriptor.
+ * @tparam Length The weight value type.
+ * @tparam Queue The fringe type, with the interface of d_ary_heap.
+ */
+template <typename Vertex, typename Length,
+          typename Queue = d_ary_heap<Length>>
+class ParallelBiDijkstraSearch {
+public:
+  static constexpr Length inf = std::numeric_limits<Length>::max();
+
+  /**
+   * Construct a new ParallelBiDijkstraSearch for a graph of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit ParallelBiDijkstraSearch(std::size_t n)
+      : distance(n), settled(n), vertex(n), parent(n), fringe(n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      distance[i].store(inf, std::memory_order_relaxed);
+      settled[i].store(false, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Make @p root the only vertex in the fringe, at distance 0.
+   *
+   * @param root The root vertex.
+   * @param root_index The index of @p root.
+   */
+  void init(Vertex root, std::size_t root_index) {
+    distance[root_index].store(Length{0});
+    vertex[root_index] = root;
+    parent[root_index] = root;
+    fringe.push_or_decrease(root_index, Length{0});
+    min_distance.store(Length{0});
+  }
+
+  /**
+   * Publish the minimum key of the fringe to the opposite direction.
+   */
+  void publish_min_distance() {
+    min_distance.store(fringe.empty() ? inf : fringe.top().priority);
+  }
+
+  std::vector<std::atomic<Length>> distance; /**< Tentative distances. */
+  std::vector<std::atomic<bool>> settled;    /**< Settled flags. */
+  std::vector<Vertex> vertex;                /**< Vertex of each index. */
+  std::vector<Vertex> parent;                /**< Search tree. */
+  Queue fringe;                              /**< The fringe. */
+  /**
+   * A lower bound on the distance of any vertex still to be settled. It is
+   * published only after the out-edges of the last settled vertex have been
+   * relaxed.
+   */
+  std::atomic<Length> min_distance{inf};
+};
+
+/**
+ * The state shared by the two threads of parallel bidirectional dijkstra: the
+ * best source-target distance found so far, its meeting vertex, the stop flag
+ * and the first error raised by either thread.
+ *
+ * @tparam Vertex A vertex_descriptor.
+ * @tparam Length The weight value type.
+ */
+template <typename Vertex, typename Length> class ParallelBiDijkstraShared {
+public:
+  static constexpr Length inf = std::numeric_limits<Length>::max();
+
+  explicit ParallelBiDijkstraShared(Vertex meeting) : meeting{meeting} {}
+
+  /**
+   * Record a source-target path of length @p length through @p v, if it is
+   * shorter than the best one.
+   */
+  void update(Length length, Vertex v) {
+    if (length < distance.load()) {
+      auto lock = std::lock_guard<std::mutex>{mutex};
+      if (length < distance.load()) {
+        distance.store(length);
+        meeting = v;
+      }
+    }
+  }
+
+  /**
+   * Stop both threads because of @p error.
+   */
+  void fail(std::exception_ptr error) {
+    {
+      auto lock = std::lock_guard<std::mutex>{mutex};
+      if (!this->error) {
+        this->error = error;
+      }
+    }
+    stop.store(true);
+  }
+
+  std::atomic<Length> distance{inf}; /**< Best source-target distance. */
+  std::atomic<bool> stop{false};     /**< Whether both threads must stop. */
+  Vertex meeting;                    /**< Meeting vertex of the best path. */
+  std::exception_ptr error;          /**< First error raised, if any. */
+  std::mutex mutex;                  /**< Guards meeting and error. */
+  std::mutex visitor_mutex;          /**< Serializes visitor calls. */
+};
+
+//===----------------------------------------------------------------------===//
+//                Parallel Bidirectional Dijkstra routines
+//===----------------------------------------------------------------------===//
+
+/**
+ * Invoke @p fn on @p visitor, holding the visitor mutex of @p shared unless
+ * the visitor is stateless.
+ */
+template <typename BiDijkstraVisitorImpl, typename Vertex, typename Length,
+          typename Fn>
+bool call_visitor(BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor,
+                  ParallelBiDijkstraShared<Vertex, Length> &shared, Fn fn) {
+  if constexpr (std::is_same_v<BiDijkstraVisitorImpl,
+                               IdentityBiDijkstraVisitor>) {
+    return fn(visitor);
+  } else {
+    auto lock = std::lock_guard<std::mutex>{shared.visitor_mutex};
+    return fn(visitor);
+  }
+}
+
+/**
+ * Run one direction of parallel bidirectional dijkstra until either direction
+ * asks to stop.
+ *
+ * A thread stops when its own fringe is exhausted, or when it settles a vertex
+ * already settled by the opposite thread and the visitor terminating condition
+ * holds. The minimum key of the opposite fringe is read from its published
+ * value, which can only be stale from below: the condition is evaluated on a
+ * lower bound and is never satisfied too early.
+ *
+ * Tentative distances are stored and then the opposite distance is loaded,
+ * both sequentially consistent: when the two threads reach the same vertex
+ * concurrently, at least one of them sees the other and records the path.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename BiDijkstraVisitorImpl, typename OnSettle, typename OnRelax,
+          typename Vertex, typename Length, typename Queue>
+void parallel_bi_dijkstra_run(
+    const Graph &G, WeightMap weight, IndexMap index,
+    ParallelBiDijkstraSearch<Vertex, Length, Queue> &search,
+    ParallelBiDijkstraSearch<Vertex, Length, Queue> &other_search,
+    ParallelBiDijkstraShared<Vertex, Length> &shared,
+    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor, OnSettle on_settle,
+    OnRelax on_relax) {
+  using boost::get;
+  constexpr Length inf = std::numeric_limits<Length>::max();
+  auto &fringe = search.fringe;
+
+  while (!shared.stop.load()) {
+    if (fringe.empty()) {
+      search.min_distance.store(inf);
+      shared.stop.store(true);
+      return;
+    }
+
+    // Extract closest node to expand
+    const auto v_index = fringe.top().key;
+    const auto dist = fringe.top().priority;
+    fringe.pop();
+    const auto v = search.vertex[v_index];
+
+    // Ask the visitor if vertex should be expanded
+    auto lower_bound_v = other_search.min_distance.load();
+    if (lower_bound_v == inf) {
+      // The opposite direction is exhausted
+      shared.stop.store(true);
+      return;
+    }
+    auto st_distance = shared.distance.load();
+    auto expand = call_visitor(visitor, shared, [&](auto &vis) {
+      return vis.expand_vertex(v, dist, lower_bound_v, st_distance);
+    });
+    if (!expand) {
+      search.publish_min_distance();
+      continue;
+    }
+
+    search.settled[v_index].store(true);
+    on_settle(v, dist);
+    if (other_search.settled[v_index].load()) {
+      // Anything pushed later in this direction is at least dist away.
+      auto min_dist = fringe.empty() ? dist : fringe.top().priority;
+      auto other_min_dist = other_search.min_distance.load();
+      if (other_min_dist == inf) {
+        shared.stop.store(true);
+        return;
+      }
+      st_distance = shared.distance.load();
+      auto terminate = call_visitor(visitor, shared, [&](auto &vis) {
+        return vis.terminating_condition(min_dist, other_min_dist,
+                                         st_distance);
+      });
+      if (terminate) {
+        shared.stop.store(true);
+        return;
+      }
+    }
+
+    // Compute neighbor distances
+    for (auto [it, end] = out_edges(v, G); it != end; ++it) {
+      auto w = target(*it, G);
+      auto w_index = get(index, w);
+      auto vw_length = dist + get(weight, *it);
+
+      if (search.settled[w_index].load(std::memory_order_relaxed)) {
+        if (vw_length < dist) {
+          throw std::domain_error{
+              "Contradictory paths found: negative weights?"};
+        }
+      } else if (vw_length <
+                 search.distance[w_index].load(std::memory_order_relaxed)) {
+        // Relax v-w edge
+        search.distance[w_index].store(vw_length);
+        search.vertex[w_index] = w;
+        search.parent[w_index] = v;
+        fringe.push_or_decrease(w_index, vw_length);
+        prefetch_out_edges(w, G);
+        on_relax(w, v, *it);
+
+        // See if this path is better than the already discovered shortests path
+        auto other_w_distance = other_search.distance[w_index].load();
+        if (other_w_distance != inf) {
+          shared.update(vw_length + other_w_distance, w);
+        }
+      }
+    }
+    search.publish_min_distance();
+  }
+}
+
+/**
+ * Run parallel bidirectional dijkstra from @p s to @p t: the backward search
+ * runs on a new thread, the forward one on the calling thread.
+ *
+ * @throw target_not_found if @p t is not reachable from @p s.
+ * @throw std::domain_error if a negative weight is detected.
+ * @return A pair (meeting vertex, s-t distance).
+ */
+template <typename Graph, typename WeightMap, typename BackGraph,
+          typename BackWeightMap, typename IndexMap,
+          typename BiDijkstraVisitorImpl, typename OnSettle, typename OnRelax,
+          typename OnSettleBack, typename OnRelaxBack, typename Vertex,
+          typename Length, typename Queue>
+std::pair<Vertex, Length> parallel_bi_dijkstra_search(
+    const Graph &G, Vertex s, Vertex t, WeightMap weight, const BackGraph &G_b,
+    BackWeightMap weight_b, IndexMap index,
+    ParallelBiDijkstraSearch<Vertex, Length, Queue> &forward,
+    ParallelBiDijkstraSearch<Vertex, Length, Queue> &backward,
+    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor, OnSettle on_settle,
+    OnRelax on_relax, OnSettleBack on_settle_b, OnRelaxBack on_relax_b) {
+  using boost::get;
+  constexpr Length inf = std::numeric_limits<Length>::max();
+
+  auto shared = ParallelBiDijkstraShared<Vertex, Length>{s};
+  forward.init(s, get(index, s));
+  backward.init(t, get(index, t));
+  if (s == t) {
+    shared.update(Length{0}, s);
+  }
+
+  auto backward_thread = std::thread{[&]() {
+    try {
+      parallel_bi_dijkstra_run(G_b, weight_b, index, backward, forward, shared,
+                               visitor, on_settle_b, on_relax_b);
+    } catch (...) {
+      shared.fail(std::current_exception());
+    }
+  }};
+  try {
+    parallel_bi_dijkstra_run(G, weight, index, forward, backward, shared,
+                             visitor, on_settle, on_relax);
+  } catch (...) {
+    shared.fail(std::current_exception());
+  }
+  backward_thread.join();
+
+  if (shared.error) {
+    std::rethrow_exception(shared.error);
+  }
+  if (shared.distance.load() == inf) {
+    throw target_not_found{"No path found!"};
+  }
+  return {shared.meeting, shared.distance.load()};
+}
+
+/**
+ * Materialise the s-t path through @p meeting into @p predecessor, following
+ * the search trees in @p forward and @p backward.
+ *
+ * @post predecessor[v] is set for each vertex v on the path but @p s.
+ */
+template <typename PredecessorMap, typename IndexMap, typename Vertex,
+          typename Length, typename Queue>
+void fill_predecessor(
+    PredecessorMap predecessor, IndexMap index, Vertex s, Vertex t,
+    Vertex meeting,
+    const ParallelBiDijkstraSearch<Vertex, Length, Queue> &forward,
+    const ParallelBiDijkstraSearch<Vertex, Length, Queue> &backward) {
+  using boost::get;
+  // Forward half: s ~> meeting
+  for (auto cur = meeting; cur != s;) {
+    auto pred = forward.parent[get(index, cur)];
+    assert(pred != cur);
+    predecessor[cur] = pred;
+    cur = pred;
+  }
+  // Backward half: meeting ~> t
+  for (auto cur = meeting; cur != t;) {
+    auto next = backward.parent[get(index, cur)];
+    assert(next != cur);
+    predecessor[next] = cur;
+    cur = next;
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_IMPL_HPP
@@ -0,0 +1,193 @@
+/**
+ * @file phast_impl.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_PHAST_IMPL_HPP
+#define ALTERNATIVE_ROUTING_LIB_PHAST_IMPL_HPP
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                         PHAST support routines
+//===----------------------------------------------------------------------===//
+
+/**
+ * The arcs between a vertex and the vertices above it in a hierarchy, in
+ * CSR form by sweep position.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> struct phast_arcs {
+  std::vector<std::size_t> offsets; /**< Arcs of p at [offsets[p], ...). */
+  std::vector<std::uint32_t> ends;  /**< The position of the other end. */
+  std::vector<Length> weights;      /**< The length of each arc. */
+};
+
+/**
+ * Run a Dijkstra's search from @p root along @p arcs, which all lead to
+ * vertices above their owner, without any stopping criterion.
+ *
+ * @param distance Upon return, an upper bound on the distance of each
+ *        position from @p root, exact for its highest vertices.
+ */
+template <typename Length>
+void phast_upward_search(phast_arcs<Length> const &arcs, std::uint32_t root,
+                         std::vector<Length> &distance,
+                         d_ary_heap<Length> &fringe) {
+  fringe.clear();
+  distance[root] = Length{0};
+  fringe.push_or_decrease(root, Length{0});
+  while (!fringe.empty()) {
+    auto [d, p] = fringe.top();
+    fringe.pop();
+    for (auto a = arcs.offsets[p]; a != arcs.offsets[p + 1]; ++a) {
+      auto q = arcs.ends[a];
+      auto dq = d + arcs.weights[a];
+      if (dq < distance[q]) {
+        distance[q] = dq;
+        fringe.push_or_decrease(q, dq);
+      }
+    }
+  }
+}
+
+/**
+ * Settle the positions [@p first, @p last) from the ones above them.
+ */
+template <typename Length>
+void phast_sweep_range(phast_arcs<Length> const &arcs, std::size_t first,
+                       std::size_t last, std::vector<Length> &distance) {
+  constexpr auto inf = std::numeric_limits<Length>::max();
+  auto const *offsets = arcs.offsets.data();
+  auto const *ends = arcs.ends.data();
+  auto const *weights = arcs.weights.data();
+  auto *d = distance.data();
+  for (auto p = first; p != last; ++p) {
+    auto best = d[p];
+    for (auto a = offsets[p]; a != offsets[p + 1]; ++a) {
+      auto dq = d[ends[a]];
+      auto via = dq + weights[a];
+      best = dq != inf && via < best ? via : best;
+    }
+    d[p] = best;
+  }
+}
+
+/**
+ * Settle every position, top-down, one level at a time.
+ *
+ * Arcs only join different levels, so the positions of a level are split
+ * across the threads of @p pool when there are enough of them.
+ *
+ * @param levels Level `i` spans positions [levels[i], levels[i + 1]).
+ * @param pool If not null, the threads to split large levels on.
+ */
+template <typename Length>
+void phast_sweep(phast_arcs<Length> const &arcs,
+                 std::vector<std::size_t> const &levels,
+                 std::vector<Length> &distance, thread_pool *pool) {
+  // Below this, waking the threads costs more than the level itself
+  constexpr std::size_t min_parallel_level = 512;
+  for (std::size_t i = 0; i + 1 < levels.size(); ++i) {
+    auto first = levels[i];
+    auto last = levels[i + 1];
+    if (pool == nullptr || pool->size() == 1 ||
+        last - first < min_parallel_level) {
+      phast_sweep_range(arcs, first, last, distance);
+      continue;
+    }
+    auto num_threads = pool->size();
+    pool->run([&](unsigned id) {
+      auto size = last - first;
+      auto begin = first + size * id / num_threads;
+      auto end = first + size * (id + 1) / num_threads;
+      phast_sweep_range(arcs, begin, end, distance);
+    });
+  }
+}
+
+/**
+ * The sweep order of a hierarchy: each vertex gets a level one above the
+ * highest level of its neighbors of higher rank, and positions are sorted
+ * by level, then by decreasing rank.
+ *
+ * @param rank The rank of each vertex index.
+ * @param neighbors_above Calls its second argument with the index of every
+ *        neighbor of higher rank of the vertex index given as first one.
+ * @param order Upon return, the vertex index at each position.
+ * @param levels Upon return, the first position of each level, then the
+ *        number of vertices.
+ */
+template <typename NeighborsAbove>
+void phast_order(std::vector<std::size_t> const &rank,
+                 NeighborsAbove neighbors_above,
+                 std::vector<std::size_t> &order,
+                 std::vector<std::size_t> &levels) {
+  auto n = rank.size();
+  auto by_rank = std::vector<std::size_t>(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    by_rank[n - 1 - rank[v]] = v;
+  }
+
+  auto level = std::vector<std::size_t>(n, 0);
+  std::size_t num_levels = 0;
+  for (auto v : by_rank) {
+    neighbors_above(v, [&](std::size_t u) {
+      level[v] = std::max(level[v], level[u] + 1);
+    });
+    num_levels = std::max(num_levels, level[v] + 1);
+  }
+
+  // Counting sort by level, stable on decreasing rank
+  levels.assign(num_levels + 1, 0);
+  for (std::size_t v = 0; v < n; ++v) {
+    ++levels[level[v] + 1];
+  }
+  for (std::size_t i = 0; i < num_levels; ++i) {
+    levels[i + 1] += levels[i];
+  }
+  auto next = std::vector<std::size_t>(levels.begin(), levels.end() - 1);
+  order.resize(n);
+  for (auto v : by_rank) {
+    order[next[level[v]]++] = v;
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_PHAST_IMPL_HPP
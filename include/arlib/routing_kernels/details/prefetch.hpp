@@ -0,0 +1,120 @@
+/**
+ * @file prefetch.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_PREFETCH_HPP
+#define ALTERNATIVE_ROUTING_LIB_PREFETCH_HPP
+
+#include <boost/graph/filtered_graph.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                          Adjacency prefetching
+//===----------------------------------------------------------------------===//
+
+/**
+ * Hint that the out-edges of @p v are about to be scanned.
+ *
+ * Kernels call it on every vertex they push to the queue, so that its
+ * adjacency is on its way to the cache by the time the vertex is settled.
+ * This overload does nothing: graphs laid out for it, such as road_graph,
+ * provide their own overload, found by argument-dependent lookup.
+ *
+ * @param v The vertex.
+ * @param G The graph.
+ */
+template <typename Vertex, typename Graph>
+void prefetch_out_edges(Vertex, const Graph &) {}
+
+/**
+ * Hint that the in-edges of @p v are about to be scanned.
+ *
+ * @see prefetch_out_edges(Vertex v, const Graph &G)
+ */
+template <typename Vertex, typename Graph>
+void prefetch_in_edges(Vertex, const Graph &) {}
+
+// Adaptors forward to the graph they wrap, which may be another adaptor.
+template <typename Vertex, typename Graph, typename EdgePredicate,
+          typename VertexPredicate>
+void prefetch_out_edges(
+    Vertex v,
+    const boost::filtered_graph<Graph, EdgePredicate, VertexPredicate> &G);
+template <typename Vertex, typename Graph, typename EdgePredicate,
+          typename VertexPredicate>
+void prefetch_in_edges(
+    Vertex v,
+    const boost::filtered_graph<Graph, EdgePredicate, VertexPredicate> &G);
+template <typename Vertex, typename Graph, typename GraphRef>
+void prefetch_out_edges(Vertex v,
+                        const boost::reverse_graph<Graph, GraphRef> &G);
+template <typename Vertex, typename Graph, typename GraphRef>
+void prefetch_in_edges(Vertex v,
+                       const boost::reverse_graph<Graph, GraphRef> &G);
+
+/**
+ * A filtered graph scans the edges of the graph it filters.
+ */
+template <typename Vertex, typename Graph, typename EdgePredicate,
+          typename VertexPredicate>
+void prefetch_out_edges(
+    Vertex v,
+    const boost::filtered_graph<Graph, EdgePredicate, VertexPredicate> &G) {
+  prefetch_out_edges(v, G.m_g);
+}
+
+template <typename Vertex, typename Graph, typename EdgePredicate,
+          typename VertexPredicate>
+void prefetch_in_edges(
+    Vertex v,
+    const boost::filtered_graph<Graph, EdgePredicate, VertexPredicate> &G) {
+  prefetch_in_edges(v, G.m_g);
+}
+
+/**
+ * The out-edges of a reverse graph are the in-edges of the graph it
+ * reverses, and vice versa.
+ */
+template <typename Vertex, typename Graph, typename GraphRef>
+void prefetch_out_edges(Vertex v,
+                        const boost::reverse_graph<Graph, GraphRef> &G) {
+  prefetch_in_edges(v, G.m_g);
+}
+
+template <typename Vertex, typename Graph, typename GraphRef>
+void prefetch_in_edges(Vertex v,
+                       const boost::reverse_graph<Graph, GraphRef> &G) {
+  prefetch_out_edges(v, G.m_g);
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_PREFETCH_HPP
@@ -0,0 +1,267 @@
+/**
+ * @file radix_heap.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_RADIX_HEAP_HPP
+#define ALTERNATIVE_ROUTING_LIB_RADIX_HEAP_HPP
+
+#include <arlib/routing_kernels/details/stamped_vector.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+/**
+ * An indexed monotone radix heap, for non-negative integer priorities.
+ *
+ * Entries are kept in one bucket per bit of the priority type: bucket @c i
+ * holds the priorities whose highest bit differing from the last minimum is
+ * bit <tt>i - 1</tt>, bucket 0 the ones equal to it. When bucket 0 runs out,
+ * the first non-empty bucket is split around its minimum, and every entry
+ * moves to a lower bucket. Each entry is thus moved at most once per bit, and
+ * there is no comparison-based sift at all.
+ *
+ * It has the same interface as d_ary_heap. Decrease-key pushes a new entry
+ * and leaves the old one behind, to be dropped when met: an entry is live if
+ * its key is in the heap with the same priority.
+ *
+ * @pre Priorities are never less than the last popped one (e.g. Dijkstra's
+ *      distances, or A* keys with a consistent heuristic), until the heap is
+ *      cleared.
+ *
+ * @tparam Priority An integral priority type, e.g. a distance.
+ */
+template <typename Priority> class radix_heap {
+  static_assert(std::is_integral_v<Priority>,
+                "A radix heap needs integral priorities: scale "
+                "floating-point weights to fixed point");
+
+public:
+  using size_type = std::size_t;
+  using key_type = size_type;
+  using priority_type = Priority;
+
+  /**
+   * A heap entry.
+   */
+  struct value_type {
+    Priority priority; /**< The priority of key. */
+    key_type key;      /**< The key. */
+  };
+
+  radix_heap() = default;
+  /**
+   * Construct a new empty radix_heap for keys in [0, @p n).
+   *
+   * @param n The number of keys.
+   */
+  explicit radix_heap(size_type n) : current(n, none) {}
+
+  /**
+   * Resize the key space to [0, @p n) and empty the heap.
+   *
+   * @param n The number of keys.
+   */
+  void resize(size_type n) {
+    clear_buckets();
+    current.resize(n);
+    last = Priority{0};
+  }
+
+  /**
+   * Empty the heap.
+   */
+  void clear() {
+    clear_buckets();
+    current.clear();
+    last = Priority{0};
+  }
+
+  bool empty() const { return count == 0; }
+  size_type size() const { return count; }
+
+  /**
+   * @param key A key.
+   * @return true if @p key is in the heap.
+   */
+  bool contains(key_type key) const { return current[key] != none; }
+
+  /**
+   * @pre !empty()
+   * @return The entry with minimum priority.
+   */
+  const value_type &top() const {
+    assert(!empty());
+    if (!min_found) {
+      find_min();
+    }
+    return min_entry;
+  }
+
+  /**
+   * Remove the entry with minimum priority.
+   *
+   * @pre !empty()
+   */
+  void pop() {
+    auto const popped = top();
+    current.at(popped.key) = none;
+    min_found = false;
+    if (--count == 0) {
+      // Only stale entries are left
+      clear_buckets();
+      last = popped.priority;
+      return;
+    }
+    if (popped.priority != last) {
+      // Split the minimum's bucket around the new last minimum
+      last = popped.priority;
+      auto &bucket = buckets[min_bucket];
+      for (auto const &entry : bucket) {
+        if (is_live(entry)) {
+          buckets[bucket_of(entry.priority)].push_back(entry);
+        }
+      }
+      bucket.clear();
+    }
+  }
+
+  /**
+   * Insert @p key with @p priority, or lower its priority to @p priority if
+   * it is already in the heap with a greater one.
+   *
+   * @param key A key.
+   * @param priority The new priority of @p key.
+   * @return true if the heap changed.
+   */
+  bool push_or_decrease(key_type key, Priority priority) {
+    assert(priority >= Priority{0} && priority != none);
+    auto &slot = current.at(key);
+    if (slot != none && !(priority < slot)) {
+      return false;
+    }
+    if (slot == none) {
+      ++count;
+    }
+    assert(!(priority < last) && "radix_heap priorities must be monotone");
+    slot = priority;
+    auto bucket = bucket_of(priority);
+    buckets[bucket].push_back(value_type{priority, key});
+    if (min_found && priority < min_entry.priority) {
+      min_entry = value_type{priority, key};
+      min_bucket = bucket;
+    }
+    return true;
+  }
+
+private:
+  using Bits = std::make_unsigned_t<Priority>;
+  static constexpr Priority none = std::numeric_limits<Priority>::max();
+  static constexpr size_type num_buckets =
+      std::numeric_limits<Bits>::digits + 1;
+
+  size_type bucket_of(Priority priority) const {
+    auto diff = static_cast<Bits>(priority) ^ static_cast<Bits>(last);
+    size_type bucket = 0;
+    while (diff != 0) {
+      ++bucket;
+      diff >>= 1;
+    }
+    return bucket;
+  }
+
+  bool is_live(value_type const &entry) const {
+    return current[entry.key] == entry.priority;
+  }
+
+  // Find the live minimum, dropping the stale entries met on the way. The
+  // last minimum only moves on pop(), since keys between it and the current
+  // minimum may still be pushed.
+  void find_min() const {
+    // Bucket 0 holds a single priority, the last minimum
+    auto &front = buckets[0];
+    while (!front.empty() && !is_live(front.back())) {
+      front.pop_back();
+    }
+    if (!front.empty()) {
+      min_entry = front.back();
+      min_bucket = 0;
+      min_found = true;
+      return;
+    }
+    for (size_type i = 1; i < num_buckets; ++i) {
+      auto &bucket = buckets[i];
+      auto live_end = bucket.begin();
+      for (auto const &entry : bucket) {
+        if (is_live(entry)) {
+          *live_end++ = entry;
+        }
+      }
+      bucket.erase(live_end, bucket.end());
+      if (bucket.empty()) {
+        continue;
+      }
+      min_entry = bucket.front();
+      for (auto const &entry : bucket) {
+        if (entry.priority < min_entry.priority) {
+          min_entry = entry;
+        }
+      }
+      min_bucket = i;
+      min_found = true;
+      return;
+    }
+    assert(false && "radix_heap::find_min on an empty heap");
+  }
+
+  void clear_buckets() {
+    for (auto &bucket : buckets) {
+      bucket.clear();
+    }
+    count = 0;
+    min_found = false;
+  }
+
+  mutable std::array<std::vector<value_type>, num_buckets> buckets;
+  stamped_vector<Priority> current = stamped_vector<Priority>(0, none);
+  size_type count = 0;
+  Priority last = Priority{0};
+  mutable value_type min_entry = value_type{};
+  mutable size_type min_bucket = 0;
+  mutable bool min_found = false;
+};
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_RADIX_HEAP_HPP
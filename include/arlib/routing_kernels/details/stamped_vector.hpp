@@ -0,0 +1,135 @@
+/**
+ * @file stamped_vector.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_STAMPED_VECTOR_HPP
+#define ALTERNATIVE_ROUTING_LIB_STAMPED_VECTOR_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace arlib {
+namespace details {
+/**
+ * A fixed-size array whose entries can all be invalidated in O(1).
+ *
+ * Every slot is tagged with the generation it was last written in. A slot
+ * holds a value only if its tag matches the current generation, so clear()
+ * just bumps the generation. This lets a search reuse the same arrays across
+ * thousands of queries without paying O(|V|) to reset them each time.
+ *
+ * @tparam T The value type.
+ */
+template <typename T> class stamped_vector {
+public:
+  using size_type = std::size_t;
+  using value_type = T;
+
+  stamped_vector() = default;
+  /**
+   * Construct a new stamped_vector of @p n empty slots, reading as @p init.
+   *
+   * @param n The number of slots.
+   * @param init The value of empty slots.
+   */
+  explicit stamped_vector(size_type n, T init = T{})
+      : values(n, init), stamps(n, 0), init{init} {}
+
+  /**
+   * @return The number of slots.
+   */
+  size_type size() const { return values.size(); }
+
+  /**
+   * Resize to @p n slots and empty all of them.
+   *
+   * @param n The number of slots.
+   */
+  void resize(size_type n) {
+    if (n != values.size()) {
+      values.assign(n, init);
+      stamps.assign(n, 0);
+      generation = 1;
+    } else {
+      clear();
+    }
+  }
+
+  /**
+   * Empty all the slots in O(1) amortized time.
+   */
+  void clear() {
+    if (generation == std::numeric_limits<std::uint32_t>::max()) {
+      std::fill(std::begin(stamps), std::end(stamps), 0);
+      generation = 0;
+    }
+    ++generation;
+  }
+
+  /**
+   * @param i A slot index.
+   * @return true if slot @p i was written since the last clear().
+   */
+  bool contains(size_type i) const { return stamps[i] == generation; }
+
+  /**
+   * @param i A slot index.
+   * @return The value in slot @p i if contains(i), the empty value otherwise.
+   */
+  const T &operator[](size_type i) const {
+    return contains(i) ? values[i] : init;
+  }
+
+  /**
+   * Access slot @p i for writing. An empty slot is reset to the empty value
+   * first.
+   *
+   * @param i A slot index.
+   * @return A reference to the value in slot @p i.
+   */
+  T &at(size_type i) {
+    if (!contains(i)) {
+      stamps[i] = generation;
+      values[i] = init;
+    }
+    return values[i];
+  }
+
+private:
+  std::vector<T> values;
+  std::vector<std::uint32_t> stamps;
+  std::uint32_t generation = 1;
+  T init{};
+};
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_STAMPED_VECTOR_HPP
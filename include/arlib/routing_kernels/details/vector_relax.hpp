@@ -0,0 +1,315 @@
+/**
+ * @file vector_relax.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_VECTOR_RELAX_HPP
+#define ALTERNATIVE_ROUTING_LIB_VECTOR_RELAX_HPP
+
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/road_graph.hpp>
+#include <arlib/routing_kernels/details/bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/details/prefetch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace arlib {
+namespace details {
+//===----------------------------------------------------------------------===//
+//                        Vectorised edge relaxation
+//===----------------------------------------------------------------------===//
+
+/**
+ * The outcome of relaxing a batch of out-edges of the same vertex.
+ */
+struct relax_mask {
+  std::uint32_t improved; /**< Bit i is set if edge i improves its head. */
+  bool negative;          /**< Whether some edge has a negative weight. */
+};
+
+/**
+ * Relax a batch of consecutive out-edges of a vertex at once: compute the
+ * distance of each head through its edge and compare it with the current
+ * one. This is the portable version, a plain loop over the batch.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length, typename = void> struct relax_batch {
+  /**
+   * The number of edges of a batch.
+   */
+  static constexpr std::size_t width = 8;
+
+  /**
+   * @param arcs The first of `width` consecutive forward arcs.
+   * @param dist The distance of the tail of the arcs.
+   * @param current The current distance of the head of each arc.
+   * @param candidate Receives the distance of the head of each arc through
+   *        it.
+   * @return Which arcs improve the distance of their head, and whether some
+   *         arc has a negative weight.
+   */
+  static relax_mask improve(const road_graph_out_arc<Length> *arcs,
+                            Length dist, const Length *current,
+                            Length *candidate) {
+    auto mask = relax_mask{0, false};
+    for (std::size_t i = 0; i < width; ++i) {
+      candidate[i] = dist + arcs[i].weight;
+      mask.negative |= candidate[i] < dist;
+      mask.improved |= static_cast<std::uint32_t>(candidate[i] < current[i])
+                       << i;
+    }
+    return mask;
+  }
+};
+
+#if defined(__AVX512F__)
+/**
+ * 16 edges of 32-bit integer weight at once, with AVX-512.
+ */
+template <typename Length>
+struct relax_batch<Length, std::enable_if_t<std::is_integral_v<Length> &&
+                                            std::is_signed_v<Length> &&
+                                            sizeof(Length) == 4>> {
+  static constexpr std::size_t width = 16;
+
+  static relax_mask improve(const road_graph_out_arc<Length> *arcs,
+                            Length dist, const Length *current,
+                            Length *candidate) {
+    static_assert(sizeof(road_graph_out_arc<Length>) == 8);
+    // Arcs are (target, weight) pairs: weights are the odd 32-bit lanes
+    auto lo = _mm512_loadu_si512(arcs);
+    auto hi = _mm512_loadu_si512(arcs + 8);
+    auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23,
+                                 25, 27, 29, 31);
+    auto weight = _mm512_permutex2var_epi32(lo, odd, hi);
+    auto from = _mm512_set1_epi32(dist);
+    auto to = _mm512_add_epi32(from, weight);
+    _mm512_storeu_si512(candidate, to);
+    auto improved = _mm512_cmplt_epi32_mask(to, _mm512_loadu_si512(current));
+    auto negative = _mm512_cmplt_epi32_mask(to, from);
+    return {static_cast<std::uint32_t>(improved), negative != 0};
+  }
+};
+
+/**
+ * 8 edges of `double` weight at once, with AVX-512.
+ */
+template <> struct relax_batch<double> {
+  static constexpr std::size_t width = 8;
+
+  static relax_mask improve(const road_graph_out_arc<double> *arcs,
+                            double dist, const double *current,
+                            double *candidate) {
+    static_assert(sizeof(road_graph_out_arc<double>) == 16);
+    // Arcs are (target, weight) pairs: weights are the odd 64-bit lanes
+    auto lo = _mm512_loadu_pd(arcs);
+    auto hi = _mm512_loadu_pd(arcs + 4);
+    auto odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    auto weight = _mm512_permutex2var_pd(lo, odd, hi);
+    auto from = _mm512_set1_pd(dist);
+    auto to = _mm512_add_pd(from, weight);
+    _mm512_storeu_pd(candidate, to);
+    auto improved =
+        _mm512_cmp_pd_mask(to, _mm512_loadu_pd(current), _CMP_LT_OQ);
+    auto negative = _mm512_cmp_pd_mask(to, from, _CMP_LT_OQ);
+    return {static_cast<std::uint32_t>(improved), negative != 0};
+  }
+};
+#elif defined(__AVX2__)
+/**
+ * 8 edges of 32-bit integer weight at once, with AVX2.
+ */
+template <typename Length>
+struct relax_batch<Length, std::enable_if_t<std::is_integral_v<Length> &&
+                                            std::is_signed_v<Length> &&
+                                            sizeof(Length) == 4>> {
+  static constexpr std::size_t width = 8;
+
+  static relax_mask improve(const road_graph_out_arc<Length> *arcs,
+                            Length dist, const Length *current,
+                            Length *candidate) {
+    static_assert(sizeof(road_graph_out_arc<Length>) == 8);
+    // Arcs are (target, weight) pairs: move the odd 32-bit lanes, the
+    // weights, to the low half of each vector and join the two halves
+    auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(arcs));
+    auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(arcs + 4));
+    auto odd = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+    auto weight = _mm256_permute2x128_si256(
+        _mm256_permutevar8x32_epi32(lo, odd),
+        _mm256_permutevar8x32_epi32(hi, odd), 0x20);
+    auto from = _mm256_set1_epi32(dist);
+    auto to = _mm256_add_epi32(from, weight);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(candidate), to);
+    auto now =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current));
+    auto improved = _mm256_cmpgt_epi32(now, to);
+    auto negative = _mm256_cmpgt_epi32(from, to);
+    return {static_cast<std::uint32_t>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(improved))),
+            _mm256_movemask_ps(_mm256_castsi256_ps(negative)) != 0};
+  }
+};
+
+/**
+ * 4 edges of `double` weight at once, with AVX2.
+ */
+template <> struct relax_batch<double> {
+  static constexpr std::size_t width = 4;
+
+  static relax_mask improve(const road_graph_out_arc<double> *arcs,
+                            double dist, const double *current,
+                            double *candidate) {
+    static_assert(sizeof(road_graph_out_arc<double>) == 16);
+    // Arcs are (target, weight) pairs: weights are the odd 64-bit lanes,
+    // which unpacking leaves in the order 0, 2, 1, 3
+    auto lo = _mm256_loadu_pd(reinterpret_cast<const double *>(arcs));
+    auto hi = _mm256_loadu_pd(reinterpret_cast<const double *>(arcs + 2));
+    auto weight = _mm256_permute4x64_pd(_mm256_unpackhi_pd(lo, hi), 0xD8);
+    auto from = _mm256_set1_pd(dist);
+    auto to = _mm256_add_pd(from, weight);
+    _mm256_storeu_pd(candidate, to);
+    auto improved = _mm256_cmp_pd(to, _mm256_loadu_pd(current), _CMP_LT_OQ);
+    auto negative = _mm256_cmp_pd(to, from, _CMP_LT_OQ);
+    return {static_cast<std::uint32_t>(_mm256_movemask_pd(improved)),
+            _mm256_movemask_pd(negative) != 0};
+  }
+};
+#endif
+
+/**
+ * @param mask A non-zero bit mask.
+ * @return The position of the lowest set bit of @p mask.
+ */
+inline unsigned lowest_bit(std::uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+  auto i = 0u;
+  for (; (mask & 1u) == 0; mask >>= 1) {
+    ++i;
+  }
+  return i;
+#endif
+}
+
+/**
+ * True if point_to_point_search() can relax the out-edges of @p Graph with
+ * relax_out_arcs(): the graph is a road_graph, searched on its own weights
+ * and vertex indices.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap>
+struct has_packed_arcs : std::false_type {};
+
+template <typename Length, typename Graph>
+struct has_packed_arcs<road_graph<Length>, road_graph_weight_map<Graph>,
+                       boost::typed_identity_property_map<std::uint32_t>>
+    : std::is_same<std::remove_const_t<Graph>, road_graph<Length>> {};
+
+template <typename Graph, typename WeightMap, typename IndexMap>
+constexpr bool has_packed_arcs_v =
+    has_packed_arcs<Graph, WeightMap, IndexMap>::value;
+
+/**
+ * Relax the out-edges of @p v, settled at distance @p dist, in batches of
+ * relax_batch::width edges: the current distances of the heads of a batch
+ * are gathered, compared at once with the distances through @p v, and only
+ * the heads that improve are updated and queued. With AVX2 or AVX-512
+ * enabled at compile time, batches of 32-bit integer and `double` weights
+ * are relaxed with vector instructions.
+ *
+ * This is the loop of point_to_point_search() for a road_graph, and has
+ * the same effects.
+ *
+ * @throw std::domain_error if a negative weight is detected.
+ */
+template <typename Length, typename Potential, typename OnRelax,
+          typename Queue>
+void relax_out_arcs(const road_graph<Length> &G, std::uint32_t v,
+                    Length dist, Potential const &potential,
+                    BiDijkstraSearch<std::uint32_t, Length, Queue> &search,
+                    OnRelax &on_relax) {
+  using Batch = relax_batch<Length>;
+  using Label = BiDijkstraLabel<std::uint32_t, Length>;
+
+  auto arcs = G.forward_arcs();
+  auto relax = [&](std::uint32_t e, Length vw_length) {
+    auto w = arcs[e].target;
+    auto w_potential = potential(w);
+    if (w_potential == std::numeric_limits<decltype(w_potential)>::max()) {
+      // t is not reachable from w
+      return;
+    }
+    auto &w_label = search.labels.at(w);
+    if (!w_label.settled && vw_length < w_label.distance) {
+      w_label = Label{vw_length, w, v, false};
+      search.fringe.push_or_decrease(
+          w, static_cast<Length>(vw_length + w_potential));
+      prefetch_out_edges(w, G);
+      on_relax(w, v, G.out_edge(v, e));
+    }
+  };
+
+  auto e = G.out_offset(v);
+  auto last = G.out_offset(v + 1);
+  Length current[Batch::width];
+  Length candidate[Batch::width];
+  for (; e + Batch::width <= last; e += Batch::width) {
+    for (std::size_t i = 0; i < Batch::width; ++i) {
+      current[i] = search.labels[arcs[e + i].target].distance;
+    }
+    auto mask = Batch::improve(arcs + e, dist, current, candidate);
+    if (mask.negative) {
+      throw std::domain_error{"Negative weight on edge"};
+    }
+    for (; mask.improved != 0; mask.improved &= mask.improved - 1) {
+      auto i = lowest_bit(mask.improved);
+      relax(e + i, candidate[i]);
+    }
+  }
+  for (; e < last; ++e) {
+    auto vw_length = dist + arcs[e].weight;
+    if (vw_length < dist) {
+      throw std::domain_error{"Negative weight on edge"};
+    }
+    relax(e, vw_length);
+  }
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_VECTOR_RELAX_HPP
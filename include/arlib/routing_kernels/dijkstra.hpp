@@ -0,0 +1,192 @@
+/**
+ * @file dijkstra.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_DIJKSTRA_HPP
+#define ALTERNATIVE_ROUTING_LIB_DIJKSTRA_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/routing_kernels/details/bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/details/dijkstra_impl.hpp>
+#include <arlib/routing_kernels/queue_policies.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cstddef>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                         Point-to-point workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory dijkstra() and astar() work on: a dense array of vertex labels
+ * and an indexed priority queue, by default a 4-ary heap.
+ *
+ * Like BiDijkstraWorkspace, it can be reused by any number of queries on
+ * graphs of the same order, and must not be shared between threads.
+ *
+ * @tparam Vertex The vertex_descriptor.
+ * @tparam Length The weight value type.
+ * @tparam QueuePolicy The priority queue of the fringe, e.g.
+ *         radix_heap_policy or bucket_queue_policy for integer weights.
+ */
+template <typename Vertex, typename Length,
+          typename QueuePolicy = d_ary_heap_policy<>>
+class DijkstraWorkspace {
+public:
+  /**
+   * The state of the search.
+   */
+  using Search = details::BiDijkstraSearch<Vertex, Length,
+                                           queue_of_t<QueuePolicy, Length>>;
+
+  DijkstraWorkspace() = default;
+  /**
+   * Construct a new DijkstraWorkspace for graphs of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit DijkstraWorkspace(std::size_t n) : state{n} {}
+
+  /**
+   * @return The state of the search.
+   */
+  Search &search() { return state; }
+
+private:
+  Search state;
+};
+
+//===----------------------------------------------------------------------===//
+//                        Point-to-point algorithms
+//===----------------------------------------------------------------------===//
+/**
+ * Dijkstra's algorithm from @p s, stopping as soon as @p t is settled.
+ *
+ * Unlike `boost::dijkstra_shortest_paths()`, the priority queue is chosen by
+ * the QueuePolicy of @p workspace, and nothing is allocated per query.
+ * @p predecessor is written only for the vertices of the shortest path.
+ *
+ * @tparam Graph A Boost::IncidenceGraph and Boost::VertexListGraph.
+ * @tparam PredecessorMap A writable PredecessorMap.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @param predecessor Receives the s-t path, with `predecessor[s] = s`.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param workspace The memory to run the search on.
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename IndexMap, typename Vertex, typename Length,
+          typename QueuePolicy>
+Length dijkstra(const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+                WeightMap weight, IndexMap index,
+                DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto &search = workspace.search();
+  auto distance = details::point_to_point_search(
+      G, s, t, weight, index, details::zero_potential{}, search);
+  details::fill_predecessor(predecessor, index, s, t, search);
+  return distance;
+}
+
+/**
+ * A* from @p s to @p t, guided by @p heuristic.
+ *
+ * @p heuristic must be consistent, i.e. `h(u) <= w(u, v) + h(v)` for every
+ * edge, as the ones of distance_heuristic and alt_heuristic are: settled
+ * vertices are never reopened, which also keeps the keys monotone for
+ * radix_heap_policy and bucket_queue_policy.
+ *
+ * @see dijkstra(const Graph &G, Vertex s, Vertex t,
+ *               PredecessorMap predecessor, WeightMap weight, IndexMap index,
+ *               DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace)
+ *
+ * @tparam Heuristic A callable returning a lower bound of the distance from
+ *         a vertex to @p t.
+ * @param heuristic The A* heuristic.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename IndexMap, typename Heuristic, typename Vertex,
+          typename Length, typename QueuePolicy>
+Length astar(const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+             WeightMap weight, IndexMap index, Heuristic const &heuristic,
+             DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto &search = workspace.search();
+  auto distance =
+      details::point_to_point_search(G, s, t, weight, index, heuristic, search);
+  details::fill_predecessor(predecessor, index, s, t, search);
+  return distance;
+}
+
+/**
+ * Dijkstra's algorithm from @p s to @p t on a fresh workspace, reading
+ * weights from the `boost::edge_weight_t` property of @p G and indices from
+ * its `boost::vertex_index_t` property.
+ *
+ * @see dijkstra(const Graph &G, Vertex s, Vertex t,
+ *               PredecessorMap predecessor, WeightMap weight, IndexMap index,
+ *               DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace)
+ *
+ * @tparam QueuePolicy The priority queue of the fringe. Defaults to a 4-ary
+ *         heap.
+ */
+template <typename QueuePolicy = d_ary_heap_policy<>, typename PropertyGraph,
+          typename PredecessorMap, typename Vertex = vertex_of_t<PropertyGraph>>
+length_of_t<PropertyGraph> dijkstra(const PropertyGraph &G, Vertex s, Vertex t,
+                                    PredecessorMap predecessor) {
+  using namespace boost;
+  using Length = length_of_t<PropertyGraph>;
+  auto workspace =
+      DijkstraWorkspace<Vertex, Length, QueuePolicy>{num_vertices(G)};
+  return dijkstra(G, s, t, predecessor, get(edge_weight, G),
+                  get(vertex_index, G), workspace);
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_DIJKSTRA_HPP
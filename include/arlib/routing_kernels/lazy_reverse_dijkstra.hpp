@@ -0,0 +1,219 @@
+/**
+ * @file lazy_reverse_dijkstra.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_LAZY_REVERSE_DIJKSTRA_HPP
+#define ALTERNATIVE_ROUTING_LIB_LAZY_REVERSE_DIJKSTRA_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                        Resumable reverse Dijkstra
+//===----------------------------------------------------------------------===//
+/**
+ * A Dijkstra's search from a target vertex on the reverse of a graph, run
+ * only as far as its queries need.
+ *
+ * Asking for the distance of a vertex v to the target resumes the search
+ * until v is settled, so a goal-directed search from a nearby source only
+ * pays for the ball of vertices around the target it actually touches,
+ * rather than for the whole graph. Vertices settled once are answered in
+ * constant time.
+ *
+ * The search can be bounded by a maximum radius. Once the queue holds no
+ * vertex within it, the search stops growing and every unsettled vertex is
+ * answered with the current radius, the smallest key in the queue: a lower
+ * bound of its distance, as any vertex still to settle is at least that far.
+ * The answers, exact or not, form a consistent A* heuristic, and the answer
+ * given for a vertex never changes afterwards.
+ *
+ * @tparam Graph A Boost::VertexListGraph providing `in_edges()`.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ */
+template <typename Graph, typename WeightMap, typename IndexMap>
+class lazy_reverse_dijkstra {
+public:
+  /**
+   * Graph vertex descriptor.
+   */
+  using Vertex = vertex_of_t<Graph>;
+  /**
+   * The edge weight type.
+   */
+  using Length = value_of_t<WeightMap>;
+
+  /**
+   * Start a reverse search from @p t. No vertex but @p t is touched until
+   * the first query.
+   *
+   * @param G The graph.
+   * @param t The target vertex.
+   * @param weight The WeightMap of @p G.
+   * @param index The IndexMap of @p G.
+   * @param max_radius The distance from @p t beyond which the search stops
+   *        growing. By default, it always settles the vertex it is asked for.
+   */
+  lazy_reverse_dijkstra(const Graph &G, Vertex t, WeightMap weight,
+                        IndexMap index,
+                        Length max_radius = std::numeric_limits<Length>::max())
+      : G{&G}, weight{weight}, index{index}, max_radius{max_radius},
+        labels(num_vertices(G)), fringe(num_vertices(G)) {
+    BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<Graph>));
+    auto t_index = boost::get(index, t);
+    labels[t_index] = Label{Length{0}, t, false};
+    fringe.push_or_decrease(t_index, Length{0});
+  }
+
+  /**
+   * Resume the search until @p v is settled, or the search stops growing.
+   *
+   * @param v The vertex.
+   * @return The distance from @p v to the target if @p v is settled, the
+   *         current radius() otherwise.
+   * @throw std::domain_error if a negative weight is detected.
+   */
+  Length distance(Vertex v) {
+    auto v_index = boost::get(index, v);
+    while (!labels[v_index].settled && can_grow()) {
+      settle_next();
+    }
+    return lower_bound(v);
+  }
+
+  /**
+   * @param v The vertex.
+   * @return The distance from @p v to the target if @p v is settled, the
+   *         current radius() otherwise. The search is not resumed.
+   */
+  Length lower_bound(Vertex v) const {
+    auto const &label = labels[boost::get(index, v)];
+    return label.settled ? label.distance : radius();
+  }
+
+  /**
+   * @param v The vertex.
+   * @return True if the exact distance from @p v to the target is known.
+   */
+  bool is_settled(Vertex v) const {
+    return labels[boost::get(index, v)].settled;
+  }
+
+  /**
+   * @return A lower bound of the distance to the target of every vertex not
+   *         settled yet: the smallest key in the queue, or
+   *         `std::numeric_limits<Length>::max()` once the whole reverse
+   *         component of the target is settled.
+   */
+  Length radius() const {
+    return fringe.empty() ? std::numeric_limits<Length>::max()
+                          : fringe.top().priority;
+  }
+
+  /**
+   * @return The number of vertices settled so far.
+   */
+  std::size_t num_settled() const { return settled_count; }
+
+private:
+  struct Label {
+    Length distance = std::numeric_limits<Length>::max();
+    Vertex vertex = Vertex{};
+    bool settled = false;
+  };
+
+  bool can_grow() const {
+    return !fringe.empty() && fringe.top().priority <= max_radius;
+  }
+
+  void settle_next() {
+    auto u_index = fringe.top().key;
+    fringe.pop();
+    auto &u_label = labels[u_index];
+    u_label.settled = true;
+    ++settled_count;
+    auto u = u_label.vertex;
+    auto dist = u_label.distance;
+
+    for (auto [it, end] = in_edges(u, *G); it != end; ++it) {
+      auto w = source(*it, *G);
+      auto w_index = boost::get(index, w);
+      auto wu_length = dist + boost::get(weight, *it);
+      if (wu_length < dist) {
+        throw std::domain_error{"Negative weight on edge"};
+      }
+      auto &w_label = labels[w_index];
+      if (!w_label.settled && wu_length < w_label.distance) {
+        w_label = Label{wu_length, w, false};
+        fringe.push_or_decrease(w_index, wu_length);
+      }
+    }
+  }
+
+  const Graph *G;
+  WeightMap weight;
+  IndexMap index;
+  Length max_radius;
+  std::vector<Label> labels;
+  details::d_ary_heap<Length> fringe;
+  std::size_t settled_count = 0;
+};
+
+/**
+ * Start a resumable reverse search from @p t on @p G.
+ *
+ * @see lazy_reverse_dijkstra
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+lazy_reverse_dijkstra<Graph, WeightMap, IndexMap> make_lazy_reverse_dijkstra(
+    const Graph &G, Vertex t, WeightMap weight, IndexMap index,
+    Length max_radius = std::numeric_limits<Length>::max()) {
+  return {G, t, weight, index, max_radius};
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_LAZY_REVERSE_DIJKSTRA_HPP
@@ -0,0 +1,361 @@
+/**
+ * @file many_to_many.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_HPP
+#define ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/routing_kernels/details/many_to_many_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                              Distance table
+//===----------------------------------------------------------------------===//
+/**
+ * A dense table of the distances from a list of sources to a list of
+ * targets, filled by many_to_many().
+ *
+ * Optionally, the table keeps for each pair the index of a vertex on one of
+ * its shortest paths, where the forward and backward searches met: a
+ * shortest path can then be unpacked as a shortest path from the source to
+ * the middle vertex followed by one from the middle vertex to the target.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class distance_table {
+public:
+  /**
+   * The distance of unreachable pairs.
+   */
+  static constexpr Length inf = std::numeric_limits<Length>::max();
+
+  /**
+   * Construct a table where every pair is unreachable.
+   *
+   * @param num_sources The number of sources.
+   * @param num_targets The number of targets.
+   * @param keep_middles Whether to record middle vertices.
+   */
+  distance_table(std::size_t num_sources, std::size_t num_targets,
+                 bool keep_middles)
+      : rows{num_sources}, columns{num_targets}, keep_middles{keep_middles},
+        distances_(num_sources * num_targets, inf),
+        middles(keep_middles ? num_sources * num_targets : 0,
+                details::ch_none) {}
+
+  /**
+   * @return The number of sources.
+   */
+  std::size_t num_sources() const { return rows; }
+  /**
+   * @return The number of targets.
+   */
+  std::size_t num_targets() const { return columns; }
+  /**
+   * @return Whether middle vertices are recorded.
+   */
+  bool has_middles() const { return keep_middles; }
+
+  /**
+   * @param i The position of a source.
+   * @param j The position of a target.
+   * @return The distance from source @p i to target @p j, or inf.
+   */
+  Length distance(std::size_t i, std::size_t j) const {
+    return distances_[i * columns + j];
+  }
+  /**
+   * @param i The position of a source.
+   * @param j The position of a target.
+   * @return Whether target @p j is reachable from source @p i.
+   */
+  bool reachable(std::size_t i, std::size_t j) const {
+    return distance(i, j) != inf;
+  }
+  /**
+   * @param i The position of a source.
+   * @param j The position of a target.
+   * @return The index of a vertex on a shortest path from source @p i to
+   *         target @p j, or an empty optional if the pair is unreachable or
+   *         middle vertices are not recorded.
+   */
+  std::optional<std::size_t> middle(std::size_t i, std::size_t j) const {
+    if (!keep_middles || !reachable(i, j)) {
+      return {};
+    }
+    return middles[i * columns + j];
+  }
+  /**
+   * @return The distances, row by row.
+   */
+  std::vector<Length> const &distances() const { return distances_; }
+
+  /**
+   * Lower the distance of a pair to @p d, through vertex index @p m.
+   */
+  void relax(std::size_t i, std::size_t j, Length d, std::size_t m) {
+    auto k = i * columns + j;
+    if (d < distances_[k]) {
+      distances_[k] = d;
+      if (keep_middles) {
+        middles[k] = m;
+      }
+    }
+  }
+
+private:
+  std::size_t rows;
+  std::size_t columns;
+  bool keep_middles;
+  std::vector<Length> distances_;
+  std::vector<std::size_t> middles;
+};
+
+//===----------------------------------------------------------------------===//
+//                         Many-to-many workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory many_to_many() works on, reusable by any number of
+ * computations on the same graph, or on filtered views of it. Reusing it
+ * saves allocating O(|V|) arrays per computation, which dominates small,
+ * bounded ones such as those of ESX priorities. A workspace is not
+ * thread-safe: use one per thread.
+ *
+ * @tparam Length The edge weight type.
+ * @tparam Vertex The vertex descriptor.
+ */
+template <typename Length, typename Vertex = std::size_t>
+class ManyToManyWorkspace {
+public:
+  /**
+   * Construct a new ManyToManyWorkspace for graphs of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit ManyToManyWorkspace(std::size_t n) : search_{n} {}
+
+  /**
+   * @return The state of the searches.
+   */
+  details::BucketSearch<Length> &search() { return search_; }
+  /**
+   * @return The buckets of the vertices.
+   */
+  details::bucket_index<Length> &buckets() { return buckets_; }
+
+  /**
+   * @return The vertex of each index of @p G, computed on first use.
+   */
+  template <typename Graph, typename IndexMap>
+  std::vector<Vertex> const &vertices_of(const Graph &G, IndexMap index) {
+    if (vertex.size() != num_vertices(G)) {
+      vertex.resize(num_vertices(G));
+      for (auto [it, end] = vertices(G); it != end; ++it) {
+        vertex[get(index, *it)] = *it;
+      }
+    }
+    return vertex;
+  }
+
+private:
+  details::BucketSearch<Length> search_;
+  details::bucket_index<Length> buckets_;
+  std::vector<Vertex> vertex;
+};
+
+//===----------------------------------------------------------------------===//
+//                         Many-to-many algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Compute the distances from every vertex in @p sources to every vertex in
+ * @p targets with the bucket-based algorithm.
+ *
+ * This implementation refers to the following publication:
+ *
+ * Sebastian Knopp, Peter Sanders, Dominik Schultes, Frank Schulz and Dorothea
+ * Wagner, Computing Many-to-Many Shortest Paths Using Highway Hierarchies, In
+ * Proc. of the 9th Workshop on Algorithm Engineering and Experiments (ALENEX)
+ * (2007)
+ *
+ * A backward search runs from each target, a forward search from each
+ * source: |S| + |T| searches instead of |S| x |T|. On a plain graph every
+ * search is a full Dijkstra's search, unless @p radius bounds it: pairs
+ * farther apart than @p radius are then reported unreachable.
+ *
+ * @tparam Graph A Boost::BidirectionalGraph and Boost::VertexListGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @param G The graph.
+ * @param sources The sources.
+ * @param targets The targets.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param keep_middles Whether to record middle vertices.
+ * @param radius The maximum distance of interest.
+ * @return The distance table of @p sources x @p targets.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+distance_table<Length>
+many_to_many(const Graph &G, std::vector<Vertex> const &sources,
+             std::vector<Vertex> const &targets, WeightMap weight,
+             IndexMap index, bool keep_middles = false,
+             Length radius = std::numeric_limits<Length>::max()) {
+  auto workspace = ManyToManyWorkspace<Length, Vertex>{num_vertices(G)};
+  return many_to_many(G, sources, targets, weight, index, workspace,
+                      keep_middles, radius);
+}
+
+/**
+ * Compute the distances from every vertex in @p sources to every vertex in
+ * @p targets, running on a reusable ManyToManyWorkspace.
+ *
+ * @see many_to_many(const Graph &G, std::vector<Vertex> const &sources,
+ *                   std::vector<Vertex> const &targets, WeightMap weight,
+ *                   IndexMap index, bool keep_middles, Length radius)
+ *
+ * @param workspace The memory to run the searches on, for the vertices of
+ *        @p G.
+ */
+template <typename Graph, typename WeightMap, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+distance_table<Length>
+many_to_many(const Graph &G, std::vector<Vertex> const &sources,
+             std::vector<Vertex> const &targets, WeightMap weight,
+             IndexMap index, ManyToManyWorkspace<Length, Vertex> &workspace,
+             bool keep_middles = false,
+             Length radius = std::numeric_limits<Length>::max()) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto const &vertex = workspace.vertices_of(G, index);
+  auto forward_arcs = [&](std::size_t u, auto &&relax) {
+    for (auto [it, end] = out_edges(vertex[u], G); it != end; ++it) {
+      relax(get(index, target(*it, G)), get(weight, *it));
+    }
+  };
+  auto backward_arcs = [&](std::size_t u, auto &&relax) {
+    for (auto [it, end] = in_edges(vertex[u], G); it != end; ++it) {
+      relax(get(index, source(*it, G)), get(weight, *it));
+    }
+  };
+
+  auto table =
+      distance_table<Length>{sources.size(), targets.size(), keep_middles};
+  details::bucket_many_to_many(num_vertices(G),
+                               details::vertex_indices(sources, index),
+                               details::vertex_indices(targets, index),
+                               forward_arcs, backward_arcs, radius, table,
+                               workspace.search(), workspace.buckets());
+  return table;
+}
+
+/**
+ * Compute the distances from every vertex in @p sources to every vertex in
+ * @p targets of a `PropertyGraph`, using its `boost::edge_weight_t` and
+ * `boost::vertex_index_t` properties.
+ *
+ * @see many_to_many(const Graph &G, std::vector<Vertex> const &sources,
+ *                   std::vector<Vertex> const &targets, WeightMap weight,
+ *                   IndexMap index, bool keep_middles, Length radius)
+ */
+template <typename PropertyGraph,
+          typename Vertex = vertex_of_t<PropertyGraph>>
+auto many_to_many(const PropertyGraph &G, std::vector<Vertex> const &sources,
+                  std::vector<Vertex> const &targets,
+                  bool keep_middles = false) {
+  return many_to_many(G, sources, targets, get(boost::edge_weight, G),
+                      get(boost::vertex_index, G), keep_middles);
+}
+
+/**
+ * Compute the distances from every vertex in @p sources to every vertex in
+ * @p targets on a contraction_hierarchy.
+ *
+ * Backward searches only follow downward arcs and forward searches upward
+ * ones, so each of them explores a small search space and no radius is
+ * needed. Middle vertices are the vertices where the two searches met.
+ *
+ * @see many_to_many(const Graph &G, std::vector<Vertex> const &sources,
+ *                   std::vector<Vertex> const &targets, WeightMap weight,
+ *                   IndexMap index, bool keep_middles, Length radius)
+ *
+ * @param ch The contraction hierarchy.
+ * @param index The IndexMap of the graph @p ch was built on.
+ */
+template <typename Graph, typename Length, typename IndexMap,
+          typename Vertex = vertex_of_t<Graph>>
+distance_table<Length>
+many_to_many(contraction_hierarchy<Graph, Length> const &ch,
+             std::vector<Vertex> const &sources,
+             std::vector<Vertex> const &targets, IndexMap index,
+             bool keep_middles = false) {
+  auto forward_arcs = [&ch](std::size_t u, auto &&relax) {
+    for (auto [first, last] = ch.up_arcs(u); first != last; ++first) {
+      relax(first->head, first->weight);
+    }
+  };
+  auto backward_arcs = [&ch](std::size_t u, auto &&relax) {
+    for (auto [first, last] = ch.down_arcs(u); first != last; ++first) {
+      relax(first->head, first->weight);
+    }
+  };
+
+  auto table =
+      distance_table<Length>{sources.size(), targets.size(), keep_middles};
+  auto workspace = ManyToManyWorkspace<Length>{ch.num_vertices()};
+  details::bucket_many_to_many(
+      ch.num_vertices(), details::vertex_indices(sources, index),
+      details::vertex_indices(targets, index), forward_arcs, backward_arcs,
+      std::numeric_limits<Length>::max(), table, workspace.search(),
+      workspace.buckets());
+  return table;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_MANY_TO_MANY_HPP
@@ -0,0 +1,152 @@
+/**
+ * @file multi_source_dijkstra.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_HPP
+#define ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/multi_source_dijkstra_impl.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                       Multi-source Dijkstra algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Compute the distances from each vertex in @p sources to every vertex of
+ * @p G, running @p Lanes Dijkstra's searches per pass over the graph.
+ *
+ * Each vertex holds its @p Lanes tentative distances side by side, and an
+ * edge is relaxed for all of them with a single vector min. This pays off
+ * when sources are close to each other, e.g. the neighbors of an edge, a
+ * set of landmarks or depots of the same area, since their searches read
+ * the same adjacency at about the same time.
+ *
+ * Like `boost::dijkstra_shortest_paths()`, the distance of unreachable
+ * vertices is `std::numeric_limits<Length>::max()`.
+ *
+ * @tparam Lanes The number of searches per pass, e.g. 4, 8 or 16.
+ * @tparam Graph A Boost::IncidenceGraph and Boost::VertexListGraph.
+ * @tparam WeightMap The weight or "length" of each edge in the graph. The
+ *         weights must all be non-negative.
+ * @tparam IndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(G)).
+ * @tparam DistanceMaps A random access container of writable DistanceMaps.
+ * @param G The graph.
+ * @param sources The sources.
+ * @param weight The WeightMap of @p G.
+ * @param index The IndexMap of @p G.
+ * @param distances `distances[i]` receives the distances from
+ *        `sources[i]`.
+ */
+template <std::size_t Lanes = 8, typename Graph, typename WeightMap,
+          typename IndexMap, typename DistanceMaps,
+          typename Vertex = vertex_of_t<Graph>>
+void multi_source_dijkstra(const Graph &G, std::vector<Vertex> const &sources,
+                           WeightMap weight, IndexMap index,
+                           DistanceMaps &distances) {
+  using namespace boost;
+  using Length = value_of_t<WeightMap>;
+  static_assert(Lanes > 0, "A multi-source search needs at least one lane");
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto n = num_vertices(G);
+  auto vertex = std::vector<Vertex>(n);
+  for (auto [it, end] = vertices(G); it != end; ++it) {
+    vertex[get(index, *it)] = *it;
+  }
+  auto roots = std::vector<std::size_t>{};
+  roots.reserve(sources.size());
+  for (auto s : sources) {
+    roots.push_back(get(index, s));
+  }
+
+  auto distance = std::vector<details::distance_lanes<Length, Lanes>>(n);
+  auto fringe = details::d_ary_heap<Length>{n};
+  for (std::size_t batch = 0; batch < roots.size(); batch += Lanes) {
+    auto first = roots.data() + batch;
+    auto last = roots.data() + std::min(batch + Lanes, roots.size());
+    details::multi_source_search(G, weight, index, vertex, first, last,
+                                 distance, fringe);
+
+    for (std::size_t l = 0; first + l != last; ++l) {
+      auto &distance_map = distances[batch + l];
+      for (std::size_t v = 0; v < n; ++v) {
+        put(distance_map, vertex[v], distance[v].lane[l]);
+      }
+    }
+  }
+}
+
+/**
+ * Compute the distances from each vertex in @p sources to every vertex of
+ * @p G, @p Lanes sources per pass.
+ *
+ * @see multi_source_dijkstra(const Graph &G,
+ *        std::vector<Vertex> const &sources, WeightMap weight,
+ *        IndexMap index, DistanceMaps &distances)
+ *
+ * @return For each source, the distances of every vertex by vertex index.
+ */
+template <std::size_t Lanes = 8, typename Graph, typename WeightMap,
+          typename IndexMap, typename Vertex = vertex_of_t<Graph>,
+          typename Length = value_of_t<WeightMap>>
+std::vector<std::vector<Length>>
+multi_source_distances(const Graph &G, std::vector<Vertex> const &sources,
+                       WeightMap weight, IndexMap index) {
+  using DistanceMap =
+      boost::iterator_property_map<typename std::vector<Length>::iterator,
+                                   IndexMap>;
+  auto result = std::vector<std::vector<Length>>(
+      sources.size(), std::vector<Length>(num_vertices(G)));
+  auto maps = std::vector<DistanceMap>{};
+  maps.reserve(sources.size());
+  for (auto &row : result) {
+    maps.push_back(boost::make_iterator_property_map(row.begin(), index));
+  }
+  multi_source_dijkstra<Lanes>(G, sources, weight, index, maps);
+  return result;
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_MULTI_SOURCE_DIJKSTRA_HPP
@@ -0,0 +1,248 @@
+/**
+ * @file parallel_bidirectional_dijkstra.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_HPP
+#define ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/details/bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/details/parallel_bidirectional_dijkstra_impl.hpp>
+#include <arlib/routing_kernels/queue_policies.hpp>
+#include <arlib/routing_kernels/visitor.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <limits>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                Parallel Bidirectional Dijkstra algorithm
+//===----------------------------------------------------------------------===//
+/**
+ * Bidirectional Dijkstra running the forward and the backward searches
+ * concurrently, on the calling thread and on a second thread respectively.
+ *
+ * The two searches share the best source-target distance and its meeting
+ * vertex. Each one publishes the minimum key of its fringe once it is done
+ * relaxing a vertex, and the visitor terminating condition is evaluated on
+ * these published keys, which can only lag behind from below: the search never
+ * stops before the shortest path has been found. Calls to @p visitor are
+ * serialized, so any BiDijkstraVisitor, e.g. UninformedBiPrunerVisitor, can be
+ * used as is.
+ *
+ * @p weight and @p weight_b are read concurrently, so they must be safe to
+ * read from two threads.
+ *
+ * @see bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                             PredecessorMap predecessor, DistanceMap distance,
+ *                             WeightMap weight, const BackGraph &G_b,
+ *                             BackPredecessorMap predecessor_b,
+ *                             BackDistanceMap distance_b,
+ *                             BackWeightMap weight_b,
+ *                             BiDijkstraVisitor<BiDijkstraVisitorImpl>
+ *                                 &visitor,
+ *                             direction_policy policy)
+ *
+ * @tparam Graph A Boost::VertexAndEdgeListGraph
+ * @tparam PredecessorMap The PredecessorMap for the forward step.
+ * @tparam DistanceMap The DistanceMap for the forward step.
+ * @tparam WeightMap The WeightMap for the forward step.
+ * @tparam BackGraph A boost::reverse_graph<Graph>
+ * @tparam BackPredecessorMap A PredecessorMap of a boost::reverse_graph<Graph>
+ * @tparam BackDistanceMap A DistanceMap of a boost::reverse_graph<Graph>
+ * @tparam BackWeightMap A WeightMap of a boost::reverse_graph<Graph>
+ * @tparam BiDijkstraVisitorImpl An implementation of a BiDijkstraVisitor.
+ * @tparam Vertex a vertex_descriptor.
+ * @tparam QueuePolicy The priority queue of the fringes, e.g.
+ *         radix_heap_policy for integer weights. Defaults to a 4-ary heap.
+ * @param G The graph.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @param predecessor The PredecessorMap for the forward step.
+ * @param distance The DistanceMap for the forward step.
+ * @param weight The WeightMap for the forward step.
+ * @param G_b A boost::reverse_graph<Graph> of @p G.
+ * @param predecessor_b The PredecessorMap for the backward step.
+ * @param distance_b The DistanceMap for the backward step.
+ * @param weight_b The WeightMap for the backward step.
+ * @param visitor An implementation of a BiDijkstraVisitor.
+ */
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackPredecessorMap,
+          typename BackDistanceMap, typename BackWeightMap,
+          typename BiDijkstraVisitorImpl, typename Vertex = vertex_of_t<Graph>>
+void parallel_bidirectional_dijkstra(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    DistanceMap distance, WeightMap weight, const BackGraph &G_b,
+    BackPredecessorMap predecessor_b, BackDistanceMap distance_b,
+    BackWeightMap weight_b, BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor) {
+  using namespace boost;
+  using Length = typename property_traits<DistanceMap>::value_type;
+  using Edge = edge_of_t<Graph>;
+  using RevEdge = edge_of_t<boost::reverse_graph<Graph>>;
+
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<BackGraph>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
+
+  // Initialize distance structures
+  details::init_distance_vector(G, distance);
+  details::init_distance_vector(G_b, distance_b);
+
+  // Initialize shortest path trees (forward and backward)
+  predecessor[s] = s;
+  predecessor_b[t] = t;
+
+  auto index = get(vertex_index, G);
+  using Search = details::ParallelBiDijkstraSearch<
+      Vertex, Length, queue_of_t<QueuePolicy, Length>>;
+  auto forward = Search{num_vertices(G)};
+  auto backward = Search{num_vertices(G)};
+  auto [meeting, st_distance] = details::parallel_bi_dijkstra_search(
+      G, s, t, weight, G_b, weight_b, index, forward, backward, visitor,
+      [&distance](Vertex v, Length d) { distance[v] = d; },
+      [&predecessor](Vertex w, Vertex v, const auto &) { predecessor[w] = v; },
+      [&distance_b](Vertex v, Length d) { distance_b[v] = d; },
+      [&predecessor_b](Vertex w, Vertex v, const auto &) {
+        predecessor_b[w] = v;
+      });
+  (void)st_distance;
+
+  // Fill predecessor map
+  details::fill_predecessor(predecessor, index, s, t, meeting, forward,
+                            backward);
+}
+
+/**
+ * Parallel Bidirectional Dijkstra.
+ *
+ * This overload does not need a PredecessorMap nor a DistanceMap for the
+ * backward step.
+ *
+ * @see parallel_bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                                      PredecessorMap predecessor,
+ *                                      DistanceMap distance, WeightMap weight,
+ *                                      const BackGraph &G_b,
+ *                                      BackPredecessorMap predecessor_b,
+ *                                      BackDistanceMap distance_b,
+ *                                      BackWeightMap weight_b,
+ *                                      BiDijkstraVisitor<BiDijkstraVisitorImpl>
+ *                                          &visitor)
+ *
+ * @tparam BackIndexMap This maps each vertex to an integer in the range [0,
+ *         num_vertices(g)). The type VertexIndexMap must be a model of
+ *         Readable Property Map. The value type of the map must be an integer
+ *         type. The vertex descriptor type of the graph needs to be usable as
+ *         the key type of the map.
+ */
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename BackIndexMap,
+          typename BiDijkstraVisitorImpl, typename Vertex = vertex_of_t<Graph>>
+void parallel_bidirectional_dijkstra(
+    const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+    DistanceMap distance, WeightMap weight, const BackGraph &G_b,
+    BackWeightMap weight_b, BackIndexMap index_map_b,
+    BiDijkstraVisitor<BiDijkstraVisitorImpl> &visitor) {
+  using namespace boost;
+  using Edge = typename graph_traits<Graph>::edge_descriptor;
+  using RevEdge =
+      typename graph_traits<boost::reverse_graph<Graph>>::edge_descriptor;
+  using Length = typename property_traits<DistanceMap>::value_type;
+
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<BackGraph>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<WeightMap, Edge>));
+  BOOST_CONCEPT_ASSERT((ReadablePropertyMapConcept<BackWeightMap, RevEdge>));
+
+  details::init_distance_vector(G, distance);
+  predecessor[s] = s;
+
+  using Search = details::ParallelBiDijkstraSearch<
+      Vertex, Length, queue_of_t<QueuePolicy, Length>>;
+  auto forward = Search{num_vertices(G)};
+  auto backward = Search{num_vertices(G)};
+  auto no_op = details::bi_dijkstra_no_op{};
+  auto [meeting, st_distance] = details::parallel_bi_dijkstra_search(
+      G, s, t, weight, G_b, weight_b, index_map_b, forward, backward, visitor,
+      [&distance](Vertex v, Length d) { distance[v] = d; },
+      [&predecessor](Vertex w, Vertex v, const auto &) { predecessor[w] = v; },
+      no_op, no_op);
+  (void)st_distance;
+
+  details::fill_predecessor(predecessor, index_map_b, s, t, meeting, forward,
+                            backward);
+}
+
+/**
+ * Parallel Bidirectional Dijkstra.
+ *
+ * This overload does not need a PredecessorMap nor a DistanceMap for the
+ * backward step nor a BiDijkstraVisitor. This simply runs Bidirectional
+ * Dijkstra on two threads.
+ *
+ * @see parallel_bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+ *                                      PredecessorMap predecessor,
+ *                                      DistanceMap distance, WeightMap weight,
+ *                                      const BackGraph &G_b,
+ *                                      BackPredecessorMap predecessor_b,
+ *                                      BackDistanceMap distance_b,
+ *                                      BackWeightMap weight_b,
+ *                                      BiDijkstraVisitor<BiDijkstraVisitorImpl>
+ *                                          &visitor)
+ */
+template <typename QueuePolicy = d_ary_heap_policy<>, typename Graph,
+          typename PredecessorMap, typename DistanceMap, typename WeightMap,
+          typename BackGraph, typename BackWeightMap, typename BackIndexMap,
+          typename Vertex = vertex_of_t<Graph>>
+void parallel_bidirectional_dijkstra(const Graph &G, Vertex s, Vertex t,
+                                     PredecessorMap predecessor,
+                                     DistanceMap distance, WeightMap weight,
+                                     const BackGraph &G_b,
+                                     BackWeightMap weight_b,
+                                     BackIndexMap index_map_b) {
+  auto visitor = IdentityBiDijkstraVisitor{};
+  parallel_bidirectional_dijkstra<QueuePolicy>(G, s, t, predecessor, distance,
+                                               weight, G_b, weight_b,
+                                               index_map_b, visitor);
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_PARALLEL_BIDIRECTIONAL_DIJKSTRA_HPP
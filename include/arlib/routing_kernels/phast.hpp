@@ -0,0 +1,293 @@
+/**
+ * @file phast.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_PHAST_HPP
+#define ALTERNATIVE_ROUTING_LIB_PHAST_HPP
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/phast_impl.hpp>
+#include <arlib/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                    PHAST (Hardware-Accelerated Shortest path Trees)
+//===----------------------------------------------------------------------===//
+
+/**
+ * A contraction hierarchy laid out for one-to-all searches.
+ *
+ * This implementation refers to the following publication:
+ * Daniel Delling, Andrew V. Goldberg, Andreas Nowatzyk and Renato F.
+ * Werneck, PHAST: Hardware-Accelerated Shortest Path Trees, Journal of
+ * Parallel and Distributed Computing, 73(7), pp. 940-952, 2013.
+ *
+ * Vertices are renumbered by sweep position: by level in the hierarchy,
+ * top first, then by decreasing rank. Every vertex keeps the arcs joining it
+ * to the vertices above it, in both directions, with the positions of their
+ * other end. A sweep is then one pass over these arrays in memory order.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class phast_hierarchy {
+public:
+  phast_hierarchy() = default;
+  /**
+   * Construct a new phast_hierarchy object.
+   *
+   * @param order The vertex index at each sweep position.
+   * @param levels The first position of each level, then the number of
+   *        vertices.
+   * @param up The arcs from each position to the positions above it.
+   * @param down The arcs to each position from the positions above it.
+   */
+  phast_hierarchy(std::vector<std::size_t> order,
+                  std::vector<std::size_t> levels,
+                  details::phast_arcs<Length> up,
+                  details::phast_arcs<Length> down)
+      : order{std::move(order)}, position(this->order.size()),
+        levels{std::move(levels)}, up{std::move(up)}, down{std::move(down)} {
+    for (std::size_t p = 0; p < this->order.size(); ++p) {
+      position[this->order[p]] = static_cast<std::uint32_t>(p);
+    }
+  }
+
+  /**
+   * @return The number of vertices.
+   */
+  std::size_t num_vertices() const { return order.size(); }
+  /**
+   * @return The number of levels of the hierarchy.
+   */
+  std::size_t num_levels() const {
+    return levels.empty() ? 0 : levels.size() - 1;
+  }
+  /**
+   * @param v A vertex index.
+   * @return The sweep position of @p v.
+   */
+  std::uint32_t position_of(std::size_t v) const { return position[v]; }
+  /**
+   * @param p A sweep position.
+   * @return The vertex index at @p p.
+   */
+  std::size_t vertex_at(std::size_t p) const { return order[p]; }
+  /**
+   * @return The first position of each level, then the number of vertices.
+   */
+  std::vector<std::size_t> const &level_offsets() const { return levels; }
+  /**
+   * @return The arcs from each position to the positions above it.
+   */
+  details::phast_arcs<Length> const &up_arcs() const { return up; }
+  /**
+   * @return The arcs to each position from the positions above it.
+   */
+  details::phast_arcs<Length> const &down_arcs() const { return down; }
+
+private:
+  std::vector<std::size_t> order;
+  std::vector<std::uint32_t> position;
+  std::vector<std::size_t> levels;
+  details::phast_arcs<Length> up;
+  details::phast_arcs<Length> down;
+};
+
+/**
+ * Lay @p ch out for PHAST sweeps.
+ *
+ * @param ch A contraction hierarchy.
+ * @return The phast_hierarchy of @p ch.
+ */
+template <typename Graph, typename Length>
+phast_hierarchy<Length>
+build_phast_hierarchy(contraction_hierarchy<Graph, Length> const &ch) {
+  auto n = ch.num_vertices();
+  auto order = std::vector<std::size_t>{};
+  auto levels = std::vector<std::size_t>{};
+  details::phast_order(
+      ch.ranks(),
+      [&ch](std::size_t v, auto &&visit) {
+        for (auto [it, end] = ch.up_arcs(v); it != end; ++it) {
+          visit(it->head);
+        }
+        for (auto [it, end] = ch.down_arcs(v); it != end; ++it) {
+          visit(it->head);
+        }
+      },
+      order, levels);
+
+  auto position = std::vector<std::uint32_t>(n);
+  for (std::size_t p = 0; p < n; ++p) {
+    position[order[p]] = static_cast<std::uint32_t>(p);
+  }
+  auto lay_out = [&](auto arcs_of) {
+    auto arcs = details::phast_arcs<Length>{};
+    arcs.offsets.reserve(n + 1);
+    arcs.offsets.push_back(0);
+    for (std::size_t p = 0; p < n; ++p) {
+      for (auto [it, end] = arcs_of(order[p]); it != end; ++it) {
+        arcs.ends.push_back(position[it->head]);
+        arcs.weights.push_back(it->weight);
+      }
+      arcs.offsets.push_back(arcs.ends.size());
+    }
+    return arcs;
+  };
+  auto up = lay_out([&ch](std::size_t v) { return ch.up_arcs(v); });
+  auto down = lay_out([&ch](std::size_t v) { return ch.down_arcs(v); });
+  return phast_hierarchy<Length>{std::move(order), std::move(levels),
+                                 std::move(up), std::move(down)};
+}
+
+/**
+ * The reusable state of PHAST sweeps: a queue for the upward search and the
+ * distances by sweep position.
+ *
+ * @tparam Length The edge weight type.
+ */
+template <typename Length> class PHASTWorkspace {
+public:
+  PHASTWorkspace() = default;
+  /**
+   * Construct a new workspace for graphs of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit PHASTWorkspace(std::size_t n) : fringe(n), distance(n) {}
+
+  details::d_ary_heap<Length> fringe;
+  std::vector<Length> distance; /**< By sweep position. */
+};
+
+namespace details {
+/**
+ * Run an upward search from @p root on @p upward and sweep @p downward,
+ * leaving the distances by position in @p workspace.
+ */
+template <typename Length>
+void phast_search(phast_hierarchy<Length> const &ph, std::size_t root,
+                  phast_arcs<Length> const &upward,
+                  phast_arcs<Length> const &downward,
+                  PHASTWorkspace<Length> &workspace, thread_pool *pool) {
+  auto n = ph.num_vertices();
+  workspace.fringe.resize(n);
+  workspace.distance.assign(n, std::numeric_limits<Length>::max());
+  phast_upward_search(upward, ph.position_of(root), workspace.distance,
+                      workspace.fringe);
+  phast_sweep(downward, ph.level_offsets(), workspace.distance, pool);
+}
+
+/**
+ * Scatter the distances by position of @p workspace to @p distance, by
+ * vertex index.
+ */
+template <typename Length, typename DistanceIt>
+void phast_scatter(phast_hierarchy<Length> const &ph,
+                   PHASTWorkspace<Length> const &workspace,
+                   DistanceIt distance) {
+  for (std::size_t p = 0; p < ph.num_vertices(); ++p) {
+    distance[ph.vertex_at(p)] = workspace.distance[p];
+  }
+}
+} // namespace details
+
+/**
+ * Compute the distances from the vertex of index @p s to every vertex with
+ * PHAST.
+ *
+ * An upward search from @p s, as in a contraction hierarchy query, settles
+ * the highest vertices. One sweep over the vertices, top-down, then settles
+ * each of them from its arcs coming from above. The sweep has no queue and
+ * reads memory in order; with @p pool, every large level of the hierarchy
+ * is split across its threads.
+ *
+ * The distances are the same as `boost::dijkstra_shortest_paths()` on the
+ * graph of the hierarchy, `std::numeric_limits<Length>::max()` for
+ * unreachable vertices.
+ *
+ * @param ph The hierarchy, laid out by build_phast_hierarchy().
+ * @param s The index of the source vertex.
+ * @param distance A random access iterator receiving the distance of every
+ *        vertex, by index.
+ * @param workspace The reusable state of the search.
+ * @param pool If not null, the threads to sweep on.
+ */
+template <typename Length, typename DistanceIt>
+void phast_from(phast_hierarchy<Length> const &ph, std::size_t s,
+                DistanceIt distance, PHASTWorkspace<Length> &workspace,
+                thread_pool *pool = nullptr) {
+  details::phast_search(ph, s, ph.up_arcs(), ph.down_arcs(), workspace, pool);
+  details::phast_scatter(ph, workspace, distance);
+}
+
+/**
+ * Compute the distances from every vertex to the vertex of index @p t with
+ * PHAST, on the reverse of the hierarchy.
+ *
+ * @see phast_from(phast_hierarchy<Length> const &ph, std::size_t s,
+ *                 DistanceIt distance, PHASTWorkspace<Length> &workspace,
+ *                 thread_pool *pool)
+ *
+ * @param t The index of the target vertex.
+ */
+template <typename Length, typename DistanceIt>
+void phast_to(phast_hierarchy<Length> const &ph, std::size_t t,
+              DistanceIt distance, PHASTWorkspace<Length> &workspace,
+              thread_pool *pool = nullptr) {
+  details::phast_search(ph, t, ph.down_arcs(), ph.up_arcs(), workspace, pool);
+  details::phast_scatter(ph, workspace, distance);
+}
+
+namespace details {
+template <typename T> struct is_phast_hierarchy : std::false_type {};
+template <typename Length>
+struct is_phast_hierarchy<phast_hierarchy<Length>> : std::true_type {};
+/**
+ * True if @p T is a specialization of arlib::phast_hierarchy.
+ */
+template <typename T>
+constexpr bool is_phast_hierarchy_v =
+    is_phast_hierarchy<std::decay_t<T>>::value;
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_PHAST_HPP
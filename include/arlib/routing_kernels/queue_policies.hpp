@@ -0,0 +1,131 @@
+/**
+ * @file queue_policies.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_QUEUE_POLICIES_HPP
+#define ALTERNATIVE_ROUTING_LIB_QUEUE_POLICIES_HPP
+
+#include <boost/property_map/function_property_map.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/routing_kernels/details/bucket_queue.hpp>
+#include <arlib/routing_kernels/details/d_ary_heap.hpp>
+#include <arlib/routing_kernels/details/radix_heap.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+//===----------------------------------------------------------------------===//
+//                           Priority queue policies
+//===----------------------------------------------------------------------===//
+/**
+ * The fringe of a search as an indexed d-ary heap with decrease-key. It works
+ * with any priority type and is the default of every search kernel.
+ *
+ * @tparam Arity The number of children of each heap node.
+ */
+template <std::size_t Arity = 4> struct d_ary_heap_policy {
+  template <typename Priority>
+  using queue = details::d_ary_heap<Priority, Arity>;
+};
+
+/**
+ * The fringe of a search as a monotone radix heap. It needs non-negative
+ * integer priorities that never decrease below the last popped one, which
+ * holds for Dijkstra's searches and for A* with consistent potentials.
+ */
+struct radix_heap_policy {
+  template <typename Priority> using queue = details::radix_heap<Priority>;
+};
+
+/**
+ * The fringe of a search as Dial's bucket queue, one bucket per distance. It
+ * has the same requirements as radix_heap_policy, and uses memory
+ * proportional to the largest edge weight.
+ */
+struct bucket_queue_policy {
+  template <typename Priority> using queue = details::bucket_queue<Priority>;
+};
+
+/**
+ * The queue type of @p QueuePolicy for priorities of type @p Priority.
+ */
+template <typename QueuePolicy, typename Priority>
+using queue_of_t = typename QueuePolicy::template queue<Priority>;
+
+//===----------------------------------------------------------------------===//
+//                           Fixed-point weights
+//===----------------------------------------------------------------------===//
+namespace details {
+/**
+ * Scale and round a floating-point weight to an integer.
+ */
+template <typename WeightMap, typename Integer> struct fixed_point_weight {
+  Integer operator()(typename boost::property_traits<WeightMap>::key_type const
+                         &e) const {
+    using boost::get;
+    return static_cast<Integer>(std::llround(get(weight, e) * scale));
+  }
+
+  WeightMap weight;
+  double scale;
+};
+} // namespace details
+
+/**
+ * Make a weight map of fixed-point integers out of a floating-point one, so
+ * that radix_heap_policy and bucket_queue_policy can run on graphs with
+ * `double` weights.
+ *
+ * Each weight @c w becomes `llround(w * scale)`. Distances come out scaled
+ * by @p scale, and each rounded edge is off by at most half a unit: pick
+ * @p scale as the inverse of the precision the weights actually have (e.g.
+ * 10 for decimeters over meters), and an @p Integer wide enough for the
+ * longest path.
+ *
+ * @tparam Integer The integer weight type.
+ * @param weight A readable WeightMap of non-negative floating-point weights.
+ * @param scale The number of units per weight unit.
+ * @return A readable WeightMap of @p Integer.
+ */
+template <typename Integer = std::int64_t, typename WeightMap>
+auto make_fixed_point_weight_map(WeightMap weight, double scale) {
+  using Edge = typename boost::property_traits<WeightMap>::key_type;
+  return boost::make_function_property_map<Edge, Integer>(
+      details::fixed_point_weight<WeightMap, Integer>{weight, scale});
+}
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_QUEUE_POLICIES_HPP
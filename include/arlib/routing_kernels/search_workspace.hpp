@@ -0,0 +1,422 @@
+/**
+ * @file search_workspace.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_SEARCH_WORKSPACE_HPP
+#define ALTERNATIVE_ROUTING_LIB_SEARCH_WORKSPACE_HPP
+
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/details/dijkstra_impl.hpp>
+#include <arlib/routing_kernels/queue_policies.hpp>
+#include <arlib/type_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+namespace details {
+/**
+ * The tree edge slot of a SearchWorkspace which records no edges.
+ */
+struct no_tree_edge {};
+} // namespace details
+
+//===----------------------------------------------------------------------===//
+//                            Search workspace
+//===----------------------------------------------------------------------===//
+/**
+ * The memory the point-to-point kernels of one thread share: the distance,
+ * predecessor and visited flag of each vertex, for a forward and a backward
+ * search, together with their priority queues.
+ *
+ * Every array is generation-stamped, so a new search resets it in O(1)
+ * instead of allocating and filling O(|V|) memory. ESX and Penalty run
+ * thousands of searches per query, and with a workspace they pay for that
+ * memory once. dijkstra() and astar() run on its forward search, and
+ * bidirectional_dijkstra() and bidirectional_alt() on both directions.
+ *
+ * Given an edge type, a workspace also records the edge through which each
+ * vertex was reached, so that the kernels returning the edges of a path
+ * never look an edge up by its endpoints with `edge(u, v, G)`: a scan of
+ * the out-edges of u, which picks an arbitrary edge on multigraphs.
+ *
+ * A workspace is not thread-safe: give each worker thread its own.
+ *
+ * @tparam Vertex The vertex_descriptor.
+ * @tparam Length The weight value type.
+ * @tparam QueuePolicy The priority queue of the fringes, e.g.
+ *         radix_heap_policy for integer weights.
+ * @tparam Edge The edge_descriptor of the searched graphs, void to record
+ *         the vertices of the search trees only.
+ */
+template <typename Vertex, typename Length,
+          typename QueuePolicy = d_ary_heap_policy<>, typename Edge = void>
+class SearchWorkspace {
+public:
+  /**
+   * The workspace of the bidirectional kernels.
+   */
+  using Bidirectional = BiDijkstraWorkspace<Vertex, Length, QueuePolicy>;
+  /**
+   * The state of one search direction.
+   */
+  using Search = typename Bidirectional::Search;
+  /**
+   * Whether the edges of the search trees are recorded.
+   */
+  static constexpr bool records_edges = !std::is_void_v<Edge>;
+  /**
+   * The type of a recorded search tree edge.
+   */
+  using TreeEdge =
+      std::conditional_t<records_edges, Edge, details::no_tree_edge>;
+
+  SearchWorkspace() = default;
+  /**
+   * Construct a new SearchWorkspace for graphs of @p n vertices.
+   *
+   * @param n The number of vertices.
+   */
+  explicit SearchWorkspace(std::size_t n)
+      : searches{n}, forward_tree(records_edges ? n : 0),
+        backward_tree(records_edges ? n : 0) {}
+
+  /**
+   * @return The state of the one-directional searches, which is also the
+   *         forward search of bidirectional().
+   */
+  Search &search() { return searches.forward_search(); }
+  /**
+   * @return The state of the one-directional searches.
+   */
+  const Search &search() const { return searches.forward_search(); }
+  /**
+   * @return This workspace, for bidirectional_dijkstra() and
+   *         bidirectional_alt().
+   */
+  Bidirectional &bidirectional() { return searches; }
+
+  /**
+   * @param i A vertex index.
+   * @return true if the last search reached the vertex of index @p i.
+   */
+  bool visited(std::size_t i) const { return search().labels.contains(i); }
+  /**
+   * @param i A vertex index.
+   * @return The distance of the vertex of index @p i from the root of the
+   *         last search, infinity if it was not visited.
+   */
+  Length distance(std::size_t i) const {
+    return search().labels[i].distance;
+  }
+  /**
+   * @pre visited(i)
+   * @param i A vertex index.
+   * @return The parent of the vertex of index @p i in the last search tree.
+   */
+  Vertex predecessor(std::size_t i) const {
+    return search().labels[i].parent;
+  }
+
+  /**
+   * A read-only PredecessorMap of the last search tree, valid until the
+   * next search.
+   *
+   * @param index The IndexMap of the searched graph.
+   */
+  template <typename IndexMap> auto predecessor_map(IndexMap index) const {
+    return boost::make_function_property_map<Vertex>(
+        [this, index](Vertex v) { return predecessor(get(index, v)); });
+  }
+
+  /**
+   * The edge through which the forward search last reached each vertex, by
+   * vertex index. Entries are not reset between searches: only those of
+   * the vertices on the last path found are meaningful.
+   */
+  std::vector<TreeEdge> &forward_edges() { return forward_tree; }
+  /**
+   * The edge through which the backward search last reached each vertex, by
+   * vertex index, as an edge of the forward graph.
+   *
+   * @see forward_edges()
+   */
+  std::vector<TreeEdge> &backward_edges() { return backward_tree; }
+
+private:
+  Bidirectional searches;
+  std::vector<TreeEdge> forward_tree;
+  std::vector<TreeEdge> backward_tree;
+};
+
+/**
+ * The SearchWorkspace of the kernels returning the edges of paths of
+ * @p Graph, which records the edges of its search trees.
+ *
+ * @tparam Graph The graph type.
+ * @tparam Length The weight value type.
+ */
+template <typename Graph, typename Length = length_of_t<Graph>>
+using PathWorkspace = SearchWorkspace<vertex_of_t<Graph>, Length,
+                                      d_ary_heap_policy<>, edge_of_t<Graph>>;
+
+//===----------------------------------------------------------------------===//
+//                     Point-to-point algorithms on a workspace
+//===----------------------------------------------------------------------===//
+/**
+ * Dijkstra's algorithm from @p s, stopping as soon as @p t is settled, on
+ * the forward search of a SearchWorkspace.
+ *
+ * @see dijkstra(const Graph &G, Vertex s, Vertex t,
+ *               PredecessorMap predecessor, WeightMap weight, IndexMap index,
+ *               DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace)
+ *
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename IndexMap, typename Vertex, typename Length,
+          typename QueuePolicy, typename Edge>
+Length
+dijkstra(const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+         WeightMap weight, IndexMap index,
+         SearchWorkspace<Vertex, Length, QueuePolicy, Edge> &workspace) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto &search = workspace.search();
+  auto distance = details::point_to_point_search(
+      G, s, t, weight, index, details::zero_potential{}, search);
+  details::fill_predecessor(predecessor, index, s, t, search);
+  return distance;
+}
+
+/**
+ * A* from @p s to @p t, guided by the consistent @p heuristic, on the
+ * forward search of a SearchWorkspace.
+ *
+ * @see astar(const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+ *            WeightMap weight, IndexMap index, Heuristic const &heuristic,
+ *            DijkstraWorkspace<Vertex, Length, QueuePolicy> &workspace)
+ *
+ * @throw details::target_not_found if @p t is not reachable from @p s.
+ * @return The distance from @p s to @p t.
+ */
+template <typename Graph, typename PredecessorMap, typename WeightMap,
+          typename IndexMap, typename Heuristic, typename Vertex,
+          typename Length, typename QueuePolicy, typename Edge>
+Length astar(const Graph &G, Vertex s, Vertex t, PredecessorMap predecessor,
+             WeightMap weight, IndexMap index, Heuristic const &heuristic,
+             SearchWorkspace<Vertex, Length, QueuePolicy, Edge> &workspace) {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((IncidenceGraphConcept<Graph>));
+  BOOST_CONCEPT_ASSERT((VertexListGraphConcept<Graph>));
+
+  auto &search = workspace.search();
+  auto distance =
+      details::point_to_point_search(G, s, t, weight, index, heuristic, search);
+  details::fill_predecessor(predecessor, index, s, t, search);
+  return distance;
+}
+
+namespace details {
+/**
+ * Search a shortest path from @p s to @p t keyed by `distance + potential`
+ * on @p workspace, and list its edges in @p G_path.
+ *
+ * If @p workspace records edges the path is read off the search tree,
+ * otherwise its edges are looked up by their endpoints.
+ *
+ * @param G The graph to search, e.g. a filtered view of @p G_path, sharing
+ *        its edge descriptors.
+ * @param G_path The graph the path edges belong to.
+ * @param radius The greatest length of a path to look for.
+ * @return The edges of the path, an empty optional if @p t is not
+ *         reachable from @p s within @p radius.
+ */
+template <typename Graph, typename PathGraph, typename WeightMap,
+          typename IndexMap, typename Potential, typename Vertex,
+          typename Length, typename QueuePolicy, typename TreeEdge,
+          typename Edge = edge_of_t<PathGraph>>
+std::optional<std::vector<Edge>> workspace_shortest_path(
+    const Graph &G, const PathGraph &G_path, Vertex s, Vertex t,
+    WeightMap weight, IndexMap index, Potential const &potential,
+    SearchWorkspace<Vertex, Length, QueuePolicy, TreeEdge> &workspace,
+    Length radius = std::numeric_limits<Length>::max()) {
+  using Workspace = SearchWorkspace<Vertex, Length, QueuePolicy, TreeEdge>;
+  if constexpr (Workspace::records_edges) {
+    auto &tree = workspace.forward_edges();
+    tree.resize(num_vertices(G));
+    try {
+      point_to_point_search(
+          G, s, t, weight, index, potential, workspace.search(),
+          [&tree, index](Vertex w, Vertex, const Edge &e) {
+            tree[get(index, w)] = e;
+          },
+          radius);
+    } catch (target_not_found &) {
+      return std::optional<std::vector<Edge>>{};
+    }
+    return std::make_optional(build_edge_list_from_tree(
+        G_path, s, t, boost::make_iterator_property_map(tree.begin(), index)));
+  } else {
+    try {
+      point_to_point_search(G, s, t, weight, index, potential,
+                            workspace.search(), bi_dijkstra_no_op{}, radius);
+    } catch (target_not_found &) {
+      return std::optional<std::vector<Edge>>{};
+    }
+    return std::make_optional(build_edge_list_from_dijkstra(
+        G_path, s, t, workspace.predecessor_map(index)));
+  }
+}
+
+/**
+ * Search a shortest path from @p s to @p t with Bidirectional Dijkstra on
+ * @p workspace, and list its edges in @p G_path, reading them off both
+ * search trees.
+ *
+ * @param G The graph to search, e.g. a filtered view of @p G_path, sharing
+ *        its edge descriptors.
+ * @param G_path The graph the path edges belong to.
+ * @param G_b The `boost::reverse_graph` of @p G.
+ * @param weight_b The WeightMap of @p G_b.
+ * @return The edges of the path from @p t back to @p s, an empty optional
+ *         if @p t is not reachable from @p s.
+ */
+template <typename Graph, typename PathGraph, typename WeightMap,
+          typename BackWeightMap, typename GRef, typename IndexMap,
+          typename Vertex, typename Length, typename QueuePolicy,
+          typename Edge>
+std::optional<std::vector<Edge>> workspace_bidirectional_path(
+    const Graph &G, const PathGraph &G_path, Vertex s, Vertex t,
+    WeightMap weight, const boost::reverse_graph<Graph, GRef> &G_b,
+    BackWeightMap weight_b, IndexMap index,
+    SearchWorkspace<Vertex, Length, QueuePolicy, Edge> &workspace) {
+  static_assert(!std::is_void_v<Edge>,
+                "The workspace must record the edges of its search trees");
+  auto &forward_tree = workspace.forward_edges();
+  auto &backward_tree = workspace.backward_edges();
+  forward_tree.resize(num_vertices(G));
+  backward_tree.resize(num_vertices(G));
+
+  auto &searches = workspace.bidirectional();
+  auto forward_edge = get_forward_edge_map(G_b);
+  auto visitor = IdentityBiDijkstraVisitor{};
+  auto no_op = bi_dijkstra_no_op{};
+  auto meeting = s;
+  try {
+    meeting =
+        bi_dijkstra_search(
+            G, s, t, weight, G_b, weight_b, index, searches.forward_search(),
+            searches.backward_search(), visitor,
+            direction_policy::alternating, no_op,
+            [&forward_tree, index](Vertex w, Vertex, const Edge &e) {
+              forward_tree[get(index, w)] = e;
+            },
+            no_op,
+            [&backward_tree, index, forward_edge](Vertex w, Vertex,
+                                                   const auto &e) {
+              backward_tree[get(index, w)] = get(forward_edge, e);
+            })
+            .first;
+  } catch (target_not_found &) {
+    return std::optional<std::vector<Edge>>{};
+  }
+
+  // Backward half, read from the meeting vertex towards t
+  auto path = std::vector<Edge>{};
+  for (auto current = meeting; current != t;) {
+    auto const &e = backward_tree[get(index, current)];
+    path.push_back(e);
+    current = target(e, G_path);
+  }
+  std::reverse(path.begin(), path.end());
+
+  // Forward half, from the meeting vertex back to s
+  for (auto current = meeting; current != s;) {
+    auto const &e = forward_tree[get(index, current)];
+    path.push_back(e);
+    current = source(e, G_path);
+  }
+  return std::make_optional(std::move(path));
+}
+
+/**
+ * Compute the shortest path from @p s to @p t with Dijkstra's algorithm on
+ * @p workspace.
+ *
+ * @return The edges of the path, an empty optional if @p t is not
+ *         reachable from @p s.
+ */
+template <typename Graph, typename EdgeWeightMap, typename Vertex,
+          typename Length, typename QueuePolicy, typename TreeEdge,
+          typename Edge = edge_of_t<Graph>>
+std::optional<std::vector<Edge>> compute_shortest_path(
+    const Graph &G, EdgeWeightMap const &weight, Vertex s, Vertex t,
+    SearchWorkspace<Vertex, Length, QueuePolicy, TreeEdge> &workspace) {
+  return workspace_shortest_path(G, G, s, t, weight,
+                                 get(boost::vertex_index, G), zero_potential{},
+                                 workspace);
+}
+
+/**
+ * Compute the shortest path from @p s to @p t with Dijkstra's algorithm.
+ *
+ * @return The edges of the path, an empty optional if @p t is not
+ *         reachable from @p s.
+ */
+template <typename Graph, typename EdgeWeightMap,
+          typename Vertex = vertex_of_t<Graph>,
+          typename Edge = edge_of_t<Graph>,
+          typename Length = value_of_t<EdgeWeightMap>>
+std::optional<std::vector<Edge>>
+compute_shortest_path(const Graph &G, EdgeWeightMap const &weight, Vertex s,
+                      Vertex t) {
+  auto workspace = PathWorkspace<Graph, Length>{num_vertices(G)};
+  return compute_shortest_path(G, weight, s, t, workspace);
+}
+} // namespace details
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_SEARCH_WORKSPACE_HPP
@@ -31,6 +31,9 @@
 #ifndef ALTERNATIVE_ROUTING_LIB_TYPES_HPP
 #define ALTERNATIVE_ROUTING_LIB_TYPES_HPP
 
+#include <stdexcept>
+#include <type_traits>
+
 /**
  * An Alternative-Routing library for Boost.Graph
  */
@@ -41,7 +44,104 @@ namespace arlib {
 enum class routing_kernels {
   dijkstra = 1, /**< Standard Dijkstra's Algorithm */
   astar,        /**< An heuristic-driven variant of Dijkstra's Algorithm*/
-  bidirectional_dijkstra /**< bidirectional_dijkstra() */
+  bidirectional_dijkstra, /**< bidirectional_dijkstra() */
+  parallel_bidirectional_dijkstra, /**< parallel_bidirectional_dijkstra() */
+  bidirectional_alt, /**< bidirectional_alt(), needs arlib::landmarks */
+  ch, /**< ch_query(), needs an arlib::contraction_hierarchy */
+  cch /**< cch_query(), needs an arlib::customizable_contraction_hierarchy */
+};
+
+/**
+ * Tag types naming the routing kernels which need no preprocessed oracle.
+ *
+ * Passing a tag instead of a routing_kernels value binds the kernel of
+ * `esx()` and `penalty()` at compile time, so that every shortest path
+ * search is a direct, inlinable call rather than a call through a
+ * `std::function`.
+ */
+namespace kernels {
+/**
+ * Tag of routing_kernels::dijkstra.
+ */
+struct dijkstra_t {
+  static constexpr routing_kernels value = routing_kernels::dijkstra;
+};
+/**
+ * Tag of routing_kernels::astar.
+ */
+struct astar_t {
+  static constexpr routing_kernels value = routing_kernels::astar;
+};
+/**
+ * Tag of routing_kernels::bidirectional_dijkstra.
+ */
+struct bidirectional_dijkstra_t {
+  static constexpr routing_kernels value =
+      routing_kernels::bidirectional_dijkstra;
+};
+/**
+ * Tag of routing_kernels::parallel_bidirectional_dijkstra.
+ */
+struct parallel_bidirectional_dijkstra_t {
+  static constexpr routing_kernels value =
+      routing_kernels::parallel_bidirectional_dijkstra;
+};
+
+inline constexpr dijkstra_t dijkstra{};
+inline constexpr astar_t astar{};
+inline constexpr bidirectional_dijkstra_t bidirectional_dijkstra{};
+inline constexpr parallel_bidirectional_dijkstra_t
+    parallel_bidirectional_dijkstra{};
+
+/**
+ * True if @p Kernel is one of the routing kernel tags.
+ */
+template <typename Kernel>
+constexpr bool is_kernel_v =
+    std::is_same_v<std::decay_t<Kernel>, dijkstra_t> ||
+    std::is_same_v<std::decay_t<Kernel>, astar_t> ||
+    std::is_same_v<std::decay_t<Kernel>, bidirectional_dijkstra_t> ||
+    std::is_same_v<std::decay_t<Kernel>, parallel_bidirectional_dijkstra_t>;
+
+/**
+ * Call @p visitor with the tag of @p algorithm, turning a runtime choice of
+ * kernel into a compile-time one.
+ *
+ * @param algorithm The routing kernel.
+ * @param visitor A callable taking any routing kernel tag.
+ * @throw std::invalid_argument if @p algorithm needs a preprocessed oracle,
+ *        and thus has no tag.
+ */
+template <typename Visitor>
+void visit(routing_kernels algorithm, Visitor &&visitor) {
+  switch (algorithm) {
+  case routing_kernels::dijkstra:
+    visitor(dijkstra);
+    break;
+  case routing_kernels::astar:
+    visitor(astar);
+    break;
+  case routing_kernels::bidirectional_dijkstra:
+    visitor(bidirectional_dijkstra);
+    break;
+  case routing_kernels::parallel_bidirectional_dijkstra:
+    visitor(parallel_bidirectional_dijkstra);
+    break;
+  default:
+    throw std::invalid_argument{
+        "Invalid algorithm. Only "
+        "[dijkstra|astar|bidirectional_dijkstra|"
+        "parallel_bidirectional_dijkstra] allowed."};
+  }
+}
+} // namespace kernels
+
+/**
+ * How bidirectional_dijkstra() picks the direction of its next step.
+ */
+enum class direction_policy {
+  alternating = 1, /**< Strictly alternate forward and backward steps. */
+  smaller_frontier /**< Step the direction whose fringe is smaller. */
 };
 } // namespace arlib
 
@@ -1,8 +1,13 @@
 #ifndef ARLIB_ERRORS_H
 #define ARLIB_ERRORS_H
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace arlib {
 struct terminator_stop_error : public std::runtime_error {
@@ -41,6 +46,76 @@ private:
   std::chrono::microseconds timeout_;
   std::chrono::time_point<std::chrono::steady_clock> t1_;
 };
+
+/**
+ * Bound the length of the alternative paths to @c stretch times the length of
+ * the shortest path, and otherwise stop when @p Terminator does.
+ *
+ * Passed in place of a terminator, it lets OnePass+ drop the labels whose A*
+ * lower bound exceeds the bound, ESX cap its searches at that radius and
+ * keep the edges whose deletion would leave no path within it, and Penalty
+ * discard the longer candidates.
+ *
+ * @tparam Terminator The terminator to wrap.
+ */
+template <typename Terminator = always_continue>
+class max_stretch : public terminator<max_stretch<Terminator>> {
+public:
+  /**
+   * @param stretch The maximum ratio of the length of an alternative path to
+   *        the length of the shortest path.
+   * @param inner The terminator to wrap.
+   * @throw std::invalid_argument if @p stretch is less than 1.
+   */
+  explicit max_stretch(double stretch, Terminator inner = Terminator{})
+      : stretch_{stretch}, inner_{std::move(inner)} {
+    if (!(stretch >= 1.0)) {
+      throw std::invalid_argument{"The maximum stretch must be at least 1."};
+    }
+  }
+
+  double stretch() const { return stretch_; }
+
+  bool should_stop() const { return inner_.should_stop(); }
+
+private:
+  double stretch_;
+  Terminator inner_;
+};
+
+namespace details {
+/**
+ * @return The maximum stretch of @p terminator if it is a max_stretch,
+ *         infinity otherwise.
+ */
+template <typename Terminator> double stretch_bound(const Terminator &) {
+  return std::numeric_limits<double>::infinity();
+}
+
+template <typename Terminator>
+double stretch_bound(const max_stretch<Terminator> &terminator) {
+  return terminator.stretch();
+}
+
+/**
+ * @return The greatest length of a path at most @p stretch times longer than
+ *         @p shortest, `std::numeric_limits<Length>::max()` if unbounded.
+ */
+template <typename Length>
+Length stretch_radius(double stretch, Length shortest) {
+  auto radius = stretch * static_cast<double>(shortest);
+  if (!(radius < static_cast<double>(std::numeric_limits<Length>::max()))) {
+    return std::numeric_limits<Length>::max();
+  }
+  if constexpr (std::is_integral_v<Length>) {
+    // Products such as 1.15 * 20 may round just below an integer
+    return static_cast<Length>(
+        std::floor(radius + 1e-9 * std::max(1.0, radius)));
+  } else {
+    return static_cast<Length>(radius);
+  }
+}
+} // namespace details
 } // namespace arlib
 
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+/**
+ * @file thread_pool.hpp
+ * @author Leonardo Arcari (leonardo1.arcari@gmail.com)
+ * @version 1.0.0
+ * @date 2018-10-28
+ *
+ * @copyright Copyright (c) 2018 Leonardo Arcari
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef ALTERNATIVE_ROUTING_LIB_THREAD_POOL_HPP
+#define ALTERNATIVE_ROUTING_LIB_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * An Alternative-Routing library for Boost.Graph
+ */
+namespace arlib {
+/**
+ * A fixed set of threads running the same task together, for the parallel
+ * kernels of arlib.
+ *
+ * run() hands a task to every worker and to the calling thread, and returns
+ * once all of them finished it. Each call is therefore a barrier: what a
+ * task wrote is visible to the next one. Workers sleep between tasks, so a
+ * pool can be built once and shared by all the queries of an application.
+ *
+ * A pool runs one task at a time: run() must not be called concurrently or
+ * from within a task.
+ */
+class thread_pool {
+public:
+  /**
+   * Start a pool of @p num_threads threads, counting the calling thread.
+   *
+   * @param num_threads The number of threads. Defaults to the number of
+   *        hardware threads. Zero is treated as one.
+   */
+  explicit thread_pool(
+      unsigned num_threads = std::max(1u, std::thread::hardware_concurrency()))
+      : workers{} {
+    num_threads = std::max(1u, num_threads);
+    workers.reserve(num_threads - 1);
+    for (unsigned id = 1; id < num_threads; ++id) {
+      workers.emplace_back([this, id]() { work(id); });
+    }
+  }
+
+  thread_pool(thread_pool const &) = delete;
+  thread_pool &operator=(thread_pool const &) = delete;
+
+  /**
+   * Stop and join the workers.
+   */
+  ~thread_pool() {
+    {
+      auto lock = std::lock_guard<std::mutex>{mutex};
+      stop = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @return The number of threads of the pool, the calling one included.
+   */
+  unsigned size() const noexcept {
+    return static_cast<unsigned>(workers.size()) + 1;
+  }
+
+  /**
+   * Run `task(id)` on every thread of the pool, with `id` in [0, size()),
+   * and wait for all of them. The calling thread runs `task(0)`.
+   *
+   * If a task throws, the first exception is rethrown once all threads are
+   * done.
+   *
+   * @param task A callable taking the unsigned id of the thread.
+   */
+  template <typename Task> void run(Task &&task) {
+    if (workers.empty()) {
+      task(0u);
+      return;
+    }
+    {
+      auto lock = std::lock_guard<std::mutex>{mutex};
+      job = [&task](unsigned id) { task(id); };
+      pending = static_cast<unsigned>(workers.size());
+      error = nullptr;
+      ++generation;
+    }
+    wake.notify_all();
+
+    auto caller_error = std::exception_ptr{};
+    try {
+      task(0u);
+    } catch (...) {
+      caller_error = std::current_exception();
+    }
+
+    auto lock = std::unique_lock<std::mutex>{mutex};
+    done.wait(lock, [this]() { return pending == 0; });
+    job = nullptr;
+    if (!caller_error) {
+      caller_error = error;
+    }
+    error = nullptr;
+    lock.unlock();
+    if (caller_error) {
+      std::rethrow_exception(caller_error);
+    }
+  }
+
+private:
+  void work(unsigned id) {
+    auto seen = std::size_t{0};
+    for (;;) {
+      auto lock = std::unique_lock<std::mutex>{mutex};
+      wake.wait(lock, [&]() { return stop || generation != seen; });
+      if (stop) {
+        return;
+      }
+      seen = generation;
+      lock.unlock();
+
+      auto task_error = std::exception_ptr{};
+      try {
+        job(id);
+      } catch (...) {
+        task_error = std::current_exception();
+      }
+
+      lock.lock();
+      if (task_error && !error) {
+        error = task_error;
+      }
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::function<void(unsigned)> job;
+  std::exception_ptr error;
+  std::size_t generation = 0;
+  unsigned pending = 0;
+  bool stop = false;
+};
+} // namespace arlib
+
+#endif // ALTERNATIVE_ROUTING_LIB_THREAD_POOL_HPP
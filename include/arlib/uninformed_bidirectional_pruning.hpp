@@ -38,13 +38,17 @@
 #include <boost/graph/properties.hpp>
 
 #include <arlib/details/arlib_utils.hpp>
+#include <arlib/query_context.hpp>
 #include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/parallel_bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/types.hpp>
 #include <arlib/routing_kernels/visitor.hpp>
 #include <arlib/type_traits.hpp>
 
 #include <arlib/details/ubp_impl.hpp>
 
 #include <limits>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
@@ -84,15 +88,18 @@ using PrunedGraph =
  * @param s The source node.
  * @param t The target node.
  * @param tau The pruning factor.
+ * @param algorithm The bidirectional search to run: either
+ *        routing_kernels::bidirectional_dijkstra or
+ *        routing_kernels::parallel_bidirectional_dijkstra.
  * @return A pruned copy of `G`.
  */
 template <typename Graph, typename WeightMap, typename RevWeightMap,
           typename Vertex = vertex_of_t<Graph>>
-PrunedGraph<Graph>
-uninformed_bidirectional_pruner(const Graph &G, WeightMap const &weight_f,
-                                boost::reverse_graph<Graph> const &rev_G,
-                                RevWeightMap const &weight_b, Vertex s,
-                                Vertex t, double tau) {
+PrunedGraph<Graph> uninformed_bidirectional_pruner(
+    const Graph &G, WeightMap const &weight_f,
+    boost::reverse_graph<Graph> const &rev_G, RevWeightMap const &weight_b,
+    Vertex s, Vertex t, double tau,
+    routing_kernels algorithm = routing_kernels::bidirectional_dijkstra) {
   using namespace boost;
   using Length = typename boost::property_traits<WeightMap>::value_type;
   using Edge = typename graph_traits<Graph>::edge_descriptor;
@@ -129,8 +136,22 @@ uninformed_bidirectional_pruner(const Graph &G, WeightMap const &weight_f,
   // Pruning visitor
   auto pruning_visitor = UninformedBiPrunerVisitor<Vertex>{tau};
 
-  bidirectional_dijkstra(G, s, t, predecessor_f, distance_f, weight_f, rev_G,
-                         predecessor_b, distance_b, weight_b, pruning_visitor);
+  switch (algorithm) {
+  case routing_kernels::bidirectional_dijkstra:
+    bidirectional_dijkstra(G, s, t, predecessor_f, distance_f, weight_f, rev_G,
+                           predecessor_b, distance_b, weight_b,
+                           pruning_visitor);
+    break;
+  case routing_kernels::parallel_bidirectional_dijkstra:
+    parallel_bidirectional_dijkstra(G, s, t, predecessor_f, distance_f,
+                                    weight_f, rev_G, predecessor_b, distance_b,
+                                    weight_b, pruning_visitor);
+    break;
+  default:
+    throw std::invalid_argument{"Invalid algorithm. Only "
+                                "[bidirectional_dijkstra|parallel_"
+                                "bidirectional_dijkstra] allowed."};
+  }
 
   // auto pruned_G = Graph{G};
   auto prd_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
@@ -179,7 +200,7 @@ uninformed_bidirectional_pruner(const Graph &G, WeightMap const &weight_f,
  *                                      &weight_f, boost::reverse_graph<Graph>
  *                                      const &rev_G, RevWeightMap const
  *                                      &weight_b, Vertex s, Vertex t, double
- *                                      tau)
+ *                                      tau, routing_kernels algorithm)
  *
  * @tparam PropertyGraph A Boost::PropertyGraph having at least one edge
  *         property with tag boost::edge_weight_t.
@@ -187,9 +208,9 @@ uninformed_bidirectional_pruner(const Graph &G, WeightMap const &weight_f,
  * @return A pruned copy of `G`.
  */
 template <typename PropertyGraph, typename Vertex = vertex_of_t<PropertyGraph>>
-PrunedGraph<PropertyGraph>
-uninformed_bidirectional_pruner(const PropertyGraph &G, Vertex s, Vertex t,
-                                double tau) {
+PrunedGraph<PropertyGraph> uninformed_bidirectional_pruner(
+    const PropertyGraph &G, Vertex s, Vertex t, double tau,
+    routing_kernels algorithm = routing_kernels::bidirectional_dijkstra) {
   using namespace boost;
   using Edge = typename graph_traits<PropertyGraph>::edge_descriptor;
 
@@ -199,7 +220,73 @@ uninformed_bidirectional_pruner(const PropertyGraph &G, Vertex s, Vertex t,
   auto weight = get(edge_weight, G);
   auto rev = make_reverse_graph(G);
   auto weight_b = get(edge_weight, rev);
-  return uninformed_bidirectional_pruner(G, weight, rev, weight_b, s, t, tau);
+  return uninformed_bidirectional_pruner(G, weight, rev, weight_b, s, t, tau,
+                                         algorithm);
+}
+
+/**
+ * An implementation of Uninformed Bidirectional Pruning for Boost::Graph,
+ * pruning with the shortest path trees of @p ctx.
+ *
+ * Since the trees of @p ctx span the whole graph, the distances from @c s
+ * and to @c t are exact for every vertex, and no search is run: a vertex
+ * other than @c s and @c t is pruned, with all its edges, if it cannot be
+ * reached from @c s, cannot reach @c t, or if the shortest path from @c s
+ * to @c t through it is longer than @p tau times the shortest one.
+ *
+ * @see uninformed_bidirectional_pruner(const Graph &G, WeightMap const
+ *                                      &weight_f, boost::reverse_graph<Graph>
+ *                                      const &rev_G, RevWeightMap const
+ *                                      &weight_b, Vertex s, Vertex t, double
+ *                                      tau, routing_kernels algorithm)
+ *
+ * @param G The input graph.
+ * @param ctx The context of the query from @c s to @c t, with its forward
+ *        tree.
+ * @param tau The pruning factor.
+ * @throw std::invalid_argument if @p ctx has no forward tree.
+ * @return A pruned copy of `G`.
+ */
+template <typename Graph, typename WeightMap>
+PrunedGraph<Graph>
+uninformed_bidirectional_pruner(const Graph &G,
+                                query_context<Graph, WeightMap> const &ctx,
+                                double tau) {
+  using namespace boost;
+  using Edge = typename graph_traits<Graph>::edge_descriptor;
+  using Length = value_of_t<WeightMap>;
+
+  if (!ctx.has_forward_tree()) {
+    throw std::invalid_argument{
+        "Pruning needs the forward tree of the query context."};
+  }
+
+  auto prd_edges = std::unordered_set<Edge, boost::hash<Edge>>{};
+  auto inf = std::numeric_limits<Length>::max();
+  auto bound = tau * static_cast<double>(ctx.shortest_distance());
+  for (auto [v_it, v_end] = vertices(G); v_it != v_end; ++v_it) {
+    auto v = *v_it;
+    if (v == ctx.source() || v == ctx.target()) {
+      continue;
+    }
+    auto d_f = ctx.distance_from_source(v);
+    auto d_b = ctx.distance_to_target(v);
+    bool should_prune =
+        d_f == inf || d_b == inf ||
+        static_cast<double>(d_f) + static_cast<double>(d_b) > bound;
+    if (should_prune) {
+      for (auto [e_it, e_end] = out_edges(v, G); e_it != e_end; ++e_it) {
+        prd_edges.insert(*e_it);
+      }
+      for (auto [e_it, e_end] = in_edges(v, G); e_it != e_end; ++e_it) {
+        prd_edges.insert(*e_it);
+      }
+    }
+  }
+
+  const auto pruned_G =
+      filtered_graph(G, details::pruned_edges{std::move(prd_edges)});
+  return pruned_G;
 }
 } // namespace arlib
 
@@ -1,44 +1,86 @@
 #include "arlib/graph_utils.hpp"
 
 namespace arlib {
+namespace {
+CSRGraph read_csr_graph_from_gr(std::string_view text) {
+  using Length = typename arlib::length_of_t<CSRGraph>;
+  auto gr = details::parse_gr<Length>(text);
+
+  // Return a CSR Graph from data
+  using VertexSize = boost::graph_traits<CSRGraph>::vertices_size_type;
+  auto G = CSRGraph{boost::edges_are_unsorted_multi_pass, gr.edges.begin(),
+                    gr.edges.end(), gr.weights.begin(),
+                    static_cast<VertexSize>(gr.nb_vertices)};
+  return G;
+}
+} // namespace
+
 CSRGraph read_csr_graph_from_string(const std::string &graph) {
-  auto ss = std::stringstream{graph};
-  std::string line{};
+  return read_csr_graph_from_gr(graph);
+}
 
-  // Drop graph type info
-  std::getline(ss, line);
+std::optional<CSRGraph> read_csr_graph_from_file(const std::string_view path) {
+  namespace fs = std::filesystem;
+  auto fs_path = fs::path(path);
 
-  // Get number of nodes and edges
-  std::getline(ss, line);
-  auto line_s = std::stringstream{line};
-  int nb_nodes, nb_edges;
-  line_s >> nb_nodes >> nb_edges;
+  if (!fs::is_regular_file(fs_path)) {
+    std::cerr << fs_path << " is not a regular file.\n";
+    return {};
+  }
 
-  // Get edges and weights
-  using Length = typename arlib::length_of_t<CSRGraph>;
-  auto edges = std::vector<std::pair<long unsigned, long unsigned>>{};
-  auto weights = std::vector<Length>{};
+  if (fs::is_empty(fs_path)) {
+    std::cerr << fs_path << " is empty.\n";
+    return {};
+  }
+
+  auto file = details::mapped_file{fs_path.string()};
+  return {read_csr_graph_from_gr(std::string_view{file.data(), file.size()})};
+}
+
+std::vector<coordinate>
+read_coordinates_from_string(const std::string &coordinates, double scale) {
+  auto ss = std::stringstream{coordinates};
+  std::string line{};
 
-  long unsigned s, t;
-  Length w;
+  auto ids = std::vector<long unsigned>{};
+  auto points = std::vector<coordinate>{};
+  std::size_t nb_nodes = 0;
+  auto line_s = std::stringstream{};
   while (std::getline(ss, line)) {
+    line_s.clear();
     line_s.str(line);
-    line_s.seekg(std::ios_base::beg);
-    line_s >> s >> t >> w;
-
-    edges.emplace_back(s, t);
-    weights.push_back(w);
+    char kind;
+    if (!(line_s >> kind)) {
+      continue;
+    }
+    if (kind == 'p') {
+      // p aux sp co <nb_nodes>
+      std::string aux, sp, co;
+      line_s >> aux >> sp >> co >> nb_nodes;
+    } else if (kind == 'v') {
+      long unsigned id;
+      double x, y;
+      line_s >> id >> x >> y;
+      ids.push_back(id);
+      points.push_back(coordinate{x * scale, y * scale});
+    }
+  }
+  if (ids.empty()) {
+    return {};
   }
 
-  // Return a CSR Graph from data
-  using VertexSize = boost::graph_traits<CSRGraph>::vertices_size_type;
-  auto G =
-      CSRGraph{boost::edges_are_unsorted_multi_pass, edges.begin(), edges.end(),
-               weights.begin(), static_cast<VertexSize>(nb_nodes)};
-  return G;
+  auto [min_id, max_id] = std::minmax_element(ids.begin(), ids.end());
+  auto first_id = *min_id;
+  auto result = std::vector<coordinate>(
+      std::max<std::size_t>(nb_nodes, *max_id - first_id + 1), coordinate{});
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    result[ids[i] - first_id] = points[i];
+  }
+  return result;
 }
 
-std::optional<CSRGraph> read_csr_graph_from_file(const std::string_view path) {
+std::optional<std::vector<coordinate>>
+read_coordinates_from_file(const std::string_view path, double scale) {
   namespace fs = std::filesystem;
   auto fs_path = fs::path(path);
 
@@ -56,6 +98,6 @@ std::optional<CSRGraph> read_csr_graph_from_file(const std::string_view path) {
   auto input = std::ifstream{fs_path.string()};
   buffer << input.rdbuf();
 
-  return {read_csr_graph_from_string(buffer.str())};
+  return {read_coordinates_from_string(buffer.str(), scale)};
 }
-} // namespace arlib
\ No newline at end of file
+} // namespace arlib
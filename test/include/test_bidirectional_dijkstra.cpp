@@ -5,13 +5,16 @@
 #include <boost/graph/properties.hpp>
 #include <boost/graph/reverse_graph.hpp>
 
+#include "cittastudi_graph.hpp"
 #include "test_types.hpp"
 #include "utils.hpp"
 #include <arlib/details/arlib_utils.hpp>
 #include <arlib/graph_types.hpp>
 #include <arlib/graph_utils.hpp>
 #include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/parallel_bidirectional_dijkstra.hpp>
 
+#include <algorithm>
 #include <experimental/filesystem>
 #include <memory>
 #include <string>
@@ -77,4 +80,113 @@ TEST_CASE("Bidirectional Dijkstra finds the same shortest path of "
   std::cout << "\n";
 
   REQUIRE(sp_bi == sp_uni);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Reverse edges map to their forward edge in constant time",
+          "[bidirectional_dijkstra]") {
+  using namespace boost;
+  using Graph = boost::adjacency_list<vecS, vecS, bidirectionalS, no_property,
+                                      property<edge_weight_t, int>>;
+  // Parallel edges: edge(v, u, G) cannot tell them apart.
+  auto G = Graph{3};
+  add_edge(0, 1, 5, G);
+  add_edge(0, 1, 2, G);
+  add_edge(1, 2, 3, G);
+
+  auto rev = make_reverse_graph(G);
+  auto weight = get(edge_weight, G);
+  auto forward_edge = arlib::details::get_forward_edge_map(rev);
+  auto rev_weight = arlib::details::make_reverse_weight_map(weight, rev);
+
+  for (auto e : make_iterator_range(edges(rev))) {
+    auto fe = get(forward_edge, e);
+    REQUIRE(source(fe, G) == target(e, rev));
+    REQUIRE(target(fe, G) == source(e, rev));
+    REQUIRE(get(rev_weight, e) == get(weight, fe));
+  }
+
+  auto weights = std::vector<int>{};
+  for (auto e : make_iterator_range(out_edges(1, rev))) {
+    weights.push_back(get(rev_weight, e));
+  }
+  std::sort(std::begin(weights), std::end(weights));
+  REQUIRE(weights == std::vector<int>{2, 5});
+}
+
+TEST_CASE("Bidirectional Dijkstra on a reused workspace finds shortest "
+          "distances with every direction policy",
+          "[bidirectional_dijkstra]") {
+  using namespace boost;
+  using Length = int;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto rev = make_reverse_graph(G);
+  auto weight_b = get(edge_weight, rev);
+  auto workspace = arlib::BiDijkstraWorkspace<Vertex, Length>{num_vertices(G)};
+
+  auto predecessor_vec = std::vector<Vertex>(num_vertices(G));
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+
+  auto n = num_vertices(G);
+  for (Vertex s = 0; s < n; s += n / 7) {
+    auto distance_uni = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s,
+                            distance_map(make_iterator_property_map(
+                                std::begin(distance_uni), index)));
+    for (Vertex t = 1; t < n; t += n / 11) {
+      if (distance_uni[t] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      for (auto policy : {arlib::direction_policy::alternating,
+                          arlib::direction_policy::smaller_frontier}) {
+        auto st_distance = arlib::bidirectional_dijkstra(
+            G, s, t, predecessor, weight, rev, weight_b, index, workspace,
+            policy);
+        REQUIRE(st_distance == distance_uni[t]);
+
+        auto sp = arlib::details::build_edge_list_from_dijkstra(G, s, t,
+                                                               predecessor);
+        REQUIRE(arlib::details::compute_length_from_edges(
+                    std::begin(sp), std::end(sp), weight) == distance_uni[t]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Parallel bidirectional Dijkstra finds shortest distances",
+          "[bidirectional_dijkstra]") {
+  using namespace boost;
+  using Length = int;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto rev = make_reverse_graph(G);
+  auto weight_b = get(edge_weight, rev);
+
+  auto n = num_vertices(G);
+  auto predecessor_vec = std::vector<Vertex>(n);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+  auto distance_vec = std::vector<Length>(n);
+  auto distance = make_iterator_property_map(distance_vec.begin(), index);
+
+  for (Vertex s = 0; s < n; s += n / 7) {
+    auto distance_uni = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s,
+                            distance_map(make_iterator_property_map(
+                                std::begin(distance_uni), index)));
+    for (Vertex t = 1; t < n; t += n / 11) {
+      if (distance_uni[t] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      arlib::parallel_bidirectional_dijkstra(G, s, t, predecessor, distance,
+                                             weight, rev, weight_b, index);
+      auto sp = arlib::details::build_edge_list_from_dijkstra(G, s, t,
+                                                             predecessor);
+      REQUIRE(arlib::details::compute_length_from_edges(
+                  std::begin(sp), std::end(sp), weight) == distance_uni[t]);
+    }
+  }
+}
@@ -0,0 +1,187 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/details/esx_impl.hpp>
+#include <arlib/edge_index.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/routing_kernels/ch_query.hpp>
+#include <arlib/routing_kernels/types.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("CH queries find shortest paths made of original edges",
+          "[contraction_hierarchy]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+  auto ch = arlib::build_contraction_hierarchy(G);
+  auto workspace = arlib::CHWorkspace<Length>{n};
+  REQUIRE(ch.num_vertices() == n);
+
+  for (Vertex s = 0; s < n; s += n / 7) {
+    auto distance = std::vector<Length>(n);
+    dijkstra_shortest_paths(
+        G, s,
+        distance_map(make_iterator_property_map(std::begin(distance), index)));
+    for (Vertex t = 1; t < n; t += n / 11) {
+      auto path = std::vector<arlib::test::Edge>{};
+      auto query = [&]() {
+        return arlib::ch_query(ch, s, t, index, workspace,
+                               std::back_inserter(path));
+      };
+      if (distance[t] == std::numeric_limits<Length>::max()) {
+        REQUIRE_THROWS_AS(query(), arlib::details::target_not_found);
+        continue;
+      }
+
+      auto st_distance = query();
+      REQUIRE(st_distance == distance[t]);
+      REQUIRE(arlib::details::compute_length_from_edges(
+                  std::begin(path), std::end(path), weight) == distance[t]);
+
+      // Edges chain from s to t
+      auto current = s;
+      for (auto const &e : path) {
+        REQUIRE(source(e, G) == current);
+        current = target(e, G);
+      }
+      REQUIRE(current == t);
+    }
+  }
+}
+
+TEST_CASE("Contraction hierarchies survive a write/read round trip",
+          "[contraction_hierarchy]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto ch = arlib::build_contraction_hierarchy(G);
+
+  auto buffer = std::stringstream{};
+  arlib::write_contraction_hierarchy(buffer, ch, G);
+  auto serialized = buffer.str();
+
+  auto read = arlib::read_contraction_hierarchy<Length>(buffer, G);
+  REQUIRE(read);
+  REQUIRE(read->ranks() == ch.ranks());
+  REQUIRE(read->up_arc_offsets() == ch.up_arc_offsets());
+  REQUIRE(read->down_arc_offsets() == ch.down_arc_offsets());
+  REQUIRE(read->num_arcs() == ch.num_arcs());
+
+  auto index = get(boost::vertex_index, G);
+  auto workspace = arlib::CHWorkspace<Length>{boost::num_vertices(G)};
+  auto expected = arlib::ch_shortest_path(ch, Vertex{0}, Vertex{20}, index,
+                                          workspace);
+  auto actual = arlib::ch_shortest_path(*read, Vertex{0}, Vertex{20}, index,
+                                        workspace);
+  REQUIRE(expected == actual);
+
+  // A hierarchy of another graph is rejected
+  auto other = arlib::read_graph_from_string<Graph>(std::string(graph_gr));
+  auto mismatch = std::stringstream{serialized};
+  REQUIRE_FALSE(arlib::read_contraction_hierarchy<Length>(mismatch, other));
+}
+
+TEST_CASE("ESX running on a contraction hierarchy returns same result as "
+          "astar",
+          "[contraction_hierarchy][esx]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto ch = arlib::build_contraction_hierarchy(G);
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::esx(G, predecessors, s, t, k, theta);
+  auto res_paths = arlib::to_paths(G, predecessors, s, t);
+
+  auto predecessors_ch = arlib::multi_predecessor_map<Vertex>{};
+  arlib::esx(G, weight, predecessors_ch, s, t, k, theta, ch);
+  auto res_paths_ch = arlib::to_paths(G, predecessors_ch, s, t);
+
+  REQUIRE(res_paths.size() == res_paths_ch.size());
+  for (std::size_t i = 0; i < res_paths.size(); ++i) {
+    REQUIRE(res_paths[i].length() == res_paths_ch[i].length());
+  }
+}
+
+TEST_CASE("CH kernel matches bidirectional Dijkstra after edge deletions",
+          "[contraction_hierarchy][esx]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto ch = arlib::build_contraction_hierarchy(G);
+  Vertex s = 0, t = 20;
+
+  SECTION("Shortest paths avoid the deleted edges") {
+    using Length = arlib::length_of_t<Graph>;
+    auto deleted_edges = arlib::edge_set<Graph>{G};
+    auto cache = arlib::details::CHPathCache<Graph, Length>{num_vertices(G)};
+    auto fallback = arlib::PathWorkspace<Graph, Length>{num_vertices(G)};
+    auto length = [&](auto const &path) {
+      return arlib::details::compute_length_from_edges(path.begin(),
+                                                       path.end(), weight);
+    };
+
+    // Delete an edge of the last shortest path, as ESX does
+    for (int i = 0; i < 6; ++i) {
+      auto expected = arlib::details::bidirectional_dijkstra_shortest_path(
+          G, s, t, weight, deleted_edges);
+      auto actual = arlib::details::ch_shortest_path(
+          G, s, t, weight, ch, deleted_edges, cache, fallback);
+      REQUIRE(actual.has_value() == expected.has_value());
+      if (!expected) {
+        break;
+      }
+      REQUIRE(length(*actual) == length(*expected));
+      for (auto const &e : *actual) {
+        REQUIRE_FALSE(deleted_edges.contains(e));
+      }
+      deleted_edges.insert((*expected)[expected->size() / 2]);
+    }
+  }
+
+  SECTION("ESX alternatives match") {
+    int k = 5;
+    double theta = 0.5;
+
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors, s, t, k, theta,
+               arlib::routing_kernels::bidirectional_dijkstra);
+    auto res_paths = arlib::to_paths(G, predecessors, s, t);
+
+    auto predecessors_ch = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_ch, s, t, k, theta, ch,
+               arlib::routing_kernels::ch);
+    auto res_paths_ch = arlib::to_paths(G, predecessors_ch, s, t);
+
+    REQUIRE(res_paths.size() == res_paths_ch.size());
+    for (std::size_t i = 0; i < res_paths.size(); ++i) {
+      REQUIRE(res_paths[i].length() == res_paths_ch[i].length());
+    }
+  }
+}
@@ -0,0 +1,180 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+#include <arlib/customizable_contraction_hierarchy.hpp>
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/routing_kernels/cch_query.hpp>
+#include <arlib/routing_kernels/types.hpp>
+#include <arlib/thread_pool.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Nested dissection orders every vertex once", "[cch]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto order =
+      arlib::nested_dissection_order(G, get(boost::vertex_index, G));
+
+  REQUIRE(order.size() == boost::num_vertices(G));
+  std::sort(order.begin(), order.end());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    REQUIRE(order[i] == i);
+  }
+}
+
+TEST_CASE("CCH queries find shortest paths under any customization",
+          "[cch]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+  auto cch = arlib::build_customizable_contraction_hierarchy(G);
+  REQUIRE(cch.num_vertices() == n);
+
+  auto check = [&](auto const &weight, auto &&threads) {
+    using Weight = typename property_traits<
+        std::decay_t<decltype(weight)>>::value_type;
+    auto metric = arlib::customize(cch, weight, threads);
+    auto workspace = arlib::CCHWorkspace<Weight>{n};
+
+    for (Vertex s = 0; s < n; s += n / 7) {
+      auto distance = std::vector<Weight>(n);
+      dijkstra_shortest_paths(
+          G, s,
+          weight_map(weight).distance_map(
+              make_iterator_property_map(std::begin(distance), index)));
+      for (Vertex t = 1; t < n; t += n / 11) {
+        auto path = std::vector<arlib::test::Edge>{};
+        auto query = [&]() {
+          return arlib::cch_query(metric, s, t, index, workspace,
+                                  std::back_inserter(path));
+        };
+        if (distance[t] == std::numeric_limits<Weight>::max()) {
+          REQUIRE_THROWS_AS(query(), arlib::details::target_not_found);
+          continue;
+        }
+
+        auto st_distance = query();
+        REQUIRE(st_distance == distance[t]);
+        REQUIRE(arlib::details::compute_length_from_edges(
+                    std::begin(path), std::end(path), weight) == distance[t]);
+
+        // Edges chain from s to t
+        auto current = s;
+        for (auto const &e : path) {
+          REQUIRE(source(e, G) == current);
+          current = target(e, G);
+        }
+        REQUIRE(current == t);
+      }
+    }
+  };
+
+  SECTION("Graph weights") { check(get(edge_weight, G), 1); }
+
+  SECTION("Live weights, customized in parallel") {
+    auto weight = get(edge_weight, G);
+    auto traffic = make_function_property_map<arlib::test::Edge>(
+        [&](arlib::test::Edge const &e) {
+          return 2 * weight[e] + static_cast<Length>(source(e, G) % 5);
+        });
+    check(traffic, 4);
+  }
+
+  SECTION("Live weights, customized on a thread pool") {
+    auto weight = get(edge_weight, G);
+    auto traffic = make_function_property_map<arlib::test::Edge>(
+        [&](arlib::test::Edge const &e) {
+          return 2 * weight[e] + static_cast<Length>(source(e, G) % 3);
+        });
+    auto pool = arlib::thread_pool{3};
+    check(traffic, pool);
+  }
+}
+
+TEST_CASE("Partial customization gives the same metric as a full one",
+          "[cch]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto cch = arlib::build_customizable_contraction_hierarchy(G);
+  auto metric = arlib::customize(cch, weight);
+
+  // Some edges get longer, others shorter, round after round
+  for (std::size_t round = 1; round <= 4; ++round) {
+    auto changed = std::vector<std::size_t>{};
+    for (auto i = round; i < cch.num_edges(); i += 37) {
+      auto e = cch.edge(i);
+      put(weight, e, i % 2 == 0 ? 3 * get(weight, e) : get(weight, e) / 2);
+      changed.push_back(i);
+    }
+    metric.customize_edges(weight, changed.begin(), changed.end());
+
+    auto full = arlib::customize(cch, weight);
+    for (std::size_t a = 0; a < cch.num_arcs(); ++a) {
+      REQUIRE(metric.weight(a, true) == full.weight(a, true));
+      REQUIRE(metric.weight(a, false) == full.weight(a, false));
+    }
+  }
+}
+
+TEST_CASE("Penalty running on a CCH returns same result as dijkstra",
+          "[cch][penalty]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto cch = arlib::build_customizable_contraction_hierarchy(G);
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+  double p = 0.1, r = 0.1;
+  int max_nb_updates = 10, max_nb_steps = 100000;
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, predecessors, s, t, k, theta, p, r, max_nb_updates,
+                 max_nb_steps);
+  auto res_paths = arlib::to_paths(G, predecessors, s, t);
+
+  auto same_lengths = [&](auto &predecessors_cch) {
+    auto res_paths_cch = arlib::to_paths(G, predecessors_cch, s, t);
+    REQUIRE(res_paths.size() == res_paths_cch.size());
+    for (std::size_t i = 0; i < res_paths.size(); ++i) {
+      REQUIRE(res_paths[i].length() == res_paths_cch[i].length());
+    }
+  };
+
+  SECTION("Customized on a pool of its own") {
+    auto predecessors_cch = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_cch, s, t, k, theta, p, r,
+                   max_nb_updates, max_nb_steps, cch);
+    same_lengths(predecessors_cch);
+  }
+
+  SECTION("Customized on a given thread pool") {
+    auto pool = arlib::thread_pool{2};
+    auto predecessors_cch = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_cch, s, t, k, theta, p, r,
+                   max_nb_updates, max_nb_steps, cch, pool);
+    same_lengths(predecessors_cch);
+  }
+}
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/routing_kernels/delta_stepping.hpp>
+#include <arlib/thread_pool.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Thread pool runs a task once per thread", "[delta_stepping]") {
+  auto pool = arlib::thread_pool{4};
+  REQUIRE(pool.size() == 4);
+
+  auto runs = std::vector<int>(pool.size(), 0);
+  for (int i = 0; i < 10; ++i) {
+    pool.run([&](unsigned id) { ++runs[id]; });
+  }
+  REQUIRE(runs == std::vector<int>(pool.size(), 10));
+
+  auto throwing = [&]() {
+    pool.run([](unsigned id) {
+      if (id == 3) {
+        throw std::runtime_error{"task failed"};
+      }
+    });
+  };
+  REQUIRE_THROWS_AS(throwing(), std::runtime_error);
+
+  // The pool is still usable after a failed task
+  auto count = std::atomic<unsigned>{0};
+  pool.run([&](unsigned) { ++count; });
+  REQUIRE(count == pool.size());
+}
+
+TEST_CASE("Delta-stepping computes the same distances as Dijkstra",
+          "[delta_stepping]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  for (auto s : {Vertex{0}, Vertex{42}, static_cast<Vertex>(n - 1)}) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(
+        G, s,
+        distance_map(make_iterator_property_map(std::begin(expected), index)));
+
+    for (unsigned num_threads : {1u, 2u, 4u}) {
+      auto pool = arlib::thread_pool{num_threads};
+      // Mean weight, every edge light and every edge heavy
+      for (auto delta : {Length{}, std::numeric_limits<Length>::max() / 2,
+                         Length{1}}) {
+        REQUIRE(arlib::delta_stepping_distances(G, s, weight, index, pool,
+                                                delta) == expected);
+      }
+    }
+  }
+
+  SECTION("Distances to a target, on the reverse graph") {
+    auto pool = arlib::thread_pool{3};
+    Vertex t = 17;
+    REQUIRE(arlib::details::distance_from_target<Length>(G, t, pool) ==
+            arlib::details::distance_from_target<Length>(G, t));
+  }
+}
+
+TEST_CASE("Delta-stepping leaves unreachable vertices at infinity",
+          "[delta_stepping]") {
+  using namespace boost;
+
+  auto G = Graph{3};
+  add_edge(0, 1, 5, G);
+  auto pool = arlib::thread_pool{2};
+  auto distance = arlib::delta_stepping_distances(
+      G, Vertex{0}, get(edge_weight, G), get(vertex_index, G), pool);
+  REQUIRE(distance ==
+          std::vector<Length>{0, 5, std::numeric_limits<Length>::max()});
+}
+
+TEST_CASE("Penalty, OnePass+ and ESX on a thread pool return the same routes",
+          "[delta_stepping][penalty][onepassplus][esx]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto weight = get(edge_weight, G);
+  auto pool = arlib::thread_pool{2};
+
+  Vertex s = 0, t = 6;
+  int k = 3;
+  double theta = 0.5;
+  auto lengths = [&](auto &predecessors) {
+    auto result = std::vector<Length>{};
+    for (auto const &path : arlib::to_paths(G, predecessors, s, t)) {
+      result.push_back(path.length());
+    }
+    return result;
+  };
+
+  SECTION("Penalty") {
+    for (auto algorithm :
+         {arlib::routing_kernels::dijkstra, arlib::routing_kernels::astar}) {
+      auto expected = arlib::multi_predecessor_map<Vertex>{};
+      arlib::penalty(G, weight, expected, s, t, k, theta, 0.1, 0.1, 10, 100000,
+                     algorithm);
+      auto actual = arlib::multi_predecessor_map<Vertex>{};
+      arlib::penalty(G, weight, actual, s, t, k, theta, 0.1, 0.1, 10, 100000,
+                     pool, algorithm);
+      REQUIRE(lengths(actual) == lengths(expected));
+    }
+  }
+
+  SECTION("OnePass+") {
+    auto expected = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, expected, s, t, k, theta);
+    auto actual = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, actual, s, t, k, theta, pool);
+    REQUIRE(lengths(actual) == lengths(expected));
+  }
+
+  SECTION("ESX") {
+    for (auto algorithm :
+         {arlib::routing_kernels::dijkstra, arlib::routing_kernels::astar}) {
+      auto expected = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, weight, expected, s, t, k, theta, algorithm);
+      auto actual = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, weight, actual, s, t, k, theta, pool, algorithm);
+      REQUIRE(lengths(actual) == lengths(expected));
+    }
+  }
+}
@@ -0,0 +1,161 @@
+#include "catch.hpp"
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <arlib/details/penalty_impl.hpp>
+#include <arlib/edge_index.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/road_graph.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("dense_edge_index numbers adjacency_list edges consecutively",
+          "[edge_index]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  // Add a parallel edge
+  auto [e, ok] = edge(0, 1, G);
+  REQUIRE(ok);
+  add_edge(0, 1, get(edge_weight, G, e), G);
+
+  auto index = arlib::dense_edge_index<Graph>{G};
+  REQUIRE(index.size() == num_edges(G));
+
+  auto seen = std::vector<int>(index.size(), 0);
+  for (auto [it, last] = edges(G); it != last; ++it) {
+    auto id = get(index, *it);
+    REQUIRE(id < index.size());
+    ++seen[id];
+  }
+  REQUIRE(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+
+  // In-edge descriptors are numbered as the same out-edges
+  for (auto [v, last] = vertices(G); v != last; ++v) {
+    for (auto [it, end] = in_edges(*v, G); it != end; ++it) {
+      auto [out, out_end] = out_edges(source(*it, G), G);
+      auto position = std::find(out, out_end, *it);
+      REQUIRE(position != out_end);
+      REQUIRE(index[*it] == index[*position]);
+    }
+  }
+}
+
+TEST_CASE("dense_edge_index wraps the intrinsic edge index of road_graph",
+          "[edge_index]") {
+  using namespace boost;
+  using RoadGraph = arlib::road_graph<Length>;
+  static_assert(arlib::details::has_intrinsic_edge_index<RoadGraph>::value);
+  static_assert(!arlib::details::has_intrinsic_edge_index<Graph>::value);
+
+  auto R = arlib::read_graph_from_string<RoadGraph>(std::string(cittastudi_gr));
+  auto index = arlib::dense_edge_index<RoadGraph>{R};
+  REQUIRE(index.size() == num_edges(R));
+  for (auto [it, last] = edges(R); it != last; ++it) {
+    REQUIRE(index[*it] == get(edge_index, R, *it));
+  }
+}
+
+TEST_CASE("edge_set and edge_map are keyed by edge descriptors",
+          "[edge_index]") {
+  using namespace boost;
+  using Edge = typename graph_traits<Graph>::edge_descriptor;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto e1 = edge(0, 3, G).first;
+  auto e2 = edge(3, 5, G).first;
+  auto e3 = edge(5, 6, G).first;
+
+  SECTION("edge_set behaves as a set") {
+    auto set = arlib::edge_set<Graph>{G};
+    REQUIRE(set.empty());
+    REQUIRE(set.insert(e1));
+    REQUIRE_FALSE(set.insert(e1));
+    REQUIRE(set.insert(e2));
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.contains(e1));
+    REQUIRE(set.count(e2) == 1);
+    REQUIRE(set.count(e3) == 0);
+    REQUIRE(set.erase(e1) == 1);
+    REQUIRE(set.erase(e1) == 0);
+    REQUIRE_FALSE(set.contains(e1));
+    REQUIRE(set.size() == 1);
+    set.clear();
+    REQUIRE(set.empty());
+    REQUIRE_FALSE(set.contains(e2));
+
+    auto path = std::vector<Edge>{e1, e2, e3};
+    auto path_set = arlib::edge_set<Graph>{path.begin(), path.end(),
+                                           arlib::dense_edge_index<Graph>{G}};
+    REQUIRE(path_set.size() == 3);
+    for (auto [it, last] = edges(G); it != last; ++it) {
+      auto on_path = std::find(path.begin(), path.end(), *it) != path.end();
+      REQUIRE(path_set.contains(*it) == on_path);
+    }
+  }
+
+  SECTION("edge_map is a shared lvalue property map") {
+    auto map = arlib::edge_map<Graph, int>{G, 7};
+    auto copy = map;
+    put(map, e1, 1);
+    ++copy[e2];
+    REQUIRE(get(copy, e1) == 1);
+    REQUIRE(map[e2] == 8);
+    REQUIRE(map[e3] == 7);
+  }
+}
+
+TEST_CASE("Penalties in flat arrays match penalties in hash tables",
+          "[edge_index]") {
+  using namespace boost;
+  using Edge = typename graph_traits<Graph>::edge_descriptor;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto candidate = std::vector<Edge>{edge(0, 3, G).first, edge(3, 5, G).first,
+                                     edge(5, 6, G).first};
+  auto other = std::vector<Edge>{edge(0, 2, G).first, edge(2, 4, G).first,
+                                 edge(4, 6, G).first};
+  auto distance_s = std::vector<Length>{0, 5, 4, 3, 7, 6, 8};
+  auto distance_t = std::vector<Length>{8, 6, 7, 5, 2, 2, 0};
+  Vertex s = 0, t = 6;
+  auto p = 0.1;
+  auto r = 0.1;
+  auto bound_limit = 2;
+
+  auto weight = get(edge_weight, G);
+  auto hashed = arlib::details::penalty_functor{weight};
+  auto hashed_bounds = std::unordered_map<Edge, int, boost::hash<Edge>>{};
+  auto index = arlib::dense_edge_index<Graph>{G};
+  auto flat = arlib::details::penalty_functor{weight, index};
+  auto flat_bounds = arlib::edge_map<Graph, int>{index, 0};
+
+  for (auto const &path : {candidate, other, candidate, candidate}) {
+    arlib::details::penalize_candidate_path(path, G, s, t, p, r, hashed,
+                                            distance_s, distance_t,
+                                            hashed_bounds, bound_limit);
+    arlib::details::penalize_candidate_path(path, G, s, t, p, r, flat,
+                                            distance_s, distance_t,
+                                            flat_bounds, bound_limit);
+    for (auto [it, last] = edges(G); it != last; ++it) {
+      REQUIRE(flat(*it) == hashed(*it));
+      REQUIRE(flat_bounds[*it] ==
+              arlib::details::times_penalized(hashed_bounds, *it));
+    }
+  }
+
+  auto unchanged = flat.clone();
+  flat[candidate.front()] += 1.0;
+  REQUIRE(unchanged(candidate.front()) + 1.0 == flat(candidate.front()));
+}
@@ -20,9 +20,11 @@
 #include <kspwlo_ref/algorithms/kspwlo.hpp>
 #include <kspwlo_ref/exploration/graph_utils.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <experimental/filesystem>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
@@ -77,6 +79,27 @@ TEST_CASE("Edge priority computation", "[esx]") {
   REQUIRE(prio_n5_t == 0);
 }
 
+TEST_CASE("Edge priority computation on decimal weights", "[esx]") {
+  using namespace boost;
+  using arlib::details::compute_priority;
+  using DecimalGraph =
+      adjacency_list<vecS, vecS, bidirectionalS, no_property,
+                     property<edge_weight_t, double>>;
+  using DecimalEdge = graph_traits<DecimalGraph>::edge_descriptor;
+
+  // 0.1 + 0.2 + 0.3 is not representable: the lengths of the only path from
+  // 0 to 3, summed in different orders, differ in their last bit
+  auto G = DecimalGraph{4};
+  add_edge(0, 1, 0.1, G);
+  auto e = add_edge(1, 2, 0.2, G).first;
+  add_edge(2, 3, 0.3, G);
+  auto weight = get(edge_weight, G);
+  auto deleted_edges =
+      std::unordered_set<DecimalEdge, boost::hash<DecimalEdge>>{};
+
+  REQUIRE(compute_priority(G, e, weight, deleted_edges) == 1);
+}
+
 TEST_CASE("esx kspwlo algorithm runs on Boost::Graph", "[esx]") {
   auto G = arlib::read_graph_from_string<Graph>(std::string{graph_gr_esx});
   Vertex s = 0, t = 6;
@@ -184,6 +207,56 @@ TEST_CASE("ESX running with plain dijkstra returns same result as astar",
   }
 }
 
+TEST_CASE("ESX with a compile-time kernel returns the same result as with "
+          "its routing_kernels value",
+          "[esx]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto weight = get(edge_weight, G);
+
+  Vertex s = 0, t = 6;
+  int k = 3;
+  double theta = 0.5;
+
+  // One workspace, reused by every run on it
+  auto workspace = arlib::PathWorkspace<Graph>{num_vertices(G)};
+
+  auto same_result = [&](auto kernel) {
+    auto predecessors_rt = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors_rt, s, t, k, theta, kernel.value);
+    auto res_paths_rt = arlib::to_paths(G, predecessors_rt, s, t);
+
+    auto predecessors_ct = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors_ct, s, t, k, theta, kernel);
+    auto res_paths_ct = arlib::to_paths(G, predecessors_ct, s, t);
+
+    REQUIRE(res_paths_rt.size() == res_paths_ct.size());
+    for (std::size_t i = 0; i < res_paths_rt.size(); ++i) {
+      REQUIRE(res_paths_rt[i].length() == res_paths_ct[i].length());
+    }
+
+    auto predecessors_ws = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_ws, s, t, k, theta, kernel, workspace);
+    auto res_paths_ws = arlib::to_paths(G, predecessors_ws, s, t);
+    REQUIRE(res_paths_rt.size() == res_paths_ws.size());
+    for (std::size_t i = 0; i < res_paths_rt.size(); ++i) {
+      REQUIRE(res_paths_rt[i].length() == res_paths_ws[i].length());
+    }
+  };
+
+  same_result(arlib::kernels::dijkstra);
+  same_result(arlib::kernels::astar);
+  same_result(arlib::kernels::bidirectional_dijkstra);
+  same_result(arlib::kernels::parallel_bidirectional_dijkstra);
+
+  // Kernels needing an oracle have no tag
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  REQUIRE_THROWS_AS(arlib::esx(G, weight, predecessors, s, t, k, theta,
+                               arlib::routing_kernels::ch),
+                    std::invalid_argument);
+}
+
 TEST_CASE("ESX times-out on large graph", "[esx]") {
   using namespace boost;
   using namespace std::chrono_literals;
@@ -242,3 +315,39 @@ TEST_CASE(
     REQUIRE(res_paths_bc[i].length() == res_paths_bi[i].length());
   }
 }
+
+TEST_CASE("ESX with a maximum stretch returns no longer alternatives",
+          "[esx]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+
+  Vertex s = 0, t = 20;
+  auto k = 10;
+  auto theta = 0.7;
+  auto stretch = 1.1;
+
+  for (auto algorithm : {arlib::routing_kernels::astar,
+                         arlib::routing_kernels::dijkstra,
+                         arlib::routing_kernels::bidirectional_dijkstra}) {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors, s, t, k, theta, algorithm);
+    auto paths = arlib::to_paths(G, predecessors, s, t);
+    auto shortest = paths.front().length();
+    REQUIRE(std::any_of(paths.begin(), paths.end(), [&](auto &p) {
+      return p.length() > stretch * shortest;
+    }));
+
+    auto bounded_predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, bounded_predecessors, s, t, k, theta, algorithm,
+               arlib::max_stretch{stretch});
+    auto bounded_paths = arlib::to_paths(G, bounded_predecessors, s, t);
+    REQUIRE(bounded_paths.size() > 1);
+    REQUIRE(bounded_paths.front().length() == shortest);
+    for (auto &p : bounded_paths) {
+      REQUIRE(p.length() <= stretch * shortest);
+    }
+    REQUIRE(alternative_paths_are_dissimilar(bounded_paths,
+                                             get(edge_weight, G), theta));
+  }
+}
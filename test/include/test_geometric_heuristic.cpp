@@ -0,0 +1,195 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/esx.hpp>
+#include <arlib/geometric_heuristic.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+
+#include "test_types.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+/**
+ * A grid of side x side vertices, one unit apart, whose edge weights are
+ * at least ten times their length.
+ */
+std::pair<Graph, std::vector<arlib::coordinate>> make_grid(int side) {
+  auto G = Graph(side * side);
+  auto coordinates = std::vector<arlib::coordinate>(side * side);
+  auto rng = std::mt19937{7};
+  auto weight = std::uniform_int_distribution<Length>{10, 25};
+  for (int i = 0; i < side; ++i) {
+    for (int j = 0; j < side; ++j) {
+      auto v = i * side + j;
+      coordinates[v] = arlib::coordinate{double(j), double(i)};
+      if (j + 1 < side) {
+        boost::add_edge(v, v + 1, weight(rng), G);
+        boost::add_edge(v + 1, v, weight(rng), G);
+      }
+      if (i + 1 < side) {
+        boost::add_edge(v, v + side, weight(rng), G);
+        boost::add_edge(v + side, v, weight(rng), G);
+      }
+    }
+  }
+  return {G, coordinates};
+}
+} // namespace
+
+TEST_CASE("Coordinates are read from DIMACS .co files", "[geometric]") {
+  SECTION("1-based ids, scaled to degrees") {
+    auto co = std::string{"c A comment\n"
+                          "p aux sp co 3\n"
+                          "c Vertices\n"
+                          "v 2 -73530538 41086098\n"
+                          "v 1 -73530767 41085396\n"
+                          "v 3 -73519366 41048796\n"};
+    auto coordinates = arlib::read_coordinates_from_string(co, 1e-6);
+    REQUIRE(coordinates.size() == 3);
+    REQUIRE(coordinates[0].x == Approx(-73.530767));
+    REQUIRE(coordinates[0].y == Approx(41.085396));
+    REQUIRE(coordinates[1].x == Approx(-73.530538));
+    REQUIRE(coordinates[2].y == Approx(41.048796));
+  }
+
+  SECTION("0-based ids") {
+    auto co = std::string{"v 0 1 2\nv 1 3 4\n"};
+    auto coordinates = arlib::read_coordinates_from_string(co);
+    REQUIRE(coordinates.size() == 2);
+    REQUIRE(coordinates[0].x == 1);
+    REQUIRE(coordinates[1].y == 4);
+  }
+
+  REQUIRE_FALSE(arlib::read_coordinates_from_file(
+      "/xyz/bla/bla/come/on/cant/be/existing.co"));
+}
+
+TEST_CASE("Great-circle distances", "[geometric]") {
+  auto metric = arlib::great_circle_distance{};
+  // One degree of latitude, and of longitude on the equator
+  auto degree =
+      arlib::great_circle_distance::earth_radius * std::acos(-1.0) / 180;
+  REQUIRE(metric({9.19, 45.0}, {9.19, 46.0}) == Approx(degree));
+  REQUIRE(metric({0.0, 0.0}, {1.0, 0.0}) == Approx(degree));
+  REQUIRE(metric({0.0, 60.0}, {1.0, 60.0}) == Approx(degree / 2).epsilon(1e-3));
+  REQUIRE(metric({12.5, 41.9}, {12.5, 41.9}) == 0);
+}
+
+TEST_CASE("Geometric and max heuristics are consistent lower bounds",
+          "[geometric]") {
+  using namespace boost;
+
+  auto grid = make_grid(20);
+  auto &G = grid.first;
+  auto &coordinates = grid.second;
+  auto weight = get(edge_weight, G);
+  auto speed = arlib::max_speed(G, coordinates);
+  REQUIRE(speed == Approx(0.1));
+
+  auto lm = arlib::select_landmarks(G, 3);
+  auto n = num_vertices(G);
+  for (Vertex t = 0; t < n; t += 37) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(make_reverse_graph(G), t,
+                            distance_map(&expected[0]));
+    auto geometric = arlib::make_geometric_heuristic(G, coordinates, speed, t);
+    auto alt = arlib::make_alt_heuristic(G, lm, t);
+    auto both = arlib::make_max_heuristic(geometric, alt);
+
+    REQUIRE(geometric(t) == 0);
+    for (Vertex u = 0; u < n; ++u) {
+      REQUIRE(geometric(u) <= expected[u]);
+      REQUIRE(both(u) <= expected[u]);
+      REQUIRE(both(u) == std::max(geometric(u), alt(u)));
+      for (auto [it, end] = out_edges(u, G); it != end; ++it) {
+        auto v = target(*it, G);
+        REQUIRE(geometric(u) <= weight[*it] + geometric(v));
+        REQUIRE(both(u) <= weight[*it] + both(v));
+      }
+    }
+  }
+}
+
+TEST_CASE("OnePass+, ESX and Penalty guided by geometric bounds return the "
+          "same result as without",
+          "[geometric]") {
+  using namespace boost;
+
+  auto grid = make_grid(15);
+  auto &G = grid.first;
+  auto &coordinates = grid.second;
+  auto weight = get(edge_weight, G);
+  auto speed = arlib::max_speed(G, coordinates);
+  auto lm = arlib::select_landmarks(G, 3);
+
+  Vertex s = 3, t = 200;
+  int k = 3;
+  double theta = 0.5;
+  auto geometric = arlib::make_geometric_heuristic(G, coordinates, speed, t);
+  auto both =
+      arlib::make_max_heuristic(geometric, arlib::make_alt_heuristic(G, lm, t));
+
+  auto same_lengths = [&](auto &expected, auto &actual) {
+    auto paths = arlib::to_paths(G, expected, s, t);
+    auto geo_paths = arlib::to_paths(G, actual, s, t);
+    REQUIRE(paths.size() == geo_paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      REQUIRE(paths[i].length() == geo_paths[i].length());
+    }
+  };
+
+  SECTION("OnePass+") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, predecessors, s, t, k, theta);
+    auto predecessors_geo = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_geo, s, t, k, theta,
+                        geometric);
+    same_lengths(predecessors, predecessors_geo);
+    auto predecessors_max = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_max, s, t, k, theta, both);
+    same_lengths(predecessors, predecessors_max);
+  }
+
+  SECTION("ESX") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors, s, t, k, theta);
+    auto predecessors_geo = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_geo, s, t, k, theta, geometric);
+    same_lengths(predecessors, predecessors_geo);
+    auto predecessors_max = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_max, s, t, k, theta, both);
+    same_lengths(predecessors, predecessors_max);
+  }
+
+  SECTION("Penalty") {
+    auto p = 0.1;
+    auto r = 0.1;
+    auto bound_limit = 10;
+    auto max_nb_steps = 100000;
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps);
+    auto predecessors_geo = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_geo, s, t, k, theta, p, r,
+                   bound_limit, max_nb_steps, geometric);
+    same_lengths(predecessors, predecessors_geo);
+    auto predecessors_max = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_max, s, t, k, theta, p, r,
+                   bound_limit, max_nb_steps, both);
+    same_lengths(predecessors, predecessors_max);
+  }
+}
@@ -215,4 +215,46 @@ TEST_CASE("CSR Graph can be built from .gr strings", "[graph_utils]") {
 
     require_correct_weights(test_edges, test_weights, G);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("CSR Graph can be built from .gr files", "[graph_utils]") {
+  namespace fs = std::experimental::filesystem;
+  auto path = fs::temp_directory_path() / std::string{"csr_graph_gr_file.gr"};
+  auto of = std::ofstream(path.string());
+  of << graph_gr;
+  of.close();
+
+  auto G_opt = arlib::read_csr_graph_from_file(path.string());
+  REQUIRE(G_opt);
+  auto G = *G_opt;
+  REQUIRE(num_vertices(G) == 7);
+
+  using arlib::VPair;
+  auto test_edges = build_test_edges<VPair>();
+  auto test_weights = build_test_weights();
+  REQUIRE(num_edges(G) == test_edges.size() * 2);
+  require_correct_weights(test_edges, test_weights, G);
+
+  auto non_existing_path = fs::path("/xyz/bla/bla/come/on/cant/be/existing.gr");
+  REQUIRE(!arlib::read_csr_graph_from_file(non_existing_path.string()));
+}
+
+TEST_CASE(".gr parsing skips comments and blank lines and rejects garbage",
+          "[graph_utils]") {
+  auto text = std::string{"d\n"
+                          "# nb_vertices nb_edges\n"
+                          "3 2\n"
+                          "\n"
+                          "# v1 v2 weight\n"
+                          "0 1 4.5\r\n"
+                          "1 2 3 0"};
+  auto G = arlib::read_csr_graph_from_string(text);
+  REQUIRE(num_vertices(G) == 3);
+  REQUIRE(num_edges(G) == 2);
+  auto weight = get(boost::edge_weight, G);
+  REQUIRE(weight[edge(Vertex{0}, Vertex{1}, G).first] == 4.5);
+  REQUIRE(weight[edge(Vertex{1}, Vertex{2}, G).first] == 3);
+
+  REQUIRE_THROWS_AS(arlib::read_csr_graph_from_string("d\n3 2\n0 x 4\n"),
+                    std::invalid_argument);
+}
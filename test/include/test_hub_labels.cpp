@@ -0,0 +1,181 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/details/hub_labels_impl.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/hub_labels.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/routing_kernels/types.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Label intersection finds the best common hub",
+          "[hub_labels]") {
+  // Long enough to take both the block-wise and the scalar paths
+  auto out_hubs = std::vector<std::uint32_t>{0, 2, 4, 6, 8, 10, 12, 14, 16};
+  auto out_dist = std::vector<int>{9, 9, 9, 9, 9, 9, 9, 3, 1};
+  auto in_hubs = std::vector<std::uint32_t>{1, 3, 5, 7, 9, 11, 14, 15, 16};
+  auto in_dist = std::vector<int>{0, 0, 0, 0, 0, 0, 4, 0, 7};
+  auto out = arlib::details::label_view<int>{out_hubs.data(), out_dist.data(),
+                                             out_hubs.size()};
+  auto in = arlib::details::label_view<int>{in_hubs.data(), in_dist.data(),
+                                            in_hubs.size()};
+  REQUIRE(arlib::details::label_intersection(out, in) == 7);
+
+  in_hubs = {1, 3, 5, 7, 9, 11, 13, 15, 17};
+  REQUIRE(arlib::details::label_intersection(out, in) ==
+          std::numeric_limits<int>::max());
+}
+
+TEST_CASE("Hub labels give exact distances", "[hub_labels]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  auto check = [&](arlib::hub_labels<Length> const &labels) {
+    REQUIRE(labels.num_vertices() == n);
+    for (Vertex s = 0; s < n; s += n / 13) {
+      auto distance = std::vector<Length>(n);
+      dijkstra_shortest_paths(G, s, distance_map(&distance[0]));
+      for (Vertex t = 0; t < n; ++t) {
+        REQUIRE(labels.distance(s, t) == distance[t]);
+      }
+    }
+  };
+
+  SECTION("Degree order") { check(arlib::build_hub_labels(G)); }
+  SECTION("Contraction order") {
+    auto ch = arlib::build_contraction_hierarchy(G);
+    check(arlib::build_hub_labels(G, weight, index, ch));
+  }
+}
+
+TEST_CASE("Hub labels survive a write/read round trip and a mapping",
+          "[hub_labels]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto labels = arlib::build_hub_labels(G);
+  auto n = labels.num_vertices();
+
+  auto buffer = std::stringstream{};
+  arlib::write_hub_labels(buffer, labels);
+  auto serialized = buffer.str();
+
+  auto same_labels = [&](arlib::hub_labels<Length> const &other) {
+    REQUIRE(other.num_vertices() == n);
+    REQUIRE(other.num_out_entries() == labels.num_out_entries());
+    REQUIRE(other.num_in_entries() == labels.num_in_entries());
+    for (std::size_t u = 0; u < n; u += n / 17) {
+      for (std::size_t v = 0; v < n; ++v) {
+        REQUIRE(other.distance(u, v) == labels.distance(u, v));
+      }
+    }
+  };
+
+  SECTION("Stream") {
+    auto read = arlib::read_hub_labels<Length>(buffer);
+    REQUIRE(read);
+    same_labels(*read);
+
+    // A different length type or a truncated stream are rejected
+    auto as_double = std::stringstream{serialized};
+    REQUIRE_FALSE(arlib::read_hub_labels<double>(as_double));
+    auto truncated =
+        std::stringstream{serialized.substr(0, serialized.size() / 2)};
+    REQUIRE_FALSE(arlib::read_hub_labels<Length>(truncated));
+  }
+
+  SECTION("Memory mapping") {
+    auto path =
+        (std::filesystem::temp_directory_path() / "arlib_test_hub_labels.bin")
+            .string();
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << serialized;
+    }
+    auto mapped = arlib::map_hub_labels<Length>(path);
+    REQUIRE(mapped);
+    same_labels(*mapped);
+    REQUIRE_FALSE(arlib::map_hub_labels<double>(path));
+
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << serialized.substr(0, serialized.size() - 8);
+    }
+    REQUIRE_FALSE(arlib::map_hub_labels<Length>(path));
+    std::remove(path.c_str());
+  }
+}
+
+TEST_CASE("OnePass+, ESX and Penalty guided by hub labels return the same "
+          "result as without",
+          "[hub_labels]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto labels = arlib::build_hub_labels(G);
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+
+  auto same_lengths = [&](auto &expected, auto &actual) {
+    auto paths = arlib::to_paths(G, expected, s, t);
+    auto hl_paths = arlib::to_paths(G, actual, s, t);
+    REQUIRE(paths.size() == hl_paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      REQUIRE(paths[i].length() == hl_paths[i].length());
+    }
+  };
+
+  SECTION("OnePass+") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, predecessors, s, t, k, theta);
+    auto predecessors_hl = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_hl, s, t, k, theta, labels);
+    same_lengths(predecessors, predecessors_hl);
+  }
+
+  SECTION("ESX") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors, s, t, k, theta);
+    auto predecessors_hl = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_hl, s, t, k, theta, labels);
+    same_lengths(predecessors, predecessors_hl);
+  }
+
+  SECTION("Penalty") {
+    auto p = 0.1;
+    auto r = 0.1;
+    auto bound_limit = 10;
+    auto max_nb_steps = 100000;
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps);
+    auto predecessors_hl = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_hl, s, t, k, theta, p, r,
+                   bound_limit, max_nb_steps, labels);
+    same_lengths(predecessors, predecessors_hl);
+  }
+}
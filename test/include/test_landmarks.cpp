@@ -0,0 +1,178 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/routing_kernels/bidirectional_alt.hpp>
+#include <arlib/routing_kernels/types.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Landmark bounds never exceed shortest distances", "[landmarks]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  for (auto selection : {arlib::landmark_selection::farthest,
+                         arlib::landmark_selection::avoid}) {
+    auto lm = arlib::select_landmarks(G, 4, selection);
+    REQUIRE(lm.size() == 4);
+    REQUIRE(lm.num_vertices() == n);
+    auto ids = std::set<std::size_t>(lm.vertices().begin(),
+                                     lm.vertices().end());
+    REQUIRE(ids.size() == 4);
+
+    for (Vertex t = 0; t < n; t += n / 13) {
+      auto to_t = arlib::details::distance_from_target<Length>(G, t);
+      auto heuristic = arlib::make_alt_heuristic(G, lm, t);
+      for (Vertex v = 0; v < n; ++v) {
+        if (to_t[v] == std::numeric_limits<Length>::max()) {
+          continue;
+        }
+        REQUIRE(heuristic(v) <= to_t[v]);
+        REQUIRE(lm.lower_bound(index[v], index[t]) <= to_t[v]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Landmarks survive a write/read round trip", "[landmarks]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto lm = arlib::select_landmarks(G, 3);
+
+  auto buffer = std::stringstream{};
+  arlib::write_landmarks(buffer, lm);
+  auto serialized = buffer.str();
+
+  auto read = arlib::read_landmarks<Length>(buffer);
+  REQUIRE(read);
+  REQUIRE(read->num_vertices() == lm.num_vertices());
+  REQUIRE(read->vertices() == lm.vertices());
+  REQUIRE(read->from_distances() == lm.from_distances());
+  REQUIRE(read->to_distances() == lm.to_distances());
+
+  // A different length type or a truncated stream are rejected
+  auto as_double = std::stringstream{serialized};
+  REQUIRE_FALSE(arlib::read_landmarks<double>(as_double));
+  auto truncated =
+      std::stringstream{serialized.substr(0, serialized.size() / 2)};
+  REQUIRE_FALSE(arlib::read_landmarks<Length>(truncated));
+}
+
+TEST_CASE("Bidirectional ALT finds shortest distances",
+          "[landmarks][bidirectional_dijkstra]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto rev = make_reverse_graph(G);
+  auto weight_b = get(edge_weight, rev);
+  auto n = num_vertices(G);
+  auto workspace = arlib::BiDijkstraWorkspace<Vertex, Length>{n};
+  auto lm = arlib::select_landmarks(G, 4);
+
+  auto predecessor_vec = std::vector<Vertex>(n);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+
+  for (Vertex s = 0; s < n; s += n / 7) {
+    auto distance_uni = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s,
+                            distance_map(make_iterator_property_map(
+                                std::begin(distance_uni), index)));
+    for (Vertex t = 1; t < n; t += n / 11) {
+      if (distance_uni[t] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      auto st_distance = arlib::bidirectional_alt(
+          G, s, t, predecessor, weight, rev, weight_b, index, lm, workspace);
+      REQUIRE(st_distance == distance_uni[t]);
+
+      auto sp =
+          arlib::details::build_edge_list_from_dijkstra(G, s, t, predecessor);
+      REQUIRE(arlib::details::compute_length_from_edges(
+                  std::begin(sp), std::end(sp), weight) == distance_uni[t]);
+    }
+  }
+}
+
+TEST_CASE("OnePass+, ESX and Penalty guided by landmarks return the same "
+          "result as without",
+          "[landmarks]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto lm = arlib::select_landmarks(G, 4);
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+
+  auto same_lengths = [&](auto &expected, auto &actual) {
+    auto paths = arlib::to_paths(G, expected, s, t);
+    auto lm_paths = arlib::to_paths(G, actual, s, t);
+    REQUIRE(paths.size() == lm_paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      REQUIRE(paths[i].length() == lm_paths[i].length());
+    }
+  };
+
+  SECTION("OnePass+") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, predecessors, s, t, k, theta);
+    auto predecessors_lm = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_lm, s, t, k, theta, lm);
+    same_lengths(predecessors, predecessors_lm);
+  }
+
+  SECTION("ESX") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors, s, t, k, theta);
+    for (auto algorithm : {arlib::routing_kernels::astar,
+                           arlib::routing_kernels::bidirectional_alt}) {
+      auto predecessors_lm = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, weight, predecessors_lm, s, t, k, theta, lm, algorithm);
+      same_lengths(predecessors, predecessors_lm);
+    }
+  }
+
+  SECTION("Penalty") {
+    auto p = 0.1;
+    auto r = 0.1;
+    auto bound_limit = 10;
+    auto max_nb_steps = 100000;
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps);
+    for (auto algorithm : {arlib::routing_kernels::astar,
+                           arlib::routing_kernels::bidirectional_alt}) {
+      auto predecessors_lm = arlib::multi_predecessor_map<Vertex>{};
+      arlib::penalty(G, weight, predecessors_lm, s, t, k, theta, p, r,
+                     bound_limit, max_nb_steps, lm, algorithm);
+      same_lengths(predecessors, predecessors_lm);
+    }
+  }
+}
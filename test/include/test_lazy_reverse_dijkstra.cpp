@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/graph_utils.hpp>
+#include <arlib/routing_kernels/lazy_reverse_dijkstra.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Lazy reverse Dijkstra settles only what it is asked for",
+          "[lazy_reverse_dijkstra]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  for (Vertex t = 0; t < n; t += n / 7) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(make_reverse_graph(G), t,
+                            distance_map(&expected[0]));
+
+    auto search = arlib::make_lazy_reverse_dijkstra(G, t, weight, index);
+    REQUIRE(search.num_settled() == 0);
+    REQUIRE(search.distance(t) == 0);
+    REQUIRE(search.num_settled() == 1);
+
+    // Asking for a vertex settles no vertex farther than it
+    auto v = (t + n / 2) % n;
+    auto v_distance = search.distance(v);
+    REQUIRE(v_distance == expected[v]);
+    for (Vertex u = 0; u < n; ++u) {
+      if (search.is_settled(u)) {
+        REQUIRE(expected[u] <= v_distance);
+      } else {
+        REQUIRE(expected[u] >= v_distance);
+        REQUIRE(search.lower_bound(u) <= expected[u]);
+      }
+    }
+
+    for (Vertex u = 0; u < n; ++u) {
+      REQUIRE(search.distance(u) == expected[u]);
+    }
+    REQUIRE(search.radius() == std::numeric_limits<Length>::max());
+  }
+}
+
+TEST_CASE("Lazy reverse Dijkstra bounded by a radius gives a consistent "
+          "lower bound",
+          "[lazy_reverse_dijkstra]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  Vertex t = 20;
+  auto expected = std::vector<Length>(n);
+  dijkstra_shortest_paths(make_reverse_graph(G), t,
+                          distance_map(&expected[0]));
+
+  auto max_radius = Length{500};
+  auto search =
+      arlib::make_lazy_reverse_dijkstra(G, t, weight, index, max_radius);
+  auto answers = std::vector<Length>(n);
+  for (Vertex u = 0; u < n; ++u) {
+    answers[u] = search.distance(u);
+    if (expected[u] <= max_radius) {
+      REQUIRE(answers[u] == expected[u]);
+    } else {
+      REQUIRE(answers[u] <= expected[u]);
+      REQUIRE(answers[u] > max_radius);
+    }
+  }
+  REQUIRE(search.num_settled() < n);
+
+  for (Vertex u = 0; u < n; ++u) {
+    // Answers never change once given
+    REQUIRE(search.distance(u) == answers[u]);
+    for (auto [it, end] = out_edges(u, G); it != end; ++it) {
+      auto v = target(*it, G);
+      if (answers[v] != std::numeric_limits<Length>::max()) {
+        REQUIRE(answers[u] <= weight[*it] + answers[v]);
+      }
+    }
+  }
+}
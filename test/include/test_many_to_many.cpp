@@ -0,0 +1,119 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/routing_kernels/many_to_many.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+std::vector<std::vector<Length>>
+dijkstra_rows(Graph const &G, std::vector<Vertex> const &sources) {
+  using namespace boost;
+  auto rows = std::vector<std::vector<Length>>{};
+  for (auto s : sources) {
+    auto distance = std::vector<Length>(num_vertices(G));
+    dijkstra_shortest_paths(G, s,
+                            distance_map(make_iterator_property_map(
+                                std::begin(distance), get(vertex_index, G))));
+    rows.push_back(std::move(distance));
+  }
+  return rows;
+}
+} // namespace
+
+TEST_CASE("Many-to-many tables match Dijkstra's distances",
+          "[many_to_many]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto n = num_vertices(G);
+  auto sources = std::vector<Vertex>{};
+  auto targets = std::vector<Vertex>{};
+  for (Vertex v = 0; v < n; v += n / 9) {
+    sources.push_back(v);
+  }
+  for (Vertex v = 3; v < n; v += n / 13) {
+    targets.push_back(v);
+  }
+  auto expected = dijkstra_rows(G, sources);
+
+  auto check = [&](arlib::distance_table<Length> const &table) {
+    REQUIRE(table.num_sources() == sources.size());
+    REQUIRE(table.num_targets() == targets.size());
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      for (std::size_t j = 0; j < targets.size(); ++j) {
+        REQUIRE(table.distance(i, j) == expected[i][targets[j]]);
+        if (!table.reachable(i, j)) {
+          REQUIRE_FALSE(table.middle(i, j));
+          continue;
+        }
+
+        // Middle vertices lie on a shortest path
+        auto m = table.middle(i, j);
+        REQUIRE(m);
+        auto to_t = dijkstra_rows(G, {Vertex(*m)});
+        REQUIRE(expected[i][*m] + to_t[0][targets[j]] == table.distance(i, j));
+      }
+    }
+  };
+
+  SECTION("Plain graph") {
+    check(arlib::many_to_many(G, sources, targets, true));
+  }
+
+  SECTION("Contraction hierarchy") {
+    auto ch = arlib::build_contraction_hierarchy(G);
+    check(arlib::many_to_many(ch, sources, targets, get(vertex_index, G),
+                              true));
+  }
+
+  SECTION("Bounded radius") {
+    auto radius = Length{500};
+    auto table =
+        arlib::many_to_many(G, sources, targets, get(edge_weight, G),
+                            get(vertex_index, G), false, radius);
+    REQUIRE_FALSE(table.has_middles());
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      for (std::size_t j = 0; j < targets.size(); ++j) {
+        if (expected[i][targets[j]] <= radius) {
+          REQUIRE(table.distance(i, j) == expected[i][targets[j]]);
+        } else {
+          REQUIRE_FALSE(table.reachable(i, j));
+        }
+      }
+    }
+  }
+
+  SECTION("Reused workspace") {
+    auto workspace = arlib::ManyToManyWorkspace<Length, Vertex>{n};
+    auto weight = get(edge_weight, G);
+    auto index = get(vertex_index, G);
+    for (int run = 0; run < 3; ++run) {
+      check(arlib::many_to_many(G, sources, targets, weight, index, workspace,
+                                true));
+      auto radius = Length{500};
+      auto bounded = arlib::many_to_many(G, sources, targets, weight, index,
+                                         workspace, false, radius);
+      for (std::size_t i = 0; i < sources.size(); ++i) {
+        for (std::size_t j = 0; j < targets.size(); ++j) {
+          REQUIRE(bounded.reachable(i, j) ==
+                  (expected[i][targets[j]] <= radius));
+        }
+      }
+    }
+  }
+}
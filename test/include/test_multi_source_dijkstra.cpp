@@ -0,0 +1,88 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/graph_utils.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/routing_kernels/multi_source_dijkstra.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("Multi-source Dijkstra matches one search per source",
+          "[multi_source_dijkstra]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+
+  // Neighboring sources, a repeated one and an odd count to leave a partial
+  // batch
+  auto sources = std::vector<Vertex>{0, 1, 2, 3, 5, 8, 13, 21, 34, 55, 55};
+  auto expected = std::vector<std::vector<Length>>{};
+  for (auto s : sources) {
+    auto distance = std::vector<Length>(n);
+    dijkstra_shortest_paths(
+        G, s,
+        distance_map(make_iterator_property_map(std::begin(distance), index)));
+    expected.push_back(std::move(distance));
+  }
+
+  SECTION("4 lanes") {
+    REQUIRE(arlib::multi_source_distances<4>(G, sources, weight, index) ==
+            expected);
+  }
+  SECTION("8 lanes") {
+    REQUIRE(arlib::multi_source_distances<8>(G, sources, weight, index) ==
+            expected);
+  }
+  SECTION("3 and 6 lanes, not a power of two") {
+    REQUIRE(arlib::multi_source_distances<3>(G, sources, weight, index) ==
+            expected);
+    REQUIRE(arlib::multi_source_distances<6>(G, sources, weight, index) ==
+            expected);
+  }
+  SECTION("16 lanes, into distance maps") {
+    using DistanceMap =
+        iterator_property_map<std::vector<Length>::iterator,
+                              property_map<Graph, vertex_index_t>::type>;
+    auto rows = std::vector<std::vector<Length>>(sources.size(),
+                                                 std::vector<Length>(n));
+    auto maps = std::vector<DistanceMap>{};
+    for (auto &row : rows) {
+      maps.push_back(make_iterator_property_map(row.begin(), index));
+    }
+    arlib::multi_source_dijkstra<16>(G, sources, weight, index, maps);
+    REQUIRE(rows == expected);
+  }
+}
+
+TEST_CASE("Landmarks made from given vertices match selected ones",
+          "[multi_source_dijkstra][landmarks]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto selected = arlib::select_landmarks(G, 10);
+
+  auto vertices = std::vector<Vertex>{};
+  for (auto id : selected.vertices()) {
+    vertices.push_back(vertex(id, G));
+  }
+  auto made = arlib::make_landmarks(G, weight, index, vertices);
+  REQUIRE(made.vertices() == selected.vertices());
+  REQUIRE(made.from_distances() == selected.from_distances());
+  REQUIRE(made.to_distances() == selected.to_distances());
+}
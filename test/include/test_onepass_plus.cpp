@@ -37,11 +37,14 @@ TEST_CASE("OnePassLabel builds a right path back to source", "[onepassplus]") {
   using Label = arlib::details::OnePassLabel<Graph, Length>;
 
   auto s = std::make_unique<Label>(0, 0, 0, 0, 0);
-  auto n1 = std::make_unique<Label>(3, 1, 1, s.get(), 1, 1);
-  auto n2 = std::make_unique<Label>(5, 2, 2, n1.get(), 2, 1);
-  auto n3 = std::make_unique<Label>(6, 3, 2, n2.get(), 3, 1);
+  auto n1 =
+      std::make_unique<Label>(3, 1, 1, s.get(), edge(0, 3, G).first, 1, 1);
+  auto n2 =
+      std::make_unique<Label>(5, 2, 2, n1.get(), edge(3, 5, G).first, 2, 1);
+  auto n3 =
+      std::make_unique<Label>(6, 3, 2, n2.get(), edge(5, 6, G).first, 3, 1);
 
-  auto path = n3->get_path(G);
+  auto path = n3->get_path();
 
   REQUIRE(std::find(std::begin(path), std::end(path), edge(0, 3, G).first) !=
           std::end(path));
@@ -51,6 +54,26 @@ TEST_CASE("OnePassLabel builds a right path back to source", "[onepassplus]") {
           std::end(path));
 }
 
+TEST_CASE("OnePassLabel keeps the parallel edge it was expanded through",
+          "[onepassplus]") {
+  using arlib::VPair;
+  using namespace boost;
+  using Label = arlib::details::OnePassLabel<Graph, Length>;
+
+  auto es = std::vector<VPair>{{0, 1}, {0, 1}};
+  auto ws = std::vector<Length>{5, 1};
+  auto G = Graph{es.begin(), es.end(), ws.begin(), 2};
+  auto light = *std::next(out_edges(0, G).first);
+  REQUIRE(get(edge_weight, G, light) == 1);
+
+  auto s = std::make_unique<Label>(0, 0, 0, 0, 0);
+  auto n1 = std::make_unique<Label>(1, 1, 1, s.get(), light, 1, 1);
+
+  auto path = n1->get_path();
+  REQUIRE(path.size() == 1);
+  REQUIRE(get(edge_weight, G, path.front()) == 1);
+}
+
 TEST_CASE("Computing distance from target", "[onepassplus]") {
   using namespace boost;
   auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr));
@@ -159,4 +182,38 @@ TEST_CASE("OnePass+ times-out on large graph", "[onepassplus]") {
   REQUIRE_THROWS_AS(
       arlib::onepass_plus(G, predecessors, s, t, k, theta, arlib::timer{1us}),
       arlib::terminator_stop_error);
-}
\ No newline at end of file
+}
+
+TEST_CASE("OnePass+ with a maximum stretch returns the alternatives within it",
+          "[onepassplus]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+
+  Vertex s = 0, t = 20;
+  auto k = 10;
+  auto theta = 0.7;
+  auto stretch = 1.1;
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::onepass_plus(G, predecessors, s, t, k, theta);
+  auto paths = arlib::to_paths(G, predecessors, s, t);
+
+  auto bounded_predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::onepass_plus(G, bounded_predecessors, s, t, k, theta,
+                      arlib::max_stretch{stretch});
+  auto bounded_paths = arlib::to_paths(G, bounded_predecessors, s, t);
+
+  // Paths are found by increasing length: the bound keeps the shortest ones
+  auto shortest = paths.front().length();
+  auto within = std::count_if(paths.begin(), paths.end(), [&](auto &p) {
+    return p.length() <= stretch * shortest;
+  });
+  REQUIRE(within < static_cast<long>(paths.size()));
+  REQUIRE(static_cast<long>(bounded_paths.size()) == within);
+  for (auto &p : bounded_paths) {
+    REQUIRE(p.length() <= stretch * shortest);
+  }
+
+  REQUIRE_THROWS_AS(arlib::max_stretch{0.9}, std::invalid_argument);
+}
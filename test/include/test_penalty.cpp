@@ -18,8 +18,12 @@
 #include <chrono>
 #include <experimental/filesystem>
 #include <memory>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 using namespace arlib::test;
 
@@ -247,6 +251,39 @@ TEST_CASE("Penalty running with bidirectional dijkstra returns same result as "
   }
 }
 
+TEST_CASE("Penalty running with parallel bidirectional dijkstra returns same "
+          "result as unidirectional dijkstra",
+          "[penalty]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+  auto p = 0.1;
+  auto r = 0.1;
+  auto bound_limit = 10;
+  auto max_nb_steps = 100000;
+
+  auto predecessors_uni = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, predecessors_uni, s, t, k, theta, p, r, bound_limit,
+                 max_nb_steps);
+  auto res_paths_uni = arlib::to_paths(G, predecessors_uni, s, t);
+
+  auto predecessors_par = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, predecessors_par, s, t, k, theta, p, r, bound_limit,
+                 max_nb_steps,
+                 arlib::routing_kernels::parallel_bidirectional_dijkstra);
+  auto res_paths_par = arlib::to_paths(G, predecessors_par, s, t);
+
+  REQUIRE(res_paths_uni.size() == res_paths_par.size());
+
+  for (std::size_t i = 0; i < res_paths_uni.size(); ++i) {
+    REQUIRE(res_paths_uni[i].length() == res_paths_par[i].length());
+  }
+}
+
 TEST_CASE("Penalty running with astar returns same result as "
           "unidirectional dijkstra",
           "[penalty]") {
@@ -279,6 +316,64 @@ TEST_CASE("Penalty running with astar returns same result as "
   }
 }
 
+TEST_CASE("Penalty with a compile-time kernel returns the same result as "
+          "with its routing_kernels value",
+          "[penalty]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto weight = get(edge_weight, G);
+
+  Vertex s = 0, t = 6;
+  int k = 3;
+  double theta = 0.5;
+  auto p = 0.1;
+  auto r = 0.1;
+  auto bound_limit = 10;
+  auto max_nb_steps = 100000;
+
+  // One workspace, reused by every run on it
+  auto workspace = arlib::PathWorkspace<Graph, double>{num_vertices(G)};
+
+  auto same_result = [&](auto kernel) {
+    auto predecessors_rt = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors_rt, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps, kernel.value);
+    auto res_paths_rt = arlib::to_paths(G, predecessors_rt, s, t);
+
+    auto predecessors_ct = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors_ct, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps, kernel);
+    auto res_paths_ct = arlib::to_paths(G, predecessors_ct, s, t);
+
+    REQUIRE(res_paths_rt.size() == res_paths_ct.size());
+    for (std::size_t i = 0; i < res_paths_rt.size(); ++i) {
+      REQUIRE(res_paths_rt[i].length() == res_paths_ct[i].length());
+    }
+
+    auto predecessors_ws = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_ws, s, t, k, theta, p, r,
+                   bound_limit, max_nb_steps, kernel, workspace);
+    auto res_paths_ws = arlib::to_paths(G, predecessors_ws, s, t);
+    REQUIRE(res_paths_rt.size() == res_paths_ws.size());
+    for (std::size_t i = 0; i < res_paths_rt.size(); ++i) {
+      REQUIRE(res_paths_rt[i].length() == res_paths_ws[i].length());
+    }
+  };
+
+  same_result(arlib::kernels::dijkstra);
+  same_result(arlib::kernels::astar);
+  same_result(arlib::kernels::bidirectional_dijkstra);
+  same_result(arlib::kernels::parallel_bidirectional_dijkstra);
+
+  // Kernels needing an oracle have no tag
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  REQUIRE_THROWS_AS(arlib::penalty(G, weight, predecessors, s, t, k, theta, p,
+                                   r, bound_limit, max_nb_steps,
+                                   arlib::routing_kernels::bidirectional_alt),
+                    std::invalid_argument);
+}
+
 TEST_CASE("Penalty times-out on large graph", "[penalty]") {
   using namespace boost;
   using namespace std::chrono_literals;
@@ -299,4 +394,90 @@ TEST_CASE("Penalty times-out on large graph", "[penalty]") {
                                    arlib::routing_kernels::astar,
                                    arlib::timer{1us}),
                     arlib::terminator_stop_error);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Penalty with a maximum stretch returns no longer alternatives",
+          "[penalty]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+
+  Vertex s = 0, t = 20;
+  auto k = 10;
+  auto theta = 0.7;
+  auto p = 0.1;
+  auto r = 0.1;
+  auto max_nb_updates = 10;
+  auto max_nb_steps = 10000;
+  auto stretch = 1.1;
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, predecessors, s, t, k, theta, p, r, max_nb_updates,
+                 max_nb_steps, arlib::routing_kernels::dijkstra,
+                 arlib::max_stretch{stretch});
+  auto paths = arlib::to_paths(G, predecessors, s, t);
+  REQUIRE(paths.size() > 1);
+  auto shortest = paths.front().length();
+  for (auto &path : paths) {
+    REQUIRE(path.length() <= stretch * shortest);
+  }
+}
+
+TEST_CASE("Penalty with a maximum stretch keeps late alternatives within it",
+          "[penalty]") {
+  using namespace boost;
+
+  // 0 -> 1 -> 4 is the shortest path, 0 -> 1 -> 2 -> 4 overlaps it within
+  // the stretch, and 0 -> 3 -> 4 is too long but found first, being the
+  // least penalized one.
+  auto G = Graph{5};
+  add_edge(0, 1, 50, G);
+  add_edge(1, 4, 50, G);
+  add_edge(1, 2, 5, G);
+  add_edge(2, 4, 50, G);
+  add_edge(0, 3, 60, G);
+  add_edge(3, 4, 60, G);
+
+  Vertex s = 0, t = 4;
+  auto k = 3;
+  auto theta = 0.7;
+  auto p = 1.0;
+  auto r = 0.1;
+  auto max_nb_updates = 10;
+  auto max_nb_steps = 100;
+  auto stretch = 1.1;
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, predecessors, s, t, k, theta, p, r, max_nb_updates,
+                 max_nb_steps, arlib::routing_kernels::dijkstra,
+                 arlib::max_stretch{stretch});
+  auto paths = arlib::to_paths(G, predecessors, s, t);
+
+  // The bound only filters the alternatives of the unbounded run
+  auto unbounded_predecessors = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, unbounded_predecessors, s, t, k, theta, p, r,
+                 max_nb_updates, max_nb_steps,
+                 arlib::routing_kernels::dijkstra);
+  auto unbounded = arlib::to_paths(G, unbounded_predecessors, s, t);
+  REQUIRE(unbounded.size() == 3);
+  auto shortest = unbounded.front().length();
+  auto endpoints = [](auto const &path) {
+    auto res = std::set<std::pair<Vertex, Vertex>>{};
+    for (auto const &e : make_edge_list(path)) {
+      res.emplace(arlib::source(e, path), arlib::target(e, path));
+    }
+    return res;
+  };
+  auto expected = std::set<std::set<std::pair<Vertex, Vertex>>>{};
+  for (auto const &path : unbounded) {
+    if (path.length() <= stretch * shortest) {
+      expected.insert(endpoints(path));
+    }
+  }
+  auto actual = std::set<std::set<std::pair<Vertex, Vertex>>>{};
+  for (auto const &path : paths) {
+    actual.insert(endpoints(path));
+  }
+  REQUIRE(expected.size() == 2);
+  REQUIRE(actual == expected);
+}
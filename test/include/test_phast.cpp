@@ -0,0 +1,145 @@
+#include "catch.hpp"
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/contraction_hierarchy.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/routing_kernels/phast.hpp>
+#include <arlib/thread_pool.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+template <typename PHAST>
+void check_phast(Graph const &G, PHAST const &ph, arlib::thread_pool *pool) {
+  using namespace boost;
+  auto n = num_vertices(G);
+  auto workspace = arlib::PHASTWorkspace<Length>{n};
+  auto step = std::max<std::size_t>(n / 11, 1);
+  for (Vertex v = 0; v < n; v += step) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, v, distance_map(&expected[0]));
+    auto actual = std::vector<Length>(n);
+    arlib::phast_from(ph, v, actual.begin(), workspace, pool);
+    REQUIRE(actual == expected);
+
+    auto expected_to = std::vector<Length>(n);
+    dijkstra_shortest_paths(make_reverse_graph(G), v,
+                            distance_map(&expected_to[0]));
+    arlib::phast_to(ph, v, actual.begin(), workspace, pool);
+    REQUIRE(actual == expected_to);
+  }
+}
+} // namespace
+
+TEST_CASE("PHAST computes the same distances as Dijkstra", "[phast]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto ph = arlib::build_phast_hierarchy(arlib::build_contraction_hierarchy(G));
+  REQUIRE(ph.num_vertices() == boost::num_vertices(G));
+
+  SECTION("Sequential sweep") { check_phast(G, ph, nullptr); }
+  SECTION("Parallel sweep") {
+    auto pool = arlib::thread_pool{3};
+    check_phast(G, ph, &pool);
+  }
+}
+
+TEST_CASE("PHAST splits large levels across a thread pool", "[phast]") {
+  // A grid large enough for its lowest levels to be swept in parallel
+  constexpr int side = 100;
+  auto G = Graph{side * side};
+  auto rng = std::mt19937{42};
+  auto weight = std::uniform_int_distribution<Length>{1, 50};
+  for (int i = 0; i < side; ++i) {
+    for (int j = 0; j < side; ++j) {
+      auto v = i * side + j;
+      if (j + 1 < side) {
+        boost::add_edge(v, v + 1, weight(rng), G);
+        boost::add_edge(v + 1, v, weight(rng), G);
+      }
+      if (i + 1 < side) {
+        boost::add_edge(v, v + side, weight(rng), G);
+        boost::add_edge(v + side, v, weight(rng), G);
+      }
+    }
+  }
+  auto ph = arlib::build_phast_hierarchy(arlib::build_contraction_hierarchy(G));
+  auto const &levels = ph.level_offsets();
+  auto widest = std::size_t{0};
+  for (std::size_t l = 0; l + 1 < levels.size(); ++l) {
+    widest = std::max(widest, levels[l + 1] - levels[l]);
+  }
+  REQUIRE(widest >= 512);
+
+  auto pool = arlib::thread_pool{4};
+  check_phast(G, ph, &pool);
+}
+
+TEST_CASE("OnePass+, ESX and Penalty guided by PHAST return the same "
+          "result as without",
+          "[phast]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto ph = arlib::build_phast_hierarchy(arlib::build_contraction_hierarchy(G));
+
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+
+  auto same_lengths = [&](auto &expected, auto &actual) {
+    auto paths = arlib::to_paths(G, expected, s, t);
+    auto phast_paths = arlib::to_paths(G, actual, s, t);
+    REQUIRE(paths.size() == phast_paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      REQUIRE(paths[i].length() == phast_paths[i].length());
+    }
+  };
+
+  SECTION("OnePass+") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, predecessors, s, t, k, theta);
+    auto predecessors_ph = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_ph, s, t, k, theta, ph);
+    same_lengths(predecessors, predecessors_ph);
+  }
+
+  SECTION("ESX") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, predecessors, s, t, k, theta);
+    auto predecessors_ph = arlib::multi_predecessor_map<Vertex>{};
+    arlib::esx(G, weight, predecessors_ph, s, t, k, theta, ph);
+    same_lengths(predecessors, predecessors_ph);
+  }
+
+  SECTION("Penalty") {
+    auto p = 0.1;
+    auto r = 0.1;
+    auto bound_limit = 10;
+    auto max_nb_steps = 100000;
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, predecessors, s, t, k, theta, p, r, bound_limit,
+                   max_nb_steps);
+    auto predecessors_ph = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, weight, predecessors_ph, s, t, k, theta, p, r,
+                   bound_limit, max_nb_steps, ph);
+    same_lengths(predecessors, predecessors_ph);
+  }
+}
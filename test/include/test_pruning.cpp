@@ -55,3 +55,30 @@ TEST_CASE("Uninformed Bidirectional Pruning with tau = 1.0 on a real world "
   const auto num_pruned_edges = std::distance(first, last);
   REQUIRE(num_pruned_edges < num_edges(G));
 }
+
+TEST_CASE("Uninformed Bidirectional Pruning running on two threads keeps the "
+          "shortest path",
+          "[pruning]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+
+  Vertex s = 0, t = 20;
+  double tau = 1.1;
+
+  auto pruned_G = arlib::uninformed_bidirectional_pruner(
+      G, s, t, tau, arlib::routing_kernels::parallel_bidirectional_dijkstra);
+
+  // How much gets pruned depends on how the two searches interleave, but the
+  // shortest path must always survive.
+  auto distance = std::vector<int>(num_vertices(G));
+  auto distance_pruned = std::vector<int>(num_vertices(G));
+  auto index = get(vertex_index, G);
+  dijkstra_shortest_paths(G, s,
+                          distance_map(make_iterator_property_map(
+                              std::begin(distance), index)));
+  dijkstra_shortest_paths(pruned_G, s,
+                          distance_map(make_iterator_property_map(
+                              std::begin(distance_pruned), index)));
+  REQUIRE(distance_pruned[t] == distance[t]);
+}
@@ -0,0 +1,160 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/query_context.hpp>
+#include <arlib/uninformed_bidirectional_pruning.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("query_context holds the exact shortest path trees of a query",
+          "[query_context]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  Vertex s = 0, t = 20;
+  auto ctx = arlib::query_context<Graph>{G, s, t, true};
+  REQUIRE(ctx.has_forward_tree());
+  REQUIRE(ctx.reachable());
+
+  auto distance_s = std::vector<Length>(num_vertices(G));
+  auto distance_t = std::vector<Length>(num_vertices(G));
+  dijkstra_shortest_paths(G, s, distance_map(&distance_s[0]));
+  dijkstra_shortest_paths(make_reverse_graph(G), t,
+                          distance_map(&distance_t[0]));
+
+  auto heuristic = ctx.heuristic();
+  for (auto [v, last] = vertices(G); v != last; ++v) {
+    REQUIRE(ctx.distance_from_source(*v) == distance_s[*v]);
+    REQUIRE(ctx.distance_to_target(*v) == distance_t[*v]);
+    REQUIRE(heuristic(*v) == distance_t[*v]);
+  }
+
+  auto const &sp = ctx.shortest_path();
+  REQUIRE_FALSE(sp.empty());
+  REQUIRE(source(sp.front(), G) == s);
+  REQUIRE(target(sp.back(), G) == t);
+  auto weight = get(edge_weight, G);
+  REQUIRE(arlib::details::compute_length_from_edges(sp.begin(), sp.end(),
+                                                    weight) ==
+          ctx.shortest_distance());
+  REQUIRE(ctx.shortest_distance() == distance_s[t]);
+
+  // Copies share the same trees
+  auto copy = ctx;
+  REQUIRE(&copy.shortest_path() == &ctx.shortest_path());
+  REQUIRE(&copy.distances_to_target() == &ctx.distances_to_target());
+}
+
+TEST_CASE("OnePass+, ESX, Penalty and pruning reuse a query_context",
+          "[query_context]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  Vertex s = 0, t = 20;
+  int k = 3;
+  double theta = 0.5;
+  auto ctx = arlib::query_context<Graph>{G, s, t, true};
+
+  auto same_lengths = [&](auto &expected, auto &actual) {
+    auto paths = arlib::to_paths(G, expected, s, t);
+    auto ctx_paths = arlib::to_paths(G, actual, s, t);
+    REQUIRE(paths.size() == ctx_paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      REQUIRE(paths[i].length() == ctx_paths[i].length());
+    }
+  };
+
+  SECTION("OnePass+") {
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, predecessors, s, t, k, theta);
+    auto predecessors_ctx = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, weight, predecessors_ctx, ctx, k, theta);
+    same_lengths(predecessors, predecessors_ctx);
+  }
+
+  SECTION("ESX") {
+    for (auto algorithm : {arlib::routing_kernels::astar,
+                           arlib::routing_kernels::bidirectional_dijkstra}) {
+      auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, predecessors, s, t, k, theta, algorithm);
+      auto predecessors_ctx = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, weight, predecessors_ctx, ctx, k, theta, algorithm);
+      same_lengths(predecessors, predecessors_ctx);
+    }
+  }
+
+  SECTION("Penalty") {
+    auto p = 0.1;
+    auto r = 0.1;
+    auto bound_limit = 10;
+    auto max_nb_steps = 100000;
+    for (auto algorithm : {arlib::routing_kernels::dijkstra,
+                           arlib::routing_kernels::astar}) {
+      auto predecessors_ctx = arlib::multi_predecessor_map<Vertex>{};
+      arlib::penalty(G, weight, predecessors_ctx, ctx, k, theta, p, r,
+                     bound_limit, max_nb_steps, algorithm);
+      auto paths = arlib::to_paths(G, predecessors_ctx, s, t);
+      REQUIRE(paths.size() > 0);
+      REQUIRE(paths[0].length() == ctx.shortest_distance());
+    }
+
+    auto without_forward_tree = arlib::query_context<Graph>{G, s, t};
+    auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+    REQUIRE_THROWS_AS(arlib::penalty(G, weight, predecessors,
+                                     without_forward_tree, k, theta, p, r,
+                                     bound_limit, max_nb_steps),
+                      std::invalid_argument);
+  }
+
+  SECTION("Uninformed Bidirectional Pruning") {
+    auto pruned_G = arlib::uninformed_bidirectional_pruner(G, ctx, 1.0);
+    auto [first, last] = edges(pruned_G);
+    REQUIRE(static_cast<std::size_t>(std::distance(first, last)) <
+            num_edges(G));
+
+    // The shortest path survives
+    for (auto const &e : ctx.shortest_path()) {
+      REQUIRE(pruned_G.m_edge_pred(e));
+    }
+  }
+}
+
+TEST_CASE("query_context rejects unreachable targets", "[query_context]") {
+  using namespace boost;
+
+  // A one-way chain 0 -> 1 -> 2
+  auto G = Graph{3};
+  add_edge(0, 1, 1, G);
+  add_edge(1, 2, 1, G);
+  Vertex s = 2, t = 0;
+  auto ctx = arlib::query_context<Graph>{G, s, t};
+  REQUIRE_FALSE(ctx.reachable());
+  REQUIRE(ctx.shortest_path().empty());
+  REQUIRE(ctx.shortest_distance() == std::numeric_limits<Length>::max());
+
+  auto weight = get(edge_weight, G);
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  REQUIRE_THROWS_AS(arlib::onepass_plus(G, weight, predecessors, ctx, 3, 0.5),
+                    arlib::details::target_not_found);
+  REQUIRE_THROWS_AS(arlib::esx(G, weight, predecessors, ctx, 3, 0.5),
+                    arlib::details::target_not_found);
+}
@@ -0,0 +1,211 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/dijkstra.hpp>
+#include <arlib/routing_kernels/parallel_bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/queue_policies.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+// Run a random monotone workload on Queue and on a d_ary_heap
+template <typename Queue> void check_against_d_ary_heap() {
+  constexpr std::size_t n = 200;
+  auto queue = Queue{n};
+  auto reference = arlib::details::d_ary_heap<int>{n};
+  auto rng = std::mt19937{42};
+  auto key_of = std::uniform_int_distribution<std::size_t>{0, n - 1};
+  auto step_of = std::uniform_int_distribution<int>{0, 40};
+
+  for (int round = 0; round < 3; ++round) {
+    auto last = 0;
+    for (int op = 0; op < 2000; ++op) {
+      if (op % 3 != 0 || queue.empty()) {
+        auto key = key_of(rng);
+        auto priority = last + step_of(rng);
+        REQUIRE(queue.push_or_decrease(key, priority) ==
+                reference.push_or_decrease(key, priority));
+      } else {
+        REQUIRE(queue.top().priority == reference.top().priority);
+        last = queue.top().priority;
+        // Ties may come out in any order: pop the same key from both
+        auto key = queue.top().key;
+        queue.pop();
+        using Entry = arlib::details::d_ary_heap<int>::value_type;
+        auto popped = std::vector<Entry>{};
+        while (reference.top().key != key) {
+          popped.push_back(reference.top());
+          reference.pop();
+        }
+        reference.pop();
+        for (auto const &entry : popped) {
+          reference.push_or_decrease(entry.key, entry.priority);
+        }
+      }
+      REQUIRE(queue.size() == reference.size());
+      REQUIRE(queue.contains(0) == reference.contains(0));
+    }
+    while (!queue.empty()) {
+      REQUIRE(queue.top().priority == reference.top().priority);
+      reference.push_or_decrease(queue.top().key, -1);
+      reference.pop();
+      queue.pop();
+    }
+    REQUIRE(reference.empty());
+    queue.clear();
+    reference.clear();
+  }
+}
+
+template <typename QueuePolicy, typename Heuristic>
+void check_point_to_point(Graph const &G, Heuristic const &heuristic_of) {
+  using namespace boost;
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+  auto workspace = arlib::DijkstraWorkspace<Vertex, Length, QueuePolicy>{n};
+  auto predecessor = std::vector<Vertex>(n);
+
+  for (Vertex s = 0; s < n; s += n / 5) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s, distance_map(&expected[0]));
+    for (Vertex t = 1; t < n; t += n / 7) {
+      if (expected[t] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      REQUIRE(arlib::dijkstra(G, s, t, &predecessor[0], weight, index,
+                              workspace) == expected[t]);
+      auto length = Length{0};
+      for (auto v = t; v != s; v = predecessor[v]) {
+        length += get(weight, edge(predecessor[v], v, G).first);
+      }
+      REQUIRE(length == expected[t]);
+
+      auto heuristic = heuristic_of(t);
+      REQUIRE(arlib::astar(G, s, t, &predecessor[0], weight, index, heuristic,
+                           workspace) == expected[t]);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Monotone queues behave as an indexed heap", "[queue_policies]") {
+  SECTION("Radix heap") {
+    check_against_d_ary_heap<arlib::details::radix_heap<int>>();
+  }
+  SECTION("Bucket queue") {
+    check_against_d_ary_heap<arlib::details::bucket_queue<int>>();
+  }
+}
+
+TEST_CASE("Dijkstra and A* find shortest distances with every queue policy",
+          "[queue_policies]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto heuristic_of = [&G](Vertex t) {
+    return arlib::details::distance_heuristic<Graph, Length>(G, t);
+  };
+
+  SECTION("4-ary heap") {
+    check_point_to_point<arlib::d_ary_heap_policy<>>(G, heuristic_of);
+  }
+  SECTION("Binary heap") {
+    check_point_to_point<arlib::d_ary_heap_policy<2>>(G, heuristic_of);
+  }
+  SECTION("Radix heap") {
+    check_point_to_point<arlib::radix_heap_policy>(G, heuristic_of);
+  }
+  SECTION("Bucket queue") {
+    check_point_to_point<arlib::bucket_queue_policy>(G, heuristic_of);
+  }
+}
+
+TEST_CASE("Bidirectional kernels accept a queue policy", "[queue_policies]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto rev = make_reverse_graph(G);
+  auto weight_b = get(edge_weight, rev);
+  auto n = num_vertices(G);
+  auto radix = arlib::BiDijkstraWorkspace<Vertex, Length,
+                                          arlib::radix_heap_policy>{n};
+  auto predecessor = std::vector<Vertex>(n);
+  auto distance = std::vector<Length>(n);
+
+  Vertex s = 3;
+  auto expected = std::vector<Length>(n);
+  dijkstra_shortest_paths(G, s, distance_map(&expected[0]));
+  for (Vertex t = 1; t < n; t += n / 9) {
+    if (expected[t] == std::numeric_limits<Length>::max()) {
+      continue;
+    }
+    REQUIRE(arlib::bidirectional_dijkstra(G, s, t, &predecessor[0], weight,
+                                          rev, weight_b, index, radix) ==
+            expected[t]);
+
+    arlib::bidirectional_dijkstra<arlib::bucket_queue_policy>(
+        G, s, t, &predecessor[0], &distance[0], weight, rev, weight_b, index);
+    auto length = Length{0};
+    for (auto v = t; v != s; v = predecessor[v]) {
+      length += get(weight, edge(predecessor[v], v, G).first);
+    }
+    REQUIRE(length == expected[t]);
+
+    arlib::parallel_bidirectional_dijkstra<arlib::radix_heap_policy>(
+        G, s, t, &predecessor[0], &distance[0], weight, rev, weight_b, index);
+    length = Length{0};
+    for (auto v = t; v != s; v = predecessor[v]) {
+      length += get(weight, edge(predecessor[v], v, G).first);
+    }
+    REQUIRE(length == expected[t]);
+  }
+}
+
+TEST_CASE("Fixed-point weights run integer queues on floating-point graphs",
+          "[queue_policies]") {
+  using namespace boost;
+  using CSREdge = graph_traits<arlib::CSRGraph>::edge_descriptor;
+
+  auto G = arlib::read_csr_graph_from_string(std::string(cittastudi_gr));
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+  // Meters as decimal kilometers
+  auto weight_km = make_function_property_map<CSREdge, double>(
+      [&G](CSREdge e) { return get(edge_weight, G, e) / 1000.0; });
+  auto weight_m = arlib::make_fixed_point_weight_map(weight_km, 1000.0);
+
+  using CSRVertex = graph_traits<arlib::CSRGraph>::vertex_descriptor;
+  auto workspace =
+      arlib::DijkstraWorkspace<CSRVertex, std::int64_t,
+                               arlib::radix_heap_policy>{n};
+  auto predecessor = std::vector<std::size_t>(n);
+  auto expected = std::vector<Length>(n);
+  dijkstra_shortest_paths(G, 0, distance_map(&expected[0]));
+  for (std::size_t t = 1; t < n; t += n / 9) {
+    if (expected[t] == std::numeric_limits<Length>::max()) {
+      continue;
+    }
+    REQUIRE(arlib::dijkstra(G, std::size_t{0}, t, &predecessor[0], weight_m,
+                            index, workspace) == expected[t]);
+  }
+}
@@ -0,0 +1,157 @@
+#include "catch.hpp"
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/landmarks.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/reachability_index.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+std::vector<bool> reachable_from(Graph const &G, Vertex s) {
+  using namespace boost;
+  auto color = std::vector<default_color_type>(num_vertices(G));
+  breadth_first_search(
+      G, s, color_map(make_iterator_property_map(color.begin(),
+                                                 get(vertex_index, G))));
+  auto reached = std::vector<bool>(num_vertices(G));
+  for (std::size_t v = 0; v < reached.size(); ++v) {
+    reached[v] = color[v] != color_traits<default_color_type>::white();
+  }
+  return reached;
+}
+
+void check_index(Graph const &G, arlib::reachability_index const &index,
+                 double min_rejected) {
+  auto n = boost::num_vertices(G);
+  REQUIRE(index.num_vertices() == n);
+  auto unreachable = 0, rejected = 0;
+  for (Vertex s = 0; s < n; ++s) {
+    auto reached = reachable_from(G, s);
+    for (Vertex t = 0; t < n; ++t) {
+      if (reached[t]) {
+        REQUIRE(index.may_reach(s, t));
+      } else {
+        REQUIRE_FALSE(index.same_component(s, t));
+        ++unreachable;
+        rejected += !index.may_reach(s, t);
+      }
+    }
+  }
+  REQUIRE(rejected >= min_rejected * unreachable);
+}
+} // namespace
+
+TEST_CASE("Reachability index never rejects a reachable target",
+          "[reachability_index]") {
+  SECTION("Road graph") {
+    auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+    check_index(G, arlib::build_reachability_index(G), 0.99);
+  }
+
+  SECTION("Random sparse graph") {
+    // Many small components and a deep condensation
+    auto rng = std::mt19937{1};
+    auto n = 300;
+    auto vertex = std::uniform_int_distribution<int>{0, n - 1};
+    auto G = Graph(n);
+    for (int i = 0; i < n; ++i) {
+      boost::add_edge(vertex(rng), vertex(rng), 1, G);
+    }
+    auto index = arlib::build_reachability_index(G);
+    REQUIRE(index.num_components() > 1);
+    check_index(G, index, 0.9);
+  }
+}
+
+TEST_CASE("Reachability index survives a write/read round trip",
+          "[reachability_index]") {
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto index = arlib::build_reachability_index(G);
+
+  auto buffer = std::stringstream{};
+  arlib::write_reachability_index(buffer, index);
+  auto serialized = buffer.str();
+  auto read = arlib::read_reachability_index(buffer);
+  REQUIRE(read);
+  REQUIRE(read->components() == index.components());
+  REQUIRE(read->ranks() == index.ranks());
+  REQUIRE(read->low_bounds() == index.low_bounds());
+  REQUIRE(read->post_bounds() == index.post_bounds());
+
+  auto truncated =
+      std::stringstream{serialized.substr(0, serialized.size() / 2)};
+  REQUIRE_FALSE(arlib::read_reachability_index(truncated));
+  auto garbage = std::stringstream{"ARLM" + serialized.substr(4)};
+  REQUIRE_FALSE(arlib::read_reachability_index(garbage));
+}
+
+TEST_CASE("OnePass+, ESX and Penalty reject unreachable targets upfront",
+          "[reachability_index]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = arlib::build_reachability_index(G);
+  auto n = num_vertices(G);
+  int k = 3;
+  double theta = 0.5;
+
+  // Find a rejected pair
+  Vertex s = 0, unreachable = 0;
+  while (unreachable < n && index.may_reach(s, unreachable)) {
+    ++unreachable;
+  }
+  REQUIRE(unreachable < n);
+  Vertex t = 20;
+  REQUIRE(index.may_reach(s, t));
+
+  auto predecessors = arlib::multi_predecessor_map<Vertex>{};
+  REQUIRE_THROWS_AS(arlib::onepass_plus(G, weight, predecessors, s,
+                                        unreachable, k, theta, index),
+                    arlib::details::target_not_found);
+  REQUIRE_THROWS_AS(arlib::esx(G, weight, predecessors, s, unreachable, k,
+                               theta, index),
+                    arlib::details::target_not_found);
+  REQUIRE_THROWS_AS(arlib::penalty(G, weight, predecessors, s, unreachable, k,
+                                   theta, 0.1, 0.1, 10, 100000, index),
+                    arlib::details::target_not_found);
+
+  // Reachable queries run the overload the trailing arguments select
+  auto lm = arlib::select_landmarks(G, 3);
+  auto expected = arlib::multi_predecessor_map<Vertex>{};
+  arlib::onepass_plus(G, expected, s, t, k, theta);
+  auto actual = arlib::multi_predecessor_map<Vertex>{};
+  arlib::onepass_plus(G, weight, actual, s, t, k, theta, index, lm);
+  auto paths = arlib::to_paths(G, expected, s, t);
+  auto indexed_paths = arlib::to_paths(G, actual, s, t);
+  REQUIRE(paths.size() == indexed_paths.size());
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    REQUIRE(paths[i].length() == indexed_paths[i].length());
+  }
+
+  auto esx_paths = arlib::multi_predecessor_map<Vertex>{};
+  arlib::esx(G, weight, esx_paths, s, t, k, theta, index,
+             arlib::routing_kernels::bidirectional_dijkstra);
+  REQUIRE(arlib::to_paths(G, esx_paths, s, t).size() > 0);
+  auto penalty_paths = arlib::multi_predecessor_map<Vertex>{};
+  arlib::penalty(G, weight, penalty_paths, s, t, k, theta, 0.1, 0.1, 10,
+                 100000, index);
+  REQUIRE(arlib::to_paths(G, penalty_paths, s, t).size() > 0);
+}
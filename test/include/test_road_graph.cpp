@@ -0,0 +1,474 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/esx.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/multi_predecessor_map.hpp>
+#include <arlib/onepass_plus.hpp>
+#include <arlib/penalty.hpp>
+#include <arlib/road_graph.hpp>
+#include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/dijkstra.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace arlib::test;
+
+namespace {
+using RoadGraph = arlib::road_graph<Length>;
+using RoadVertex = boost::graph_traits<RoadGraph>::vertex_descriptor;
+using RoadEdge = boost::graph_traits<RoadGraph>::edge_descriptor;
+
+template <typename G>
+std::vector<std::tuple<std::size_t, std::size_t, Length>>
+sorted_edges(G const &graph) {
+  auto result = std::vector<std::tuple<std::size_t, std::size_t, Length>>{};
+  for (auto [it, end] = edges(graph); it != end; ++it) {
+    result.emplace_back(source(*it, graph), target(*it, graph),
+                        get(boost::edge_weight, graph, *it));
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+} // namespace
+
+TEST_CASE("road_graph models the Boost.Graph concepts", "[road_graph]") {
+  using namespace boost;
+  BOOST_CONCEPT_ASSERT((VertexAndEdgeListGraphConcept<RoadGraph>));
+  BOOST_CONCEPT_ASSERT((BidirectionalGraphConcept<RoadGraph>));
+  BOOST_CONCEPT_ASSERT((AdjacencyGraphConcept<RoadGraph>));
+  BOOST_CONCEPT_ASSERT(
+      (PropertyGraphConcept<RoadGraph, RoadEdge, edge_weight_t>));
+  BOOST_CONCEPT_ASSERT(
+      (ReadablePropertyGraphConcept<RoadGraph, RoadVertex, vertex_index_t>));
+  BOOST_CONCEPT_ASSERT(
+      (ReadablePropertyGraphConcept<RoadGraph, RoadEdge, edge_index_t>));
+  BOOST_CONCEPT_ASSERT(
+      (BidirectionalGraphConcept<reverse_graph<RoadGraph>>));
+  REQUIRE(std::is_same_v<arlib::length_of_t<RoadGraph>, Length>);
+}
+
+TEST_CASE("road_graph stores the same edges as adjacency_list",
+          "[road_graph]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto R = arlib::read_graph_from_string<RoadGraph>(std::string(cittastudi_gr));
+  REQUIRE(num_vertices(R) == num_vertices(G));
+  REQUIRE(num_edges(R) == num_edges(G));
+  REQUIRE(sorted_edges(R) == sorted_edges(G));
+
+  for (RoadVertex v = 0; v < num_vertices(R); ++v) {
+    REQUIRE(out_degree(v, R) == out_degree(v, G));
+    REQUIRE(in_degree(v, R) == in_degree(v, G));
+    for (auto [it, end] = out_edges(v, R); it != end; ++it) {
+      REQUIRE(source(*it, R) == v);
+    }
+    for (auto [it, end] = in_edges(v, R); it != end; ++it) {
+      REQUIRE(target(*it, R) == v);
+      auto [e, found] = edge(source(*it, R), v, R);
+      REQUIRE(found);
+      REQUIRE(target(e, R) == v);
+    }
+  }
+
+  // The edge index is dense and follows the edge list
+  auto index = get(edge_index, R);
+  auto expected = std::uint32_t{0};
+  for (auto [it, end] = edges(R); it != end; ++it, ++expected) {
+    REQUIRE(get(index, *it) == expected);
+  }
+  REQUIRE(expected == num_edges(R));
+}
+
+TEST_CASE("road_graph keeps parallel edges and both weight copies in sync",
+          "[road_graph]") {
+  using namespace boost;
+
+  auto es = std::vector<arlib::VPair>{{1, 2}, {0, 1}, {0, 1}, {2, 0}};
+  auto ws = std::vector<Length>{4, 5, 1, 3};
+  auto R = RoadGraph{es.begin(), es.end(), ws.begin(), 3};
+  auto weight = get(edge_weight, R);
+
+  // Out-edges of the same tail keep their order
+  auto [first, last] = out_edges(0, R);
+  REQUIRE(std::distance(first, last) == 2);
+  auto heavy = *first, light = *std::next(first);
+  REQUIRE(heavy != light);
+  REQUIRE(get(weight, heavy) == 5);
+  REQUIRE(get(weight, light) == 1);
+  REQUIRE(edge(0, 1, R).first == heavy);
+  REQUIRE_FALSE(edge(1, 0, R).second);
+
+  put(weight, light, 7);
+  REQUIRE(get(edge_weight, R, light) == 7);
+  auto in_weights = std::vector<Length>{};
+  for (auto [it, end] = in_edges(1, R); it != end; ++it) {
+    in_weights.push_back(get(weight, *it));
+  }
+  REQUIRE(in_weights == std::vector<Length>{5, 7});
+
+  auto rev = make_reverse_graph(R);
+  auto rev_weight = get(edge_weight, rev);
+  auto rev_weights = std::vector<Length>{};
+  for (auto [it, end] = out_edges(1, rev); it != end; ++it) {
+    REQUIRE(target(*it, rev) == 0);
+    rev_weights.push_back(get(rev_weight, *it));
+  }
+  REQUIRE(rev_weights == std::vector<Length>{5, 7});
+
+  REQUIRE_THROWS_AS((RoadGraph{es.begin(), es.end(), ws.begin(), 2}),
+                    std::out_of_range);
+}
+
+TEST_CASE("Shortest path kernels find the same distances on road_graph",
+          "[road_graph]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto R = arlib::read_graph_from_string<RoadGraph>(std::string(cittastudi_gr));
+  auto n = num_vertices(R);
+  auto weight = get(edge_weight, R);
+  auto index = get(vertex_index, R);
+  auto rev = make_reverse_graph(R);
+  auto rev_weight = get(edge_weight, rev);
+
+  auto workspace = arlib::SearchWorkspace<RoadVertex, Length>{n};
+  auto predecessor_vec = std::vector<RoadVertex>(n);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+
+  for (RoadVertex s = 0; s < n; s += n / 5) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s, distance_map(&expected[0]));
+    auto distance = std::vector<Length>(n);
+    dijkstra_shortest_paths(R, s, distance_map(&distance[0]));
+    REQUIRE(distance == expected);
+
+    for (RoadVertex t = 1; t < n; t += n / 9) {
+      if (expected[t] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      REQUIRE(arlib::dijkstra(R, s, t, predecessor, weight, index,
+                              workspace) == expected[t]);
+      REQUIRE(arlib::bidirectional_dijkstra(R, s, t, predecessor, weight, rev,
+                                            rev_weight, index,
+                                            workspace.bidirectional()) ==
+              expected[t]);
+    }
+  }
+}
+
+TEST_CASE("Batched relaxation agrees with Boost on high-degree vertices",
+          "[road_graph]") {
+  using namespace boost;
+
+  // A few hubs with dozens of out-edges, parallel ones included, among
+  // vertices of road-like degree
+  auto n = std::size_t{300};
+  auto rng = std::mt19937{42};
+  auto vertex = std::uniform_int_distribution<std::size_t>{0, n - 1};
+  auto length = std::uniform_int_distribution<Length>{1, 100};
+  auto es = std::vector<arlib::VPair>{};
+  auto ws = std::vector<Length>{};
+  for (std::size_t u = 0; u < n; ++u) {
+    auto degree = (u % 50 == 0) ? 45 + u / 50 : 3;
+    for (std::size_t i = 0; i < degree; ++i) {
+      es.emplace_back(u, (i % 9 == 8) ? es.back().second : vertex(rng));
+      ws.push_back(length(rng));
+    }
+  }
+  auto G = Graph{es.begin(), es.end(), ws.begin(), n};
+  auto R = RoadGraph{es.begin(), es.end(), ws.begin(), n};
+  auto D = arlib::road_graph<double>{es.begin(), es.end(), ws.begin(), n};
+
+  auto check = [&](auto const &graph, auto const &expected, auto s) {
+    using Dist = arlib::length_of_t<std::decay_t<decltype(graph)>>;
+    auto weight = get(edge_weight, graph);
+    auto index = get(vertex_index, graph);
+    auto workspace = arlib::SearchWorkspace<RoadVertex, Dist>{n};
+    auto predecessor = std::vector<RoadVertex>(n);
+    for (RoadVertex t = 0; t < n; ++t) {
+      if (expected[t] == std::numeric_limits<Length>::max()) {
+        REQUIRE_THROWS_AS(arlib::dijkstra(graph, s, t, &predecessor[0],
+                                          weight, index, workspace),
+                          arlib::details::target_not_found);
+        continue;
+      }
+      REQUIRE(arlib::dijkstra(graph, s, t, &predecessor[0], weight, index,
+                              workspace) == expected[t]);
+      auto heuristic =
+          arlib::details::distance_heuristic<std::decay_t<decltype(graph)>,
+                                             Dist>{graph, t};
+      REQUIRE(arlib::astar(graph, s, t, &predecessor[0], weight, index,
+                           heuristic, workspace) == expected[t]);
+
+      // The predecessors are joined by edges adding up to the distance
+      auto total = Dist{0};
+      for (auto v = t; v != s; v = predecessor[v]) {
+        auto best = std::numeric_limits<Dist>::max();
+        for (auto [it, end] = out_edges(predecessor[v], graph); it != end;
+             ++it) {
+          if (target(*it, graph) == v) {
+            best = std::min(best, get(weight, *it));
+          }
+        }
+        total += best;
+      }
+      REQUIRE(total == expected[t]);
+    }
+  };
+
+  for (RoadVertex s : {0u, 7u, 150u}) {
+    auto expected = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s, distance_map(&expected[0]));
+    check(R, expected, s);
+    check(D, expected, s);
+  }
+
+  // A negative weight in the middle of a batch
+  ws[17] = -1;
+  auto negative = RoadGraph{es.begin(), es.end(), ws.begin(), n};
+  auto workspace = arlib::SearchWorkspace<RoadVertex, Length>{n};
+  auto predecessor = std::vector<RoadVertex>(n);
+  REQUIRE_THROWS_AS(arlib::dijkstra(negative, 0u, 1u, &predecessor[0],
+                                    get(edge_weight, negative),
+                                    get(vertex_index, negative), workspace),
+                    std::domain_error);
+}
+
+TEST_CASE("Alternative routes are the same on road_graph",
+          "[road_graph][esx][onepassplus][penalty]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(graph_gr_esx));
+  auto R = arlib::read_graph_from_string<RoadGraph>(std::string(graph_gr_esx));
+
+  Vertex s = 0, t = 6;
+  RoadVertex road_s = 0, road_t = 6;
+  int k = 3;
+  double theta = 0.5;
+  auto lengths = [](auto const &graph, auto &predecessors, auto s, auto t) {
+    auto result = std::vector<Length>{};
+    for (auto const &path : arlib::to_paths(graph, predecessors, s, t)) {
+      result.push_back(path.length());
+    }
+    return result;
+  };
+
+  SECTION("ESX") {
+    using arlib::routing_kernels;
+    for (auto kernel : {routing_kernels::dijkstra, routing_kernels::astar,
+                        routing_kernels::bidirectional_dijkstra,
+                        routing_kernels::parallel_bidirectional_dijkstra}) {
+      auto expected = arlib::multi_predecessor_map<Vertex>{};
+      arlib::esx(G, expected, s, t, k, theta, kernel);
+      auto actual = arlib::multi_predecessor_map<RoadVertex>{};
+      arlib::esx(R, actual, road_s, road_t, k, theta, kernel);
+      REQUIRE(lengths(R, actual, road_s, road_t) ==
+              lengths(G, expected, s, t));
+    }
+  }
+
+  SECTION("OnePass+") {
+    auto expected = arlib::multi_predecessor_map<Vertex>{};
+    arlib::onepass_plus(G, expected, s, t, k, theta);
+    auto actual = arlib::multi_predecessor_map<RoadVertex>{};
+    arlib::onepass_plus(R, actual, road_s, road_t, k, theta);
+    REQUIRE(lengths(R, actual, road_s, road_t) ==
+            lengths(G, expected, s, t));
+  }
+
+  SECTION("Penalty") {
+    auto expected = arlib::multi_predecessor_map<Vertex>{};
+    arlib::penalty(G, expected, s, t, k, theta, 0.1, 0.1, 10, 100000);
+    auto actual = arlib::multi_predecessor_map<RoadVertex>{};
+    arlib::penalty(R, actual, road_s, road_t, k, theta, 0.1, 0.1, 10,
+                   100000);
+    REQUIRE(lengths(R, actual, road_s, road_t) ==
+            lengths(G, expected, s, t));
+  }
+}
+
+TEST_CASE("road_graph survives a write/read round trip and a mapping",
+          "[road_graph]") {
+  using namespace boost;
+
+  auto R = arlib::read_graph_from_string<RoadGraph>(std::string(cittastudi_gr));
+  auto buffer = std::stringstream{};
+  arlib::write_road_graph(buffer, R);
+  auto serialized = buffer.str();
+
+  auto same_graph = [&](RoadGraph const &other) {
+    REQUIRE(num_vertices(other) == num_vertices(R));
+    REQUIRE(num_edges(other) == num_edges(R));
+    auto [it, end] = edges(R);
+    for (auto [o_it, o_end] = edges(other); o_it != o_end; ++o_it, ++it) {
+      REQUIRE(it != end);
+      REQUIRE(get(edge_index, other, *o_it) == get(edge_index, R, *it));
+      REQUIRE(source(*o_it, other) == source(*it, R));
+      REQUIRE(target(*o_it, other) == target(*it, R));
+      REQUIRE(get(edge_weight, other, *o_it) == get(edge_weight, R, *it));
+    }
+    for (RoadVertex v = 0; v < num_vertices(R); ++v) {
+      REQUIRE(in_degree(v, other) == in_degree(v, R));
+    }
+  };
+
+  SECTION("Stream") {
+    auto read = arlib::read_road_graph<Length>(buffer);
+    REQUIRE(read);
+    same_graph(*read);
+
+    // Weights of a graph read back can still be changed
+    auto e = *edges(*read).first;
+    put(edge_weight, *read, e, 42);
+    REQUIRE(get(edge_weight, *read, *in_edges(target(e, *read), *read).first) ==
+            42);
+
+    // A different length type, a truncated stream or a corrupted one are
+    // rejected
+    auto as_double = std::stringstream{serialized};
+    REQUIRE_FALSE(arlib::read_road_graph<double>(as_double));
+    auto truncated =
+        std::stringstream{serialized.substr(0, serialized.size() / 2)};
+    REQUIRE_FALSE(arlib::read_road_graph<Length>(truncated));
+    auto corrupted_bytes = serialized;
+    corrupted_bytes[corrupted_bytes.size() - 1] ^= 1;
+    auto corrupted = std::stringstream{corrupted_bytes};
+    REQUIRE_FALSE(arlib::read_road_graph<Length>(corrupted));
+  }
+
+  SECTION("Memory mapping") {
+    auto path =
+        (std::filesystem::temp_directory_path() / "arlib_test_road_graph.bin")
+            .string();
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << serialized;
+    }
+    auto mapped = arlib::map_road_graph<Length>(path, true);
+    REQUIRE(mapped);
+    REQUIRE(mapped->read_only());
+    same_graph(*mapped);
+    auto copy = *mapped;
+    mapped.reset();
+    same_graph(copy);
+
+    auto e = *edges(copy).first;
+    REQUIRE_THROWS_AS(put(edge_weight, copy, e, 42), std::logic_error);
+    REQUIRE_FALSE(arlib::map_road_graph<double>(path));
+
+    // The checksum is only read when asked to
+    auto corrupted = serialized;
+    corrupted[corrupted.size() - 1] ^= 1;
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << corrupted;
+    }
+    REQUIRE(arlib::map_road_graph<Length>(path));
+    REQUIRE_FALSE(arlib::map_road_graph<Length>(path, true));
+
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << serialized.substr(0, serialized.size() - 8);
+    }
+    REQUIRE_FALSE(arlib::map_road_graph<Length>(path));
+
+    // The structure is always checked: an arc leading out of the graph or
+    // decreasing offsets are rejected without the checksum
+    auto offsets = sizeof(arlib::details::road_graph_header);
+    auto offsets_bytes = (num_vertices(R) + 1) * sizeof(std::uint32_t);
+    auto out_arcs = offsets + arlib::details::padded_size(offsets_bytes);
+    auto rejected = [&](std::size_t position, std::uint32_t value) {
+      auto broken = serialized;
+      std::memcpy(&broken[position], &value, sizeof(value));
+      {
+        auto file = std::ofstream{path, std::ios::binary};
+        file << broken;
+      }
+      return !arlib::map_road_graph<Length>(path);
+    };
+    REQUIRE(rejected(out_arcs, num_vertices(R)));
+    REQUIRE(rejected(offsets + sizeof(std::uint32_t), num_edges(R) + 1));
+    std::remove(path.c_str());
+  }
+}
+
+TEST_CASE("Snapshot checksums catch any two flipped bits", "[road_graph]") {
+  // Three words, the last one padded. Folding words with a single multiply
+  // missed e.g. the top bits of two consecutive words.
+  auto data = std::vector<unsigned char>(21);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>(i * 37);
+  }
+  auto hash = arlib::details::checksum(data.data(), data.size());
+  auto bits = data.size() * 8;
+  for (std::size_t a = 0; a < bits; ++a) {
+    data[a / 8] ^= 1u << (a % 8);
+    REQUIRE(arlib::details::checksum(data.data(), data.size()) != hash);
+    for (auto b = a + 1; b < bits; ++b) {
+      data[b / 8] ^= 1u << (b % 8);
+      REQUIRE(arlib::details::checksum(data.data(), data.size()) != hash);
+      data[b / 8] ^= 1u << (b % 8);
+    }
+    data[a / 8] ^= 1u << (a % 8);
+  }
+}
+
+TEST_CASE("A CSRGraph snapshot loads as a graph with the same edges",
+          "[road_graph]") {
+  using namespace boost;
+
+  auto G = arlib::read_csr_graph_from_string(std::string(cittastudi_gr));
+  auto path =
+      (std::filesystem::temp_directory_path() / "arlib_test_csr_graph.bin")
+          .string();
+  arlib::save_csr_graph(path, G);
+  auto R = arlib::load_csr_graph(path, true);
+  REQUIRE(R);
+  REQUIRE(num_vertices(*R) == num_vertices(G));
+  REQUIRE(num_edges(*R) == num_edges(G));
+
+  // Edges keep the order, and so the index, they have in the CSRGraph
+  auto [it, end] = edges(G);
+  for (auto [r_it, r_end] = edges(*R); r_it != r_end; ++r_it, ++it) {
+    REQUIRE(it != end);
+    REQUIRE(get(edge_index, *R, *r_it) == get(edge_index, G, *it));
+    REQUIRE(source(*r_it, *R) == source(*it, G));
+    REQUIRE(target(*r_it, *R) == target(*it, G));
+    REQUIRE(get(edge_weight, *R, *r_it) == get(edge_weight, G, *it));
+  }
+
+  // The mapped graph can be searched like the original one
+  auto n = num_vertices(G);
+  auto expected = std::vector<double>(n);
+  auto actual = std::vector<double>(n);
+  dijkstra_shortest_paths(G, vertex(0, G), distance_map(expected.data()));
+  dijkstra_shortest_paths(*R, RoadVertex{0}, distance_map(actual.data()));
+  REQUIRE(actual == expected);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,204 @@
+#include "catch.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include <arlib/details/arlib_utils.hpp>
+#include <arlib/details/esx_impl.hpp>
+#include <arlib/details/penalty_impl.hpp>
+#include <arlib/graph_utils.hpp>
+#include <arlib/routing_kernels/bidirectional_dijkstra.hpp>
+#include <arlib/routing_kernels/search_workspace.hpp>
+
+#include "cittastudi_graph.hpp"
+#include "test_types.hpp"
+
+#include <limits>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace arlib::test;
+
+TEST_CASE("One search workspace serves many queries of every kernel",
+          "[search_workspace]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto index = get(vertex_index, G);
+  auto n = num_vertices(G);
+  auto rev_G = make_reverse_graph(G);
+  auto rev_weight = get(edge_weight, rev_G);
+
+  auto workspace = arlib::SearchWorkspace<Vertex, Length>{n};
+  auto predecessor_vec = std::vector<Vertex>(n);
+  auto predecessor = make_iterator_property_map(predecessor_vec.begin(), index);
+
+  for (Vertex s = 0; s < n; s += n / 7) {
+    auto distance = std::vector<Length>(n);
+    dijkstra_shortest_paths(G, s, distance_map(&distance[0]));
+    auto heuristic = arlib::details::distance_heuristic<Graph, Length>{G, s};
+    for (Vertex t = 1; t < n; t += n / 11) {
+      if (distance[t] == std::numeric_limits<Length>::max()) {
+        REQUIRE_THROWS_AS(arlib::dijkstra(G, s, t, predecessor, weight, index,
+                                          workspace),
+                          arlib::details::target_not_found);
+        continue;
+      }
+      REQUIRE(arlib::dijkstra(G, s, t, predecessor, weight, index,
+                              workspace) == distance[t]);
+      REQUIRE(workspace.visited(t));
+      REQUIRE(workspace.distance(t) == distance[t]);
+
+      // Walk the tree back to s through the search labels
+      auto length = Length{0};
+      for (auto v = t; v != s; v = workspace.predecessor(v)) {
+        auto [e, found] = edge(workspace.predecessor(v), v, G);
+        REQUIRE(found);
+        length += weight[e];
+      }
+      REQUIRE(length == distance[t]);
+
+      REQUIRE(arlib::bidirectional_dijkstra(G, s, t, predecessor, weight,
+                                            rev_G, rev_weight, index,
+                                            workspace.bidirectional()) ==
+              distance[t]);
+    }
+
+    // The reverse distances from s guide A* towards s
+    auto reverse = std::vector<Length>(n);
+    dijkstra_shortest_paths(rev_G, s, distance_map(&reverse[0]));
+    for (Vertex u = 1; u < n; u += n / 11) {
+      if (reverse[u] == std::numeric_limits<Length>::max()) {
+        continue;
+      }
+      REQUIRE(arlib::astar(G, u, s, predecessor, weight, index, heuristic,
+                           workspace) == reverse[u]);
+    }
+  }
+}
+
+TEST_CASE("ESX and Penalty kernels give the same paths on a shared "
+          "workspace",
+          "[search_workspace]") {
+  using namespace boost;
+
+  auto G = arlib::read_graph_from_string<Graph>(std::string(cittastudi_gr));
+  auto weight = get(edge_weight, G);
+  auto n = num_vertices(G);
+  Vertex t = 20;
+
+  auto path_length = [&](auto const &path) {
+    auto length = Length{0};
+    for (auto const &e : path) {
+      length += weight[e];
+    }
+    return length;
+  };
+
+  SECTION("ESX") {
+    using Edge = arlib::edge_of_t<Graph>;
+    auto deleted = std::unordered_set<Edge, boost::hash<Edge>>{};
+    auto workspace = arlib::SearchWorkspace<Vertex, Length>{n};
+    auto heuristic = arlib::details::distance_heuristic<Graph, Length>{G, t};
+    for (Vertex s = 0; s < n; s += n / 13) {
+      auto fresh =
+          arlib::details::dijkstra_shortest_path(G, s, t, weight, deleted);
+      auto reused = arlib::details::dijkstra_shortest_path(G, s, t, weight,
+                                                           deleted, workspace);
+      auto guided = arlib::details::astar_shortest_path(
+          G, s, t, weight, heuristic, deleted, workspace);
+      REQUIRE(fresh.has_value() == reused.has_value());
+      REQUIRE(fresh.has_value() == guided.has_value());
+      if (fresh) {
+        REQUIRE(path_length(*fresh) == path_length(*reused));
+        REQUIRE(path_length(*fresh) == path_length(*guided));
+        // Deleting an edge of the path must be seen by the next query
+        deleted.insert(fresh->front());
+      }
+    }
+  }
+
+  SECTION("Penalty") {
+    auto penalty = arlib::details::penalty_functor{weight};
+    auto workspace = arlib::SearchWorkspace<Vertex, double>{n};
+    for (Vertex s = 0; s < n; s += n / 13) {
+      auto fresh = arlib::details::dijkstra_shortest_path(G, s, t, penalty);
+      auto reused =
+          arlib::details::dijkstra_shortest_path(G, s, t, penalty, workspace);
+      REQUIRE(fresh.has_value() == reused.has_value());
+      if (fresh) {
+        REQUIRE(*fresh == *reused);
+      }
+    }
+  }
+
+  SECTION("Shortest path of a run") {
+    auto workspace = arlib::SearchWorkspace<Vertex, Length>{n};
+    for (Vertex s = 0; s < n; s += n / 13) {
+      auto fresh = arlib::details::compute_shortest_path(G, weight, s, t);
+      auto reused =
+          arlib::details::compute_shortest_path(G, weight, s, t, workspace);
+      REQUIRE(fresh.has_value() == reused.has_value());
+      if (fresh) {
+        REQUIRE(*fresh == *reused);
+      }
+    }
+  }
+}
+
+TEST_CASE("Kernels returning paths keep the parallel edges they relaxed",
+          "[search_workspace]") {
+  using namespace boost;
+  using arlib::VPair;
+
+  // Both hops have a heavy edge listed before a light parallel one
+  auto es = std::vector<VPair>{{0, 1}, {0, 1}, {1, 2}, {1, 2}, {0, 2}};
+  auto ws = std::vector<Length>{5, 1, 4, 1, 10};
+  auto G = Graph{es.begin(), es.end(), ws.begin(), 3};
+  auto weight = get(edge_weight, G);
+  Vertex s = 0, t = 2;
+
+  auto path_length = [&](auto const &path) {
+    auto length = Length{0};
+    for (auto const &e : path) {
+      length += weight[e];
+    }
+    return length;
+  };
+
+  SECTION("ESX") {
+    using Edge = arlib::edge_of_t<Graph>;
+    auto deleted = std::unordered_set<Edge, boost::hash<Edge>>{};
+    auto heuristic = arlib::details::distance_heuristic<Graph, Length>{G, t};
+    auto dijkstra =
+        arlib::details::dijkstra_shortest_path(G, s, t, weight, deleted);
+    auto astar = arlib::details::astar_shortest_path(G, s, t, weight,
+                                                     heuristic, deleted);
+    auto bidirectional = arlib::details::bidirectional_dijkstra_shortest_path(
+        G, s, t, weight, deleted);
+    REQUIRE(path_length(*dijkstra) == 2);
+    REQUIRE(path_length(*astar) == 2);
+    REQUIRE(path_length(*bidirectional) == 2);
+    REQUIRE(*dijkstra == *bidirectional);
+  }
+
+  SECTION("Penalty") {
+    auto penalty = arlib::details::penalty_functor{weight};
+    auto dijkstra = arlib::details::dijkstra_shortest_path(G, s, t, penalty);
+    auto bidirectional =
+        arlib::details::bidirectional_dijkstra_shortest_path(G, s, t, penalty);
+    REQUIRE(path_length(*dijkstra) == 2);
+    REQUIRE(path_length(*bidirectional) == 2);
+  }
+
+  SECTION("Shortest path of a run") {
+    auto path = arlib::details::compute_shortest_path(G, weight, s, t);
+    REQUIRE(path);
+    REQUIRE(path->size() == 2);
+    REQUIRE(path_length(*path) == 2);
+  }
+}